@@ -0,0 +1,86 @@
+/*****************************************************************************************
+ **	Name:        CPUComputeBenchmark.cpp                                                **
+ **	Description: Thread group throughput of the CPU compute backend versus worker count **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                           **
+ **	Published:   <insert date>                                                          **
+ ****************************************************************************************/
+
+#include "CPUComputeBackend.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+int main(int argc, char** argv)
+{
+	uint32_t width = 1280;
+	uint32_t height = 720;
+	uint32_t tileSize = CS_THREAD_GROUP_SIZE;
+	uint32_t frames = 200;
+	uint32_t maxThreads = std::thread::hardware_concurrency();
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--width") == 0)        width = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--height") == 0)  height = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--frames") == 0)  frames = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--tile") == 0)    tileSize = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--threads") == 0) maxThreads = (uint32_t)atoi(argv[i + 1]);
+	}
+
+	if (maxThreads == 0)
+	{
+		maxThreads = 1;
+	}
+
+	// Same tile constants the sample bakes into its immutable constant buffers in Init()
+	TileGrid grid(width, height, tileSize);
+
+	std::vector<CPUComputeBackend::ConstantBuffer> tiles;
+	CPUComputeBackend::BuildTileConstants(grid, tiles);
+
+	CPUTexture2D uav(width, height);
+	double pixelsPerFrame = (double)width * height;
+
+	printf("CPU compute backend: %ux%u, %ux%u tiles, %u dispatches/frame, %u frames\n", width, height, grid.GetTileSize(), grid.GetTileSize(), (uint32_t)tiles.size(), frames);
+	printf("%8s %12s %14s %14s %10s %10s\n", "threads", "ms/frame", "groups/s", "Mpixels/s", "speedup", "steals");
+
+	// Powers of two up to, and always including, the requested maximum
+	std::vector<uint32_t> threadCounts;
+	for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+	{
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(maxThreads);
+
+	double baseline = 0.0;
+	for (uint32_t threads : threadCounts)
+	{
+		ThreadPool pool(threads);
+		CPUComputeBackend backend(pool, grid.GetTileSize());
+
+		// Warm up caches and wake every worker before timing
+		backend.DispatchTiles(tiles.data(), (uint32_t)tiles.size(), uav);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t frame = 0; frame < frames; frame++)
+		{
+			backend.DispatchTiles(tiles.data(), (uint32_t)tiles.size(), uav);
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		double groupsPerSecond = (double)tiles.size() * frames / seconds;
+		double pixelsPerSecond = pixelsPerFrame * frames / seconds;
+		if (threads == 1)
+		{
+			baseline = groupsPerSecond;
+		}
+
+		printf("%8u %12.4f %14.0f %14.2f %9.2fx %10llu\n", threads, seconds * 1000.0 / frames, groupsPerSecond,
+			pixelsPerSecond / 1.0e6, groupsPerSecond / baseline, (unsigned long long)pool.GetStealCount());
+	}
+
+	return 0;
+}
@@ -0,0 +1,172 @@
+/***************************************************************************************************************************
+ **	Name:        DeferredRecordingBenchmark.cpp                                                                           **
+ **	Description: Measures how recording the compute pass on deferred contexts scales with the number of recording threads **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                             **
+ **	Published:   <insert date>                                                                                            **
+ **************************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "ThreadPool.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// The compute pass of one frame, set up directly on the device so only the recording and execution are timed
+struct TilePass
+{
+	GfxTexture texture;
+	GfxView uav;
+	GfxShader shader;
+	std::vector<GfxBuffer> constantBuffers;
+};
+
+static bool CreateTilePass(GraphicsDevice& device, uint32_t width, uint32_t height, uint32_t tileSize, TilePass& pass)
+{
+	pass.texture = device.CreateTexture2D(width, height, GFX_BIND_UNORDERED_ACCESS);
+	pass.uav = device.CreateUnorderedAccessView(pass.texture);
+	pass.shader = device.CreateComputeShader(tileSize == 8 ? "ComputeShaderTile8" : (tileSize == 32 ? "ComputeShaderTile32" : "ComputeShader"));
+
+	for (uint32_t x = 0; x < (width + tileSize - 1) / tileSize; x++)
+	{
+		for (uint32_t y = 0; y < (height + tileSize - 1) / tileSize; y++)
+		{
+			UAVOverlapSampleApp::ConstantBuffer cbuffer = { x, y, width, height, ComputeWorkload() };
+			pass.constantBuffers.push_back(device.CreateConstantBuffer(&cbuffer, sizeof(cbuffer)));
+		}
+	}
+	return pass.uav != GFX_NULL_HANDLE && pass.shader != GFX_NULL_HANDLE;
+}
+
+static void RecordRange(GfxComputeContext& context, const TilePass& pass, uint32_t begin, uint32_t end)
+{
+	context.CSSetShader(pass.shader);
+	context.CSSetUnorderedAccessView(0, pass.uav);
+	context.BeginUAVOverlap();
+	for (uint32_t i = begin; i < end; i++)
+	{
+		context.CSSetConstantBuffer(0, pass.constantBuffers[i]);
+		context.Dispatch(1, 1, 1);
+	}
+	context.EndUAVOverlap();
+}
+
+struct Timing
+{
+	double recordMs;
+	double executeMs;
+};
+
+// Splits the pass across threadCount deferred contexts, or records it on the immediate context for 0
+static Timing RunTilePass(CPUGraphicsDevice& device, const TilePass& pass, uint32_t threadCount, uint32_t passes)
+{
+	std::vector<std::unique_ptr<GfxDeferredContext>> contexts;
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		contexts.push_back(device.CreateDeferredContext());
+	}
+	ThreadPool pool(threadCount > 0 ? threadCount : 1);
+
+	uint32_t dispatchCount = (uint32_t)pass.constantBuffers.size();
+	Timing timing = { 0.0, 0.0 };
+	for (uint32_t p = 0; p < passes; p++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if (threadCount == 0)
+		{
+			RecordRange(device, pass, 0, dispatchCount);
+			device.Present();
+			timing.executeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			continue;
+		}
+
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			GfxDeferredContext* context = contexts[i].get();
+			uint32_t begin = (uint32_t)((uint64_t)dispatchCount * i / threadCount);
+			uint32_t end = (uint32_t)((uint64_t)dispatchCount * (i + 1) / threadCount);
+			pool.Submit([context, &pass, begin, end]()
+			{
+				RecordRange(*context, pass, begin, end);
+				context->FinishCommandList();
+			});
+		}
+		pool.Wait();
+
+		std::chrono::steady_clock::time_point recorded = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			device.ExecuteCommandList(contexts[i].get());
+		}
+		device.Present();
+
+		timing.recordMs += std::chrono::duration<double, std::milli>(recorded - start).count();
+		timing.executeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recorded).count();
+	}
+
+	timing.recordMs /= passes;
+	timing.executeMs /= passes;
+	return timing;
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t passes = 20;
+	uint32_t width = 1920;
+	uint32_t height = 1080;
+	uint32_t maxThreads = std::thread::hardware_concurrency();
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--passes") == 0) passes = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--width") == 0) width = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--height") == 0) height = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--max-threads") == 0) maxThreads = (uint32_t)atoi(argv[i + 1]);
+	}
+	if (maxThreads == 0)
+	{
+		maxThreads = 1;
+	}
+	if (passes == 0)
+	{
+		passes = 1;
+	}
+
+	// Split, record and merge of an 8x8 tile pass, inside one overlap bracket per list. Execution queues every
+	// dispatch on the device's own workers, so it stays serial on the submitting thread whatever the split.
+	CPUGraphicsDevice device;
+	TilePass pass;
+	if (!device.Init(width, height) || !CreateTilePass(device, width, height, 8, pass))
+	{
+		printf("failed to set up the %ux%u tile pass\n", width, height);
+		return 1;
+	}
+
+	printf("%ux%u, 8x8 tiles, %zu dispatches, mean of %u passes\n", width, height, pass.constantBuffers.size(), passes);
+	printf("%-16s %12s %12s %12s %14s\n", "recording", "record ms", "execute ms", "total ms", "record speedup");
+
+	Timing immediate = RunTilePass(device, pass, 0, passes);
+	printf("%-16s %12s %12.3f %12.3f %14s\n", "immediate", "-", immediate.executeMs, immediate.executeMs, "-");
+
+	double singleRecordMs = 0.0;
+	for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		Timing timing = RunTilePass(device, pass, threads, passes);
+		if (threads == 1)
+		{
+			singleRecordMs = timing.recordMs;
+		}
+
+		char name[32];
+		snprintf(name, sizeof(name), "%u deferred", threads);
+		printf("%-16s %12.3f %12.3f %12.3f %13.2fx\n", name, timing.recordMs, timing.executeMs, timing.recordMs + timing.executeMs,
+			timing.recordMs > 0.0 ? singleRecordMs / timing.recordMs : 0.0);
+	}
+
+	device.Cleanup();
+	return 0;
+}
@@ -0,0 +1,15 @@
+/*******************************************************************
+ **	Name:        FakeClock.cpp                                    **
+ **	Description: A clock that only moves when the caller moves it **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com     **
+ **	Published:   <insert date>                                    **
+ ******************************************************************/
+
+#include "FakeClock.h"
+
+std::atomic<uint64_t> gFakeClockNs(0);
+
+uint64_t FakeClock()
+{
+	return gFakeClockNs.load();
+}
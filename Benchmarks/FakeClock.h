@@ -0,0 +1,21 @@
+/**********************************************************************************************************
+ **	Name:        FakeClock.h                                                                             **
+ **	Description: A clock for FrameClockFn parameters that only moves when the caller moves it, so timers **
+ **              can be checked against known durations                                                  **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                            **
+ **	Published:   <insert date>                                                                           **
+ *********************************************************************************************************/
+
+#ifndef FAKECLOCK_H
+#define FAKECLOCK_H
+
+#include <atomic>
+#include <cstdint>
+
+// Nanoseconds FakeClock() returns. Atomic because devices may read their clock from worker threads.
+extern std::atomic<uint64_t> gFakeClockNs;
+
+// A FrameClockFn reading gFakeClockNs
+uint64_t FakeClock();
+
+#endif // FAKECLOCK_H
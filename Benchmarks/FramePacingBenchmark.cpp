@@ -0,0 +1,73 @@
+/****************************************************************************************************************
+ **	Name:        FramePacingBenchmark.cpp                                                                      **
+ **	Description: Reports the sample's frame latency, throughput and CPU wait at each depth of the CPU device's **
+ **              frames-in-flight pipeline                                                                     **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                  **
+ **	Published:   <insert date>                                                                                 **
+ ***************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "StateFilterGraphicsDevice.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	uint32_t timedFrames = 100;
+	uint32_t width = 1920;
+	uint32_t height = 1080;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--timed-frames") == 0) timedFrames = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--width") == 0) width = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--height") == 0) height = (uint32_t)atoi(argv[i + 1]);
+	}
+	if (timedFrames == 0)
+	{
+		timedFrames = 1;
+	}
+
+	// The sample at each depth: the deeper pipeline trades latency for throughput once the CPU and the timeline overlap
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = width;
+	options.height = height;
+	options.bAutoUAVOverlap = true;
+
+	printf("%ux%u, auto overlap, %u frames\n", width, height, timedFrames);
+	printf("%-10s %12s %12s %12s %12s\n", "in flight", "fps", "latency ms", "p95 ms", "cpu wait ms");
+	for (uint32_t framesInFlight = 1; framesInFlight <= GFX_MAX_FRAMES_IN_FLIGHT; framesInFlight++)
+	{
+		options.framesInFlight = framesInFlight;
+
+		CPUGraphicsDevice cpuDevice;
+		StateFilterGraphicsDevice stateFilter(&cpuDevice);
+		UAVOverlapSampleApp app(&stateFilter, width, height);
+		app.ApplyOptions(options);
+		if (!app.Init())
+		{
+			printf("%-10u failed to initialize\n", framesInFlight);
+			app.Cleanup();
+			return 1;
+		}
+
+		for (uint32_t frame = 0; frame < timedFrames; frame++)
+		{
+			app.Render(1.0);
+		}
+		app.FinishFrames();
+
+		FramePacer::Report report = app.GetFramePacer().GetReport();
+		printf("%-10u %12.2f %12.4f %12.4f %12.4f\n", framesInFlight, report.throughputFps, report.latency.meanMs, report.latency.p95Ms, report.meanCpuWaitMs);
+		app.Cleanup();
+	}
+
+	return 0;
+}
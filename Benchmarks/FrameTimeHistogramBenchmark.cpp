@@ -0,0 +1,70 @@
+/*****************************************************************************************************
+ **	Name:        FrameTimeHistogramBenchmark.cpp                                                    **
+ **	Description: Cost of FrameTimeHistogram::Record() from one thread and from many threads at once **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                       **
+ **	Published:   <insert date>                                                                      **
+ ****************************************************************************************************/
+
+#include "FrameTimeHistogram.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	uint32_t records = 2000000;
+	uint32_t maxThreads = std::thread::hardware_concurrency();
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--records") == 0)      records = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--threads") == 0) maxThreads = (uint32_t)atoi(argv[i + 1]);
+	}
+
+	maxThreads = maxThreads == 0 ? 1 : maxThreads;
+
+	// Record() cost from one thread and from many recording at once
+	printf("Frame time histogram: %u buckets, %u KB\n", FrameTimeHistogram::BUCKET_COUNT, (uint32_t)(sizeof(FrameTimeHistogram) / 1024));
+	printf("%8s %14s %14s\n", "threads", "ns/record", "Mrecords/s");
+
+	std::vector<uint32_t> threadCounts;
+	for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+	{
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(maxThreads);
+
+	for (uint32_t threads : threadCounts)
+	{
+		FrameTimeHistogram histogram;
+		uint32_t perThread = records / threads;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::vector<std::thread> workers;
+		for (uint32_t t = 0; t < threads; t++)
+		{
+			workers.push_back(std::thread([&histogram, perThread, t]()
+			{
+				uint64_t value = 1000000 + t * 7919;
+				for (uint32_t i = 0; i < perThread; i++)
+				{
+					histogram.Record(value);
+					value = (value * 6364136223846793005ull + 1442695040888963407ull) % 100000000ull;
+				}
+			}));
+		}
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		uint64_t recorded = (uint64_t)perThread * threads;
+		printf("%8u %14.2f %14.2f\n", threads, seconds * 1.0e9 / (double)recorded, (double)recorded / seconds / 1.0e6);
+	}
+
+	return 0;
+}
@@ -0,0 +1,51 @@
+/***********************************************************************************************************
+ **	Name:        GpuPassTimerBenchmark.cpp                                                                **
+ **	Description: Per-frame CPU overhead of issuing and polling the GpuPassTimer queries on the CPU device **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                             **
+ **	Published:   <insert date>                                                                            **
+ **********************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "GpuPassTimer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv)
+{
+	uint32_t overheadFrames = 100000;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--overhead-frames") == 0) overheadFrames = (uint32_t)atoi(argv[i + 1]);
+	}
+
+	// CPU cost of issuing and polling the queries, with results arriving two frames late as on a typical GPU
+	CPUGraphicsDevice device(1);
+	device.SetQueryLatency(2);
+	device.Init(64, 64);
+
+	GpuPassTimer timer;
+	timer.Init(&device, 2);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t frame = 0; frame < overheadFrames; frame++)
+	{
+		timer.BeginFrame();
+		timer.EndPass(0);
+		timer.EndPass(1);
+		timer.EndFrame();
+		device.Present();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("overhead: %.1f ns per frame including Present(), %llu frames resolved\n", seconds * 1.0e9 / overheadFrames,
+		(unsigned long long)timer.GetResolvedFrameCount());
+
+	timer.Release();
+	device.Cleanup();
+
+	return 0;
+}
@@ -0,0 +1,83 @@
+/*******************************************************************************************************
+ **	Name:        GradientKernelBenchmark.cpp                                                          **
+ **	Description: Single-thread throughput of the SIMD gradient row kernels against the scalar kernel, **
+ **              through full thread groups                                                           **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                         **
+ **	Published:   <insert date>                                                                        **
+ ******************************************************************************************************/
+
+#include "CPUComputeBackend.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Runs every thread group of the grid on the calling thread, the way one worker would
+static void RunGrid(const std::vector<CPUComputeBackend::ConstantBuffer>& tiles, uint32_t tileSize, CPUTexture2D& uav)
+{
+	for (const CPUComputeBackend::ConstantBuffer& cb : tiles)
+	{
+		CPUComputeBackend::RunThreadGroup(cb, tileSize, 0, 0, uav);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t width = 1280;
+	uint32_t height = 720;
+	uint32_t tileSize = CS_THREAD_GROUP_SIZE;
+	uint32_t frames = 200;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--width") == 0)       width = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--height") == 0) height = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--frames") == 0) frames = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--tile") == 0)   tileSize = (uint32_t)atoi(argv[i + 1]);
+	}
+
+	TileGrid grid(width, height, tileSize);
+
+	std::vector<CPUComputeBackend::ConstantBuffer> tiles;
+	CPUComputeBackend::BuildTileConstants(grid, tiles);
+
+	KernelISA defaultISA = CPUComputeBackend::GetKernelISA();
+
+	printf("Gradient row kernels: %ux%u, %ux%u tiles, %u frames, 1 thread, default %s\n", width, height, grid.GetTileSize(), grid.GetTileSize(), frames, GetKernelISAName(defaultISA));
+	printf("%8s %12s %14s %10s\n", "isa", "ms/frame", "Mpixels/s", "speedup");
+
+	double baseline = 0.0;
+	for (int isa = KERNEL_ISA_SCALAR; isa < KERNEL_ISA_COUNT; isa++)
+	{
+		if (!IsKernelISASupported((KernelISA)isa))
+		{
+			printf("%8s %12s\n", GetKernelISAName((KernelISA)isa), "n/a");
+			continue;
+		}
+
+		// One untimed frame to fault in the texture
+		CPUComputeBackend::SetKernelISA((KernelISA)isa);
+		CPUTexture2D uav(width, height);
+		RunGrid(tiles, grid.GetTileSize(), uav);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t frame = 0; frame < frames; frame++)
+		{
+			RunGrid(tiles, grid.GetTileSize(), uav);
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		double pixelsPerSecond = (double)width * height * frames / seconds;
+		if (isa == KERNEL_ISA_SCALAR)
+		{
+			baseline = pixelsPerSecond;
+		}
+
+		printf("%8s %12.4f %14.2f %9.2fx\n", GetKernelISAName((KernelISA)isa), seconds * 1000.0 / frames, pixelsPerSecond / 1.0e6, pixelsPerSecond / baseline);
+	}
+
+	CPUComputeBackend::SetKernelISA(defaultISA);
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+/*********************************************************************************************************************
+ **	Name:        IndirectDispatchBenchmark.cpp                                                                      **
+ **	Description: Compares the CPU cost of submitting the compute pass per tile, batched and as one DispatchIndirect **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                       **
+ **	Published:   <insert date>                                                                                      **
+ ********************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "StateFilterGraphicsDevice.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	uint32_t timedFrames = 50;
+	uint32_t width = 1920;
+	uint32_t height = 1080;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--timed-frames") == 0) timedFrames = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--width") == 0) width = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--height") == 0) height = (uint32_t)atoi(argv[i + 1]);
+	}
+	if (timedFrames == 0)
+	{
+		timedFrames = 1;
+	}
+
+	// CPU time the app spends issuing the compute pass, with the state filter in front as in the sample
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = width;
+	options.height = height;
+	options.tileSize = 8;
+
+	printf("%ux%u, 8x8 tiles, mean of %u frames\n", width, height, timedFrames);
+	printf("%-12s %10s %12s\n", "submission", "commands", "submit ms");
+
+	const char* modeNames[] = { "per-tile", "batched", "indirect" };
+	for (uint32_t mode = 0; mode < 3; mode++)
+	{
+		options.bUseBatchedDispatch = (mode == 1);
+		options.bUseIndirectDispatch = (mode == 2);
+
+		CPUGraphicsDevice cpuDevice;
+		StateFilterGraphicsDevice stateFilter(&cpuDevice);
+		UAVOverlapSampleApp app(&stateFilter, width, height);
+		app.ApplyOptions(options);
+		if (!app.Init())
+		{
+			printf("%-12s failed to initialize\n", modeNames[mode]);
+			app.Cleanup();
+			return 1;
+		}
+
+		double submitMs = 0.0;
+		for (uint32_t frame = 0; frame < timedFrames; frame++)
+		{
+			app.Render(1.0);
+			submitMs += app.GetComputeCounters().submissionTimeMs;
+		}
+		printf("%-12s %10u %12.4f\n", modeNames[mode], app.GetComputeCounters().commandCount, submitMs / timedFrames);
+		app.Cleanup();
+	}
+
+	return 0;
+}
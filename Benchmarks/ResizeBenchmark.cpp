@@ -0,0 +1,84 @@
+/**************************************************************************************************************
+ **	Name:        ResizeBenchmark.cpp                                                                         **
+ **	Description: Times resizing the sample at runtime against initializing a new device and app at each size **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                **
+ **	Published:   <insert date>                                                                               **
+ *************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "StateFilterGraphicsDevice.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Mean CPU time of resizing back and forth between two sizes, against initializing a new device and app at each. The
+// fresh apps start after the resized one is cleaned up, as ImGui has one current context.
+static void TimeResize(const char* name, uint32_t widthA, uint32_t heightA, uint32_t widthB, uint32_t heightB, uint32_t iterations)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+
+	CPUGraphicsDevice cpuDevice;
+	StateFilterGraphicsDevice stateFilter(&cpuDevice);
+	UAVOverlapSampleApp app(&stateFilter, widthA, heightA);
+	app.ApplyOptions(options);
+	if (!app.Init())
+	{
+		printf("%-28s failed to initialize\n", name);
+		app.Cleanup();
+		return;
+	}
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		app.Resize(widthB, heightB);
+		app.Render(1.0);
+		app.Resize(widthA, heightA);
+		app.Render(1.0);
+	}
+	ResizeReport report = app.GetResizeReport();
+	app.Cleanup();
+
+	double initMs = 0.0;
+	for (uint32_t i = 0; i < 2 * iterations; i++)
+	{
+		CPUGraphicsDevice freshDevice;
+		StateFilterGraphicsDevice freshFilter(&freshDevice);
+		UAVOverlapSampleApp fresh(&freshFilter, (i & 1) ? widthA : widthB, (i & 1) ? heightA : heightB);
+		fresh.ApplyOptions(options);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		fresh.Init();
+		initMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		fresh.Cleanup();
+	}
+
+	printf("%-28s %8u %10u %12.4f %12.4f %12.4f\n", name, report.GetCount(), report.GetReallocationCount(), report.GetMeanMs(), report.GetMaxMs(),
+		initMs / (2 * iterations));
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t iterations = 10;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--iterations") == 0) iterations = (uint32_t)atoi(argv[i + 1]);
+	}
+	if (iterations == 0)
+	{
+		iterations = 1;
+	}
+
+	printf("%-28s %8s %10s %12s %12s %12s\n", "resize, 16x16 tiles", "resizes", "realloc", "mean ms", "max ms", "fresh Init ms");
+	TimeResize("640x360 <-> 480x270", 640, 360, 480, 270, iterations);
+	TimeResize("640x360 <-> 256x144", 640, 360, 256, 144, iterations);
+
+	return 0;
+}
@@ -0,0 +1,70 @@
+/***********************************************************************************************
+ **	Name:        SampleFixture.cpp                                                            **
+ **	Description: Runs the sample on the CPU reference device for the benchmarks and the tests **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                 **
+ **	Published:   <insert date>                                                                **
+ **********************************************************************************************/
+
+#include "SampleFixture.h"
+#include "StateFilterGraphicsDevice.h"
+
+const char* const gOverlapNames[] = { "off", "always", "auto" };
+
+bool RenderSample(const HeadlessOptions& options, bool useStateFilter, uint32_t frames, SampleFrame& frame)
+{
+	CPUGraphicsDevice cpuDevice(2);
+	StateFilterGraphicsDevice stateFilter(&cpuDevice);
+	GraphicsDevice* device = useStateFilter ? static_cast<GraphicsDevice*>(&stateFilter) : &cpuDevice;
+
+	UAVOverlapSampleApp app(device, options.width, options.height);
+	app.ApplyOptions(options);
+	if (!app.Init())
+	{
+		app.Cleanup();
+		return false;
+	}
+	for (uint32_t i = 0; i < frames; i++)
+	{
+		app.Render(1.0);
+	}
+	app.FinishFrames();
+	bool read = device->ReadBackBuffer(frame.image);
+	frame.overlapStats = app.GetLastOverlapStats();
+	frame.recordThreadCount = app.GetRecordThreadCount();
+	frame.computeCounters = app.GetComputeCounters();
+	app.Cleanup();
+	return read;
+}
+
+bool ReadThroughBackBuffer(CPUGraphicsDevice& device, GfxView srv, uint32_t width, uint32_t height, std::vector<uint32_t>& image)
+{
+	const UAVOverlapSampleApp::SimpleVertex vertices[3] =
+	{
+		{ { -1.0f, -3.0f, 0.0f }, { 0.0f, 2.0f } },
+		{ { -1.0f, +1.0f, 0.0f }, { 0.0f, 0.0f } },
+		{ { +3.0f, +1.0f, 0.0f }, { 2.0f, 0.0f } }
+	};
+
+	GfxShader vertexShader = device.CreateVertexShader("VertexShader");
+	GfxShader pixelShader = device.CreatePixelShader("PixelShader");
+	GfxInputLayout layout = device.CreateInputLayout(vertexShader);
+	GfxBuffer vertexBuffer = device.CreateVertexBuffer(vertices, sizeof(vertices));
+
+	device.OMSetRenderTarget(device.GetBackBufferRTV());
+	device.RSSetViewport((float)width, (float)height);
+	device.IASetInputLayout(layout);
+	device.IASetVertexBuffer(0, vertexBuffer, sizeof(UAVOverlapSampleApp::SimpleVertex), 0);
+	device.VSSetShader(vertexShader);
+	device.PSSetShader(pixelShader);
+	device.PSSetShaderResource(0, srv);
+	device.Draw(3, 0);
+	device.PSSetShaderResource(0, GFX_NULL_HANDLE);
+	bool read = device.ReadBackBuffer(image);
+
+	GfxHandle handles[] = { vertexBuffer, layout, pixelShader, vertexShader };
+	for (GfxHandle handle : handles)
+	{
+		device.Release(handle);
+	}
+	return read;
+}
@@ -0,0 +1,41 @@
+/**************************************************************************************************************
+ **	Name:        SampleFixture.h                                                                             **
+ **	Description: Runs the sample on the CPU reference device for the benchmarks and the tests, and the names **
+ **              they print results under                                                                    **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                **
+ **	Published:   <insert date>                                                                               **
+ *************************************************************************************************************/
+
+#ifndef SAMPLEFIXTURE_H
+#define SAMPLEFIXTURE_H
+
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "UAVHazardTracker.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <cstdint>
+#include <vector>
+
+// UAVOverlapMode values as printed in result tables
+extern const char* const gOverlapNames[];
+
+// The last frame of a RenderSample() run
+struct SampleFrame
+{
+	std::vector<uint32_t> image;              // The back buffer, packed RGBA8
+	UAVHazardTracker::PassStats overlapStats; // Brackets and hazards of the compute pass
+	uint32_t recordThreadCount;               // Deferred contexts the compute pass was recorded on
+	UAVOverlapSampleApp::SubmissionCounters computeCounters;
+
+	SampleFrame() : overlapStats(), recordThreadCount(0), computeCounters() {}
+};
+
+// Initializes the sample with options on a CPU device with two worker threads, with a StateFilterGraphicsDevice in
+// front if useStateFilter is set, renders frames and reads back the last one once the frames in flight have finished
+bool RenderSample(const HeadlessOptions& options, bool useStateFilter, uint32_t frames, SampleFrame& frame);
+
+// Draws srv over the back buffer with the sample's composite shaders, which copy it unchanged, and reads it back
+bool ReadThroughBackBuffer(CPUGraphicsDevice& device, GfxView srv, uint32_t width, uint32_t height, std::vector<uint32_t>& image);
+
+#endif // SAMPLEFIXTURE_H
@@ -0,0 +1,53 @@
+/***************************************************************************************************************
+ **	Name:        StartupTimerBenchmark.cpp                                                                    **
+ **	Description: Times where the sample's startup goes on the CPU device with --startup-bench, and writes its **
+ **              Chrome trace                                                                                 **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                 **
+ **	Published:   <insert date>                                                                                **
+ **************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "StartupBench.h"
+#include "StartupTimer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	uint32_t runs = 5;
+	uint32_t width = 1920;
+	uint32_t height = 1080;
+	std::string tracePath = "StartupTimerBenchmark.json";
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--runs") == 0) runs = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--width") == 0) width = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--height") == 0) height = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--trace") == 0) tracePath = argv[i + 1];
+	}
+	if (runs == 0)
+	{
+		runs = 1;
+	}
+
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = width;
+	options.height = height;
+
+	// Where the time goes when the sample starts on the CPU device, as --startup-bench reports it
+	options.startupBenchRuns = runs;
+	options.startupTracePath = tracePath;
+	std::vector<StartupTimer> timers;
+	bool ok = RunStartupBench(options, []() { return std::unique_ptr<GraphicsDevice>(new CPUGraphicsDevice()); }, stdout, timers);
+
+	return ok ? 0 : 1;
+}
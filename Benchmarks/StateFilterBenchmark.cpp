@@ -0,0 +1,99 @@
+/**********************************************************************************************************
+ **	Name:        StateFilterBenchmark.cpp                                                                **
+ **	Description: Share of the sample's state changes the redundant state filter drops, and the cost of a **
+ **              filtered call against a forwarded one                                                   **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                            **
+ **	Published:   <insert date>                                                                           **
+ *********************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "StateFilterGraphicsDevice.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Renders frames of the sample through the filter and reports how many of the app's state changes it dropped
+static void ReportSample(uint32_t frames, bool bBatched, bool bOverlap)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 320;
+	options.height = 180;
+	options.bUseBatchedDispatch = bBatched;
+	options.bUseUAVOverlap = bOverlap;
+
+	CPUGraphicsDevice cpuDevice(1);
+	StateFilterGraphicsDevice filter(&cpuDevice);
+	UAVOverlapSampleApp app(&filter, options.width, options.height);
+	app.ApplyOptions(options);
+	if (!app.Init())
+	{
+		printf("%-8s %-8s failed to initialize\n", bBatched ? "batched" : "tiles", bOverlap ? "on" : "off");
+		app.Cleanup();
+		return;
+	}
+	for (uint32_t frame = 0; frame < frames; frame++)
+	{
+		app.Render(1.0);
+	}
+	uint64_t forwarded = filter.GetForwardedCount();
+	uint64_t filtered = filter.GetFilteredCount();
+	uint64_t issued = forwarded + filtered;
+	app.Cleanup();
+
+	printf("%-8s %-8s %8llu %10llu %10llu %8.1f%%\n", bBatched ? "batched" : "tiles", bOverlap ? "on" : "off", (unsigned long long)issued,
+		(unsigned long long)forwarded, (unsigned long long)filtered, issued ? 100.0 * filtered / issued : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t frames = 10;
+	uint32_t overheadCalls = 10000000;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--frames") == 0)              frames = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--overhead-calls") == 0) overheadCalls = (uint32_t)atoi(argv[i + 1]);
+	}
+
+	printf("Sample at 320x180, %u frames, state changes issued by the app and forwarded by the filter\n", frames);
+	printf("%-8s %-8s %8s %10s %10s %9s\n", "dispatch", "overlap", "issued", "forwarded", "filtered", "saved");
+	ReportSample(frames, false, false);
+	ReportSample(frames, false, true);
+	ReportSample(frames, true, false);
+
+	// Cost of a call the filter drops, against one it forwards to the CPU device
+	{
+		CPUGraphicsDevice cpuDevice(1);
+		StateFilterGraphicsDevice filter(&cpuDevice);
+		filter.Init(64, 64);
+		uint32_t zero[4] = { 0, 0, 0, 0 };
+		GfxBuffer buffers[2] = { filter.CreateConstantBuffer(zero, sizeof(zero)), filter.CreateConstantBuffer(zero, sizeof(zero)) };
+		GraphicsDevice* device = &filter;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < overheadCalls; i++)
+		{
+			device->CSSetConstantBuffer(0, buffers[0]);
+		}
+		double filteredNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / overheadCalls;
+
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < overheadCalls; i++)
+		{
+			device->CSSetConstantBuffer(0, buffers[i & 1]);
+		}
+		double forwardedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / overheadCalls;
+
+		printf("\nCSSetConstantBuffer through the filter: %.2f ns filtered, %.2f ns forwarded to the CPU device\n", filteredNs, forwardedNs);
+		filter.Cleanup();
+	}
+
+	return 0;
+}
@@ -0,0 +1,56 @@
+/**********************************************************************************************************************
+ **	Name:        UAVHazardBenchmark.cpp                                                                              **
+ **	Description: Measures the per-dispatch cost of the automatic overlap brackets at tens of thousands of dispatches **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                        **
+ **	Published:   <insert date>                                                                                       **
+ *********************************************************************************************************************/
+
+#include "UAVHazardFixture.h"
+#include "UAVHazardTracker.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	uint32_t passes = 20;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--passes") == 0) passes = (uint32_t)atoi(argv[i + 1]);
+	}
+
+	// Per-dispatch cost of the automatic mode on a no-op device: 1080p and 4K grids of 8x8 tiles
+	printf("%-24s %10s %14s\n", "grid", "dispatches", "ns/dispatch");
+	const uint32_t sizes[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+	for (const uint32_t* size : sizes)
+	{
+		std::vector<UAVFootprint> footprints;
+		TileFootprints(size[0], size[1], 8, footprints);
+
+		CallLogDevice device;
+		device.calls.reserve(footprints.size() + 2);
+		UAVHazardTracker tracker;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t pass = 0; pass < passes; pass++)
+		{
+			device.calls.clear();
+			tracker.BeginPass(&device, UAV_OVERLAP_AUTO, size[0], size[1]);
+			for (const UAVFootprint& footprint : footprints)
+			{
+				tracker.Dispatch(footprint, 1, 1, 1);
+			}
+			tracker.EndPass();
+		}
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)passes * footprints.size());
+
+		char name[32];
+		snprintf(name, sizeof(name), "%ux%u 8x8", size[0], size[1]);
+		printf("%-24s %10zu %14.1f\n", name, footprints.size(), ns);
+	}
+
+	return 0;
+}
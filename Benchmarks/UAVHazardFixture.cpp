@@ -0,0 +1,21 @@
+/***************************************************************************************************************
+ **	Name:        UAVHazardFixture.cpp                                                                         **
+ **	Description: Dispatch footprints and a call-logging device for the UAV hazard tracker benchmark and tests **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                 **
+ **	Published:   <insert date>                                                                                **
+ **************************************************************************************************************/
+
+#include "UAVHazardFixture.h"
+
+#include "TileGrid.h"
+
+void TileFootprints(uint32_t width, uint32_t height, uint32_t tileSize, std::vector<UAVFootprint>& footprints)
+{
+	TileGrid grid(width, height, tileSize);
+	for (uint32_t i = 0; i < grid.GetTileCount(); i++)
+	{
+		TileGrid::Tile tile = grid.GetTile(i);
+		UAVFootprint footprint = { tile.x, tile.y, tile.x + tile.width, tile.y + tile.height };
+		footprints.push_back(footprint);
+	}
+}
@@ -0,0 +1,33 @@
+/***************************************************************************************************************
+ **	Name:        UAVHazardFixture.h                                                                           **
+ **	Description: Dispatch footprints and a call-logging device for the UAV hazard tracker benchmark and tests **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                 **
+ **	Published:   <insert date>                                                                                **
+ **************************************************************************************************************/
+
+#ifndef UAVHAZARDFIXTURE_H
+#define UAVHAZARDFIXTURE_H
+
+#include "GraphicsDeviceDecorator.h"
+#include "UAVHazardTracker.h"
+
+#include <cstdint>
+#include <vector>
+
+// Logs the bracket and dispatch calls the tracker makes; it makes no others, so there is no device underneath
+class CallLogDevice : public GraphicsDeviceDecorator
+{
+public:
+	CallLogDevice() : GraphicsDeviceDecorator(nullptr) {}
+
+	std::vector<char> calls; // 'B'egin, 'E'nd, 'D'ispatch
+
+	virtual void BeginUAVOverlap() { calls.push_back('B'); }
+	virtual void EndUAVOverlap() { calls.push_back('E'); }
+	virtual void Dispatch(uint32_t, uint32_t, uint32_t) { calls.push_back('D'); }
+};
+
+// Every tile of a width x height grid in the sample's column-major order
+void TileFootprints(uint32_t width, uint32_t height, uint32_t tileSize, std::vector<UAVFootprint>& footprints);
+
+#endif // UAVHAZARDFIXTURE_H
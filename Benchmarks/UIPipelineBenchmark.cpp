@@ -0,0 +1,69 @@
+/*************************************************************************************************************
+ **	Name:        UIPipelineBenchmark.cpp                                                                    **
+ **	Description: Compares the context calls per frame and walk time of the save-and-restore and owned ImGui **
+ **              pipelines on the sample's overlay                                                          **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                               **
+ **	Published:   <insert date>                                                                              **
+ ************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "UAVOverlapSampleApp.h"
+#include "UIPipelineFixture.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	uint32_t frames = 20;
+	uint32_t width = 1280;
+	uint32_t height = 720;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--frames") == 0) frames = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--width") == 0) width = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--height") == 0) height = (uint32_t)atoi(argv[i + 1]);
+	}
+	if (frames == 0)
+	{
+		frames = 1;
+	}
+
+	// The sample's own overlay, frame after frame
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = width;
+	options.height = height;
+
+	CPUGraphicsDevice cpuDevice(2);
+	DrawDataComparisonDevice comparisonDevice(&cpuDevice);
+	UAVOverlapSampleApp app(&comparisonDevice, width, height);
+	app.ApplyOptions(options);
+	bool rendered = app.Init();
+	for (uint32_t frame = 0; frame < frames && rendered; frame++)
+	{
+		app.Render(1.0);
+	}
+	app.Cleanup();
+
+	if (!rendered)
+	{
+		printf("failed to render the sample\n");
+		return 1;
+	}
+
+	FrameComparison& comparison = comparisonDevice.GetComparison();
+	uint32_t count = comparison.frameCount ? comparison.frameCount : 1;
+	printf("%ux%u sample overlay, mean of %u frames\n", width, height, count);
+	printf("%-22s %14s %14s %14s %12s\n", "pipeline", "context calls", "skipped binds", "round-trip", "walk ms");
+	printf("%-22s %14.1f %14.1f %14.1f %12.4f\n", "save and restore", (double)comparison.savedCalls / count, 0.0, 0.0, comparison.savedMs / count);
+	printf("%-22s %14.1f %14.1f %14.1f %12.4f\n", "owned", (double)comparison.ownedCalls / count, (double)comparison.skippedBinds / count,
+		(double)comparison.skippedRoundTripCalls / count, comparison.ownedMs / count);
+
+	return 0;
+}
@@ -0,0 +1,110 @@
+/************************************************************************************************
+ **	Name:        UIPipelineFixture.cpp                                                         **
+ **	Description: The mock context comparison of the save-and-restore and owned ImGui pipelines **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                  **
+ **	Published:   <insert date>                                                                 **
+ ***********************************************************************************************/
+
+#include "UIPipelineFixture.h"
+
+#include <chrono>
+
+// Stand-ins for the backend's objects and the app's
+static const char gBackendObjects[UI_SLOT_COUNT] = {};
+static const char gAppObjects[UI_SLOT_COUNT] = {};
+
+MockContext* gCallbackContext = nullptr;
+
+// The sample's composite pass as D3D11GraphicsDevice issues it: the app's shaders, layout, vertex buffer, viewport and
+// texture, the compute shader from the compute pass, and with an owned pipeline the default blend, depth-stencil,
+// rasterizer and sampler state put back before its draw. Returns the slots it bound.
+static uint32_t BindAppState(MockContext& context, bool ownedPipeline)
+{
+	const UIPipelineSlot appSlots[] = { UI_SLOT_COMPUTE_SHADER, UI_SLOT_VIEWPORT, UI_SLOT_INPUT_LAYOUT, UI_SLOT_VERTEX_BUFFER, UI_SLOT_VERTEX_SHADER, UI_SLOT_PIXEL_SHADER };
+	uint32_t dirty = 0;
+	for (UIPipelineSlot slot : appSlots)
+	{
+		dirty |= context.BindForApp(slot, &gAppObjects[slot]);
+	}
+	if (ownedPipeline)
+	{
+		const UIPipelineSlot resetSlots[] = { UI_SLOT_BLEND_STATE, UI_SLOT_DEPTH_STENCIL_STATE, UI_SLOT_RASTERIZER_STATE, UI_SLOT_PS_SAMPLER };
+		for (UIPipelineSlot slot : resetSlots)
+		{
+			dirty |= context.BindForApp(slot, nullptr);
+		}
+	}
+	dirty |= context.BindForApp(UI_SLOT_PS_TEXTURE, nullptr);
+	return dirty;
+}
+
+static const void* const* GetBackendObjects()
+{
+	static const void* objects[UI_SLOT_COUNT] = {};
+	for (uint32_t slot = UI_SLOT_INPUT_LAYOUT; slot <= UI_SLOT_RASTERIZER_STATE; slot++)
+	{
+		bool cleared = slot == UI_SLOT_TOPOLOGY || (slot >= UI_SLOT_GEOMETRY_SHADER && slot <= UI_SLOT_COMPUTE_SHADER);
+		objects[slot] = cleared ? nullptr : &gBackendObjects[slot];
+	}
+	return objects;
+}
+
+static bool SameDraws(const std::vector<MockContext::DrawRecord>& a, const std::vector<MockContext::DrawRecord>& b)
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		bool same = a[i].indexCount == b[i].indexCount && a[i].startIndex == b[i].startIndex && a[i].baseVertex == b[i].baseVertex;
+		for (uint32_t slot = 0; slot < UI_SLOT_COUNT && same; slot++)
+		{
+			same = a[i].state[slot] == b[i].state[slot];
+		}
+		if (!same)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FrameComparison::Render(const ImDrawData* drawData, uint32_t vertexOffset, uint32_t indexOffset)
+{
+	BindAppState(saved, false);
+	ownedRenderer.Invalidate(BindAppState(owned, true));
+
+	UIBinding before[UI_SLOT_COUNT];
+	memcpy(before, saved.GetState(), sizeof(before));
+	saved.ResetFrame();
+	owned.ResetFrame();
+
+	gCallbackContext = &saved;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	savedRenderer.Render(drawData, GetBackendObjects(), vertexOffset, indexOffset, saved);
+	gCallbackContext = &owned;
+	std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+	ownedRenderer.Render(drawData, GetBackendObjects(), vertexOffset, indexOffset, owned);
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	savedMs += std::chrono::duration<double, std::milli>(middle - start).count();
+	ownedMs += std::chrono::duration<double, std::milli>(end - middle).count();
+
+	// Same draws with the same state; the saved path leaves the state as it found it; the counters add up
+	bool restored = true;
+	for (uint32_t slot = 0; slot < UI_SLOT_COUNT; slot++)
+	{
+		restored &= saved.GetState()[slot] == before[slot];
+	}
+	const UIPipelineCounters& savedCounters = savedRenderer.GetLastCounters();
+	const UIPipelineCounters& ownedCounters = ownedRenderer.GetLastCounters();
+	bOk &= SameDraws(saved.GetDraws(), owned.GetDraws()) && restored && savedCounters.GetSavedCalls() == 0 &&
+		savedCounters.issuedCalls == saved.GetCallCount() && ownedCounters.issuedCalls == owned.GetCallCount() &&
+		ownedCounters.issuedCalls + ownedCounters.GetSavedCalls() == savedCounters.issuedCalls;
+
+	frameCount++;
+	savedCalls += savedCounters.issuedCalls;
+	ownedCalls += ownedCounters.issuedCalls;
+	skippedBinds += ownedCounters.skippedBinds;
+	skippedRoundTripCalls += ownedCounters.skippedRoundTripCalls;
+}
@@ -0,0 +1,141 @@
+/******************************************************************************************************************
+ **	Name:        UIPipelineFixture.h                                                                             **
+ **	Description: A mock device context for the ImGui pipeline walk, and a comparison of the save-and-restore and **
+ **              owned pipelines on it for the UI pipeline benchmark and tests                                   **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                    **
+ **	Published:   <insert date>                                                                                   **
+ *****************************************************************************************************************/
+
+#ifndef UIPIPELINEFIXTURE_H
+#define UIPIPELINEFIXTURE_H
+
+#include "GraphicsDeviceDecorator.h"
+#include "UIPipeline.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "imgui.h"
+
+// A device context that holds a binding per slot, makes every call one context call, and records the state each
+// draw ran with
+class MockContext : public UIPipelineContext
+{
+public:
+	struct DrawRecord
+	{
+		uint32_t indexCount;
+		uint32_t startIndex;
+		int32_t baseVertex;
+		UIBinding state[UI_SLOT_COUNT];
+	};
+
+	MockContext() : mCallCount(0)
+	{
+		for (uint32_t slot = 0; slot < UI_SLOT_COUNT; slot++)
+		{
+			mState[slot] = UIBinding();
+			mSaved[slot] = UIBinding();
+		}
+	}
+
+	virtual void Bind(UIPipelineSlot slot, const UIBinding& binding)
+	{
+		mState[slot] = binding;
+		mCallCount++;
+	}
+
+	virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+	{
+		DrawRecord draw;
+		draw.indexCount = indexCount;
+		draw.startIndex = startIndex;
+		draw.baseVertex = baseVertex;
+		memcpy(draw.state, mState, sizeof(mState));
+		mDraws.push_back(draw);
+		mCallCount++;
+	}
+
+	// One get and one set per slot
+	virtual void BackupState()
+	{
+		memcpy(mSaved, mState, sizeof(mState));
+		mCallCount += UI_SLOT_COUNT;
+	}
+
+	virtual void RestoreState()
+	{
+		memcpy(mState, mSaved, sizeof(mState));
+		mCallCount += UI_SLOT_COUNT;
+	}
+
+	virtual uint32_t GetStateRoundTripCallCount() const { return 2 * UI_SLOT_COUNT; }
+
+	// What the app binds directly, outside the renderer; returns the slots it changed
+	uint32_t BindForApp(UIPipelineSlot slot, const void* object)
+	{
+		mState[slot].object = object;
+		return UI_SLOT_BIT(slot);
+	}
+
+	const UIBinding* GetState() const { return mState; }
+	const std::vector<DrawRecord>& GetDraws() const { return mDraws; }
+	uint32_t GetCallCount() const { return mCallCount; }
+	void ResetFrame() { mDraws.clear(); mCallCount = 0; }
+
+private:
+	UIBinding mState[UI_SLOT_COUNT];
+	UIBinding mSaved[UI_SLOT_COUNT];
+	std::vector<DrawRecord> mDraws;
+	uint32_t mCallCount;
+};
+
+// The context being rendered to, for draw callbacks
+extern MockContext* gCallbackContext;
+
+// One frame through both renderers, each on its own context after the app's part of the frame
+struct FrameComparison
+{
+	MockContext saved;
+	MockContext owned;
+	UIPipelineRenderer savedRenderer;
+	UIPipelineRenderer ownedRenderer;
+	uint32_t frameCount;
+	uint64_t savedCalls;
+	uint64_t ownedCalls;
+	uint64_t skippedBinds;
+	uint64_t skippedRoundTripCalls;
+	double savedMs;
+	double ownedMs;
+	bool bOk;
+
+	FrameComparison() : frameCount(0), savedCalls(0), ownedCalls(0), skippedBinds(0), skippedRoundTripCalls(0), savedMs(0.0), ownedMs(0.0), bOk(true)
+	{
+		ownedRenderer.SetOwnedPipeline(true);
+	}
+
+	// Renders drawData through both, after BindAppState(), and checks the draws, the restored state and the counters
+	void Render(const ImDrawData* drawData, uint32_t vertexOffset, uint32_t indexOffset);
+};
+
+// Runs every frame of the sample's draw data through both renderers
+class DrawDataComparisonDevice : public GraphicsDeviceDecorator
+{
+public:
+	explicit DrawDataComparisonDevice(GraphicsDevice* inner) : GraphicsDeviceDecorator(inner) {}
+
+	FrameComparison& GetComparison() { return mComparison; }
+
+	virtual void RenderUI(ImDrawData* drawData)
+	{
+		// Ring offsets that move from frame to frame, as with the upload ring
+		mComparison.Render(drawData, 1000 * (mComparison.frameCount % 3), 3000 * (mComparison.frameCount % 3));
+		mInner->RenderUI(drawData);
+	}
+
+private:
+	FrameComparison mComparison;
+};
+
+#endif // UIPIPELINEFIXTURE_H
@@ -0,0 +1,90 @@
+/********************************************************************************************************************
+ **	Name:        UIRasterizerBenchmark.cpp                                                                         **
+ **	Description: Times the tiled ImGui rasterizer per thread count and ISA on draw data captured from the sample's **
+ **              Performance and Settings windows, against a per-triangle reference                                **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                      **
+ **	Published:   <insert date>                                                                                     **
+ *******************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "UIRasterizerFixture.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv)
+{
+	uint32_t frames = 3;
+	uint32_t iterations = 50;
+	uint32_t width = 1280;
+	uint32_t height = 720;
+	uint32_t maxThreads = 4;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--frames") == 0) frames = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--iterations") == 0) iterations = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--width") == 0) width = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--height") == 0) height = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--max-threads") == 0) maxThreads = (uint32_t)atoi(argv[i + 1]);
+	}
+	if (frames == 0)
+	{
+		frames = 1;
+	}
+	if (iterations == 0)
+	{
+		iterations = 1;
+	}
+
+	CPUGraphicsDevice cpuDevice(2);
+	DrawDataCaptureDevice capture(&cpuDevice);
+	CPUTexture2D background;
+	if (!CaptureSampleUI(width, height, frames, capture, background))
+	{
+		printf("failed to capture the sample's draw data\n");
+		return 1;
+	}
+	const UIFrame& frame = capture.GetFrame();
+
+	// The captured overlay over the captured frame, mean of the iterations
+	printf("%ux%u overlay, %u triangles in %zu commands, mean of %u frames\n", width, height, frame.GetTriangleCount(), frame.commands.size(), iterations);
+	printf("%-22s %8s %8s %12s %12s %12s\n", "rasterizer", "tiles", "binned", "setup ms", "raster ms", "reference ms");
+
+	double referenceMs = 0.0;
+	{
+		CPUTexture2D image = background;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		ReferenceRender(frame, image);
+		referenceMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		ThreadPool pool(threads);
+		for (uint32_t simd = 0; simd < 2; simd++)
+		{
+			UIRasterizer rasterizer(threads > 1 ? &pool : nullptr);
+			rasterizer.SetSIMDEnabled(simd != 0);
+
+			double setupMs = 0.0;
+			double rasterMs = 0.0;
+			CPUTexture2D image = background;
+			for (uint32_t i = 0; i < iterations; i++)
+			{
+				rasterizer.Render(frame, image);
+				setupMs += rasterizer.GetLastStats().setupMs;
+				rasterMs += rasterizer.GetLastStats().rasterMs;
+			}
+
+			char name[32];
+			snprintf(name, sizeof(name), "%s, %u thread%s", rasterizer.IsSIMDEnabled() ? "sse2" : "scalar", threads, threads > 1 ? "s" : "");
+			printf("%-22s %8u %8u %12.4f %12.4f %12.4f\n", name, rasterizer.GetLastStats().tileCount, rasterizer.GetLastStats().binnedCount,
+				setupMs / iterations, rasterMs / iterations, referenceMs);
+		}
+	}
+
+	return 0;
+}
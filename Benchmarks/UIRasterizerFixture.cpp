@@ -0,0 +1,130 @@
+/*****************************************************************************************************************
+ **	Name:        UIRasterizerFixture.cpp                                                                        **
+ **	Description: Per-triangle reference of the rules in UIRasterizer.h, and the capture of the sample's overlay **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                   **
+ **	Published:   <insert date>                                                                                  **
+ ****************************************************************************************************************/
+
+#include "UIRasterizerFixture.h"
+
+#include "GradientKernels.h"
+#include "HeadlessRun.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Vertex color times the point-sampled texel, interpolated with the barycentrics w0, w1 and w2
+static uint32_t ReferenceShade(const UIVertex* v, const CPUTexture2D& texture, float w0, float w1, float w2)
+{
+	float u = v[0].u * w0 + v[1].u * w1 + v[2].u * w2;
+	float t = v[0].v * w0 + v[1].v * w1 + v[2].v * w2;
+	u -= floorf(u);
+	t -= floorf(t);
+	uint32_t tx = std::min((uint32_t)(u * texture.width), texture.width - 1);
+	uint32_t ty = std::min((uint32_t)(t * texture.height), texture.height - 1);
+	uint32_t texel = texture.texels[(size_t)ty * texture.width + tx];
+
+	uint32_t result = 0;
+	for (uint32_t c = 0; c < 4; c++)
+	{
+		float color = (float)((v[0].color >> (8 * c)) & 0xFF) * w0 + (float)((v[1].color >> (8 * c)) & 0xFF) * w1 + (float)((v[2].color >> (8 * c)) & 0xFF) * w2;
+		result |= FloatToUNorm8(color * (float)((texel >> (8 * c)) & 0xFF) * (1.0f / 65025.0f)) << (8 * c);
+	}
+	return result;
+}
+
+uint32_t ReferenceBlend(uint32_t src, uint32_t dst)
+{
+	uint32_t alpha = src >> 24;
+	uint32_t result = ((alpha * (255 - alpha) + 127) / 255) << 24;
+	for (uint32_t c = 0; c < 3; c++)
+	{
+		uint32_t s = (src >> (8 * c)) & 0xFF;
+		uint32_t d = (dst >> (8 * c)) & 0xFF;
+		result |= ((s * alpha + d * (255 - alpha) + 127) / 255) << (8 * c);
+	}
+	return result;
+}
+
+void ReferenceRender(const UIFrame& frame, CPUTexture2D& target)
+{
+	for (const UIDrawCommand& command : frame.commands)
+	{
+		for (uint32_t i = 0; i < command.triangleCount; i++)
+		{
+			const UIVertex* v = &frame.vertices[3 * (size_t)(command.firstTriangle + i)];
+			float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+			if (!(fabsf(area) > 0.0f))
+			{
+				continue;
+			}
+
+			float a[3];
+			float b[3];
+			float c[3];
+			bool tie[3];
+			float sign = area > 0.0f ? 1.0f : -1.0f;
+			for (uint32_t e = 0; e < 3; e++)
+			{
+				const UIVertex& p = v[(e + 1) % 3];
+				const UIVertex& q = v[(e + 2) % 3];
+				const UIVertex& anchor = (p.y < q.y || (p.y == q.y && p.x < q.x)) ? p : q;
+				a[e] = (p.y - q.y) * sign;
+				b[e] = (q.x - p.x) * sign;
+				c[e] = -(a[e] * anchor.x + b[e] * anchor.y);
+				tie[e] = a[e] > 0.0f || (a[e] == 0.0f && b[e] > 0.0f);
+			}
+			float invArea = 1.0f / fabsf(area);
+			bool flat = v[0].color == v[1].color && v[0].color == v[2].color && v[0].u == v[1].u && v[0].u == v[2].u && v[0].v == v[1].v && v[0].v == v[2].v;
+
+			int32_t x0 = std::max(std::max(command.clipX0, 0), (int32_t)floorf(std::min(v[0].x, std::min(v[1].x, v[2].x))));
+			int32_t y0 = std::max(std::max(command.clipY0, 0), (int32_t)floorf(std::min(v[0].y, std::min(v[1].y, v[2].y))));
+			int32_t x1 = std::min(std::min(command.clipX1, (int32_t)target.width), (int32_t)ceilf(std::max(v[0].x, std::max(v[1].x, v[2].x))));
+			int32_t y1 = std::min(std::min(command.clipY1, (int32_t)target.height), (int32_t)ceilf(std::max(v[0].y, std::max(v[1].y, v[2].y))));
+			for (int32_t y = y0; y < y1; y++)
+			{
+				for (int32_t x = x0; x < x1; x++)
+				{
+					float px = (float)x + 0.5f;
+					float py = (float)y + 0.5f;
+					float edge[3];
+					bool inside = true;
+					for (uint32_t e = 0; e < 3; e++)
+					{
+						edge[e] = a[e] * px + (b[e] * py + c[e]);
+						inside = inside && (edge[e] > 0.0f || (edge[e] == 0.0f && tie[e]));
+					}
+					if (inside)
+					{
+						uint32_t src = flat ? ReferenceShade(v, *command.texture, 1.0f, 0.0f, 0.0f) :
+							ReferenceShade(v, *command.texture, edge[0] * invArea, edge[1] * invArea, edge[2] * invArea);
+						uint32_t& dst = target.texels[(size_t)y * target.width + x];
+						dst = ReferenceBlend(src, dst);
+					}
+				}
+			}
+		}
+	}
+}
+
+bool CaptureSampleUI(uint32_t width, uint32_t height, uint32_t frames, DrawDataCaptureDevice& capture, CPUTexture2D& background)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+
+	UAVOverlapSampleApp app(&capture, width, height);
+	app.ApplyOptions(options);
+	bool ok = app.Init();
+	for (uint32_t frame = 0; frame < frames && ok; frame++)
+	{
+		app.Render(1.0);
+	}
+	background = CPUTexture2D(width, height);
+	ok = ok && capture.ReadBackBuffer(background.texels);
+	app.Cleanup();
+	return ok && capture.GetFrame().GetTriangleCount() > 0;
+}
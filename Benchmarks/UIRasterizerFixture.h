@@ -0,0 +1,59 @@
+/**********************************************************************************************************************
+ **	Name:        UIRasterizerFixture.h                                                                               **
+ **	Description: The sample's captured ImGui draw data and a per-triangle reference rasterizer for the UI rasterizer **
+ **              benchmark and tests                                                                                 **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                        **
+ **	Published:   <insert date>                                                                                       **
+ *********************************************************************************************************************/
+
+#ifndef UIRASTERIZERFIXTURE_H
+#define UIRASTERIZERFIXTURE_H
+
+#include "CPUComputeBackend.h"
+#include "GraphicsDeviceDecorator.h"
+#include "UIRasterizer.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "imgui.h"
+
+// Keeps a copy of the last frame's draw data, with the font atlas as its only texture
+class DrawDataCaptureDevice : public GraphicsDeviceDecorator
+{
+public:
+	explicit DrawDataCaptureDevice(GraphicsDevice* inner) : GraphicsDeviceDecorator(inner) {}
+
+	const UIFrame& GetFrame() const { return mFrame; }
+
+	virtual void RenderUI(ImDrawData* drawData)
+	{
+		if (mFont.texels.empty())
+		{
+			unsigned char* pixels = nullptr;
+			int width = 0;
+			int height = 0;
+			ImGui::GetIO().Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+			mFont = CPUTexture2D((uint32_t)width, (uint32_t)height);
+			memcpy(mFont.texels.data(), pixels, (size_t)width * height * sizeof(uint32_t));
+		}
+		BuildUIFrame(drawData, [this](void*) { return &mFont; }, mFrame);
+		mInner->RenderUI(drawData);
+	}
+
+private:
+	CPUTexture2D mFont;
+	UIFrame mFrame;
+};
+
+// Literal transcription of the rules in UIRasterizer.h: every triangle in submission order, every pixel of its
+// clipped bounding box, one at a time
+void ReferenceRender(const UIFrame& frame, CPUTexture2D& target);
+
+// The blend of one source texel over dst, as the rasterizer and the DX11 backend's blend state do it
+uint32_t ReferenceBlend(uint32_t src, uint32_t dst);
+
+// Renders a few frames of the sample with the overlay, keeping the last frame's draw data and the frame under it
+bool CaptureSampleUI(uint32_t width, uint32_t height, uint32_t frames, DrawDataCaptureDevice& capture, CPUTexture2D& background);
+
+#endif // UIRASTERIZERFIXTURE_H
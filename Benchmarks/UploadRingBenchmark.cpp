@@ -0,0 +1,105 @@
+/**********************************************************************************************************************
+ **	Name:        UploadRingBenchmark.cpp                                                                             **
+ **	Description: Compares the upload ring's buffer recreations and discards with the fixed-slack scheme on synthetic **
+ **              and captured ImGui traces, and times its bookkeeping per upload                                     **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                        **
+ **	Published:   <insert date>                                                                                       **
+ *********************************************************************************************************************/
+
+#include "UploadRing.h"
+#include "UploadTraceFixture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// What the backend did before the ring: a discard every frame, and a new buffer of count + slack whenever it overflows
+struct SlackResult
+{
+	uint64_t recreationCount;
+	uint64_t discardCount;
+};
+
+static SlackResult RunSlack(const std::vector<uint32_t>& counts, uint32_t slack)
+{
+	SlackResult result = {};
+	uint32_t capacity = 0;
+	bool hasBuffer = false;
+	for (uint32_t count : counts)
+	{
+		if (!hasBuffer || capacity < count)
+		{
+			capacity = count + slack;
+			hasBuffer = true;
+			result.recreationCount++;
+		}
+		else
+		{
+			result.discardCount++;
+		}
+	}
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t frames = 2000;
+	uint32_t sampleFrames = 8;
+	uint32_t allocations = 10000000;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--frames") == 0) frames = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--sample-frames") == 0) sampleFrames = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--allocations") == 0) allocations = (uint32_t)atoi(argv[i + 1]);
+	}
+	if (allocations == 0)
+	{
+		allocations = 1;
+	}
+
+	std::vector<uint32_t> vertexCounts;
+	std::vector<uint32_t> indexCounts;
+	if (!CaptureSampleCounts(sampleFrames, vertexCounts, indexCounts))
+	{
+		printf("failed to capture the sample's draw data\n");
+		return 1;
+	}
+
+	std::vector<Trace> traces = MakeTraces(indexCounts, frames);
+
+	// Index buffer recreations and discards against the fixed +10000 slack, sizes in 16-bit indices
+	printf("%-22s %8s %14s %14s %14s %14s %12s\n", "index trace", "frames", "slack recreate", "slack discard", "ring recreate", "ring discard", "MB uploaded");
+	for (const Trace& trace : traces)
+	{
+		SlackResult slack = RunSlack(trace.counts, 10000);
+		UploadRing indexRing(sizeof(uint16_t), 10000);
+		for (uint32_t count : trace.counts)
+		{
+			indexRing.Allocate(count);
+		}
+		const UploadRingStats& stats = indexRing.GetStats();
+		printf("%-22s %8zu %14llu %14llu %14llu %14llu %12.2f\n", trace.name, trace.counts.size(), (unsigned long long)slack.recreationCount,
+			(unsigned long long)slack.discardCount, (unsigned long long)stats.recreationCount, (unsigned long long)stats.discardCount,
+			(double)stats.bytesUploaded / (1024.0 * 1024.0));
+	}
+	printf("captured sample: %u to %u vertices, %u to %u indices per frame\n", *std::min_element(vertexCounts.begin(), vertexCounts.end()),
+		*std::max_element(vertexCounts.begin(), vertexCounts.end()), *std::min_element(indexCounts.begin(), indexCounts.end()),
+		*std::max_element(indexCounts.begin(), indexCounts.end()));
+
+	// Bookkeeping cost per upload
+	UploadRing timedRing(sizeof(uint32_t), 5000);
+	uint32_t checksum = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < allocations; i++)
+	{
+		checksum += timedRing.Allocate(1000 + (i & 1023)).offset;
+	}
+	double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / allocations;
+	printf("\nAllocate: %.2f ns per upload (checksum %u)\n", ns, checksum);
+
+	return 0;
+}
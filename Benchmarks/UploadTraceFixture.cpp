@@ -0,0 +1,84 @@
+/***********************************************************************************************
+ **	Name:        UploadTraceFixture.cpp                                                       **
+ **	Description: Synthetic and captured upload traces for the upload ring benchmark and tests **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                 **
+ **	Published:   <insert date>                                                                **
+ **********************************************************************************************/
+
+#include "UploadTraceFixture.h"
+
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <random>
+#include <string>
+
+std::vector<Trace> MakeTraces(const std::vector<uint32_t>& captured, uint32_t frames)
+{
+	std::vector<Trace> traces;
+	std::mt19937 random(7);
+
+	Trace steady = { "steady 2000", std::vector<uint32_t>(frames, 2000) };
+	traces.push_back(steady);
+
+	// A UI that keeps adding a little, like a growing log window
+	Trace growing = { "growing +40/frame", std::vector<uint32_t>() };
+	for (uint32_t frame = 0; frame < frames; frame++)
+	{
+		growing.counts.push_back(1000 + 40 * frame);
+	}
+	traces.push_back(growing);
+
+	// Mostly small with occasional large frames, like a window opening and closing
+	Trace spiky = { "spiky 1500/60000", std::vector<uint32_t>() };
+	for (uint32_t frame = 0; frame < frames; frame++)
+	{
+		spiky.counts.push_back((frame % 97) < 5 ? 60000 : 1500);
+	}
+	traces.push_back(spiky);
+
+	Trace randomSizes = { "random 0..20000", std::vector<uint32_t>() };
+	std::uniform_int_distribution<uint32_t> size(0, 20000);
+	for (uint32_t frame = 0; frame < frames; frame++)
+	{
+		randomSizes.counts.push_back(size(random));
+	}
+	traces.push_back(randomSizes);
+
+	Trace sample = { "captured sample", std::vector<uint32_t>() };
+	while (!captured.empty() && sample.counts.size() < frames)
+	{
+		sample.counts.insert(sample.counts.end(), captured.begin(), captured.end());
+	}
+	sample.counts.resize(captured.empty() ? 0 : frames);
+	traces.push_back(sample);
+	return traces;
+}
+
+bool CaptureSampleCounts(uint32_t frames, std::vector<uint32_t>& vertexCounts, std::vector<uint32_t>& indexCounts)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 1280;
+	options.height = 720;
+
+	CPUGraphicsDevice cpuDevice(2);
+	DrawCountCaptureDevice capture(&cpuDevice);
+	UAVOverlapSampleApp app(&capture, options.width, options.height);
+	app.ApplyOptions(options);
+	bool ok = app.Init();
+	for (uint32_t frame = 0; frame < frames && ok; frame++)
+	{
+		if (frame == frames / 2)
+		{
+			ok = app.Resize(640, 360);
+		}
+		app.Render(1.0);
+	}
+	app.Cleanup();
+	vertexCounts = capture.GetVertexCounts();
+	indexCounts = capture.GetIndexCounts();
+	return ok && !vertexCounts.empty();
+}
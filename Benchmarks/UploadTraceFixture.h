@@ -0,0 +1,53 @@
+/*******************************************************************************************************************
+ **	Name:        UploadTraceFixture.h                                                                             **
+ **	Description: Per-frame upload sizes for the upload ring benchmark and tests: synthetic traces, and the vertex **
+ **              and index counts of the sample's own ImGui draw data                                             **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                     **
+ **	Published:   <insert date>                                                                                    **
+ ******************************************************************************************************************/
+
+#ifndef UPLOADTRACEFIXTURE_H
+#define UPLOADTRACEFIXTURE_H
+
+#include "GraphicsDeviceDecorator.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "imgui.h"
+
+// Records the vertex and index counts of every frame's draw data
+class DrawCountCaptureDevice : public GraphicsDeviceDecorator
+{
+public:
+	explicit DrawCountCaptureDevice(GraphicsDevice* inner) : GraphicsDeviceDecorator(inner) {}
+
+	const std::vector<uint32_t>& GetVertexCounts() const { return mVertexCounts; }
+	const std::vector<uint32_t>& GetIndexCounts() const { return mIndexCounts; }
+
+	virtual void RenderUI(ImDrawData* drawData)
+	{
+		mVertexCounts.push_back((uint32_t)drawData->TotalVtxCount);
+		mIndexCounts.push_back((uint32_t)drawData->TotalIdxCount);
+		mInner->RenderUI(drawData);
+	}
+
+private:
+	std::vector<uint32_t> mVertexCounts;
+	std::vector<uint32_t> mIndexCounts;
+};
+
+// Upload sizes, one per frame
+struct Trace
+{
+	const char* name;
+	std::vector<uint32_t> counts;
+};
+
+// Steady, growing, spiky and random traces of frames uploads, then captured repeated to the same length
+std::vector<Trace> MakeTraces(const std::vector<uint32_t>& captured, uint32_t frames);
+
+// The draw data of a few frames of the sample, through a resize so the window contents change
+bool CaptureSampleCounts(uint32_t frames, std::vector<uint32_t>& vertexCounts, std::vector<uint32_t>& indexCounts);
+
+#endif // UPLOADTRACEFIXTURE_H
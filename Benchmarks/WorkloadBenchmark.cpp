@@ -0,0 +1,98 @@
+/********************************************************************************************************
+ **	Name:        WorkloadBenchmark.cpp                                                                 **
+ **	Description: Measures what overlap and batching buy the sample at each ComputeWorkload.hlsl preset **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                          **
+ **	Published:   <insert date>                                                                         **
+ *******************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "ComputeWorkload.h"
+#include "HeadlessRun.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Mean frame time of the sample on the CPU device with the given submission settings
+static double TimeSample(const HeadlessOptions& options, uint32_t frames)
+{
+	CPUGraphicsDevice device;
+	UAVOverlapSampleApp app(&device, options.width, options.height);
+	app.ApplyOptions(options);
+	if (!app.Init())
+	{
+		app.Cleanup();
+		return -1.0;
+	}
+
+	// One untimed frame builds the UI font atlas and fills the pools
+	app.Render(1.0);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t frame = 0; frame < frames; frame++)
+	{
+		app.Render(1.0);
+	}
+	app.FinishFrames();
+	double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	app.Cleanup();
+	return totalMs / frames;
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t timedFrames = 5;
+	uint32_t width = 640;
+	uint32_t height = 360;
+	uint32_t tileSize = 16;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--timed-frames") == 0) timedFrames = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--width") == 0) width = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--height") == 0) height = (uint32_t)atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--tile") == 0) tileSize = (uint32_t)atoi(argv[i + 1]);
+	}
+	if (timedFrames == 0)
+	{
+		timedFrames = 1;
+	}
+
+	// Frame time per workload shape. The speedups are per-tile without overlap over each of the other two submissions.
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = width;
+	options.height = height;
+	options.tileSize = tileSize;
+
+	printf("%ux%u, %ux%u tiles, mean of %u frames\n", width, height, options.tileSize, options.tileSize, timedFrames);
+	printf("%-12s %12s %12s %12s %10s %10s\n", "workload", "per-tile ms", "overlap ms", "batched ms", "overlap x", "batched x");
+	for (uint32_t preset = 0; preset < GetComputeWorkloadPresetCount(); preset++)
+	{
+		options.workload = GetComputeWorkloadPreset(preset);
+
+		options.bUseUAVOverlap = false;
+		options.bUseBatchedDispatch = false;
+		double perTileMs = TimeSample(options, timedFrames);
+		options.bUseUAVOverlap = true;
+		double overlapMs = TimeSample(options, timedFrames);
+		options.bUseUAVOverlap = false;
+		options.bUseBatchedDispatch = true;
+		double batchedMs = TimeSample(options, timedFrames);
+
+		if (perTileMs < 0.0 || overlapMs < 0.0 || batchedMs < 0.0)
+		{
+			printf("%-12s failed to initialize\n", GetComputeWorkloadPresetName(preset));
+			return 1;
+		}
+		printf("%-12s %12.3f %12.3f %12.3f %10.2f %10.2f\n", GetComputeWorkloadPresetName(preset), perTileMs, overlapMs, batchedMs,
+			perTileMs / overlapMs, perTileMs / batchedMs);
+	}
+
+	return 0;
+}
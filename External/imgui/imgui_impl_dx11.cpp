@@ -4,6 +4,9 @@
 // Implemented features:
 //  [X] Renderer: User texture binding. Use 'ID3D11ShaderResourceView*' as ImTextureID. Read the FAQ about ImTextureID!
 //  [X] Renderer: Support for large meshes (64k+ vertices) with 16-bit indices.
+//  [X] Renderer: Vertex/index upload sub-allocated from NO_OVERWRITE ring buffers (see UploadRing.h), discarded only on wrap.
+//  [X] Renderer: Optional owned-pipeline mode without the state backup/restore, skipping redundant binds (see UIPipeline.h).
+//  [X] Renderer: Shader bytecode compiled at build time when IMGUI_IMPL_DX11_PRECOMPILED_SHADERS is defined, D3DCompile() otherwise.
 
 // You can copy and use unmodified imgui_impl_* files in your project. See main.cpp for an example of using this.
 // If you are new to dear imgui, read examples/README.txt and read the documentation at the top of imgui.cpp
@@ -27,6 +30,8 @@
 
 #include "imgui.h"
 #include "imgui_impl_dx11.h"
+#include "UIPipeline.h"
+#include "UploadRing.h"
 
 // DirectX
 #include <stdio.h>
@@ -36,6 +41,12 @@
 #pragma comment(lib, "d3dcompiler") // Automatically link with d3dcompiler.lib as we are using D3DCompile() below.
 #endif
 
+// Generated by fxc /Fh from Shaders/ImGuiVertexShader.hlsl and Shaders/ImGuiPixelShader.hlsl, as g_ImGuiVertexShader and g_ImGuiPixelShader
+#ifdef IMGUI_IMPL_DX11_PRECOMPILED_SHADERS
+#include "ImGuiVertexShader.h"
+#include "ImGuiPixelShader.h"
+#endif
+
 // DirectX data
 static ID3D11Device*            g_pd3dDevice = NULL;
 static ID3D11DeviceContext*     g_pd3dDeviceContext = NULL;
@@ -53,46 +64,171 @@ static ID3D11ShaderResourceView*g_pFontTextureView = NULL;
 static ID3D11RasterizerState*   g_pRasterizerState = NULL;
 static ID3D11BlendState*        g_pBlendState = NULL;
 static ID3D11DepthStencilState* g_pDepthStencilState = NULL;
-static int                      g_VertexBufferSize = 5000, g_IndexBufferSize = 10000;
+static UploadRing               g_VertexRing(sizeof(ImDrawVert), 5000), g_IndexRing(sizeof(ImDrawIdx), 10000);
+static UIPipelineRenderer       g_Pipeline;
+static bool                     g_bPrecompiledShaders = false;
 
 struct VERTEX_CONSTANT_BUFFER
 {
     float   mvp[4][4];
 };
 
-static void ImGui_ImplDX11_SetupRenderState(ImDrawData* draw_data, ID3D11DeviceContext* ctx)
+// The pipeline calls of UIPipelineRenderer on the immediate context. The state round-trip saves and restores every slot
+// the renderer binds; the Release() calls of the backup are not counted as context calls.
+class ImGui_ImplDX11_PipelineContext : public UIPipelineContext
 {
-    // Setup viewport
-    D3D11_VIEWPORT vp;
-    memset(&vp, 0, sizeof(D3D11_VIEWPORT));
-    vp.Width = draw_data->DisplaySize.x;
-    vp.Height = draw_data->DisplaySize.y;
-    vp.MinDepth = 0.0f;
-    vp.MaxDepth = 1.0f;
-    vp.TopLeftX = vp.TopLeftY = 0;
-    ctx->RSSetViewports(1, &vp);
-
-    // Setup shader and vertex buffers
-    unsigned int stride = sizeof(ImDrawVert);
-    unsigned int offset = 0;
-    ctx->IASetInputLayout(g_pInputLayout);
-    ctx->IASetVertexBuffers(0, 1, &g_pVB, &stride, &offset);
-    ctx->IASetIndexBuffer(g_pIB, sizeof(ImDrawIdx) == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
-    ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    ctx->VSSetShader(g_pVertexShader, NULL, 0);
-    ctx->VSSetConstantBuffers(0, 1, &g_pVertexConstantBuffer);
-    ctx->PSSetShader(g_pPixelShader, NULL, 0);
-    ctx->PSSetSamplers(0, 1, &g_pFontSampler);
-    ctx->GSSetShader(NULL, NULL, 0);
-    ctx->HSSetShader(NULL, NULL, 0); // In theory we should backup and restore this as well.. very infrequently used..
-    ctx->DSSetShader(NULL, NULL, 0); // In theory we should backup and restore this as well.. very infrequently used..
-    ctx->CSSetShader(NULL, NULL, 0); // In theory we should backup and restore this as well.. very infrequently used..
-
-    // Setup blend state
-    const float blend_factor[4] = { 0.f, 0.f, 0.f, 0.f };
-    ctx->OMSetBlendState(g_pBlendState, blend_factor, 0xffffffff);
-    ctx->OMSetDepthStencilState(g_pDepthStencilState, 0);
-    ctx->RSSetState(g_pRasterizerState);
+public:
+    explicit ImGui_ImplDX11_PipelineContext(ID3D11DeviceContext* ctx) : m_Ctx(ctx) {}
+
+    virtual void Bind(UIPipelineSlot slot, const UIBinding& binding)
+    {
+        ID3D11DeviceContext* ctx = m_Ctx;
+        void* object = const_cast<void*>(binding.object);
+        switch (slot)
+        {
+        case UI_SLOT_VIEWPORT:
+        {
+            D3D11_VIEWPORT vp;
+            memset(&vp, 0, sizeof(D3D11_VIEWPORT));
+            vp.Width = (float)binding.rect[2];
+            vp.Height = (float)binding.rect[3];
+            vp.MinDepth = 0.0f;
+            vp.MaxDepth = 1.0f;
+            vp.TopLeftX = vp.TopLeftY = 0;
+            ctx->RSSetViewports(1, &vp);
+            break;
+        }
+        case UI_SLOT_INPUT_LAYOUT: ctx->IASetInputLayout((ID3D11InputLayout*)object); break;
+        case UI_SLOT_VERTEX_BUFFER:
+        {
+            ID3D11Buffer* buffer = (ID3D11Buffer*)object;
+            unsigned int stride = sizeof(ImDrawVert);
+            unsigned int offset = 0;
+            ctx->IASetVertexBuffers(0, 1, &buffer, &stride, &offset);
+            break;
+        }
+        case UI_SLOT_INDEX_BUFFER: ctx->IASetIndexBuffer((ID3D11Buffer*)object, sizeof(ImDrawIdx) == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0); break;
+        case UI_SLOT_TOPOLOGY: ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST); break;
+        case UI_SLOT_VERTEX_SHADER: ctx->VSSetShader((ID3D11VertexShader*)object, NULL, 0); break;
+        case UI_SLOT_VS_CONSTANT_BUFFER: { ID3D11Buffer* buffer = (ID3D11Buffer*)object; ctx->VSSetConstantBuffers(0, 1, &buffer); break; }
+        case UI_SLOT_PIXEL_SHADER: ctx->PSSetShader((ID3D11PixelShader*)object, NULL, 0); break;
+        case UI_SLOT_PS_SAMPLER: { ID3D11SamplerState* sampler = (ID3D11SamplerState*)object; ctx->PSSetSamplers(0, 1, &sampler); break; }
+        case UI_SLOT_GEOMETRY_SHADER: ctx->GSSetShader(NULL, NULL, 0); break;
+        case UI_SLOT_HULL_SHADER: ctx->HSSetShader(NULL, NULL, 0); break; // In theory we should backup and restore this as well.. very infrequently used..
+        case UI_SLOT_DOMAIN_SHADER: ctx->DSSetShader(NULL, NULL, 0); break; // In theory we should backup and restore this as well.. very infrequently used..
+        case UI_SLOT_COMPUTE_SHADER: ctx->CSSetShader(NULL, NULL, 0); break; // In theory we should backup and restore this as well.. very infrequently used..
+        case UI_SLOT_BLEND_STATE:
+        {
+            const float blend_factor[4] = { 0.f, 0.f, 0.f, 0.f };
+            ctx->OMSetBlendState((ID3D11BlendState*)object, blend_factor, 0xffffffff);
+            break;
+        }
+        case UI_SLOT_DEPTH_STENCIL_STATE: ctx->OMSetDepthStencilState((ID3D11DepthStencilState*)object, 0); break;
+        case UI_SLOT_RASTERIZER_STATE: ctx->RSSetState((ID3D11RasterizerState*)object); break;
+        case UI_SLOT_SCISSOR_RECT:
+        {
+            const D3D11_RECT r = { (LONG)binding.rect[0], (LONG)binding.rect[1], (LONG)binding.rect[2], (LONG)binding.rect[3] };
+            ctx->RSSetScissorRects(1, &r);
+            break;
+        }
+        case UI_SLOT_PS_TEXTURE: { ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)object; ctx->PSSetShaderResources(0, 1, &texture_srv); break; }
+        default: break;
+        }
+    }
+
+    virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+    {
+        m_Ctx->DrawIndexed(indexCount, startIndex, baseVertex);
+    }
+
+    // Backup DX state that will be modified to restore it afterwards (unfortunately this is very ugly looking and verbose. Close your eyes!)
+    virtual void BackupState()
+    {
+        ID3D11DeviceContext* ctx = m_Ctx;
+        BACKUP_DX11_STATE& old = m_Old;
+        old.ScissorRectsCount = old.ViewportsCount = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+        ctx->RSGetScissorRects(&old.ScissorRectsCount, old.ScissorRects);
+        ctx->RSGetViewports(&old.ViewportsCount, old.Viewports);
+        ctx->RSGetState(&old.RS);
+        ctx->OMGetBlendState(&old.BlendState, old.BlendFactor, &old.SampleMask);
+        ctx->OMGetDepthStencilState(&old.DepthStencilState, &old.StencilRef);
+        ctx->PSGetShaderResources(0, 1, &old.PSShaderResource);
+        ctx->PSGetSamplers(0, 1, &old.PSSampler);
+        old.PSInstancesCount = old.VSInstancesCount = old.GSInstancesCount = 256;
+        ctx->PSGetShader(&old.PS, old.PSInstances, &old.PSInstancesCount);
+        ctx->VSGetShader(&old.VS, old.VSInstances, &old.VSInstancesCount);
+        ctx->VSGetConstantBuffers(0, 1, &old.VSConstantBuffer);
+        ctx->GSGetShader(&old.GS, old.GSInstances, &old.GSInstancesCount);
+
+        ctx->IAGetPrimitiveTopology(&old.PrimitiveTopology);
+        ctx->IAGetIndexBuffer(&old.IndexBuffer, &old.IndexBufferFormat, &old.IndexBufferOffset);
+        ctx->IAGetVertexBuffers(0, 1, &old.VertexBuffer, &old.VertexBufferStride, &old.VertexBufferOffset);
+        ctx->IAGetInputLayout(&old.InputLayout);
+    }
+
+    // Restore modified DX state
+    virtual void RestoreState()
+    {
+        ID3D11DeviceContext* ctx = m_Ctx;
+        BACKUP_DX11_STATE& old = m_Old;
+        ctx->RSSetScissorRects(old.ScissorRectsCount, old.ScissorRects);
+        ctx->RSSetViewports(old.ViewportsCount, old.Viewports);
+        ctx->RSSetState(old.RS); if (old.RS) old.RS->Release();
+        ctx->OMSetBlendState(old.BlendState, old.BlendFactor, old.SampleMask); if (old.BlendState) old.BlendState->Release();
+        ctx->OMSetDepthStencilState(old.DepthStencilState, old.StencilRef); if (old.DepthStencilState) old.DepthStencilState->Release();
+        ctx->PSSetShaderResources(0, 1, &old.PSShaderResource); if (old.PSShaderResource) old.PSShaderResource->Release();
+        ctx->PSSetSamplers(0, 1, &old.PSSampler); if (old.PSSampler) old.PSSampler->Release();
+        ctx->PSSetShader(old.PS, old.PSInstances, old.PSInstancesCount); if (old.PS) old.PS->Release();
+        for (UINT i = 0; i < old.PSInstancesCount; i++) if (old.PSInstances[i]) old.PSInstances[i]->Release();
+        ctx->VSSetShader(old.VS, old.VSInstances, old.VSInstancesCount); if (old.VS) old.VS->Release();
+        ctx->VSSetConstantBuffers(0, 1, &old.VSConstantBuffer); if (old.VSConstantBuffer) old.VSConstantBuffer->Release();
+        ctx->GSSetShader(old.GS, old.GSInstances, old.GSInstancesCount); if (old.GS) old.GS->Release();
+        for (UINT i = 0; i < old.VSInstancesCount; i++) if (old.VSInstances[i]) old.VSInstances[i]->Release();
+        ctx->IASetPrimitiveTopology(old.PrimitiveTopology);
+        ctx->IASetIndexBuffer(old.IndexBuffer, old.IndexBufferFormat, old.IndexBufferOffset); if (old.IndexBuffer) old.IndexBuffer->Release();
+        ctx->IASetVertexBuffers(0, 1, &old.VertexBuffer, &old.VertexBufferStride, &old.VertexBufferOffset); if (old.VertexBuffer) old.VertexBuffer->Release();
+        ctx->IASetInputLayout(old.InputLayout); if (old.InputLayout) old.InputLayout->Release();
+    }
+
+    // 15 Get calls in BackupState() and 15 Set calls in RestoreState()
+    virtual uint32_t GetStateRoundTripCallCount() const { return 30; }
+
+private:
+    struct BACKUP_DX11_STATE
+    {
+        UINT                        ScissorRectsCount, ViewportsCount;
+        D3D11_RECT                  ScissorRects[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+        D3D11_VIEWPORT              Viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+        ID3D11RasterizerState*      RS;
+        ID3D11BlendState*           BlendState;
+        FLOAT                       BlendFactor[4];
+        UINT                        SampleMask;
+        UINT                        StencilRef;
+        ID3D11DepthStencilState*    DepthStencilState;
+        ID3D11ShaderResourceView*   PSShaderResource;
+        ID3D11SamplerState*         PSSampler;
+        ID3D11PixelShader*          PS;
+        ID3D11VertexShader*         VS;
+        ID3D11GeometryShader*       GS;
+        UINT                        PSInstancesCount, VSInstancesCount, GSInstancesCount;
+        ID3D11ClassInstance         *PSInstances[256], *VSInstances[256], *GSInstances[256];   // 256 is max according to PSSetShader documentation
+        D3D11_PRIMITIVE_TOPOLOGY    PrimitiveTopology;
+        ID3D11Buffer*               IndexBuffer, *VertexBuffer, *VSConstantBuffer;
+        UINT                        IndexBufferOffset, VertexBufferStride, VertexBufferOffset;
+        DXGI_FORMAT                 IndexBufferFormat;
+        ID3D11InputLayout*          InputLayout;
+    };
+
+    ID3D11DeviceContext*    m_Ctx;
+    BACKUP_DX11_STATE       m_Old;
+};
+
+// Forgets both ring buffers after a failed frame, so the next one recreates them instead of writing into a buffer that
+// was never created, or with NO_OVERWRITE into one whose wrap was never discarded
+static void ImGui_ImplDX11_InvalidateRings()
+{
+    g_VertexRing.Invalidate();
+    g_IndexRing.Invalidate();
 }
 
 // Render function
@@ -105,43 +241,57 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
 
     ID3D11DeviceContext* ctx = g_pd3dDeviceContext;
 
-    // Create and grow vertex/index buffers if needed
-    if (!g_pVB || g_VertexBufferSize < draw_data->TotalVtxCount)
+    // Sub-allocate this frame's vertices and indices from the rings, creating or growing the buffers if needed
+    UploadRingAllocation vtx_alloc = g_VertexRing.Allocate((unsigned int)draw_data->TotalVtxCount);
+    UploadRingAllocation idx_alloc = g_IndexRing.Allocate((unsigned int)draw_data->TotalIdxCount);
+    if (vtx_alloc.bRecreate)
     {
         if (g_pVB) { g_pVB->Release(); g_pVB = NULL; }
-        g_VertexBufferSize = draw_data->TotalVtxCount + 5000;
         D3D11_BUFFER_DESC desc;
         memset(&desc, 0, sizeof(D3D11_BUFFER_DESC));
         desc.Usage = D3D11_USAGE_DYNAMIC;
-        desc.ByteWidth = g_VertexBufferSize * sizeof(ImDrawVert);
+        desc.ByteWidth = g_VertexRing.GetCapacity() * sizeof(ImDrawVert);
         desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
         desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
         desc.MiscFlags = 0;
         if (g_pd3dDevice->CreateBuffer(&desc, NULL, &g_pVB) < 0)
+        {
+            ImGui_ImplDX11_InvalidateRings();
             return;
+        }
     }
-    if (!g_pIB || g_IndexBufferSize < draw_data->TotalIdxCount)
+    if (idx_alloc.bRecreate)
     {
         if (g_pIB) { g_pIB->Release(); g_pIB = NULL; }
-        g_IndexBufferSize = draw_data->TotalIdxCount + 10000;
         D3D11_BUFFER_DESC desc;
         memset(&desc, 0, sizeof(D3D11_BUFFER_DESC));
         desc.Usage = D3D11_USAGE_DYNAMIC;
-        desc.ByteWidth = g_IndexBufferSize * sizeof(ImDrawIdx);
+        desc.ByteWidth = g_IndexRing.GetCapacity() * sizeof(ImDrawIdx);
         desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
         desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
         if (g_pd3dDevice->CreateBuffer(&desc, NULL, &g_pIB) < 0)
+        {
+            ImGui_ImplDX11_InvalidateRings();
             return;
+        }
     }
 
-    // Upload vertex/index data into a single contiguous GPU buffer
+    // Upload vertex/index data after the previous frames' data. Only a wrap discards the buffer, so the driver does not
+    // have to rename it every frame; NO_OVERWRITE promises not to touch ranges the GPU may still be reading.
     D3D11_MAPPED_SUBRESOURCE vtx_resource, idx_resource;
-    if (ctx->Map(g_pVB, 0, D3D11_MAP_WRITE_DISCARD, 0, &vtx_resource) != S_OK)
+    if (ctx->Map(g_pVB, 0, vtx_alloc.bDiscard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &vtx_resource) != S_OK)
+    {
+        ImGui_ImplDX11_InvalidateRings();
         return;
-    if (ctx->Map(g_pIB, 0, D3D11_MAP_WRITE_DISCARD, 0, &idx_resource) != S_OK)
+    }
+    if (ctx->Map(g_pIB, 0, idx_alloc.bDiscard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &idx_resource) != S_OK)
+    {
+        ctx->Unmap(g_pVB, 0);
+        ImGui_ImplDX11_InvalidateRings();
         return;
-    ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource.pData;
-    ImDrawIdx* idx_dst = (ImDrawIdx*)idx_resource.pData;
+    }
+    ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource.pData + vtx_alloc.offset;
+    ImDrawIdx* idx_dst = (ImDrawIdx*)idx_resource.pData + idx_alloc.offset;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
@@ -175,108 +325,21 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
         ctx->Unmap(g_pVertexConstantBuffer, 0);
     }
 
-    // Backup DX state that will be modified to restore it afterwards (unfortunately this is very ugly looking and verbose. Close your eyes!)
-    struct BACKUP_DX11_STATE
-    {
-        UINT                        ScissorRectsCount, ViewportsCount;
-        D3D11_RECT                  ScissorRects[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
-        D3D11_VIEWPORT              Viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
-        ID3D11RasterizerState*      RS;
-        ID3D11BlendState*           BlendState;
-        FLOAT                       BlendFactor[4];
-        UINT                        SampleMask;
-        UINT                        StencilRef;
-        ID3D11DepthStencilState*    DepthStencilState;
-        ID3D11ShaderResourceView*   PSShaderResource;
-        ID3D11SamplerState*         PSSampler;
-        ID3D11PixelShader*          PS;
-        ID3D11VertexShader*         VS;
-        ID3D11GeometryShader*       GS;
-        UINT                        PSInstancesCount, VSInstancesCount, GSInstancesCount;
-        ID3D11ClassInstance         *PSInstances[256], *VSInstances[256], *GSInstances[256];   // 256 is max according to PSSetShader documentation
-        D3D11_PRIMITIVE_TOPOLOGY    PrimitiveTopology;
-        ID3D11Buffer*               IndexBuffer, *VertexBuffer, *VSConstantBuffer;
-        UINT                        IndexBufferOffset, VertexBufferStride, VertexBufferOffset;
-        DXGI_FORMAT                 IndexBufferFormat;
-        ID3D11InputLayout*          InputLayout;
-    };
-    BACKUP_DX11_STATE old;
-    old.ScissorRectsCount = old.ViewportsCount = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
-    ctx->RSGetScissorRects(&old.ScissorRectsCount, old.ScissorRects);
-    ctx->RSGetViewports(&old.ViewportsCount, old.Viewports);
-    ctx->RSGetState(&old.RS);
-    ctx->OMGetBlendState(&old.BlendState, old.BlendFactor, &old.SampleMask);
-    ctx->OMGetDepthStencilState(&old.DepthStencilState, &old.StencilRef);
-    ctx->PSGetShaderResources(0, 1, &old.PSShaderResource);
-    ctx->PSGetSamplers(0, 1, &old.PSSampler);
-    old.PSInstancesCount = old.VSInstancesCount = old.GSInstancesCount = 256;
-    ctx->PSGetShader(&old.PS, old.PSInstances, &old.PSInstancesCount);
-    ctx->VSGetShader(&old.VS, old.VSInstances, &old.VSInstancesCount);
-    ctx->VSGetConstantBuffers(0, 1, &old.VSConstantBuffer);
-    ctx->GSGetShader(&old.GS, old.GSInstances, &old.GSInstancesCount);
-
-    ctx->IAGetPrimitiveTopology(&old.PrimitiveTopology);
-    ctx->IAGetIndexBuffer(&old.IndexBuffer, &old.IndexBufferFormat, &old.IndexBufferOffset);
-    ctx->IAGetVertexBuffers(0, 1, &old.VertexBuffer, &old.VertexBufferStride, &old.VertexBufferOffset);
-    ctx->IAGetInputLayout(&old.InputLayout);
-
-    // Setup desired DX state
-    ImGui_ImplDX11_SetupRenderState(draw_data, ctx);
-
-    // Render command lists
-    // (Because we merged all buffers into a single one, we maintain our own offset into them)
-    int global_idx_offset = 0;
-    int global_vtx_offset = 0;
-    ImVec2 clip_off = draw_data->DisplayPos;
-    for (int n = 0; n < draw_data->CmdListsCount; n++)
-    {
-        const ImDrawList* cmd_list = draw_data->CmdLists[n];
-        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
-        {
-            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
-            if (pcmd->UserCallback != NULL)
-            {
-                // User callback, registered via ImDrawList::AddCallback()
-                // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
-                if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
-                    ImGui_ImplDX11_SetupRenderState(draw_data, ctx);
-                else
-                    pcmd->UserCallback(cmd_list, pcmd);
-            }
-            else
-            {
-                // Apply scissor/clipping rectangle
-                const D3D11_RECT r = { (LONG)(pcmd->ClipRect.x - clip_off.x), (LONG)(pcmd->ClipRect.y - clip_off.y), (LONG)(pcmd->ClipRect.z - clip_off.x), (LONG)(pcmd->ClipRect.w - clip_off.y) };
-                ctx->RSSetScissorRects(1, &r);
-
-                // Bind texture, Draw
-                ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)pcmd->TextureId;
-                ctx->PSSetShaderResources(0, 1, &texture_srv);
-                ctx->DrawIndexed(pcmd->ElemCount, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset);
-            }
-        }
-        global_idx_offset += cmd_list->IdxBuffer.Size;
-        global_vtx_offset += cmd_list->VtxBuffer.Size;
-    }
-
-    // Restore modified DX state
-    ctx->RSSetScissorRects(old.ScissorRectsCount, old.ScissorRects);
-    ctx->RSSetViewports(old.ViewportsCount, old.Viewports);
-    ctx->RSSetState(old.RS); if (old.RS) old.RS->Release();
-    ctx->OMSetBlendState(old.BlendState, old.BlendFactor, old.SampleMask); if (old.BlendState) old.BlendState->Release();
-    ctx->OMSetDepthStencilState(old.DepthStencilState, old.StencilRef); if (old.DepthStencilState) old.DepthStencilState->Release();
-    ctx->PSSetShaderResources(0, 1, &old.PSShaderResource); if (old.PSShaderResource) old.PSShaderResource->Release();
-    ctx->PSSetSamplers(0, 1, &old.PSSampler); if (old.PSSampler) old.PSSampler->Release();
-    ctx->PSSetShader(old.PS, old.PSInstances, old.PSInstancesCount); if (old.PS) old.PS->Release();
-    for (UINT i = 0; i < old.PSInstancesCount; i++) if (old.PSInstances[i]) old.PSInstances[i]->Release();
-    ctx->VSSetShader(old.VS, old.VSInstances, old.VSInstancesCount); if (old.VS) old.VS->Release();
-    ctx->VSSetConstantBuffers(0, 1, &old.VSConstantBuffer); if (old.VSConstantBuffer) old.VSConstantBuffer->Release();
-    ctx->GSSetShader(old.GS, old.GSInstances, old.GSInstancesCount); if (old.GS) old.GS->Release();
-    for (UINT i = 0; i < old.VSInstancesCount; i++) if (old.VSInstances[i]) old.VSInstances[i]->Release();
-    ctx->IASetPrimitiveTopology(old.PrimitiveTopology);
-    ctx->IASetIndexBuffer(old.IndexBuffer, old.IndexBufferFormat, old.IndexBufferOffset); if (old.IndexBuffer) old.IndexBuffer->Release();
-    ctx->IASetVertexBuffers(0, 1, &old.VertexBuffer, &old.VertexBufferStride, &old.VertexBufferOffset); if (old.VertexBuffer) old.VertexBuffer->Release();
-    ctx->IASetInputLayout(old.InputLayout); if (old.InputLayout) old.InputLayout->Release();
+    // Bind our state and draw the command lists, saving and restoring the previous state unless we own the pipeline
+    const void* objects[UI_SLOT_COUNT] = {};
+    objects[UI_SLOT_INPUT_LAYOUT] = g_pInputLayout;
+    objects[UI_SLOT_VERTEX_BUFFER] = g_pVB;
+    objects[UI_SLOT_INDEX_BUFFER] = g_pIB;
+    objects[UI_SLOT_VERTEX_SHADER] = g_pVertexShader;
+    objects[UI_SLOT_VS_CONSTANT_BUFFER] = g_pVertexConstantBuffer;
+    objects[UI_SLOT_PIXEL_SHADER] = g_pPixelShader;
+    objects[UI_SLOT_PS_SAMPLER] = g_pFontSampler;
+    objects[UI_SLOT_BLEND_STATE] = g_pBlendState;
+    objects[UI_SLOT_DEPTH_STENCIL_STATE] = g_pDepthStencilState;
+    objects[UI_SLOT_RASTERIZER_STATE] = g_pRasterizerState;
+
+    ImGui_ImplDX11_PipelineContext pipeline_ctx(ctx);
+    g_Pipeline.Render(draw_data, objects, vtx_alloc.offset, idx_alloc.offset, pipeline_ctx);
 }
 
 static void ImGui_ImplDX11_CreateFontsTexture()
@@ -350,6 +413,23 @@ bool    ImGui_ImplDX11_CreateDeviceObjects()
     //  1) compile once, save the compiled shader blobs into a file or source code and pass them to CreateVertexShader()/CreatePixelShader() [preferred solution]
     //  2) use code to detect any version of the DLL and grab a pointer to D3DCompile from the DLL.
     // See https://github.com/ocornut/imgui/pull/638 for sources and details.
+    // The build does 1) with IMGUI_IMPL_DX11_PRECOMPILED_SHADERS; D3DCompile() remains the fallback, without it or if the device rejects the bytecode.
+    g_bPrecompiledShaders = false;
+    const void* vs_code = NULL;
+    size_t vs_code_size = 0;
+#ifdef IMGUI_IMPL_DX11_PRECOMPILED_SHADERS
+    if (g_pd3dDevice->CreateVertexShader(g_ImGuiVertexShader, sizeof(g_ImGuiVertexShader), NULL, &g_pVertexShader) == S_OK &&
+        g_pd3dDevice->CreatePixelShader(g_ImGuiPixelShader, sizeof(g_ImGuiPixelShader), NULL, &g_pPixelShader) == S_OK)
+    {
+        vs_code = g_ImGuiVertexShader;
+        vs_code_size = sizeof(g_ImGuiVertexShader);
+        g_bPrecompiledShaders = true;
+    }
+    else
+    {
+        if (g_pVertexShader) { g_pVertexShader->Release(); g_pVertexShader = NULL; }
+    }
+#endif
 
     // Create the vertex shader
     {
@@ -381,11 +461,16 @@ bool    ImGui_ImplDX11_CreateDeviceObjects()
             return output;\
             }";
 
-        D3DCompile(vertexShader, strlen(vertexShader), NULL, NULL, NULL, "main", "vs_4_0", 0, 0, &g_pVertexShaderBlob, NULL);
-        if (g_pVertexShaderBlob == NULL) // NB: Pass ID3D10Blob* pErrorBlob to D3DCompile() to get error showing in (const char*)pErrorBlob->GetBufferPointer(). Make sure to Release() the blob!
-            return false;
-        if (g_pd3dDevice->CreateVertexShader((DWORD*)g_pVertexShaderBlob->GetBufferPointer(), g_pVertexShaderBlob->GetBufferSize(), NULL, &g_pVertexShader) != S_OK)
-            return false;
+        if (!g_bPrecompiledShaders)
+        {
+            D3DCompile(vertexShader, strlen(vertexShader), NULL, NULL, NULL, "main", "vs_4_0", 0, 0, &g_pVertexShaderBlob, NULL);
+            if (g_pVertexShaderBlob == NULL) // NB: Pass ID3D10Blob* pErrorBlob to D3DCompile() to get error showing in (const char*)pErrorBlob->GetBufferPointer(). Make sure to Release() the blob!
+                return false;
+            if (g_pd3dDevice->CreateVertexShader((DWORD*)g_pVertexShaderBlob->GetBufferPointer(), g_pVertexShaderBlob->GetBufferSize(), NULL, &g_pVertexShader) != S_OK)
+                return false;
+            vs_code = g_pVertexShaderBlob->GetBufferPointer();
+            vs_code_size = g_pVertexShaderBlob->GetBufferSize();
+        }
 
         // Create the input layout
         D3D11_INPUT_ELEMENT_DESC local_layout[] =
@@ -394,7 +479,7 @@ bool    ImGui_ImplDX11_CreateDeviceObjects()
             { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,   0, (size_t)(&((ImDrawVert*)0)->uv),  D3D11_INPUT_PER_VERTEX_DATA, 0 },
             { "COLOR",    0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, (size_t)(&((ImDrawVert*)0)->col), D3D11_INPUT_PER_VERTEX_DATA, 0 },
         };
-        if (g_pd3dDevice->CreateInputLayout(local_layout, 3, g_pVertexShaderBlob->GetBufferPointer(), g_pVertexShaderBlob->GetBufferSize(), &g_pInputLayout) != S_OK)
+        if (g_pd3dDevice->CreateInputLayout(local_layout, 3, vs_code, vs_code_size, &g_pInputLayout) != S_OK)
             return false;
 
         // Create the constant buffer
@@ -427,11 +512,14 @@ bool    ImGui_ImplDX11_CreateDeviceObjects()
             return out_col; \
             }";
 
-        D3DCompile(pixelShader, strlen(pixelShader), NULL, NULL, NULL, "main", "ps_4_0", 0, 0, &g_pPixelShaderBlob, NULL);
-        if (g_pPixelShaderBlob == NULL)  // NB: Pass ID3D10Blob* pErrorBlob to D3DCompile() to get error showing in (const char*)pErrorBlob->GetBufferPointer(). Make sure to Release() the blob!
-            return false;
-        if (g_pd3dDevice->CreatePixelShader((DWORD*)g_pPixelShaderBlob->GetBufferPointer(), g_pPixelShaderBlob->GetBufferSize(), NULL, &g_pPixelShader) != S_OK)
-            return false;
+        if (!g_bPrecompiledShaders)
+        {
+            D3DCompile(pixelShader, strlen(pixelShader), NULL, NULL, NULL, "main", "ps_4_0", 0, 0, &g_pPixelShaderBlob, NULL);
+            if (g_pPixelShaderBlob == NULL)  // NB: Pass ID3D10Blob* pErrorBlob to D3DCompile() to get error showing in (const char*)pErrorBlob->GetBufferPointer(). Make sure to Release() the blob!
+                return false;
+            if (g_pd3dDevice->CreatePixelShader((DWORD*)g_pPixelShaderBlob->GetBufferPointer(), g_pPixelShaderBlob->GetBufferSize(), NULL, &g_pPixelShader) != S_OK)
+                return false;
+        }
     }
 
     // Create the blending setup
@@ -487,8 +575,9 @@ void    ImGui_ImplDX11_InvalidateDeviceObjects()
 
     if (g_pFontSampler) { g_pFontSampler->Release(); g_pFontSampler = NULL; }
     if (g_pFontTextureView) { g_pFontTextureView->Release(); g_pFontTextureView = NULL; ImGui::GetIO().Fonts->TexID = NULL; } // We copied g_pFontTextureView to io.Fonts->TexID so let's clear that as well.
-    if (g_pIB) { g_pIB->Release(); g_pIB = NULL; }
-    if (g_pVB) { g_pVB->Release(); g_pVB = NULL; }
+    g_Pipeline.Invalidate();
+    if (g_pIB) { g_pIB->Release(); g_pIB = NULL; g_IndexRing.Invalidate(); }
+    if (g_pVB) { g_pVB->Release(); g_pVB = NULL; g_VertexRing.Invalidate(); }
 
     if (g_pBlendState) { g_pBlendState->Release(); g_pBlendState = NULL; }
     if (g_pDepthStencilState) { g_pDepthStencilState->Release(); g_pDepthStencilState = NULL; }
@@ -542,3 +631,32 @@ void ImGui_ImplDX11_NewFrame()
     if (!g_pFontSampler)
         ImGui_ImplDX11_CreateDeviceObjects();
 }
+
+void ImGui_ImplDX11_GetUploadStats(UploadRingStats* vertex_stats, UploadRingStats* index_stats)
+{
+    if (vertex_stats)
+        *vertex_stats = g_VertexRing.GetStats();
+    if (index_stats)
+        *index_stats = g_IndexRing.GetStats();
+}
+
+bool ImGui_ImplDX11_UsesPrecompiledShaders()
+{
+    return g_bPrecompiledShaders;
+}
+
+void ImGui_ImplDX11_SetOwnedPipeline(bool owned)
+{
+    g_Pipeline.SetOwnedPipeline(owned);
+}
+
+void ImGui_ImplDX11_InvalidatePipelineState(unsigned int slot_mask)
+{
+    g_Pipeline.Invalidate(slot_mask);
+}
+
+void ImGui_ImplDX11_GetPipelineCounters(UIPipelineCounters* counters)
+{
+    if (counters)
+        *counters = g_Pipeline.GetLastCounters();
+}
@@ -13,6 +13,8 @@
 
 struct ID3D11Device;
 struct ID3D11DeviceContext;
+struct UploadRingStats;
+struct UIPipelineCounters;
 
 IMGUI_IMPL_API bool     ImGui_ImplDX11_Init(ID3D11Device* device, ID3D11DeviceContext* device_context);
 IMGUI_IMPL_API void     ImGui_ImplDX11_Shutdown();
@@ -22,3 +24,17 @@ IMGUI_IMPL_API void     ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data);
 // Use if you want to reset your rendering device without losing ImGui state.
 IMGUI_IMPL_API void     ImGui_ImplDX11_InvalidateDeviceObjects();
 IMGUI_IMPL_API bool     ImGui_ImplDX11_CreateDeviceObjects();
+
+// Vertex and index upload counters: buffer recreations, discards on wrap and bytes copied, accumulated across Init/Shutdown.
+IMGUI_IMPL_API void     ImGui_ImplDX11_GetUploadStats(UploadRingStats* vertex_stats, UploadRingStats* index_stats);
+
+// Whether the device objects were last created from the bytecode compiled into the build (IMGUI_IMPL_DX11_PRECOMPILED_SHADERS)
+// rather than with D3DCompile() at runtime.
+IMGUI_IMPL_API bool     ImGui_ImplDX11_UsesPrecompiledShaders();
+
+// Owned pipeline: the caller draws the overlay last and does not need its state back, so RenderDrawData skips the
+// state backup/restore and drops binds of what is still bound from the previous frame. The caller must report every
+// slot it binds in between with InvalidatePipelineState(), as a mask of UI_SLOT_BIT(UIPipelineSlot).
+IMGUI_IMPL_API void     ImGui_ImplDX11_SetOwnedPipeline(bool owned);
+IMGUI_IMPL_API void     ImGui_ImplDX11_InvalidatePipelineState(unsigned int slot_mask);
+IMGUI_IMPL_API void     ImGui_ImplDX11_GetPipelineCounters(UIPipelineCounters* counters);
@@ -0,0 +1,95 @@
+/*****************************************************************************************************
+ **	Name:        BenchmarkRunner.h                                                                  **
+ **	Description: Scripted A/B benchmark: runs the sample over a matrix of overlap, tile size,       **
+ **              resolution and submission mode and reports frame time statistics per configuration **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                       **
+ **	Published:   <insert date>                                                                      **
+ ****************************************************************************************************/
+
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ComputeWorkload.h"
+#include "GraphicsDevice.h"
+
+// How a configuration submits the compute pass
+enum BenchmarkDispatchMode
+{
+	BENCH_DISPATCH_TILES,                  // One dispatch per tile
+	BENCH_DISPATCH_BATCHED,                // One dispatch per frame
+	BENCH_DISPATCH_INDIRECT                // One DispatchIndirect over the tile list per frame
+};
+
+// Every combination of these values is one configuration. Configurations run back to back, each on a freshly
+// created device, so no state carries over from one to the next.
+struct BenchmarkMatrix
+{
+	bool bEnabled;                         // --bench
+	std::vector<bool> overlap;             // --bench-overlap off,on
+	std::vector<uint32_t> tileSizes;       // --bench-tiles 8,16,32
+	std::vector<uint32_t> widths;          // --bench-resolutions 1280x720,1920x1080
+	std::vector<uint32_t> heights;
+	std::vector<BenchmarkDispatchMode> dispatchModes; // --bench-dispatch tiles,batched,indirect
+	std::vector<uint32_t> framesInFlight;  // --bench-frames-in-flight 1,2,3
+	std::vector<ComputeWorkload> workloads; // --bench-workloads none,alu,alu=64+reduce, presets or ParseComputeWorkload() forms
+	uint32_t warmupFrames;                 // --bench-warmup N
+	uint32_t measuredFrames;               // --bench-frames N
+	std::string reportPath;                // --bench-report file.json|file.csv; stdout gets a table either way
+};
+
+// Frame time statistics of one configuration. The confidence interval is the two-sided 95% Student-t
+// interval of the mean, treating frames as independent samples.
+struct BenchmarkResult
+{
+	bool bOverlap;
+	bool bOverlapActive;                   // Overlap was requested and the device supports it
+	uint32_t tileSize;
+	uint32_t width;
+	uint32_t height;
+	bool bBatched;
+	bool bIndirect;
+	uint32_t framesInFlight;
+	ComputeWorkload workload;
+	uint32_t dispatchCount;                // Per frame
+	uint32_t frameCount;
+	double meanMs;
+	double stddevMs;
+	double ci95LowMs;
+	double ci95HighMs;
+	double minMs;
+	double maxMs;
+	double p50Ms;
+	double p99Ms;
+	double computeMs;                      // Device timestamps, mean of the last resolved frames
+	double compositeMs;
+	double throughputFps;                  // Frame pacing over the measured frames: finished frames per second,
+	double latencyMeanMs;                  // and CPU frame start to device completion
+	double latencyP95Ms;
+	bool bFailed;                          // The device or the app failed to initialize
+};
+
+// Pulls the --bench* options out of args, leaving everything else for ParseHeadlessOptions().
+// Unset axes default to overlap off,on; tile 16; 1280x720; per-tile dispatch; one frame in flight; no workload; 30 warm-up
+// and 300 measured frames.
+// Returns false if a --bench* value is malformed.
+bool ExtractBenchmarkOptions(std::vector<std::string>& args, BenchmarkMatrix& matrix);
+
+typedef std::function<std::unique_ptr<GraphicsDevice>()> GraphicsDeviceFactory;
+
+// Runs every configuration, printing one line per configuration as it finishes, then writes the report if one
+// was asked for. Returns false if any configuration failed or the report could not be written.
+bool RunBenchmarkMatrix(const BenchmarkMatrix& matrix, const GraphicsDeviceFactory& createDevice, FILE* log, std::vector<BenchmarkResult>& results);
+
+// Mean, sample standard deviation and 95% confidence interval of the mean
+void ComputeSampleStatistics(const std::vector<double>& samples, double& mean, double& stddev, double& ci95Low, double& ci95High);
+
+bool WriteBenchmarkReport(const char* path, const char* deviceName, const std::vector<BenchmarkResult>& results);
+
+#endif // BENCHMARKRUNNER_H
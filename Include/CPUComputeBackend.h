@@ -0,0 +1,105 @@
+/************************************************************************************************
+ **	Name:        CPUComputeBackend.h                                                           **
+ **	Description: CPU reference backend for Shaders/ComputeShader.hlsl - runs the CS entrypoint **
+ **              over an in-memory RGBA8 texture standing in for the sample UAV                **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                  **
+ **	Published:   <insert date>                                                                 **
+ ***********************************************************************************************/
+
+#ifndef CPUCOMPUTEBACKEND_H
+#define CPUCOMPUTEBACKEND_H
+
+#include <cstdint>
+#include <vector>
+
+#include "GradientKernels.h"
+#include "ThreadPool.h"
+#include "TileGrid.h"
+
+struct CPUWorkloadBinding;
+
+// Default [numthreads(TILE_SIZE, TILE_SIZE, 1)] of the CS entrypoint; 8 and 32 are also compiled
+#define CS_THREAD_GROUP_SIZE 16
+
+// Mirrors TILE_LIST_ROW_GROUPS: group (x, y) of a tile-list dispatch runs list entry y * CS_TILE_LIST_ROW_GROUPS + x
+#define CS_TILE_LIST_ROW_GROUPS 1024
+
+// Tile list entries pack the tile's x in the low 16 bits and its y in the high 16
+inline uint32_t PackTileListEntry(uint32_t tileX, uint32_t tileY) { return (tileX & 0xFFFF) | (tileY << 16); }
+
+// Packs a float4 into DXGI_FORMAT_R8G8B8A8_UNORM using the D3D conversion rules:
+// saturate, scale by 255 and round to nearest. NaN converts to 0.
+uint32_t PackUNorm4x8(float r, float g, float b, float a);
+
+// In-memory stand-in for the R8G8B8A8_UNORM texture the sample binds as a UAV
+struct CPUTexture2D
+{
+	uint32_t width;
+	uint32_t height;
+	std::vector<uint32_t> texels; // Packed RGBA8, red in the low byte
+
+	CPUTexture2D() : width(0), height(0) {}
+	CPUTexture2D(uint32_t w, uint32_t h) : width(w), height(h), texels((size_t)w * h, 0) {}
+
+	void Clear(uint32_t value) { texels.assign((size_t)width * height, value); }
+
+	// Like a UAV store, writes outside the texture are discarded
+	void Store(uint32_t x, uint32_t y, uint32_t value)
+	{
+		if (x < width && y < height)
+		{
+			texels[(size_t)y * width + x] = value;
+		}
+	}
+};
+
+class CPUComputeBackend
+{
+public:
+	// Mirrors cbuffer cbuff : register(b0) in Shaders/ComputeShader.hlsl
+	struct ConstantBuffer
+	{
+		uint32_t dispatchX;
+		uint32_t dispatchY;
+		uint32_t windowWidth;
+		uint32_t windowHeight;
+	};
+
+	// Fills one constant buffer per tile of the grid, in the grid's dispatch order
+	static void BuildTileConstants(const TileGrid& grid, std::vector<ConstantBuffer>& tiles);
+
+	explicit CPUComputeBackend(ThreadPool& threadPool, uint32_t tileSize = CS_THREAD_GROUP_SIZE) : mThreadPool(threadPool), mTileSize(tileSize) {}
+
+	// Executes every thread of one tileSize x tileSize CS thread group (SV_GroupID = groupX, groupY) against the
+	// bound UAV. Threads that fall outside windowWidth x windowHeight exit early, as in the shader.
+	static void RunThreadGroup(const ConstantBuffer& cb, uint32_t tileSize, uint32_t groupX, uint32_t groupY, CPUTexture2D& uav);
+
+	// Thread group (groupX, groupY) of the tile-list variant of the CS entrypoint, reading its tile from tiles[tileCount].
+	// With a workload it runs the tile-list variant of ComputeWorkload.hlsl instead.
+	static void RunTileListGroup(const ConstantBuffer& cb, uint32_t tileSize, const uint32_t* tiles, uint32_t tileCount, uint32_t groupX, uint32_t groupY, CPUTexture2D& uav,
+		const CPUWorkloadBinding* workload = nullptr);
+
+	// Equivalent of CSSetConstantBuffers(cb) + Dispatch(groupsX, groupsY, 1); thread groups are spread across the pool
+	void Dispatch(const ConstantBuffer& cb, uint32_t groupsX, uint32_t groupsY, CPUTexture2D& uav);
+
+	// Equivalent of tileCount back-to-back CSSetConstantBuffers(tiles[i]) + Dispatch(1, 1, 1) pairs.
+	// Each dispatch is one thread group; the groups are spread across the thread pool.
+	void DispatchTiles(const ConstantBuffer* tiles, uint32_t tileCount, CPUTexture2D& uav);
+
+	ThreadPool& GetThreadPool() { return mThreadPool; }
+
+	// Selects the row kernel every RunThreadGroup uses, process-wide. Defaults to GetBestKernelISA();
+	// returns false and keeps the current kernel if the ISA is not supported here.
+	static bool SetKernelISA(KernelISA isa);
+	static KernelISA GetKernelISA();
+
+	// Selects which CS variant (TILE_SIZE 8, 16 or 32) subsequent dispatches run
+	void SetTileSize(uint32_t tileSize) { mTileSize = tileSize; }
+	uint32_t GetTileSize() const { return mTileSize; }
+
+private:
+	ThreadPool& mThreadPool;
+	uint32_t mTileSize;
+};
+
+#endif // CPUCOMPUTEBACKEND_H
@@ -0,0 +1,275 @@
+/********************************************************************************************
+ **	Name:        CPUGraphicsDevice.h                                                       **
+ **	Description: CPU reference implementation of GraphicsDevice. Compute work runs through **
+ **              the DispatchScheduler, the composite pass is a software fullscreen blit   **
+ **              and the ImGui overlay goes through the UIRasterizer                       **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                              **
+ **	Published:   <insert date>                                                             **
+ *******************************************************************************************/
+
+#ifndef CPUGRAPHICSDEVICE_H
+#define CPUGRAPHICSDEVICE_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+#include "GraphicsDevice.h"
+#include "DeviceTimeline.h"
+#include "DispatchScheduler.h"
+#include "FrameTimeHistogram.h"
+#include "StartupTimer.h"
+#include "UIRasterizer.h"
+
+struct INTCExtensionContext;
+
+// With more than one frame in flight, everything the GPU would execute (dispatches, overlap brackets, clears, draws,
+// timestamps and the end of frame) is recorded on the calling thread, handed to a DeviceTimeline at Present() and run
+// there while the caller moves on to the next frame. With one frame in flight it all runs inline on the calling thread.
+class CPUGraphicsDevice : public GraphicsDevice
+{
+public:
+	// A thread count of 0 creates one worker per hardware thread. Timestamp queries read clock, in nanoseconds.
+	explicit CPUGraphicsDevice(uint32_t threadCount = 0, FrameClockFn clock = SteadyClockNanoseconds);
+	virtual ~CPUGraphicsDevice();
+
+	virtual bool Init(uint32_t width, uint32_t height);
+	virtual void Cleanup();
+	virtual void SetStartupTimer(StartupTimer* timer) { mStartupTimer = timer; }
+
+	virtual const char* GetName() const { return "cpu"; }
+
+	// Overlap brackets end up in the DispatchScheduler. Builds with UAVOVERLAP_INTC_STUB route them through the
+	// stub extension runtime first, so support then depends on extension negotiation succeeding, as on D3D11.
+	virtual bool IsUAVOverlapSupported() const { return bUAVOverlapSupported; }
+
+	virtual GfxTexture CreateTexture2D(uint32_t width, uint32_t height, uint32_t bindFlags);
+	virtual GfxView CreateShaderResourceView(GfxTexture texture);
+	virtual GfxView CreateUnorderedAccessView(GfxTexture texture);
+	virtual GfxView CreateRenderTargetView(GfxTexture texture);
+	virtual GfxBuffer CreateConstantBuffer(const void* data, uint32_t byteWidth);
+	virtual GfxBuffer CreateVertexBuffer(const void* data, uint32_t byteWidth);
+	virtual GfxBuffer CreateStructuredBuffer(const void* data, uint32_t stride, uint32_t count);
+	virtual GfxBuffer CreateIndirectArgumentBuffer(const void* data, uint32_t byteWidth);
+	virtual GfxShader CreateComputeShader(const char* name);
+	virtual GfxShader CreateVertexShader(const char* name);
+	virtual GfxShader CreatePixelShader(const char* name);
+	virtual GfxInputLayout CreateInputLayout(GfxShader vertexShader);
+	virtual void Release(GfxHandle handle);
+
+	virtual GfxView GetBackBufferRTV() { return mBackBufferRTV; }
+	virtual bool ResizeBuffers(uint32_t width, uint32_t height);
+
+	virtual void CSSetShader(GfxShader shader) { mBoundCS = shader; }
+	virtual void CSSetUnorderedAccessView(uint32_t slot, GfxView view) { if (slot == 0) mBoundUAV = view; }
+	virtual void CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer) { if (slot == 0) mBoundConstantBuffer = buffer; }
+
+	// t0 is the tile list of the tile-list shaders, t1 the source texture of the workload shaders. Binding a texture to
+	// t1 waits for dispatches still writing to it, as D3D11 does when a resource goes from UAV to SRV binding.
+	virtual void CSSetShaderResource(uint32_t slot, GfxView view);
+	virtual void Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ);
+
+	// Reads the arguments from the buffer when called, which is when the dispatch reaches this device's timeline
+	virtual void DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset);
+	virtual void BeginUAVOverlap();
+	virtual void EndUAVOverlap();
+
+	// A deferred context resolves the shader, constant buffer and UAV of each dispatch while it records, so executing
+	// its list only queues the dispatches on the scheduler
+	virtual std::unique_ptr<GfxDeferredContext> CreateDeferredContext();
+	virtual void ExecuteCommandList(GfxDeferredContext* context);
+
+	virtual void ClearRenderTargetView(GfxView view, const float color[4]);
+	virtual void OMSetRenderTarget(GfxView view) { mBoundRTV = view; }
+	virtual void RSSetViewport(float width, float height) { mViewportWidth = width; mViewportHeight = height; }
+	virtual void IASetInputLayout(GfxInputLayout layout) { mBoundInputLayout = layout; }
+	virtual void IASetVertexBuffer(uint32_t slot, GfxBuffer buffer, uint32_t /*stride*/, uint32_t /*offset*/) { if (slot == 0) mBoundVertexBuffer = buffer; }
+	virtual void VSSetShader(GfxShader shader) { mBoundVS = shader; }
+	virtual void PSSetShader(GfxShader shader) { mBoundPS = shader; }
+	virtual void PSSetShaderResource(uint32_t slot, GfxView view) { if (slot == 0) mBoundSRV = view; }
+
+	// Only the fullscreen triangle: samples the SRV at the texture coordinates of the bound vertices, interpolated per pixel
+	virtual void Draw(uint32_t vertexCount, uint32_t startVertex);
+
+	// A timestamp waits for the dispatches queued before it, so it marks when their writes have landed
+	virtual GfxQuery CreateQuery(GfxQueryType type);
+	virtual void Begin(GfxQuery query);
+	virtual void End(GfxQuery query);
+	virtual bool GetTimestamp(GfxQuery query, uint64_t& ticks);
+	virtual bool GetTimestampDisjoint(GfxQuery query, uint64_t& frequency, bool& disjoint);
+
+	// Holds query results back for this many Present() calls after End(), like a GPU running frames behind the CPU.
+	// 0, the default, makes them available as soon as End() returns.
+	void SetQueryLatency(uint32_t frames) { mQueryLatency = frames; }
+
+	virtual void InitUI();
+	virtual void ShutdownUI();
+	virtual void NewUIFrame();
+
+	// Copies the draw data and draws it into the bound render target on the device timeline, if UI rasterization is on
+	virtual void RenderUI(ImDrawData* drawData);
+	virtual bool IsUIStatePreserved() const { return true; }
+
+	// Off by default: the overlay prints timings, so frames that include it differ from run to run. It is still
+	// built every frame either way, so its CPU cost is paid.
+	void SetUIRasterizationEnabled(bool enabled) { bRasterizeUI = enabled; }
+
+	// Triangle counts and setup and raster times of the last overlay the device timeline drew
+	UIRasterizer::Stats GetLastUIStats() const;
+
+	virtual void SetMaxFramesInFlight(uint32_t count);
+	virtual uint32_t GetMaxFramesInFlight() const { return mMaxFramesInFlight; }
+	virtual uint64_t GetSubmittedFrame() const { return mPresentCount; }
+	virtual uint64_t GetCompletedFrame();
+	virtual void WaitForFrame(uint64_t frame);
+
+	virtual void Present();
+
+	// Waits for every frame in flight first
+	virtual bool ReadBackBuffer(std::vector<uint32_t>& texels);
+
+	// Scheduler statistics (wall time, barriers, worker idle time) of the last frame the device timeline finished
+	DispatchScheduler::Stats GetLastFrameStats() const;
+
+	ThreadPool& GetThreadPool() { return mThreadPool; }
+
+private:
+	class DeferredContext;
+
+	enum ObjectType
+	{
+		OBJECT_NONE,
+		OBJECT_TEXTURE,
+		OBJECT_SRV,
+		OBJECT_BUFFER_SRV,
+		OBJECT_UAV,
+		OBJECT_RTV,
+		OBJECT_BUFFER,
+		OBJECT_COMPUTE_SHADER,
+		OBJECT_VERTEX_SHADER,
+		OBJECT_PIXEL_SHADER,
+		OBJECT_INPUT_LAYOUT,
+		OBJECT_TIMESTAMP_QUERY,
+		OBJECT_DISJOINT_QUERY
+	};
+
+	struct Object
+	{
+		ObjectType type;
+		uint32_t bindFlags;                     // Textures
+		std::shared_ptr<CPUTexture2D> texture;  // Textures and the views of them
+		std::vector<uint8_t> data;              // Buffers
+		uint32_t stride;                        // Structured buffers
+		bool bIndirectArguments;                // Buffers
+		GfxBuffer buffer;                       // Views of structured buffers
+		uint32_t tileSize;                      // Compute shaders
+		bool bTileList;                         // Compute shaders: reads its tiles from t0
+		bool bWorkload;                         // Compute shaders: ComputeWorkload.hlsl, reads its knobs from b0 and t1
+		std::shared_ptr<uint64_t> timestamp;    // Timestamp queries: clock reading at End(), written on the device timeline
+		uint64_t readyFrame;                    // Queries: Present() count at which the result becomes available
+		uint64_t readyFence;                    // Queries: device timeline value that has run End()
+		bool bEnded;                            // Queries
+
+		Object() : type(OBJECT_NONE), bindFlags(0), stride(0), bIndirectArguments(false), buffer(GFX_NULL_HANDLE), tileSize(0), bTileList(false),
+			bWorkload(false), readyFrame(0), readyFence(0), bEnded(false) {}
+	};
+
+	GfxView CreateView(GfxTexture texture, ObjectType viewType, uint32_t requiredBindFlag);
+	CPUTexture2D* GetTexture(GfxHandle handle, ObjectType type);
+	bool IsObject(GfxHandle handle, ObjectType type) const { return mObjects.IsValid(handle) && mObjects.Get(handle).type == type; }
+
+	// Compute state a dispatch reads, from the immediate context or from a deferred context's command list
+	struct ComputeBindings
+	{
+		GfxShader shader;
+		GfxView uav;
+		GfxBuffer constantBuffer;
+		GfxView tileList;
+		GfxView source;
+	};
+
+	// Validates the bindings like Dispatch(), and queues the dispatch if they are complete
+	void RunDispatch(const ComputeBindings& bindings, uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ);
+	bool ReadIndirectArguments(GfxBuffer arguments, uint32_t byteOffset, uint32_t groups[3]) const;
+
+	// Switches the kernel to the shader's tile size if needed, then queues the dispatch
+	void QueueDispatch(const CPUComputeBackend::ConstantBuffer& cb, uint32_t tileSize, uint32_t groupsX, uint32_t groupsY, CPUTexture2D& uav,
+		const CPUWorkloadBinding* workload = nullptr);
+
+	// Every shader the sample uses runs a fixed CPU kernel, so a shader object just records which one
+	GfxShader CreateShader(const char* name, ObjectType type);
+
+	// Runs work on the device timeline: right away with one frame in flight, otherwise when the timeline thread reaches
+	// it. Work may hold raw pointers into live objects, because Release() waits for the timeline to go idle first.
+	template <typename Work>
+	void RunOnTimeline(const Work& work)
+	{
+		if (mTimeline)
+		{
+			mRecordedWork.push_back(work);
+		}
+		else
+		{
+			work();
+		}
+	}
+
+	// Hands the work recorded since the last submission to the timeline and returns its fence value
+	uint64_t SubmitRecordedWork();
+
+	// Waits for everything submitted or recorded so far, including dispatches still queued on the scheduler
+	void WaitForIdle();
+
+	// INTCStubOverlapHandler forwarding the extension's brackets to the scheduler
+	static void OnUAVOverlapBracket(void* userData, bool begin);
+
+	ThreadPool mThreadPool;
+	CPUComputeBackend mBackend;
+	DispatchScheduler mScheduler;
+	DispatchScheduler::Stats mLastFrameStats;  // Written on the device timeline, under mStatsLock
+	UIRasterizer mUIRasterizer;                // Used on the device timeline
+	UIRasterizer::Stats mLastUIStats;          // Written on the device timeline, under mStatsLock
+	bool bRasterizeUI;
+	mutable std::mutex mStatsLock;
+
+	// Frames in flight. The timeline only exists while more than one is allowed; each of the last few frames keeps
+	// the fence value of the submission its Present() ended.
+	uint32_t mMaxFramesInFlight;
+	std::unique_ptr<DeviceTimeline> mTimeline;
+	std::vector<DeviceTimeline::Work> mRecordedWork;
+	uint64_t mFrameFenceValues[GFX_MAX_FRAMES_IN_FLIGHT];
+
+	GfxHandleTable<Object> mObjects;
+
+	uint32_t mWidth;
+	uint32_t mHeight;
+	GfxTexture mBackBuffer;
+	GfxView mBackBufferRTV;
+	GfxTexture mFontTexture;
+
+	GfxShader mBoundCS;
+	GfxView mBoundUAV;
+	GfxBuffer mBoundConstantBuffer;
+	GfxView mBoundCSSRV;
+	GfxView mBoundCSSource;
+	GfxShader mBoundVS;
+	GfxShader mBoundPS;
+	GfxView mBoundSRV;
+	GfxView mBoundRTV;
+	GfxInputLayout mBoundInputLayout;
+	GfxBuffer mBoundVertexBuffer;
+	float mViewportWidth;
+	float mViewportHeight;
+
+	std::chrono::steady_clock::time_point mLastUIFrameTime;
+
+	FrameClockFn mClock;
+	StartupTimer* mStartupTimer;
+	uint32_t mQueryLatency;
+	uint64_t mPresentCount;
+
+	INTCExtensionContext* mINTCExtensionContext;
+	bool bUAVOverlapSupported;
+};
+
+#endif // CPUGRAPHICSDEVICE_H
@@ -0,0 +1,60 @@
+/************************************************************************************************
+ **	Name:        CommandReplay.h                                                               **
+ **	Description: Replays a captured CommandStream on any GraphicsDevice, timing every call and **
+ **              reporting redundant state changes and UAV hazard edges                        **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                  **
+ **	Published:   <insert date>                                                                 **
+ ***********************************************************************************************/
+
+#ifndef COMMANDREPLAY_H
+#define COMMANDREPLAY_H
+
+#include "CommandStream.h"
+#include "GraphicsDevice.h"
+
+#include <cstdio>
+
+struct ReplayOpcodeStats
+{
+	uint32_t count;
+	uint32_t redundantCount;   // Set calls that rebound what the slot already held
+	double totalMs;            // CPU time spent in the device call
+};
+
+// Two dispatches inside one overlap bracket whose footprints on the same texture intersect
+struct ReplayHazard
+{
+	uint32_t firstCommand;     // Command indices within the stream
+	uint32_t secondCommand;
+};
+
+// Dispatch footprints come from the bound constant buffer (the sample's tile origin and window size) and the tile size
+// in the compute shader's name. A dispatch without a recognizable constant buffer is assumed to write the whole texture,
+// and so are indirect dispatches and the tile-list shaders, whose tiles live in buffers the capture does not interpret.
+struct ReplayReport
+{
+	static const uint32_t MAX_REPORTED_HAZARDS = 8;
+
+	ReplayOpcodeStats opcodes[CMD_COUNT];
+	uint32_t commandCount;
+	uint32_t frameCount;
+	uint32_t skippedCount;           // UI calls, whose draw data is not captured
+	uint32_t unmappedHandleCount;    // Handles used before the capture created them
+	double totalMs;
+
+	uint32_t syncEdges;              // Consecutive dispatches on one UAV texture that the device must serialize
+	uint32_t unnecessarySyncEdges;   // ...of which the footprints were disjoint, so overlap would have been safe
+	uint32_t overlapEdges;           // Consecutive dispatches on one UAV texture inside an overlap bracket
+	uint32_t overlapHazards;         // ...of which the footprints intersect, a race
+	uint32_t uavToSrvEdges;          // Draws reading a texture written by compute since it was last read
+	std::vector<ReplayHazard> hazards;
+};
+
+// Replays stream on device, which must not have been initialized; the stream's own Init call does that, and the
+// device is cleaned up at the end if the capture stopped before Cleanup, or if the replay fails. Returns false if the
+// stream is malformed or the device fails to initialize; report then covers the commands replayed so far.
+bool ReplayCommandStream(const std::vector<uint8_t>& stream, GraphicsDevice* device, ReplayReport& report);
+
+void PrintReplayReport(FILE* file, const ReplayReport& report);
+
+#endif // COMMANDREPLAY_H
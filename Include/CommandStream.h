@@ -0,0 +1,121 @@
+/****************************************************************************************************
+ **	Name:        CommandStream.h                                                                   **
+ **	Description: Compact binary encoding of GraphicsDevice calls: opcodes, varint-packed arguments **
+ **              and the capture file format                                                       **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                      **
+ **	Published:   <insert date>                                                                     **
+ ***************************************************************************************************/
+
+#ifndef COMMANDSTREAM_H
+#define COMMANDSTREAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Capture files start with COMMAND_STREAM_MAGIC and COMMAND_STREAM_VERSION as little-endian uint32s, followed by the
+// commands back to back. Each command is a one-byte opcode followed by its arguments in call order:
+//     unsigned integers and handles  LEB128 varints, so handles, slots and small counts take one byte
+//     floats                         4 raw little-endian bytes
+//     buffer contents and strings    varint length, then the bytes
+// Calls that create an object end with the handle the recording device returned, so replay can map it.
+// Versions 2 and 3 only appended opcodes, so older files still read as is.
+#define COMMAND_STREAM_MAGIC 0x43564155 // "UAVC"
+#define COMMAND_STREAM_VERSION 3
+#define COMMAND_STREAM_MIN_VERSION 1
+
+enum CommandOpcode
+{
+	CMD_INIT = 1,                  // width, height
+	CMD_CLEANUP,
+	CMD_CREATE_TEXTURE2D,          // width, height, bindFlags, result
+	CMD_CREATE_SRV,                // texture, result
+	CMD_CREATE_UAV,                // texture, result
+	CMD_CREATE_RTV,                // texture, result
+	CMD_CREATE_CONSTANT_BUFFER,    // bytes, result
+	CMD_CREATE_VERTEX_BUFFER,      // bytes, result
+	CMD_CREATE_COMPUTE_SHADER,     // name, result
+	CMD_CREATE_VERTEX_SHADER,      // name, result
+	CMD_CREATE_PIXEL_SHADER,       // name, result
+	CMD_CREATE_INPUT_LAYOUT,       // vertexShader, result
+	CMD_CREATE_QUERY,              // type, result
+	CMD_RELEASE,                   // handle
+	CMD_GET_BACK_BUFFER_RTV,       // result
+	CMD_CS_SET_SHADER,             // shader
+	CMD_CS_SET_UAV,                // slot, view
+	CMD_CS_SET_CONSTANT_BUFFER,    // slot, buffer
+	CMD_DISPATCH,                  // groupsX, groupsY, groupsZ
+	CMD_BEGIN_UAV_OVERLAP,
+	CMD_END_UAV_OVERLAP,
+	CMD_CLEAR_RTV,                 // view, 4 floats
+	CMD_OM_SET_RENDER_TARGET,      // view
+	CMD_RS_SET_VIEWPORT,           // 2 floats
+	CMD_IA_SET_INPUT_LAYOUT,       // layout
+	CMD_IA_SET_VERTEX_BUFFER,      // slot, buffer, stride, offset
+	CMD_VS_SET_SHADER,             // shader
+	CMD_PS_SET_SHADER,             // shader
+	CMD_PS_SET_SHADER_RESOURCE,    // slot, view
+	CMD_DRAW,                      // vertexCount, startVertex
+	CMD_BEGIN_QUERY,               // query
+	CMD_END_QUERY,                 // query
+	CMD_INIT_UI,
+	CMD_SHUTDOWN_UI,
+	CMD_NEW_UI_FRAME,
+	CMD_RENDER_UI,                 // Draw data is not captured
+	CMD_PRESENT,
+	CMD_CREATE_STRUCTURED_BUFFER,  // bytes, stride, result
+	CMD_CREATE_INDIRECT_ARGS,      // bytes, result
+	CMD_CS_SET_SHADER_RESOURCE,    // slot, view
+	CMD_DISPATCH_INDIRECT,         // arguments, byteOffset
+	CMD_RESIZE_BUFFERS,            // width, height
+	CMD_COUNT
+};
+
+const char* GetCommandOpcodeName(CommandOpcode opcode);
+
+class CommandStreamWriter
+{
+public:
+	void WriteOpcode(CommandOpcode opcode) { mData.push_back((uint8_t)opcode); }
+	void WriteUInt(uint32_t value);
+	void WriteFloat(float value);
+	void WriteBytes(const void* data, uint32_t size);
+	void WriteString(const char* text);
+
+	const std::vector<uint8_t>& GetData() const { return mData; }
+	void Clear() { mData.clear(); }
+
+private:
+	std::vector<uint8_t> mData;
+};
+
+// Every Read call returns false, and leaves the reader failed, if the stream ends early or is malformed
+class CommandStreamReader
+{
+public:
+	CommandStreamReader(const uint8_t* data, size_t size) : mData(data), mSize(size), mOffset(0), bFailed(false) {}
+
+	bool AtEnd() const { return mOffset >= mSize; }
+	bool HasFailed() const { return bFailed; }
+	size_t GetOffset() const { return mOffset; }
+
+	bool ReadOpcode(CommandOpcode& opcode);
+	bool ReadUInt(uint32_t& value);
+	bool ReadFloat(float& value);
+	bool ReadBytes(std::vector<uint8_t>& bytes);
+	bool ReadString(std::string& text);
+
+private:
+	bool Fail() { bFailed = true; return false; }
+
+	const uint8_t* mData;
+	size_t mSize;
+	size_t mOffset;
+	bool bFailed;
+};
+
+// Adds or checks the file header; the commands themselves are stored as is
+bool WriteCommandStreamFile(const char* path, const std::vector<uint8_t>& commands);
+bool ReadCommandStreamFile(const char* path, std::vector<uint8_t>& commands);
+
+#endif // COMMANDSTREAM_H
@@ -0,0 +1,64 @@
+/****************************************************************************************************
+ **	Name:        ComputeWorkload.h                                                                 **
+ **	Description: Parameterized compute workloads for Shaders/ComputeWorkload.hlsl - named presets, **
+ **              command line parsing and the CPU reference kernel                                 **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                      **
+ **	Published:   <insert date>                                                                     **
+ ***************************************************************************************************/
+
+#ifndef COMPUTEWORKLOAD_H
+#define COMPUTEWORKLOAD_H
+
+#include <cstdint>
+#include <string>
+
+#include "CPUComputeBackend.h"
+
+// Mirror WORKLOAD_GROUP_REDUCTION and WORKLOAD_IRREGULAR_TILES in ComputeWorkload.hlsl
+#define COMPUTE_WORKLOAD_GROUP_REDUCTION 1   // Sum every active thread's value through group shared memory
+#define COMPUTE_WORKLOAD_IRREGULAR_TILES 2   // Each tile runs the workload on a square of its own, hashed, size
+
+// Knobs of the workload shader: the second row of its constant buffer, after the sample's tile constants
+struct ComputeWorkload
+{
+	uint32_t aluIterations;   // Integer hash rounds per thread
+	uint32_t srvReads;        // Texels each thread loads from the source bound as t1
+	uint32_t flags;           // COMPUTE_WORKLOAD_*
+	uint32_t coverage;        // Percent of the tile edge that runs the workload, from the top-left; 0 or 100 is the whole tile
+};
+
+// A workload with every knob at zero still runs the workload shader; the sample uses the gradient shader for it instead
+inline bool IsComputeWorkloadEnabled(const ComputeWorkload& workload)
+{
+	return workload.aluIterations != 0 || workload.srvReads != 0 || workload.flags != 0 || (workload.coverage != 0 && workload.coverage < 100);
+}
+
+inline bool operator==(const ComputeWorkload& a, const ComputeWorkload& b)
+{
+	return a.aluIterations == b.aluIterations && a.srvReads == b.srvReads && a.flags == b.flags && a.coverage == b.coverage;
+}
+
+// Accepts a preset name (none, alu, bandwidth, reduction, partial, irregular, mixed) or a '+' separated list of
+// alu=N, reads=N, coverage=N, reduce and irregular, e.g. "alu=64+reads=4+reduce". Returns false if the text is malformed.
+bool ParseComputeWorkload(const std::string& text, ComputeWorkload& workload);
+
+// Preset name if the workload matches one, otherwise the '+' separated form ParseComputeWorkload() accepts
+std::string FormatComputeWorkload(const ComputeWorkload& workload);
+
+// Every preset, in the order the benchmarks sweep them; the first is "none"
+uint32_t GetComputeWorkloadPresetCount();
+const char* GetComputeWorkloadPresetName(uint32_t index);
+ComputeWorkload GetComputeWorkloadPreset(uint32_t index);
+
+// What a workload dispatch needs on the CPU backend besides the tile constants
+struct CPUWorkloadBinding
+{
+	ComputeWorkload workload;
+	const CPUTexture2D* source;   // Texture bound as t1; nullptr reads zeros, like an unbound SRV
+};
+
+// CPU reference of the CS entrypoint of ComputeWorkload.hlsl for thread group (groupX, groupY). Bit-exact with the
+// shader on the workload's blue channel; the gradient channels match the CS reference kernel.
+void RunWorkloadThreadGroup(const CPUComputeBackend::ConstantBuffer& cb, const CPUWorkloadBinding& binding, uint32_t tileSize, uint32_t groupX, uint32_t groupY, CPUTexture2D& uav);
+
+#endif // COMPUTEWORKLOAD_H
@@ -0,0 +1,189 @@
+/******************************************************************************************
+ **	Name:        D3D11GraphicsDevice.h                                                   **
+ **	Description: D3D11 implementation of GraphicsDevice: device and swap chain creation, **
+ **              Intel extension setup and the ImGui Win32/DX11 backends                 **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                            **
+ **	Published:   <insert date>                                                           **
+ *****************************************************************************************/
+
+#ifndef D3D11GRAPHICSDEVICE_H
+#define D3D11GRAPHICSDEVICE_H
+
+#include <windows.h>
+#include <d3d11.h>
+#include <d3d12.h>
+#include <d3dcompiler.h>
+#include <exception>
+
+#include "GraphicsDevice.h"
+#include "IntelExtensions.h"
+#include "StartupTimer.h"
+#include "UIPipeline.h"
+#include "UploadRing.h"
+
+#ifndef ThrowIfFailed
+#define ThrowIfFailed(x) \
+{                        \
+    HRESULT hr__ = (x);  \
+    if(FAILED(hr__)) { throw std::exception(); return hr__; } \
+}
+#endif
+
+class D3D11GraphicsDevice : public GraphicsDevice
+{
+public:
+	// A NULL window renders into an offscreen back buffer: no swap chain is created and Present only paces the CPU
+	explicit D3D11GraphicsDevice(HWND window);
+	virtual ~D3D11GraphicsDevice() {}
+
+	virtual bool Init(uint32_t width, uint32_t height);
+	virtual void Cleanup();
+	virtual void SetStartupTimer(StartupTimer* timer) { mStartupTimer = timer; }
+
+	virtual const char* GetName() const { return "d3d11"; }
+	virtual bool IsUAVOverlapSupported() const { return bUAVOverlapSupported; }
+
+	virtual GfxTexture CreateTexture2D(uint32_t width, uint32_t height, uint32_t bindFlags);
+	virtual GfxView CreateShaderResourceView(GfxTexture texture);
+	virtual GfxView CreateUnorderedAccessView(GfxTexture texture);
+	virtual GfxView CreateRenderTargetView(GfxTexture texture);
+	virtual GfxBuffer CreateConstantBuffer(const void* data, uint32_t byteWidth);
+	virtual GfxBuffer CreateVertexBuffer(const void* data, uint32_t byteWidth);
+	virtual GfxBuffer CreateStructuredBuffer(const void* data, uint32_t stride, uint32_t count);
+	virtual GfxBuffer CreateIndirectArgumentBuffer(const void* data, uint32_t byteWidth);
+	virtual GfxShader CreateComputeShader(const char* name);
+	virtual GfxShader CreateVertexShader(const char* name);
+	virtual GfxShader CreatePixelShader(const char* name);
+	virtual GfxInputLayout CreateInputLayout(GfxShader vertexShader);
+	virtual void Release(GfxHandle handle);
+
+	virtual GfxView GetBackBufferRTV() { return mBackBufferRTV; }
+
+	// Headless devices recreate the offscreen target, and tell ImGui the new display size the Win32 backend would
+	// otherwise read from the window
+	virtual bool ResizeBuffers(uint32_t width, uint32_t height);
+
+	virtual void CSSetShader(GfxShader shader);
+	virtual void CSSetUnorderedAccessView(uint32_t slot, GfxView view);
+	virtual void CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer);
+	virtual void CSSetShaderResource(uint32_t slot, GfxView view);
+	virtual void Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ);
+	virtual void DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset);
+	virtual void BeginUAVOverlap();
+	virtual void EndUAVOverlap();
+
+	// ID3D11DeviceContext deferred contexts. The extension's overlap brackets only apply to the immediate context, so
+	// dispatches recorded on a deferred context always sync.
+	virtual std::unique_ptr<GfxDeferredContext> CreateDeferredContext();
+	virtual void ExecuteCommandList(GfxDeferredContext* context);
+
+	virtual void ClearRenderTargetView(GfxView view, const float color[4]);
+	virtual void OMSetRenderTarget(GfxView view);
+	virtual void RSSetViewport(float width, float height);
+	virtual void IASetInputLayout(GfxInputLayout layout);
+	virtual void IASetVertexBuffer(uint32_t slot, GfxBuffer buffer, uint32_t stride, uint32_t offset);
+	virtual void VSSetShader(GfxShader shader);
+	virtual void PSSetShader(GfxShader shader);
+	virtual void PSSetShaderResource(uint32_t slot, GfxView view);
+	virtual void Draw(uint32_t vertexCount, uint32_t startVertex);
+
+	virtual GfxQuery CreateQuery(GfxQueryType type);
+	virtual void Begin(GfxQuery query);
+	virtual void End(GfxQuery query);
+	virtual bool GetTimestamp(GfxQuery query, uint64_t& ticks);
+	virtual bool GetTimestampDisjoint(GfxQuery query, uint64_t& frequency, bool& disjoint);
+
+	virtual void InitUI();
+	virtual void ShutdownUI();
+	virtual void NewUIFrame();
+	virtual void RenderUI(ImDrawData* drawData);
+
+	virtual bool IsUIStatePreserved() const { return !bUIOwnedPipeline; }
+
+	// Whether InitUI() created the ImGui shaders from the bytecode built with the sample, or compiled them at runtime
+	bool IsUIShaderPrecompiled() const;
+
+	// The DX11 backend's vertex and index rings since the process started
+	void GetUIUploadStats(UploadRingStats& vertexStats, UploadRingStats& indexStats) const;
+
+	// Off by default. With it on, the ImGui backend neither saves nor restores the pipeline state around the overlay,
+	// which is always drawn last. The device tells it which of its slots the app has bound since, and puts back the
+	// default blend, depth-stencil, rasterizer and sampler state before the app's next draw.
+	void SetUIOwnedPipeline(bool owned);
+	bool IsUIOwnedPipeline() const { return bUIOwnedPipeline; }
+	void GetUIPipelineCounters(UIPipelineCounters& counters) const;
+
+	// Frame fences are D3D11_QUERY_EVENT queries, one per frame in flight. The swap chain gets one buffer per frame in
+	// flight and the same maximum frame latency.
+	virtual void SetMaxFramesInFlight(uint32_t count);
+	virtual uint32_t GetMaxFramesInFlight() const { return mMaxFramesInFlight; }
+	virtual uint64_t GetSubmittedFrame() const { return mSubmittedFrame; }
+	virtual uint64_t GetCompletedFrame();
+	virtual void WaitForFrame(uint64_t frame);
+
+	virtual void Present();
+	virtual bool ReadBackBuffer(std::vector<uint32_t>& texels);
+
+	bool IsHeadless() const { return mWindow == NULL; }
+	bool IsIntelGPUPresent() const { return bIntelGPUPresent; }
+
+	ID3D11Device* GetDevice() { return mDevice; }
+	ID3D11DeviceContext* GetImmediateContext() { return mImmediateContext; }
+
+private:
+	class DeferredContext;
+
+	struct Object
+	{
+		ID3D11DeviceChild* object;
+		ID3DBlob* blob; // Vertex shader bytecode, kept to validate input layouts against
+
+		Object() : object(nullptr), blob(nullptr) {}
+	};
+
+	// Creates the offscreen target at the current size, or takes the swap chain's buffer, and a view of it
+	bool CreateBackBufferView(ID3D11RenderTargetView** backBufferRTV);
+
+	// Binds the state the overlay changed and the app's draws rely on being the default
+	void ResetUIState();
+
+	// Reads Shaders/<name>.cso
+	bool LoadShaderBlob(const char* name, ID3DBlob** blob);
+
+	template <typename T>
+	T* Get(GfxHandle handle) { return mObjects.IsValid(handle) ? static_cast<T*>(mObjects.Get(handle).object) : nullptr; }
+
+	HWND mWindow;
+	UINT mWidth;
+	UINT mHeight;
+
+	ID3D11Device* mDevice;
+	ID3D11DeviceContext* mImmediateContext;
+	IDXGISwapChain* mSwapChain;
+
+	// Headless runs only
+	ID3D11Texture2D* mOffscreenTarget;
+
+	// Frame f ends mFrameFences[f % GFX_MAX_FRAMES_IN_FLIGHT]
+	ID3D11Query* mFrameFences[GFX_MAX_FRAMES_IN_FLIGHT];
+	uint32_t mMaxFramesInFlight;
+	uint64_t mSubmittedFrame;
+	uint64_t mCompletedFrame;
+
+	GfxView mBackBufferRTV;
+
+	GfxHandleTable<Object> mObjects;
+
+	INTCExtensionContext* mINTCExtensionContext;
+
+	StartupTimer* mStartupTimer;
+
+	bool bUAVOverlapSupported;
+	bool bIntelGPUPresent;
+
+	bool bUIOwnedPipeline;
+	bool bUIStateBound;           // The overlay's blend, depth-stencil, rasterizer and sampler state is still bound
+	uint32_t mUIDirtySlots;       // UI_SLOT_BIT mask of the ImGui backend's slots bound since the overlay
+};
+
+#endif // D3D11GRAPHICSDEVICE_H
@@ -0,0 +1,59 @@
+/*****************************************************************************************************
+ **	Name:        DeviceTimeline.h                                                                   **
+ **	Description: Worker thread standing in for a GPU queue: runs submitted batches of work in order **
+ **              and signals a fence value as each one completes                                    **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                       **
+ **	Published:   <insert date>                                                                      **
+ ****************************************************************************************************/
+
+#ifndef DEVICETIMELINE_H
+#define DEVICETIMELINE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The CPU device's model of a GPU command queue. The submitting thread records work into batches and hands each one
+// over with Submit(), which returns at once; a single worker runs the batches in submission order and then signals
+// the fence value Submit() returned, like ID3D11Query EVENT or ID3D12Fence::Signal after an ExecuteCommandLists.
+// Fence values start at 1 and a value of 0 is always complete.
+class DeviceTimeline
+{
+public:
+	typedef std::function<void()> Work;
+
+	DeviceTimeline();
+
+	// Runs every submitted batch before returning
+	~DeviceTimeline();
+
+	// Queues a batch and returns the fence value signaled once all of it has run. An empty batch still gets a value.
+	uint64_t Submit(std::vector<Work>&& batch);
+
+	uint64_t GetSubmittedValue() const;
+	uint64_t GetCompletedValue() const;
+
+	// Blocks until value has been signaled. Values that were never submitted return at once.
+	void Wait(uint64_t value);
+	void WaitIdle() { Wait(GetSubmittedValue()); }
+
+private:
+	void WorkerMain();
+
+	mutable std::mutex mLock;
+	std::condition_variable mWorkCondition;
+	std::condition_variable mCompleteCondition;
+	std::deque<std::vector<Work>> mBatches;
+
+	uint64_t mSubmittedValue;
+	uint64_t mCompletedValue;
+	bool bShutdown;
+
+	std::thread mWorker;
+};
+
+#endif // DEVICETIMELINE_H
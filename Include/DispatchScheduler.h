@@ -0,0 +1,71 @@
+/********************************************************************************************
+ **	Name:        DispatchScheduler.h                                                       **
+ **	Description: Models D3D11 dispatch ordering on the CPU backend: serialized by default, **
+ **              concurrent inside a BeginUAVOverlap/EndUAVOverlap bracket                 **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                              **
+ **	Published:   <insert date>                                                             **
+ *******************************************************************************************/
+
+#ifndef DISPATCHSCHEDULER_H
+#define DISPATCHSCHEDULER_H
+
+#include <chrono>
+#include <vector>
+
+#include "CPUComputeBackend.h"
+#include "ComputeWorkload.h"
+
+class DispatchScheduler
+{
+public:
+	struct Stats
+	{
+		double wallTimeMs;
+		uint32_t dispatchCount;
+		uint32_t barrierCount;              // Times the submitting thread had to drain outstanding dispatches
+		std::vector<double> workerIdleMs;   // Wall time minus time spent running thread groups, per worker
+	};
+
+	explicit DispatchScheduler(CPUComputeBackend& backend);
+
+	void BeginFrame();
+	const Stats& EndFrame();
+
+	// Counterparts of INTC_D3D11_BeginUAVOverlap/EndUAVOverlap. Outside a bracket every dispatch waits for
+	// the previous one to finish, as the D3D11 runtime does for back-to-back dispatches sharing a UAV.
+	// Inside a bracket dispatches are queued without waiting and only drained at EndUAVOverlap.
+	void BeginUAVOverlap();
+	void EndUAVOverlap();
+
+	// Equivalent of CSSetConstantBuffers(cb) + Dispatch(groupsX, groupsY, 1) with uav bound. The thread groups of
+	// a single dispatch never wait on each other; only consecutive dispatches are ordered. A workload switches the
+	// dispatch over to the ComputeWorkload.hlsl reference kernel; it is copied, but its source must stay alive until
+	// the dispatch has drained.
+	void Dispatch(const CPUComputeBackend::ConstantBuffer& cb, uint32_t groupsX, uint32_t groupsY, CPUTexture2D& uav, const CPUWorkloadBinding* workload = nullptr);
+
+	// Dispatch(groupsX, groupsY, 1) of the tile-list shader variant, with tiles[tileCount] bound as its tile list.
+	// The list must stay alive until the dispatch has drained.
+	void DispatchTileList(const CPUComputeBackend::ConstantBuffer& cb, const uint32_t* tiles, uint32_t tileCount, uint32_t groupsX, uint32_t groupsY, CPUTexture2D& uav,
+		const CPUWorkloadBinding* workload = nullptr);
+
+	// Runs one frame of the sample's compute pass: every tile dispatched back-to-back, optionally inside an overlap bracket
+	const Stats& RunTileFrame(const CPUComputeBackend::ConstantBuffer* tiles, uint32_t tileCount, CPUTexture2D& uav, bool useUAVOverlap);
+
+	// Runs one frame of the batched compute pass: a single dispatch of numTilesX * numTilesY thread groups
+	const Stats& RunBatchedFrame(uint32_t numTilesX, uint32_t numTilesY, CPUTexture2D& uav);
+
+	const Stats& GetStats() const { return mStats; }
+
+	// Waits for every outstanding dispatch, e.g. before the UAV is read as an SRV. Counts as a barrier if anything was in flight.
+	void Barrier();
+
+private:
+
+	CPUComputeBackend& mBackend;
+	Stats mStats;
+	std::chrono::steady_clock::time_point mFrameStart;
+	bool bInUAVOverlap;
+	bool bDispatchOutstanding;
+};
+
+#endif // DISPATCHSCHEDULER_H
@@ -0,0 +1,80 @@
+/************************************************************************************************************
+ **	Name:        FramePacer.h                                                                              **
+ **	Description: Paces CPU frames against the device's frames in flight, hands out per-frame resource sets **
+ **              and reports CPU wait, frame latency and throughput                                        **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                              **
+ **	Published:   <insert date>                                                                             **
+ ***********************************************************************************************************/
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <cstdint>
+#include <cstdio>
+
+#include "FrameTimeHistogram.h"
+#include "GraphicsDevice.h"
+
+// Frame f (the fence value its Present() signals) records into resource set f % framesInFlight, so with N frames in
+// flight the CPU never writes a set the device may still be reading. Latency is measured from the start of a CPU
+// frame until the device is seen to have finished it; completion is polled at BeginFrame(), after Present() and in
+// Flush(), so it is observed, not exact. Throughput is finished frames over the wall time they took.
+class FramePacer
+{
+public:
+	struct Report
+	{
+		uint32_t framesInFlight;
+		uint64_t frameCount;                 // Frames seen to finish
+		double throughputFps;
+		double meanCpuWaitMs;                // Per frame, blocked in Present() and waiting for a resource set
+		double maxCpuWaitMs;
+		FrameTimeHistogram::Summary latency;
+	};
+
+	explicit FramePacer(FrameClockFn clock = SteadyClockNanoseconds);
+
+	// Call after the device's Init(); the number of resource sets is its GetMaxFramesInFlight()
+	void Init(GraphicsDevice* device);
+
+	uint32_t GetFramesInFlight() const { return mFramesInFlight; }
+
+	// Starts a CPU frame. Waits for the frame that last recorded into the returned set to finish.
+	uint32_t BeginFrame();
+
+	// Ends the CPU frame with the device's Present()
+	void Present();
+
+	// Waits for every frame in flight, so all of them are in the report
+	void Flush();
+
+	// Forgets every frame measured so far, e.g. the warm-up of a benchmark
+	void ResetReport();
+
+	Report GetReport() const;
+	void PrintReport(FILE* file) const;
+
+private:
+	// Records the latency of every frame the device has finished since the last call
+	void CollectCompletedFrames();
+
+	GraphicsDevice* mDevice;
+	FrameClockFn mClock;
+	uint32_t mFramesInFlight;
+
+	uint64_t mSetFrames[GFX_MAX_FRAMES_IN_FLIGHT];       // Last frame that recorded into each set
+	uint64_t mFrameStartNs[GFX_MAX_FRAMES_IN_FLIGHT];    // CPU start of frame f, at f % GFX_MAX_FRAMES_IN_FLIGHT
+	uint64_t mCollectedFrame;                            // Frames up to this one have a latency recorded
+	uint64_t mFirstFrame;                                // First frame the report covers
+
+	uint64_t mFirstStartNs;
+	uint64_t mLastCompleteNs;
+	uint64_t mWaitNs;
+	uint64_t mMaxWaitNs;
+	uint64_t mWaitFrames;
+	uint64_t mFrameWaitNs;                               // Current frame
+
+	FrameTimeHistogram mLatency;
+};
+
+#endif // FRAMEPACER_H
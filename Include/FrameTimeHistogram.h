@@ -0,0 +1,125 @@
+/****************************************************************************************************
+ **	Name:        FrameTimeHistogram.h                                                              **
+ **	Description: Lock-free, fixed-memory log-linear frame time histogram with rolling and lifetime **
+ **              percentiles, a frame history for graphing, and CSV/JSON export                    **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                      **
+ **	Published:   <insert date>                                                                     **
+ ***************************************************************************************************/
+
+#ifndef FRAMETIMEHISTOGRAM_H
+#define FRAMETIMEHISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+// Source of monotonic nanoseconds; the default reads std::chrono::steady_clock
+typedef uint64_t (*FrameClockFn)();
+
+uint64_t SteadyClockNanoseconds();
+
+// Measures the interval between successive Tick() calls
+class FrameTimer
+{
+public:
+	explicit FrameTimer(FrameClockFn clock = SteadyClockNanoseconds) : mClock(clock), mLastTick(0), bStarted(false) {}
+
+	// Returns the nanoseconds since the previous Tick(), or 0 on the first call
+	uint64_t Tick();
+
+	// The next Tick() starts a new interval instead of measuring one
+	void Restart() { bStarted = false; }
+
+private:
+	FrameClockFn mClock;
+	uint64_t mLastTick;
+	bool bStarted;
+};
+
+// HDR-style histogram of frame times in nanoseconds. Each power of two is split into SUB_BUCKET_COUNT linear
+// buckets, so every recorded value is kept to within 1/64 (about 1.6%) from 64 ns up to MAX_TRACKABLE_NS; larger
+// values land in the last bucket. Record() may be called from any number of threads without locks, and all
+// storage is allocated up front.
+//
+// Every counter is updated with relaxed atomics, so a reader running alongside Record() sees each counter's latest
+// value but no consistent snapshot across them: a frame being recorded may be in the count and not yet in a bucket,
+// or out of one rolling bucket before it is in another, and results can be off by the frames in flight. Rolling
+// bucket counts are signed, since a frame can leave a bucket before another writer's increment for it lands, and
+// are read as 0 while negative. Once the writers have finished and synchronized with the reader, e.g. by being
+// joined, every result is exact.
+//
+// Two views are kept: the lifetime histogram, which is what gets exported, and a rolling one covering the last
+// HISTORY_SIZE frames. Recording a frame overwrites the oldest slot of the history ring and moves that frame out
+// of the rolling histogram, so rolling percentiles need no periodic reset.
+class FrameTimeHistogram
+{
+public:
+	static const uint32_t SUB_BUCKET_BITS = 6;
+	static const uint32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+	static const uint32_t MAX_EXPONENT = 35;
+	static const uint32_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKET_COUNT;
+	static const uint64_t MAX_TRACKABLE_NS = (2ull << MAX_EXPONENT) - 1; // About 68.7 seconds
+	static const uint32_t HISTORY_SIZE = 256;
+
+	struct Summary
+	{
+		uint64_t count;
+		double minMs;
+		double maxMs;
+		double meanMs;
+		double p50Ms;
+		double p95Ms;
+		double p99Ms;
+	};
+
+	FrameTimeHistogram();
+
+	void Record(uint64_t frameTimeNs);
+	void RecordMs(double frameTimeMs);
+
+	// Drops every recorded frame. Not safe against concurrent Record() calls.
+	void Reset();
+
+	// Frames recorded over the histogram's lifetime, or only those still in the history ring
+	Summary GetSummary() const;
+	Summary GetRollingSummary() const;
+
+	// Smallest recorded value v such that at least percentile% of the frames are <= v, to bucket precision.
+	// Reported as the bucket midpoint, clamped to the recorded min and max.
+	double GetPercentileMs(double percentile) const;
+	double GetRollingPercentileMs(double percentile) const;
+
+	// Copies up to count of the most recent frame times, oldest first, for ImGui::PlotLines.
+	// Returns the number written, which is less than count until the ring has filled.
+	uint32_t GetHistoryMs(float* values, uint32_t count) const;
+
+	// Lifetime summary followed by every non-empty bucket. CSV has one row per bucket; JSON also
+	// carries the rolling summary and the history ring.
+	bool WriteCSV(const char* path) const;
+	bool WriteJSON(const char* path) const;
+
+	// Picks CSV or JSON from the file extension (.json, anything else is CSV)
+	bool WriteFile(const char* path) const;
+
+	void PrintSummary(FILE* file) const;
+
+	static uint32_t GetBucketIndex(uint64_t valueNs);
+	static uint64_t GetBucketLowerBound(uint32_t index);
+	static uint64_t GetBucketUpperBound(uint32_t index); // Exclusive
+
+private:
+	static double PercentileFromCounts(const uint32_t* counts, double percentile, uint64_t minNs, uint64_t maxNs);
+	void GetRollingRange(uint64_t& minNs, uint64_t& maxNs, uint64_t& sumNs, uint64_t& count) const;
+
+	std::atomic<uint32_t> mCounts[BUCKET_COUNT];
+	std::atomic<int32_t> mRollingCounts[BUCKET_COUNT];
+	std::atomic<uint64_t> mHistory[HISTORY_SIZE]; // EMPTY_SLOT until written
+	std::atomic<uint64_t> mHistoryWriteIndex;
+
+	std::atomic<uint64_t> mCount;
+	std::atomic<uint64_t> mSumNs;
+	std::atomic<uint64_t> mMinNs;
+	std::atomic<uint64_t> mMaxNs;
+};
+
+#endif // FRAMETIMEHISTOGRAM_H
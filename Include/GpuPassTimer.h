@@ -0,0 +1,85 @@
+/*************************************************************************************************
+ **	Name:        GpuPassTimer.h                                                                 **
+ **	Description: Per-pass GPU timing from a ring of timestamp queries that is read back several **
+ **              frames late, so collecting results never stalls the CPU                        **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                   **
+ **	Published:   <insert date>                                                                  **
+ ************************************************************************************************/
+
+#ifndef GPUPASSTIMER_H
+#define GPUPASSTIMER_H
+
+#include <cstdint>
+
+#include "GraphicsDevice.h"
+
+// Each frame gets a disjoint query and passCount + 1 timestamps: one at the start of the frame and one at the end
+// of every pass. Frames cycle through ringSize sets of queries. At the end of every frame, every earlier frame whose
+// results have arrived is resolved, oldest first, and polling stops at the first one still in flight.
+// If the GPU falls so far behind that the next set is still in flight when the frame begins, that frame goes
+// untimed instead of waiting for it.
+//
+// Only GraphicsDevice calls are used, so the ring logic runs the same on the CPU device, where a fake clock and
+// CPUGraphicsDevice::SetQueryLatency() make it deterministic.
+class GpuPassTimer
+{
+public:
+	static const uint32_t MAX_PASSES = 4;
+	static const uint32_t MAX_RING_SIZE = 8;
+	static const uint32_t AVERAGE_FRAMES = 32;
+
+	GpuPassTimer();
+	~GpuPassTimer() {}
+
+	// Creates the queries. ringSize bounds how many frames may be in flight before frames go untimed.
+	bool Init(GraphicsDevice* device, uint32_t passCount, uint32_t ringSize = 4);
+	void Release();
+
+	// Call BeginFrame() before the first pass, EndPass(i) after pass i, and EndFrame() before Present()
+	void BeginFrame();
+	void EndPass(uint32_t pass);
+	void EndFrame();
+
+	// Latest resolved frame, and the mean of the last AVERAGE_FRAMES resolved frames
+	double GetLastPassMs(uint32_t pass) const { return pass < mPassCount ? mLastPassMs[pass] : 0.0; }
+	double GetAveragePassMs(uint32_t pass) const;
+
+	// How many frames behind the CPU the most recently resolved frame was
+	uint32_t GetResultLatencyFrames() const { return mResultLatency; }
+
+	uint64_t GetResolvedFrameCount() const { return mResolvedFrames; }
+	uint64_t GetSkippedFrameCount() const { return mSkippedFrames; }   // Ring full at BeginFrame()
+	uint64_t GetDisjointFrameCount() const { return mDisjointFrames; } // Resolved, but the timestamps were unreliable
+
+private:
+	struct FrameQueries
+	{
+		GfxQuery disjoint;
+		GfxQuery timestamps[MAX_PASSES + 1];
+		uint64_t frameIndex; // CPU frame the queries were issued in
+	};
+
+	// Reads one in-flight frame's results; false if any of them have not arrived yet
+	bool TryResolve(FrameQueries& frame);
+
+	GraphicsDevice* mDevice;
+	uint32_t mPassCount;
+	uint32_t mRingSize;
+
+	FrameQueries mFrames[MAX_RING_SIZE];
+	uint64_t mFrameIndex;    // CPU frames begun so far
+	uint64_t mIssueIndex;    // Timed frames issued so far; picks the ring slot
+	uint64_t mOldestPending; // Issue index of the oldest frame still in flight
+	bool bFrameActive;       // This frame's queries are being issued
+
+	double mLastPassMs[MAX_PASSES];
+	double mHistoryMs[MAX_PASSES][AVERAGE_FRAMES];
+	uint32_t mHistoryCount;
+	uint32_t mResultLatency;
+
+	uint64_t mResolvedFrames;
+	uint64_t mSkippedFrames;
+	uint64_t mDisjointFrames;
+};
+
+#endif // GPUPASSTIMER_H
@@ -0,0 +1,54 @@
+/************************************************************************************************
+ **	Name:        GradientKernels.h                                                             **
+ **	Description: Scalar, SSE2, AVX2 and AVX-512 row kernels for the gradient written by the CS **
+ **              entrypoint, with runtime selection of the widest one the CPU supports         **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                  **
+ **	Published:   <insert date>                                                                 **
+ ***********************************************************************************************/
+
+#ifndef GRADIENTKERNELS_H
+#define GRADIENTKERNELS_H
+
+#include <cstdint>
+
+// One channel of the D3D float -> UNORM8 conversion: saturate, scale by 255, round to nearest.
+// Written so that NaN fails both comparisons and lands on 0.
+inline uint32_t FloatToUNorm8(float value)
+{
+	if (!(value > 0.0f))
+	{
+		return 0;
+	}
+	if (!(value < 1.0f))
+	{
+		return 255;
+	}
+	return (uint32_t)(value * 255.0f + 0.5f);
+}
+
+enum KernelISA
+{
+	KERNEL_ISA_SCALAR,
+	KERNEL_ISA_SSE2,
+	KERNEL_ISA_AVX2,
+	KERNEL_ISA_AVX512,
+	KERNEL_ISA_COUNT
+};
+
+// Writes count texels of one row of the CS output, starting at column x:
+//     dst[i] = R8G8B8A8_UNORM(float4((x + i) * invWidth, y * invHeight, 0.5, 1.0))
+// Only red varies along a row, so the caller packs green, blue and alpha once per row into rowBits.
+// Every ISA produces bit-identical output to the scalar kernel, which uses FloatToUNorm8.
+typedef void (*GradientRowKernel)(uint32_t* dst, uint32_t x, uint32_t count, float invWidth, uint32_t rowBits);
+
+bool IsKernelISASupported(KernelISA isa);
+
+// Widest ISA the CPU and OS support
+KernelISA GetBestKernelISA();
+
+const char* GetKernelISAName(KernelISA isa);
+
+// Returns nullptr if the ISA is unsupported on this CPU or was not compiled in
+GradientRowKernel GetGradientRowKernel(KernelISA isa);
+
+#endif // GRADIENTKERNELS_H
@@ -0,0 +1,246 @@
+/************************************************************************************************
+ **	Name:        GraphicsDevice.h                                                              **
+ **	Description: Abstract graphics device the sample's frame logic is written against.         **
+ **              Implemented by D3D11GraphicsDevice and by the CPU reference CPUGraphicsDevice **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                  **
+ **	Published:   <insert date>                                                                 **
+ ***********************************************************************************************/
+
+#ifndef GRAPHICSDEVICE_H
+#define GRAPHICSDEVICE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct ImDrawData;
+class StartupTimer;
+
+// Opaque handles to device objects. 0 is the null handle; passing it to a Set call unbinds the slot.
+typedef uint32_t GfxHandle;
+typedef GfxHandle GfxTexture;
+typedef GfxHandle GfxView;
+typedef GfxHandle GfxBuffer;
+typedef GfxHandle GfxShader;
+typedef GfxHandle GfxInputLayout;
+typedef GfxHandle GfxQuery;
+
+#define GFX_NULL_HANDLE 0
+
+// Deepest CPU/GPU pipeline a device can be asked to run, in frames
+#define GFX_MAX_FRAMES_IN_FLIGHT 3
+
+enum GfxBindFlags
+{
+	GFX_BIND_SHADER_RESOURCE = 0x1,
+	GFX_BIND_UNORDERED_ACCESS = 0x2,
+	GFX_BIND_RENDER_TARGET = 0x4
+};
+
+enum GfxQueryType
+{
+	GFX_QUERY_TIMESTAMP,
+	GFX_QUERY_TIMESTAMP_DISJOINT
+};
+
+// Maps handles to backend objects. Handle i refers to slot i - 1, and released slots are reused.
+template <typename T>
+class GfxHandleTable
+{
+public:
+	GfxHandle Add(const T& object)
+	{
+		if (!mFreeSlots.empty())
+		{
+			uint32_t slot = mFreeSlots.back();
+			mFreeSlots.pop_back();
+			mObjects[slot] = object;
+			mLive[slot] = true;
+			return slot + 1;
+		}
+
+		mObjects.push_back(object);
+		mLive.push_back(true);
+		return (GfxHandle)mObjects.size();
+	}
+
+	bool IsValid(GfxHandle handle) const { return handle != GFX_NULL_HANDLE && handle <= mObjects.size() && mLive[handle - 1]; }
+
+	T& Get(GfxHandle handle) { return mObjects[handle - 1]; }
+	const T& Get(GfxHandle handle) const { return mObjects[handle - 1]; }
+
+	void Remove(GfxHandle handle)
+	{
+		mObjects[handle - 1] = T();
+		mLive[handle - 1] = false;
+		mFreeSlots.push_back(handle - 1);
+	}
+
+	// Visits every live object, e.g. to release everything at shutdown
+	template <typename Func>
+	void ForEach(Func func)
+	{
+		for (uint32_t slot = 0; slot < mObjects.size(); slot++)
+		{
+			if (mLive[slot])
+			{
+				func(slot + 1, mObjects[slot]);
+			}
+		}
+	}
+
+	void Clear()
+	{
+		mObjects.clear();
+		mLive.clear();
+		mFreeSlots.clear();
+	}
+
+private:
+	std::vector<T> mObjects;
+	std::vector<bool> mLive;
+	std::vector<uint32_t> mFreeSlots;
+};
+
+// The compute calls, shared by the immediate context and by deferred contexts recording command lists
+class GfxComputeContext
+{
+public:
+	virtual ~GfxComputeContext() {}
+
+	virtual bool IsUAVOverlapSupported() const = 0;
+
+	virtual void CSSetShader(GfxShader shader) = 0;
+	virtual void CSSetUnorderedAccessView(uint32_t slot, GfxView view) = 0;
+	virtual void CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer) = 0;
+	virtual void CSSetShaderResource(uint32_t slot, GfxView view) = 0;
+	virtual void Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ) = 0;
+
+	// Dispatch with groupsX, groupsY and groupsZ read as uint32s from an indirect argument buffer at byteOffset, when
+	// the call reaches the device timeline
+	virtual void DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset) = 0;
+
+	// Disables UAV syncs between the dispatches issued until EndUAVOverlap()
+	virtual void BeginUAVOverlap() = 0;
+	virtual void EndUAVOverlap() = 0;
+};
+
+// Records compute calls on another thread, the counterpart of an ID3D11DeviceContext created with
+// CreateDeferredContext. Each context starts out with nothing bound, and only one thread may record into it at a time.
+// Objects used by a recording must not be created or released while it is in progress.
+class GfxDeferredContext : public GfxComputeContext
+{
+public:
+	// Closes the calls made since the previous FinishCommandList() into the context's command list, replacing any
+	// list that has not been executed yet, and resets the context's bindings
+	virtual void FinishCommandList() = 0;
+};
+
+// Device plus immediate context. Every texture is DXGI_FORMAT_R8G8B8A8_UNORM, which is all the sample needs,
+// and method names follow the D3D11 calls they stand for.
+class GraphicsDevice : public GfxComputeContext
+{
+public:
+	virtual ~GraphicsDevice() {}
+
+	// Creates the device, plus a swap chain or an offscreen back buffer of the given size
+	virtual bool Init(uint32_t width, uint32_t height) = 0;
+	virtual void Cleanup() = 0;
+
+	// Init(), InitUI() and shader creation record their stages on timer, nested in whatever phase is open there, until
+	// it is set back to null. The timer must stay alive while it is set.
+	virtual void SetStartupTimer(StartupTimer* timer) = 0;
+
+	virtual const char* GetName() const = 0;
+
+	// Resource creation. Failures return GFX_NULL_HANDLE. Shader resource views can be of a texture or of a whole
+	// structured buffer.
+	virtual GfxTexture CreateTexture2D(uint32_t width, uint32_t height, uint32_t bindFlags) = 0;
+	virtual GfxView CreateShaderResourceView(GfxTexture texture) = 0;
+	virtual GfxView CreateUnorderedAccessView(GfxTexture texture) = 0;
+	virtual GfxView CreateRenderTargetView(GfxTexture texture) = 0;
+	virtual GfxBuffer CreateConstantBuffer(const void* data, uint32_t byteWidth) = 0;
+	virtual GfxBuffer CreateVertexBuffer(const void* data, uint32_t byteWidth) = 0;
+
+	// Immutable StructuredBuffer of count elements of stride bytes, read by shaders through a shader resource view
+	virtual GfxBuffer CreateStructuredBuffer(const void* data, uint32_t stride, uint32_t count) = 0;
+
+	// Buffer of DispatchIndirect arguments, three uint32s per dispatch. The GPU may also write it through a UAV.
+	virtual GfxBuffer CreateIndirectArgumentBuffer(const void* data, uint32_t byteWidth) = 0;
+
+	// Shaders are named after their source file in Shaders/, e.g. "ComputeShaderTile8"
+	virtual GfxShader CreateComputeShader(const char* name) = 0;
+	virtual GfxShader CreateVertexShader(const char* name) = 0;
+	virtual GfxShader CreatePixelShader(const char* name) = 0;
+
+	// Input layout for UAVOverlapSampleApp::SimpleVertex (float3 POSITION, float2 TEXCOORD)
+	virtual GfxInputLayout CreateInputLayout(GfxShader vertexShader) = 0;
+
+	virtual void Release(GfxHandle handle) = 0;
+
+	virtual GfxView GetBackBufferRTV() = 0;
+
+	// Resizes the swap chain buffers, or the offscreen back buffer, like IDXGISwapChain::ResizeBuffers. Waits for every
+	// frame in flight first and leaves no render target bound. GetBackBufferRTV() keeps returning the same handle, now
+	// a view of the new buffer. Returns false for a zero size.
+	virtual bool ResizeBuffers(uint32_t width, uint32_t height) = 0;
+
+	// Multithreaded recording. CreateDeferredContext() returns nullptr if the device can only record on the immediate
+	// context; contexts must be destroyed before Cleanup(). ExecuteCommandList() runs the list the context last finished,
+	// if any, and drops it. Like ExecuteCommandList(list, FALSE) on D3D11, it leaves nothing bound on the immediate context.
+	virtual std::unique_ptr<GfxDeferredContext> CreateDeferredContext() = 0;
+	virtual void ExecuteCommandList(GfxDeferredContext* context) = 0;
+
+	// Graphics
+	virtual void ClearRenderTargetView(GfxView view, const float color[4]) = 0;
+	virtual void OMSetRenderTarget(GfxView view) = 0;
+	virtual void RSSetViewport(float width, float height) = 0;
+	virtual void IASetInputLayout(GfxInputLayout layout) = 0;
+	virtual void IASetVertexBuffer(uint32_t slot, GfxBuffer buffer, uint32_t stride, uint32_t offset) = 0;
+	virtual void VSSetShader(GfxShader shader) = 0;
+	virtual void PSSetShader(GfxShader shader) = 0;
+	virtual void PSSetShaderResource(uint32_t slot, GfxView view) = 0;
+	virtual void Draw(uint32_t vertexCount, uint32_t startVertex) = 0;
+
+	// Timestamp queries. A timestamp is taken when End() is reached on the device timeline; a disjoint query brackets a
+	// frame's timestamps with Begin()/End() and reports their tick frequency. The Get calls never block: they return
+	// false until the result is available.
+	virtual GfxQuery CreateQuery(GfxQueryType type) = 0;
+	virtual void Begin(GfxQuery query) = 0;
+	virtual void End(GfxQuery query) = 0;
+	virtual bool GetTimestamp(GfxQuery query, uint64_t& ticks) = 0;
+	virtual bool GetTimestampDisjoint(GfxQuery query, uint64_t& frequency, bool& disjoint) = 0;
+
+	// ImGui platform and renderer backend hooks; the ImGui context itself is owned by the app
+	virtual void InitUI() = 0;
+	virtual void ShutdownUI() = 0;
+	virtual void NewUIFrame() = 0;
+	virtual void RenderUI(ImDrawData* drawData) = 0;
+
+	// Whether RenderUI leaves every binding as it found it. A renderer that owns the pipeline does not, and layers that
+	// cache bindings have to forget the ones it may change.
+	virtual bool IsUIStatePreserved() const = 0;
+
+	// Frame pacing. Every Present() ends a frame and signals its fence value: 1 for the first frame, 2 for the second and
+	// so on. Present() returns once no more than maxFramesInFlight - 1 earlier frames are still executing, so the CPU
+	// can record the next frame while the GPU works through the ones before it; with 1, every frame has finished by
+	// the time Present() returns. SetMaxFramesInFlight() takes 1 to GFX_MAX_FRAMES_IN_FLIGHT and must be called before Init().
+	virtual void SetMaxFramesInFlight(uint32_t count) = 0;
+	virtual uint32_t GetMaxFramesInFlight() const = 0;
+	virtual uint64_t GetSubmittedFrame() const = 0;
+
+	// Fence value of the newest frame that has finished executing, without blocking
+	virtual uint64_t GetCompletedFrame() = 0;
+
+	// Blocks until the frame has finished; frames not presented yet are treated as the last one presented
+	virtual void WaitForFrame(uint64_t frame) = 0;
+
+	// Presents the back buffer and throttles the CPU as described above. With an offscreen back buffer there is
+	// nothing to show, and only the throttling happens.
+	virtual void Present() = 0;
+
+	// Copies the back buffer to the CPU as packed RGBA8, red in the low byte, rows tightly packed
+	virtual bool ReadBackBuffer(std::vector<uint32_t>& texels) = 0;
+};
+
+#endif // GRAPHICSDEVICE_H
@@ -0,0 +1,95 @@
+/**************************************************************************************************
+ **	Name:        GraphicsDeviceDecorator.h                                                       **
+ **	Description: GraphicsDevice that forwards every call to another one. Recording and filtering **
+ **              layers derive from it and override only the calls they care about               **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                    **
+ **	Published:   <insert date>                                                                   **
+ *************************************************************************************************/
+
+#ifndef GRAPHICSDEVICEDECORATOR_H
+#define GRAPHICSDEVICEDECORATOR_H
+
+#include "GraphicsDevice.h"
+
+// The inner device must outlive the decorator. Handles are the inner device's own.
+class GraphicsDeviceDecorator : public GraphicsDevice
+{
+public:
+	explicit GraphicsDeviceDecorator(GraphicsDevice* inner) : mInner(inner) {}
+	virtual ~GraphicsDeviceDecorator() {}
+
+	GraphicsDevice* GetInner() { return mInner; }
+
+	virtual bool Init(uint32_t width, uint32_t height) { return mInner->Init(width, height); }
+	virtual void Cleanup() { mInner->Cleanup(); }
+	virtual void SetStartupTimer(StartupTimer* timer) { mInner->SetStartupTimer(timer); }
+
+	virtual const char* GetName() const { return mInner->GetName(); }
+	virtual bool IsUAVOverlapSupported() const { return mInner->IsUAVOverlapSupported(); }
+
+	virtual GfxTexture CreateTexture2D(uint32_t width, uint32_t height, uint32_t bindFlags) { return mInner->CreateTexture2D(width, height, bindFlags); }
+	virtual GfxView CreateShaderResourceView(GfxTexture texture) { return mInner->CreateShaderResourceView(texture); }
+	virtual GfxView CreateUnorderedAccessView(GfxTexture texture) { return mInner->CreateUnorderedAccessView(texture); }
+	virtual GfxView CreateRenderTargetView(GfxTexture texture) { return mInner->CreateRenderTargetView(texture); }
+	virtual GfxBuffer CreateConstantBuffer(const void* data, uint32_t byteWidth) { return mInner->CreateConstantBuffer(data, byteWidth); }
+	virtual GfxBuffer CreateVertexBuffer(const void* data, uint32_t byteWidth) { return mInner->CreateVertexBuffer(data, byteWidth); }
+	virtual GfxBuffer CreateStructuredBuffer(const void* data, uint32_t stride, uint32_t count) { return mInner->CreateStructuredBuffer(data, stride, count); }
+	virtual GfxBuffer CreateIndirectArgumentBuffer(const void* data, uint32_t byteWidth) { return mInner->CreateIndirectArgumentBuffer(data, byteWidth); }
+	virtual GfxShader CreateComputeShader(const char* name) { return mInner->CreateComputeShader(name); }
+	virtual GfxShader CreateVertexShader(const char* name) { return mInner->CreateVertexShader(name); }
+	virtual GfxShader CreatePixelShader(const char* name) { return mInner->CreatePixelShader(name); }
+	virtual GfxInputLayout CreateInputLayout(GfxShader vertexShader) { return mInner->CreateInputLayout(vertexShader); }
+	virtual void Release(GfxHandle handle) { mInner->Release(handle); }
+
+	virtual GfxView GetBackBufferRTV() { return mInner->GetBackBufferRTV(); }
+	virtual bool ResizeBuffers(uint32_t width, uint32_t height) { return mInner->ResizeBuffers(width, height); }
+
+	virtual void CSSetShader(GfxShader shader) { mInner->CSSetShader(shader); }
+	virtual void CSSetUnorderedAccessView(uint32_t slot, GfxView view) { mInner->CSSetUnorderedAccessView(slot, view); }
+	virtual void CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer) { mInner->CSSetConstantBuffer(slot, buffer); }
+	virtual void CSSetShaderResource(uint32_t slot, GfxView view) { mInner->CSSetShaderResource(slot, view); }
+	virtual void Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ) { mInner->Dispatch(groupsX, groupsY, groupsZ); }
+	virtual void DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset) { mInner->DispatchIndirect(arguments, byteOffset); }
+	virtual void BeginUAVOverlap() { mInner->BeginUAVOverlap(); }
+	virtual void EndUAVOverlap() { mInner->EndUAVOverlap(); }
+
+	// Deferred contexts record straight into the inner device's command lists
+	virtual std::unique_ptr<GfxDeferredContext> CreateDeferredContext() { return mInner->CreateDeferredContext(); }
+	virtual void ExecuteCommandList(GfxDeferredContext* context) { mInner->ExecuteCommandList(context); }
+
+	virtual void ClearRenderTargetView(GfxView view, const float color[4]) { mInner->ClearRenderTargetView(view, color); }
+	virtual void OMSetRenderTarget(GfxView view) { mInner->OMSetRenderTarget(view); }
+	virtual void RSSetViewport(float width, float height) { mInner->RSSetViewport(width, height); }
+	virtual void IASetInputLayout(GfxInputLayout layout) { mInner->IASetInputLayout(layout); }
+	virtual void IASetVertexBuffer(uint32_t slot, GfxBuffer buffer, uint32_t stride, uint32_t offset) { mInner->IASetVertexBuffer(slot, buffer, stride, offset); }
+	virtual void VSSetShader(GfxShader shader) { mInner->VSSetShader(shader); }
+	virtual void PSSetShader(GfxShader shader) { mInner->PSSetShader(shader); }
+	virtual void PSSetShaderResource(uint32_t slot, GfxView view) { mInner->PSSetShaderResource(slot, view); }
+	virtual void Draw(uint32_t vertexCount, uint32_t startVertex) { mInner->Draw(vertexCount, startVertex); }
+
+	virtual GfxQuery CreateQuery(GfxQueryType type) { return mInner->CreateQuery(type); }
+	virtual void Begin(GfxQuery query) { mInner->Begin(query); }
+	virtual void End(GfxQuery query) { mInner->End(query); }
+	virtual bool GetTimestamp(GfxQuery query, uint64_t& ticks) { return mInner->GetTimestamp(query, ticks); }
+	virtual bool GetTimestampDisjoint(GfxQuery query, uint64_t& frequency, bool& disjoint) { return mInner->GetTimestampDisjoint(query, frequency, disjoint); }
+
+	virtual void InitUI() { mInner->InitUI(); }
+	virtual void ShutdownUI() { mInner->ShutdownUI(); }
+	virtual void NewUIFrame() { mInner->NewUIFrame(); }
+	virtual void RenderUI(ImDrawData* drawData) { mInner->RenderUI(drawData); }
+	virtual bool IsUIStatePreserved() const { return mInner->IsUIStatePreserved(); }
+
+	virtual void SetMaxFramesInFlight(uint32_t count) { mInner->SetMaxFramesInFlight(count); }
+	virtual uint32_t GetMaxFramesInFlight() const { return mInner->GetMaxFramesInFlight(); }
+	virtual uint64_t GetSubmittedFrame() const { return mInner->GetSubmittedFrame(); }
+	virtual uint64_t GetCompletedFrame() { return mInner->GetCompletedFrame(); }
+	virtual void WaitForFrame(uint64_t frame) { mInner->WaitForFrame(frame); }
+
+	virtual void Present() { mInner->Present(); }
+	virtual bool ReadBackBuffer(std::vector<uint32_t>& texels) { return mInner->ReadBackBuffer(texels); }
+
+protected:
+	GraphicsDevice* mInner;
+};
+
+#endif // GRAPHICSDEVICEDECORATOR_H
@@ -0,0 +1,85 @@
+/******************************************************************************************
+ **	Name:        HeadlessRun.h                                                           **
+ **	Description: Command line options and frame timing summary for headless (windowless, **
+ **              swap-chain-less) runs of the sample                                     **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                            **
+ **	Published:   <insert date>                                                           **
+ *****************************************************************************************/
+
+#ifndef HEADLESSRUN_H
+#define HEADLESSRUN_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ComputeWorkload.h"
+
+struct HeadlessOptions
+{
+	bool bHeadless;               // --headless
+	uint32_t frameCount;          // --frames N
+	uint32_t width;               // --width N
+	uint32_t height;              // --height N
+	uint32_t tileSize;            // --tile 8|16|32
+	bool bUseUAVOverlap;          // --overlap
+	bool bAutoUAVOverlap;         // --auto-overlap, brackets only runs of dispatches checked to write disjoint tiles
+	bool bUseBatchedDispatch;     // --batched
+	bool bUseIndirectDispatch;    // --indirect, one DispatchIndirect over a tile list; takes precedence over --batched
+	bool bUseStateFilter;         // Cleared by --no-state-filter, which sends redundant state changes to the device
+	uint32_t threadCount;         // --threads N, CPU backend only; 0 = one per hardware thread
+	bool bRasterizeUI;            // --ui, CPU backend only: draws the ImGui overlay into the frame, as D3D11 always does
+	bool bUIOwnedPipeline;        // --ui-owned-pipeline, D3D11 only: the ImGui backend skips its state backup and restore
+	uint32_t recordThreadCount;   // --record-threads N, records the per-tile dispatches on N deferred contexts; 0 = immediate context
+	uint32_t framesInFlight;      // --frames-in-flight 1|2|3, frames the CPU may run ahead of the device
+	ComputeWorkload workload;     // --workload preset|alu=N+reads=N+coverage=N+reduce+irregular, runs ComputeWorkload.hlsl per tile
+	std::string outputPath;       // --output file.ppm, writes the last rendered frame
+	std::string frameStatsPath;   // --frame-stats file.csv|file.json, writes the frame time histogram on exit
+	std::string capturePath;      // --capture file.uavc, records every device call for UAVOverlapReplay
+	uint32_t captureFrames;       // --capture-frames N, frames recorded after setup; 0 = the whole run
+	std::vector<uint32_t> resizeWidths;  // --resize WxH,WxH,..., render sizes the run cycles through
+	std::vector<uint32_t> resizeHeights;
+	uint32_t resizeInterval;      // --resize-interval N, frames between resizes
+	uint32_t startupBenchRuns;    // --startup-bench N, starts and cleans up the sample N times, reports each phase and exits; 0 = off
+	std::string startupTracePath; // --startup-trace file.json, writes the Init() phases (of every run under --startup-bench) as a Chrome trace
+};
+
+// Fills options with defaults (1280x720, 16x16 tiles, 100 frames, windowed, state filter on, one captured frame, one frame in flight, the
+// gradient shader rather than a workload, no resizes, 10 frames between resizes, no overlay on the CPU backend, no startup bench or trace) and then applies any recognised arguments.
+// Returns false if an argument is unknown or malformed.
+bool ParseHeadlessOptions(const std::vector<std::string>& args, HeadlessOptions& options);
+
+// Parses a whole argument as an unsigned decimal integer
+bool ParseUIntArgument(const std::string& text, uint32_t& value);
+
+// Parses WIDTHxHEIGHT, both non-zero
+bool ParseResolution(const std::string& text, uint32_t& width, uint32_t& height);
+
+// Render size a --resize run switches to before frame, if any: the next size in the list every resizeInterval frames
+bool GetHeadlessResize(const HeadlessOptions& options, uint32_t frame, uint32_t& width, uint32_t& height);
+
+// Min/mean/max over every frame of a headless run
+class HeadlessFrameStats
+{
+public:
+	HeadlessFrameStats() : mFrameCount(0), mTotalMs(0.0), mMinMs(0.0), mMaxMs(0.0) {}
+
+	void AddFrame(double frameTimeMs);
+
+	uint32_t GetFrameCount() const { return mFrameCount; }
+	double GetMeanMs() const { return mFrameCount ? mTotalMs / mFrameCount : 0.0; }
+
+	void Print(FILE* file, const HeadlessOptions& options, const char* backendName) const;
+
+private:
+	uint32_t mFrameCount;
+	double mTotalMs;
+	double mMinMs;
+	double mMaxMs;
+};
+
+// Writes a packed RGBA8 image (red in the low byte) as a binary PPM, dropping alpha
+bool WriteRGBA8ToPPM(const char* path, const uint32_t* texels, uint32_t width, uint32_t height, uint32_t rowPitchInTexels);
+
+#endif // HEADLESSRUN_H
@@ -0,0 +1,56 @@
+/*********************************************************************************************
+ **	Name:        IntelExtensions.h                                                          **
+ **	Description: Includes igdext.h on any platform and wraps the Intel Extensions Framework **
+ **              setup shared by the D3D11 and CPU graphics devices                         **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                               **
+ **	Published:   <insert date>                                                              **
+ ********************************************************************************************/
+
+#ifndef INTELEXTENSIONS_H
+#define INTELEXTENSIONS_H
+
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <d3d11.h>
+#else
+// igdext.h is written against the Windows SDK; elsewhere only the handful of types it names are declared
+typedef int32_t HRESULT;
+typedef int BOOL;
+typedef unsigned int UINT;
+typedef float FLOAT;
+
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+struct ID3D11Buffer;
+struct ID3D11Texture2D;
+struct D3D11_TEXTURE2D_DESC;
+struct D3D11_SUBRESOURCE_DATA;
+
+#define S_OK            ((HRESULT)0)
+#define E_FAIL          ((HRESULT)0x80004005)
+#define E_INVALIDARG    ((HRESULT)0x80070057)
+#define E_OUTOFMEMORY   ((HRESULT)0x8007000E)
+#define SUCCEEDED(hr)   (((HRESULT)(hr)) >= 0)
+#define FAILED(hr)      (((HRESULT)(hr)) < 0)
+#endif
+
+#ifndef INTC_IGDEXT_D3D11
+#define INTC_IGDEXT_D3D11
+#endif
+
+#include "igdext.h"
+
+// Oldest extension interface version with BeginUAVOverlap/EndUAVOverlap
+#define INTC_UAV_OVERLAP_REQUIRED_VERSION { 1, 2, 0 }
+
+// Loads the extensions library, picks the first supported version at or above INTC_UAV_OVERLAP_REQUIRED_VERSION
+// and creates a device extension context. On failure the library is unloaded again and false is returned.
+bool CreateIntelExtensionContext(ID3D11Device* device, INTCExtensionContext** context);
+
+// Destroys a context made by CreateIntelExtensionContext and unloads the library. A null context is ignored.
+// Returns false if the framework failed to destroy the context.
+bool DestroyIntelExtensionContext(INTCExtensionContext** context);
+
+#endif // INTELEXTENSIONS_H
@@ -0,0 +1,72 @@
+/***********************************************************************************************
+ **	Name:        IntelExtensionsStub.h                                                        **
+ **	Description: Stand-in for the igdext runtime on hosts without Intel drivers. Records call **
+ **              counts and timing per entrypoint, serves a configurable supported-version    **
+ **              list, injects failures, and forwards UAV overlap brackets to a handler       **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                 **
+ **	Published:   <insert date>                                                                **
+ **********************************************************************************************/
+
+#ifndef INTELEXTENSIONSSTUB_H
+#define INTELEXTENSIONSSTUB_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "IntelExtensions.h"
+
+// Only the entrypoints the sample calls are implemented; the MultiDraw, depth bounds and texture extensions are not
+enum INTCStubEntrypoint
+{
+	INTC_STUB_LOAD_LIBRARY,             // INTC_LoadExtensionsLibrary
+	INTC_STUB_UNLOAD_LIBRARY,           // INTC_UnloadExtensionsLibrary
+	INTC_STUB_GET_SUPPORTED_VERSIONS,   // INTC_D3D11_GetSupportedVersions
+	INTC_STUB_CREATE_CONTEXT,           // INTC_D3D11_CreateDeviceExtensionContext
+	INTC_STUB_DESTROY_CONTEXT,          // INTC_DestroyDeviceExtensionContext
+	INTC_STUB_BEGIN_UAV_OVERLAP,        // INTC_D3D11_BeginUAVOverlap
+	INTC_STUB_END_UAV_OVERLAP,          // INTC_D3D11_EndUAVOverlap
+	INTC_STUB_ENTRYPOINT_COUNT
+};
+
+struct INTCStubCallStats
+{
+	uint64_t callCount;
+	uint64_t failureCount;  // Injected failures plus calls rejected for bad arguments or state
+	double totalMs;         // Time spent inside the stub itself; the overlap handler is not included
+};
+
+// Called from INTC_D3D11_BeginUAVOverlap (begin = true) and INTC_D3D11_EndUAVOverlap (begin = false)
+typedef void (*INTCStubOverlapHandler)(void* userData, bool begin);
+
+// Restores the default configuration (a single supported version 1.2.0, no injected failures) and clears the stats.
+// Like the immediate context it stands in for, the stub is not thread-safe.
+void INTCStub_Reset();
+
+void INTCStub_SetSupportedVersions(const std::vector<INTCExtensionVersion>& versions);
+
+// Makes the entrypoint return result once it has succeeded skipCalls more times, until cleared.
+// Void entrypoints (unload) only count the failure.
+void INTCStub_SetFailure(INTCStubEntrypoint entrypoint, HRESULT result, uint32_t skipCalls = 0);
+void INTCStub_ClearFailures();
+
+void INTCStub_SetOverlapHandler(INTCExtensionContext* context, INTCStubOverlapHandler handler, void* userData);
+
+// Nesting depth of BeginUAVOverlap on the context: 0 outside a bracket, 1 inside
+uint32_t INTCStub_GetOverlapDepth(const INTCExtensionContext* context);
+
+INTCStubCallStats INTCStub_GetCallStats(INTCStubEntrypoint entrypoint);
+void INTCStub_ResetCallStats();
+
+// The igdext function name for an entrypoint, and the short names accepted on the command line
+// ("load", "unload", "versions", "create", "destroy", "begin", "end")
+const char* INTCStub_GetEntrypointName(INTCStubEntrypoint entrypoint);
+bool INTCStub_ParseEntrypoint(const std::string& name, INTCStubEntrypoint& entrypoint);
+
+// Parses a comma-separated version list such as "1.2.0,1.1.0"
+bool INTCStub_ParseVersionList(const std::string& text, std::vector<INTCExtensionVersion>& versions);
+
+// One line per entrypoint that was called
+void INTCStub_PrintCallStats(FILE* file);
+
+#endif // INTELEXTENSIONSSTUB_H
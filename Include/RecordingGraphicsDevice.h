@@ -0,0 +1,94 @@
+/*****************************************************************************************************
+ **	Name:        RecordingGraphicsDevice.h                                                          **
+ **	Description: GraphicsDevice decorator that encodes every call it forwards into a CommandStream, **
+ **              so a run can be captured to disk and replayed or analyzed later                    **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                       **
+ **	Published:   <insert date>                                                                      **
+ ****************************************************************************************************/
+
+#ifndef RECORDINGGRAPHICSDEVICE_H
+#define RECORDINGGRAPHICSDEVICE_H
+
+#include "CommandStream.h"
+#include "GraphicsDeviceDecorator.h"
+
+// Records from construction until maxFrames Presents have been captured (0 records until destruction), so a capture
+// holds the device setup followed by that many whole frames. Reads (timestamps, back buffer) are not recorded, and
+// RenderUI records only that it was called.
+class RecordingGraphicsDevice : public GraphicsDeviceDecorator
+{
+public:
+	RecordingGraphicsDevice(GraphicsDevice* inner, uint32_t maxFrames = 1);
+
+	const std::vector<uint8_t>& GetCommandStream() const { return mWriter.GetData(); }
+	uint32_t GetRecordedFrameCount() const { return mRecordedFrames; }
+	bool IsRecording() const { return mMaxFrames == 0 || mRecordedFrames < mMaxFrames; }
+
+	bool WriteToFile(const char* path) const { return WriteCommandStreamFile(path, mWriter.GetData()); }
+
+	virtual bool Init(uint32_t width, uint32_t height);
+	virtual void Cleanup();
+
+	virtual GfxTexture CreateTexture2D(uint32_t width, uint32_t height, uint32_t bindFlags);
+	virtual GfxView CreateShaderResourceView(GfxTexture texture);
+	virtual GfxView CreateUnorderedAccessView(GfxTexture texture);
+	virtual GfxView CreateRenderTargetView(GfxTexture texture);
+	virtual GfxBuffer CreateConstantBuffer(const void* data, uint32_t byteWidth);
+	virtual GfxBuffer CreateVertexBuffer(const void* data, uint32_t byteWidth);
+	virtual GfxBuffer CreateStructuredBuffer(const void* data, uint32_t stride, uint32_t count);
+	virtual GfxBuffer CreateIndirectArgumentBuffer(const void* data, uint32_t byteWidth);
+	virtual GfxShader CreateComputeShader(const char* name);
+	virtual GfxShader CreateVertexShader(const char* name);
+	virtual GfxShader CreatePixelShader(const char* name);
+	virtual GfxInputLayout CreateInputLayout(GfxShader vertexShader);
+	virtual void Release(GfxHandle handle);
+
+	virtual GfxView GetBackBufferRTV();
+	virtual bool ResizeBuffers(uint32_t width, uint32_t height);
+
+	virtual void CSSetShader(GfxShader shader);
+	virtual void CSSetUnorderedAccessView(uint32_t slot, GfxView view);
+	virtual void CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer);
+	virtual void CSSetShaderResource(uint32_t slot, GfxView view);
+	virtual void Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ);
+	virtual void DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset);
+	virtual void BeginUAVOverlap();
+	virtual void EndUAVOverlap();
+
+	// Calls made on a deferred context would bypass the capture, so none are handed out and callers record on the
+	// immediate context instead
+	virtual std::unique_ptr<GfxDeferredContext> CreateDeferredContext() { return nullptr; }
+
+	virtual void ClearRenderTargetView(GfxView view, const float color[4]);
+	virtual void OMSetRenderTarget(GfxView view);
+	virtual void RSSetViewport(float width, float height);
+	virtual void IASetInputLayout(GfxInputLayout layout);
+	virtual void IASetVertexBuffer(uint32_t slot, GfxBuffer buffer, uint32_t stride, uint32_t offset);
+	virtual void VSSetShader(GfxShader shader);
+	virtual void PSSetShader(GfxShader shader);
+	virtual void PSSetShaderResource(uint32_t slot, GfxView view);
+	virtual void Draw(uint32_t vertexCount, uint32_t startVertex);
+
+	virtual GfxQuery CreateQuery(GfxQueryType type);
+	virtual void Begin(GfxQuery query);
+	virtual void End(GfxQuery query);
+
+	virtual void InitUI();
+	virtual void ShutdownUI();
+	virtual void NewUIFrame();
+	virtual void RenderUI(ImDrawData* drawData);
+
+	virtual void Present();
+
+private:
+	// Writes the opcode and returns true while recording; arguments follow only when it returns true
+	bool Record(CommandOpcode opcode);
+	void Record(CommandOpcode opcode, uint32_t a);
+	void Record(CommandOpcode opcode, uint32_t a, uint32_t b);
+
+	CommandStreamWriter mWriter;
+	uint32_t mMaxFrames;
+	uint32_t mRecordedFrames;
+};
+
+#endif // RECORDINGGRAPHICSDEVICE_H
@@ -0,0 +1,60 @@
+/**************************************************************************************************************
+ **	Name:        ResizePlan.h                                                                                **
+ **	Description: Works out which render-size dependent resources a resize has to rebuild, with pooled        **
+ **              sample textures that are reused when the render size shrinks, and the resize latency report **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                **
+ **	Published:   <insert date>                                                                               **
+ *************************************************************************************************************/
+
+#ifndef RESIZEPLAN_H
+#define RESIZEPLAN_H
+
+#include <cstdint>
+#include <cstdio>
+
+// What changing the render size from width x height to newWidth x newHeight rebuilds. The sample textures are a pool:
+// they are allocated at least as large as the render size and written from the top-left corner, so shrinking, or
+// growing back within the allocation, keeps them and only changes the part of them the fullscreen triangle samples.
+struct ResizePlan
+{
+	uint32_t width;               // Render size after the resize
+	uint32_t height;
+	uint32_t allocatedWidth;      // Sample texture size after the resize
+	uint32_t allocatedHeight;
+	bool bResizeBuffers;          // Swap chain or offscreen back buffer; false when the size does not change at all
+	bool bReallocateTextures;     // Sample textures and their views
+	bool bUpdateTexCoords;        // Fullscreen triangle, when the render size becomes a different part of the allocation
+	bool bRebuildTiles;           // Tile grid, per-tile and batched constant buffers, tile list and indirect arguments
+	bool bRebuildSource;          // Workload source texture; the shaders wrap their reads at its size
+};
+
+// The allocation grows to cover the new size in both dimensions. It is trimmed to exactly the new size when that
+// would leave more than three quarters of it unused, so a long stay at a low resolution does not hold the memory of
+// the highest one.
+ResizePlan PlanResize(uint32_t width, uint32_t height, uint32_t allocatedWidth, uint32_t allocatedHeight, uint32_t newWidth, uint32_t newHeight);
+
+// Resize count and CPU latency, from the call until every rebuilt resource exists, and how often the pool was reused
+class ResizeReport
+{
+public:
+	ResizeReport() : mCount(0), mReallocationCount(0), mTotalMs(0.0), mLastMs(0.0), mMaxMs(0.0) {}
+
+	void Record(const ResizePlan& plan, double latencyMs);
+
+	uint32_t GetCount() const { return mCount; }
+	uint32_t GetReallocationCount() const { return mReallocationCount; }
+	double GetMeanMs() const { return mCount ? mTotalMs / mCount : 0.0; }
+	double GetLastMs() const { return mLastMs; }
+	double GetMaxMs() const { return mMaxMs; }
+
+	void Print(FILE* file) const;
+
+private:
+	uint32_t mCount;
+	uint32_t mReallocationCount;
+	double mTotalMs;
+	double mLastMs;
+	double mMaxMs;
+};
+
+#endif // RESIZEPLAN_H
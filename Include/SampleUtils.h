@@ -0,0 +1,24 @@
+/********************************************************************************************
+ **	Name:        SampleUtils.h                                                             **
+ **	Description: Small platform helpers shared by the Windows and CPU builds of the sample **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                              **
+ **	Published:   <insert date>                                                             **
+ *******************************************************************************************/
+
+#ifndef SAMPLEUTILS_H
+#define SAMPLEUTILS_H
+
+#include <cstdio>
+
+// fopen is deprecated under MSVC's /sdl checks, fopen_s does not exist elsewhere
+inline FILE* OpenFile(const char* path, const char* mode)
+{
+#ifdef _MSC_VER
+	FILE* file = nullptr;
+	return (fopen_s(&file, path, mode) == 0) ? file : nullptr;
+#else
+	return fopen(path, mode);
+#endif
+}
+
+#endif // SAMPLEUTILS_H
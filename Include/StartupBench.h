@@ -0,0 +1,47 @@
+/*****************************************************************************************************************
+ **	Name:        StartupBench.h                                                                                 **
+ **	Description: Repeated cold starts of the sample for --startup-bench: device creation, Init(), Cleanup() and **
+ **              device destruction timed phase by phase, and summarized over the runs                          **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                   **
+ **	Published:   <insert date>                                                                                  **
+ ****************************************************************************************************************/
+
+#ifndef STARTUPBENCH_H
+#define STARTUPBENCH_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "BenchmarkRunner.h"
+#include "HeadlessRun.h"
+#include "StartupTimer.h"
+
+// One phase over every run it appears in. Phases are matched between runs by their path, the names of the phases
+// enclosing them and their own, so the same step in two places is reported twice.
+struct StartupPhaseSummary
+{
+	std::string path;             // Names from the top level down, separated by '/'
+	std::string name;
+	uint32_t depth;
+	uint32_t runCount;            // Runs that ended this phase
+	double firstMs;               // First run that has it, the coldest
+	double meanMs;                // Over the later runs, or the first run when it is the only one
+	double minMs;
+	double maxMs;
+};
+
+// Starts the sample options.startupBenchRuns times, each with a fresh device from createDevice. Each run's timer has
+// the top-level phases "device constructor", "Init()", "Cleanup()" and "device destructor", with the app's and the
+// device's phases nested in "Init()". Prints a line per run and the summary to log, and writes the runs to
+// options.startupTracePath when it is set. Returns false if any Init() failed or the trace was not written; every
+// run is still made.
+bool RunStartupBench(const HeadlessOptions& options, const GraphicsDeviceFactory& createDevice, FILE* log, std::vector<StartupTimer>& runs);
+
+// Phases in the order they first appear
+void SummarizeStartupRuns(const std::vector<StartupTimer>& runs, std::vector<StartupPhaseSummary>& summary);
+
+void PrintStartupSummary(FILE* file, const std::vector<StartupPhaseSummary>& summary);
+
+#endif // STARTUPBENCH_H
@@ -0,0 +1,94 @@
+/****************************************************************************************************************
+ **	Name:        StartupTimer.h                                                                                **
+ **	Description: Times the stages of startup, nested, on a monotonic clock, reports the time spent in each and **
+ **              writes them as a Chrome trace                                                                 **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                  **
+ **	Published:   <insert date>                                                                                 **
+ ***************************************************************************************************************/
+
+#ifndef STARTUPTIMER_H
+#define STARTUPTIMER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "FrameTimeHistogram.h"
+
+// Phases are recorded in the order they begin. A phase begun while another is open is nested in it, one level deeper,
+// and its time is also part of the outer phase's.
+class StartupTimer
+{
+public:
+	struct Phase
+	{
+		std::string name;
+		uint32_t depth;               // 0 for top-level phases
+		uint64_t startNs;             // From the first BeginPhase() since construction or Reset()
+		uint64_t durationNs;
+		bool bOpen;                   // Not ended yet; durationNs is 0
+	};
+
+	explicit StartupTimer(FrameClockFn clock = SteadyClockNanoseconds);
+
+	void BeginPhase(const char* name);
+
+	// Ends the innermost open phase; does nothing when none is open
+	void EndPhase();
+
+	void Reset();
+
+	// Adds the phases of other, which must read the same clock, where they happened on this timer's timeline and
+	// nested in the phases open here. Phases still open in other stay open, but cannot be ended through this timer.
+	void Append(const StartupTimer& other);
+
+	const std::vector<Phase>& GetPhases() const { return mPhases; }
+
+	// Sum of the ended top-level phases
+	uint64_t GetTotalNs() const;
+	double GetTotalMs() const { return GetTotalNs() / 1.0e6; }
+
+	// One line per ended phase, indented by depth, with its time and its share of the total
+	void PrintReport(FILE* file) const;
+
+private:
+	FrameClockFn mClock;
+	uint64_t mOriginNs;
+	std::vector<Phase> mPhases;
+	std::vector<uint32_t> mOpenPhases;       // Indices into mPhases, innermost last
+};
+
+// For code that may run with or without a timer, e.g. a device whose owner did not ask for startup phases
+inline void BeginStartupPhase(StartupTimer* timer, const char* name)
+{
+	if (timer != nullptr)
+	{
+		timer->BeginPhase(name);
+	}
+}
+
+inline void EndStartupPhase(StartupTimer* timer)
+{
+	if (timer != nullptr)
+	{
+		timer->EndPhase();
+	}
+}
+
+// Times a scope as one phase; a null timer times nothing
+class StartupPhaseScope
+{
+public:
+	StartupPhaseScope(StartupTimer* timer, const char* name) : mTimer(timer) { BeginStartupPhase(mTimer, name); }
+	~StartupPhaseScope() { EndStartupPhase(mTimer); }
+
+private:
+	StartupTimer* mTimer;
+};
+
+// Writes the ended phases of every run as complete ("X") events in the Chrome trace event format, which
+// chrome://tracing and Perfetto load. Each run is a thread of its own, starting at 0, so runs line up for comparison.
+bool WriteStartupTrace(const char* path, const std::vector<StartupTimer>& runs);
+
+#endif // STARTUPTIMER_H
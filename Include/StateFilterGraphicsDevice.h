@@ -0,0 +1,119 @@
+/************************************************************************************************
+ **	Name:        StateFilterGraphicsDevice.h                                                   **
+ **	Description: GraphicsDevice decorator that caches the bound pipeline state and drops calls **
+ **              that would rebind what is already bound                                       **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                  **
+ **	Published:   <insert date>                                                                 **
+ ***********************************************************************************************/
+
+#ifndef STATEFILTERGRAPHICSDEVICE_H
+#define STATEFILTERGRAPHICSDEVICE_H
+
+#include "GraphicsDeviceDecorator.h"
+
+#include <unordered_map>
+
+// Tracks the shaders, UAVs, SRVs, constant buffers, render target, viewport and input assembler state bound through
+// it, and forwards a Set call only when it changes that state. Follows the D3D11 hazard rules where a cached binding
+// can go stale behind its back: binding a texture for output unbinds its SRVs, and an SRV of a texture bound for
+// output is bound as null. Released handles, and the render target across Present, are forgotten rather than assumed,
+// so the next Set of that state is always forwarded. RenderUI normally leaves the cache alone: the ImGui DX11 renderer
+// restores every binding it changes, and the CPU one changes none. When the device's UI renderer owns the pipeline
+// instead, the bindings it shares with the app are forgotten after it.
+class StateFilterGraphicsDevice : public GraphicsDeviceDecorator
+{
+public:
+	// Slots beyond these are not cached; calls on them are always forwarded
+	static const uint32_t MAX_UAV_SLOTS = 8;
+	static const uint32_t MAX_CONSTANT_BUFFER_SLOTS = 14;
+	static const uint32_t MAX_SRV_SLOTS = 16;
+	static const uint32_t MAX_VERTEX_BUFFER_SLOTS = 16;
+
+	explicit StateFilterGraphicsDevice(GraphicsDevice* inner);
+
+	uint64_t GetForwardedCount() const { return mForwardedCount; }
+	uint64_t GetFilteredCount() const { return mFilteredCount; }
+	void ResetCounters() { mForwardedCount = 0; mFilteredCount = 0; }
+
+	// Forgets every cached binding, for when the inner device has been used directly
+	void Invalidate();
+
+	virtual bool Init(uint32_t width, uint32_t height);
+	virtual void Cleanup();
+
+	virtual GfxView CreateShaderResourceView(GfxTexture texture);
+	virtual GfxView CreateUnorderedAccessView(GfxTexture texture);
+	virtual GfxView CreateRenderTargetView(GfxTexture texture);
+	virtual void Release(GfxHandle handle);
+
+	// The device leaves no render target bound
+	virtual bool ResizeBuffers(uint32_t width, uint32_t height);
+
+	virtual void CSSetShader(GfxShader shader);
+	virtual void CSSetUnorderedAccessView(uint32_t slot, GfxView view);
+	virtual void CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer);
+
+	// Not cached: the sample binds buffer views here, which the texture hazard rules above do not cover
+	virtual void CSSetShaderResource(uint32_t slot, GfxView view);
+
+	// Command lists leave the immediate context with nothing bound. Deferred contexts themselves are not filtered.
+	virtual void ExecuteCommandList(GfxDeferredContext* context);
+
+	virtual void OMSetRenderTarget(GfxView view);
+	virtual void RSSetViewport(float width, float height);
+	virtual void IASetInputLayout(GfxInputLayout layout);
+	virtual void IASetVertexBuffer(uint32_t slot, GfxBuffer buffer, uint32_t stride, uint32_t offset);
+	virtual void VSSetShader(GfxShader shader);
+	virtual void PSSetShader(GfxShader shader);
+	virtual void PSSetShaderResource(uint32_t slot, GfxView view);
+
+	// Forgets the compute shader, viewport, input layout, vertex buffer 0, vertex and pixel shaders and SRV 0 when the
+	// inner device does not preserve them
+	virtual void RenderUI(ImDrawData* drawData);
+
+	virtual void Present();
+
+private:
+	// Cached value of a binding the filter cannot vouch for
+	static const GfxHandle UNKNOWN_HANDLE = 0xFFFFFFFF;
+
+	struct VertexBufferBinding
+	{
+		GfxBuffer buffer;
+		uint32_t stride;
+		uint32_t offset;
+	};
+
+	// Returns true, and counts the call as filtered, if cached already holds value; otherwise stores it
+	bool IsRedundant(GfxHandle& cached, GfxHandle value);
+	void CountForwarded() { mForwardedCount++; }
+
+	// Sets every cached binding to value: UNKNOWN_HANDLE, or GFX_NULL_HANDLE for a freshly initialized device
+	void ResetBindings(GfxHandle value);
+	// Forgets the SRV slots bound to texture; GFX_NULL_HANDLE stands for a texture that could be any of them
+	void UnbindShaderResources(GfxTexture texture);
+	bool IsBoundForOutput(GfxTexture texture) const;
+	GfxTexture GetViewTexture(GfxView view) const;
+
+	GfxShader mComputeShader;
+	GfxView mUAVs[MAX_UAV_SLOTS];
+	GfxBuffer mConstantBuffers[MAX_CONSTANT_BUFFER_SLOTS];
+
+	GfxView mRenderTarget;
+	bool bViewportKnown;
+	float mViewportWidth;
+	float mViewportHeight;
+	GfxInputLayout mInputLayout;
+	VertexBufferBinding mVertexBuffers[MAX_VERTEX_BUFFER_SLOTS];
+	GfxShader mVertexShader;
+	GfxShader mPixelShader;
+	GfxView mSRVs[MAX_SRV_SLOTS];
+
+	// Texture of every view created through the filter, for the hazard rules
+	std::unordered_map<GfxView, GfxTexture> mViewTextures;
+
+	uint64_t mForwardedCount;
+	uint64_t mFilteredCount;
+};
+
+#endif // STATEFILTERGRAPHICSDEVICE_H
@@ -0,0 +1,78 @@
+/******************************************************************************************
+ **	Name:        ThreadPool.h                                                            **
+ **	Description: Work-stealing thread pool used to spread CPU thread groups across cores **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                            **
+ **	Published:   <insert date>                                                           **
+ *****************************************************************************************/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+	typedef std::function<void()> Task;
+	typedef std::function<void(uint32_t begin, uint32_t end)> RangeTask;
+
+	// A thread count of 0 creates one worker per hardware thread
+	explicit ThreadPool(uint32_t numThreads = 0);
+	~ThreadPool();
+
+	uint32_t GetThreadCount() const { return (uint32_t)mWorkers.size(); }
+
+	// Tasks are dealt round-robin onto the per-worker queues. A worker pops from the back of its own queue
+	// and, once that runs dry, steals from the front of its peers' queues.
+	void Submit(Task task);
+
+	// Blocks the calling thread until every submitted task has finished
+	void Wait();
+
+	// Splits [0, count) into chunks of grainSize items, runs func(begin, end) for each chunk and waits for all of them.
+	// A grainSize of 0 picks a chunk size that gives every worker several chunks to balance with.
+	void ParallelFor(uint32_t count, uint32_t grainSize, const RangeTask& func);
+
+	uint64_t GetStealCount() const { return mStealCount.load(); }
+
+	// Time each worker has spent executing tasks since the last ResetWorkerStats()
+	double GetWorkerBusySeconds(uint32_t workerIndex) const;
+	void ResetWorkerStats();
+
+private:
+	struct WorkerQueue
+	{
+		std::mutex lock;
+		std::deque<Task> tasks;
+		std::atomic<uint64_t> busyNanoseconds;
+
+		WorkerQueue() : busyNanoseconds(0) {}
+	};
+
+	void WorkerMain(uint32_t workerIndex);
+	bool PopTask(uint32_t workerIndex, Task& task);
+
+	std::vector<std::thread> mWorkers;
+	std::vector<std::unique_ptr<WorkerQueue>> mQueues;
+
+	std::mutex mSleepLock;
+	std::condition_variable mWakeCondition;
+	std::condition_variable mIdleCondition;
+
+	std::atomic<uint32_t> mNextQueue;
+	std::atomic<uint32_t> mQueuedTasks;
+	std::atomic<uint32_t> mPendingTasks;
+	std::atomic<uint64_t> mStealCount;
+
+	bool bShutdown;
+};
+
+#endif // THREADPOOL_H
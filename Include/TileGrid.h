@@ -0,0 +1,60 @@
+/***********************************************************************************************
+ **	Name:        TileGrid.h                                                                   **
+ **	Description: Resolution-independent grid of square compute tiles covering a render target **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                 **
+ **	Published:   <insert date>                                                                **
+ **********************************************************************************************/
+
+#ifndef TILEGRID_H
+#define TILEGRID_H
+
+#include <cstdint>
+
+class TileGrid
+{
+public:
+	// Pixel rectangle covered by one tile. Edge tiles are clipped to the render target.
+	struct Tile
+	{
+		uint32_t tileX;
+		uint32_t tileY;
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	TileGrid() : mWidth(0), mHeight(0), mTileSize(16), mTilesX(0), mTilesY(0) {}
+	TileGrid(uint32_t width, uint32_t height, uint32_t tileSize) { Resize(width, height, tileSize); }
+
+	// Thread group sizes the compute shader is compiled for
+	static bool IsSupportedTileSize(uint32_t tileSize) { return tileSize == 8 || tileSize == 16 || tileSize == 32; }
+
+	static uint32_t CeilDiv(uint32_t value, uint32_t divisor) { return (value + divisor - 1) / divisor; }
+
+	// Rounds the grid up so partially covered tiles at the right and bottom edges are still dispatched.
+	// Unsupported tile sizes fall back to 16.
+	void Resize(uint32_t width, uint32_t height, uint32_t tileSize);
+
+	uint32_t GetWidth() const { return mWidth; }
+	uint32_t GetHeight() const { return mHeight; }
+	uint32_t GetTileSize() const { return mTileSize; }
+	uint32_t GetTilesX() const { return mTilesX; }
+	uint32_t GetTilesY() const { return mTilesY; }
+	uint32_t GetTileCount() const { return mTilesX * mTilesY; }
+
+	// Tiles are stored column-major, matching the order the sample dispatches them in
+	uint32_t GetTileIndex(uint32_t tileX, uint32_t tileY) const { return (tileX * mTilesY) + tileY; }
+	Tile GetTile(uint32_t index) const;
+
+	bool IsEdgeTile(uint32_t tileX, uint32_t tileY) const;
+
+private:
+	uint32_t mWidth;
+	uint32_t mHeight;
+	uint32_t mTileSize;
+	uint32_t mTilesX;
+	uint32_t mTilesY;
+};
+
+#endif // TILEGRID_H
@@ -0,0 +1,65 @@
+/**************************************************************************************************
+ **	Name:        UAVFootprintIndex.h                                                             **
+ **	Description: Spatial index of the texel rectangles written by a run of dispatches, answering **
+ **              whether a new dispatch would write any texel an earlier one in the run wrote    **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                    **
+ **	Published:   <insert date>                                                                   **
+ *************************************************************************************************/
+
+#ifndef UAVFOOTPRINTINDEX_H
+#define UAVFOOTPRINTINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Texels [x0, x1) x [y0, y1) of a UAV written by one dispatch
+struct UAVFootprint
+{
+	uint32_t x0;
+	uint32_t y0;
+	uint32_t x1;
+	uint32_t y1;
+
+	bool IsEmpty() const { return x0 >= x1 || y0 >= y1; }
+	bool Intersects(const UAVFootprint& other) const { return x0 < other.x1 && other.x0 < x1 && y0 < other.y1 && other.y0 < y1; }
+};
+
+// Buckets footprints into a uniform grid of cells over the texture, so a query only tests the footprints sharing a
+// cell with it. Tile-sized footprints touch one or a few cells, which keeps Insert and Intersects constant time no
+// matter how many dispatches the run holds. Clear is constant time too: cells are emptied lazily, on the first
+// Insert after it.
+class UAVFootprintIndex
+{
+public:
+	UAVFootprintIndex() : mCellSize(32), mCellsX(0), mCellsY(0), mGeneration(1) {}
+
+	// Sizes the grid for a width x height texture and clears it. Footprints reaching past the texture still
+	// compare exactly; they just share the edge cells.
+	void Reset(uint32_t width, uint32_t height, uint32_t cellSize = 32);
+	void Clear();
+
+	// Empty footprints intersect nothing and are not stored
+	bool Intersects(const UAVFootprint& footprint) const;
+	void Insert(const UAVFootprint& footprint);
+
+	uint32_t GetCount() const { return (uint32_t)mFootprints.size(); }
+
+private:
+	struct Cell
+	{
+		uint32_t generation;              // Contents are stale unless this matches mGeneration
+		std::vector<uint32_t> footprints; // Indices into mFootprints
+	};
+
+	void GetCellRange(const UAVFootprint& footprint, uint32_t& cellX0, uint32_t& cellY0, uint32_t& cellX1, uint32_t& cellY1) const;
+
+	uint32_t mCellSize;
+	uint32_t mCellsX;
+	uint32_t mCellsY;
+	uint32_t mGeneration;
+	std::vector<Cell> mCells;
+	std::vector<UAVFootprint> mFootprints;
+};
+
+#endif // UAVFOOTPRINTINDEX_H
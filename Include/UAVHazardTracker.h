@@ -0,0 +1,70 @@
+/*******************************************************************************************************
+ **	Name:        UAVHazardTracker.h                                                                   **
+ **	Description: Checks the declared write footprint of every dispatch in a compute pass and brackets **
+ **              hazard-free runs of dispatches with BeginUAVOverlap/EndUAVOverlap                    **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                         **
+ **	Published:   <insert date>                                                                        **
+ ******************************************************************************************************/
+
+#ifndef UAVHAZARDTRACKER_H
+#define UAVHAZARDTRACKER_H
+
+#include "GraphicsDevice.h"
+#include "UAVFootprintIndex.h"
+
+enum UAVOverlapMode
+{
+	UAV_OVERLAP_OFF,       // No brackets and no tracking; the device syncs between every dispatch
+	UAV_OVERLAP_ALWAYS,    // One bracket around the whole pass, trusting the caller. Hazards are still counted.
+	UAV_OVERLAP_AUTO       // A bracket around each run of dispatches whose footprints are pairwise disjoint
+};
+
+// Dispatches of a pass go through Dispatch() with the texels they write on the pass's UAV. In the automatic mode a
+// dispatch that would write a texel already written in the open bracket closes it first, so the device syncs there,
+// and starts a new run.
+class UAVHazardTracker
+{
+public:
+	struct PassStats
+	{
+		uint32_t dispatchCount;
+		uint32_t hazardCount;      // Dispatches that wrote a texel an earlier one in the same bracket wrote
+		uint32_t bracketCount;     // BeginUAVOverlap calls issued
+		uint32_t longestRun;       // Most dispatches in one hazard-free run
+	};
+
+	UAVHazardTracker();
+
+	// Starts a pass writing a width x height UAV, on the immediate context or a deferred one. Returns the number of
+	// device calls issued.
+	uint32_t BeginPass(GfxComputeContext* context, UAVOverlapMode mode, uint32_t width, uint32_t height);
+
+	// Issues one dispatch that writes footprint, with whatever bracket calls it needs first. Returns the number of
+	// device calls issued, the dispatch included.
+	uint32_t Dispatch(const UAVFootprint& footprint, uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ);
+
+	// Same for an indirect dispatch. The group counts live in the argument buffer, so footprint has to cover
+	// everything the dispatch could write.
+	uint32_t DispatchIndirect(const UAVFootprint& footprint, GfxBuffer arguments, uint32_t byteOffset);
+
+	// Closes the open bracket, if any. Returns the number of device calls issued.
+	uint32_t EndPass();
+
+	const PassStats& GetLastPassStats() const { return mLastPass; }
+
+private:
+	// Bracket calls needed before a dispatch writing footprint; returns how many were issued
+	uint32_t TrackDispatch(const UAVFootprint& footprint);
+
+	GfxComputeContext* mContext;
+	UAVOverlapMode mMode;
+	bool bBracketOpen;
+	uint32_t mRunLength;
+	UAVFootprintIndex mRun;
+	uint32_t mWidth;
+	uint32_t mHeight;
+	PassStats mPass;
+	PassStats mLastPass;
+};
+
+#endif // UAVHAZARDTRACKER_H
@@ -8,89 +8,200 @@
 #ifndef UAVOVERLAPSAMPLEAPP_H
 #define UAVOVERLAPSAMPLEAPP_H
 
-#include <windows.h>
-#include <d3d11.h>
-#include <d3d12.h>
-#include <d3dcompiler.h>
-#include <exception>
-#include "DirectXMath.h"
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "imgui.h"
-#include "imgui_impl_win32.h"
-#include "imgui_impl_dx11.h"
 #include "imgui_internal.h"
 
-#include "igdext.h"
+#include "ComputeWorkload.h"
+#include "FramePacer.h"
+#include "FrameTimeHistogram.h"
+#include "GpuPassTimer.h"
+#include "GraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "ResizePlan.h"
+#include "StartupTimer.h"
+#include "ThreadPool.h"
+#include "TileGrid.h"
+#include "UAVHazardTracker.h"
+
+// Passes timed on the device timeline by GpuPassTimer
+enum SamplePass
+{
+	PASS_COMPUTE,
+	PASS_COMPOSITE,
+	PASS_COUNT
+};
 
-#ifndef ThrowIfFailed
-#define ThrowIfFailed(x) \
-{                        \
-    HRESULT hr__ = (x);  \
-    if(FAILED(hr__)) { throw std::exception(); return hr__; } \
-}
-#endif
+// Tile sizes the compute shader is compiled for: ComputeShaderTile8, ComputeShader (16) and ComputeShaderTile32
+#define NUM_TILE_SIZES 3
 
 class UAVOverlapSampleApp
 {
 public:
-	UAVOverlapSampleApp(HWND window, uint32_t width, uint32_t height);
+	// The app only talks to the GraphicsDevice, so the same frame runs on D3D11 or on the CPU reference device.
+	// The device must outlive the app; Init() initializes it and Cleanup() cleans it up.
+	UAVOverlapSampleApp(GraphicsDevice* device, uint32_t width, uint32_t height);
 
-	HRESULT Init();
+	// Applies tile size, overlap, submission, frames-in-flight and workload settings from the command line; call before Init()
+	void ApplyOptions(const HeadlessOptions& options);
+
+	bool Init();
 	void Cleanup();
 	void Render(double frameTime);
 
-	bool InitIntelExtensions();
+	// Changes the render size after Init(), rebuilding only what PlanResize() says the new size needs, and resizes the
+	// device's back buffer. Waits for every frame in flight first. A zero size, e.g. a minimized window, is ignored.
+	bool Resize(uint32_t width, uint32_t height);
+
+	uint32_t GetWidth() const { return mWidth; }
+	uint32_t GetHeight() const { return mHeight; }
+
+	// Latency of every Resize() that changed the size, and how many of them reused the pooled sample textures
+	const ResizeReport& GetResizeReport() const { return mResizeReport; }
+
+	// Waits for every frame still in flight, e.g. before reporting frame pacing at the end of a run
+	void FinishFrames() { mFramePacer.Flush(); }
+
+	// Reads back the last rendered frame
+	bool WriteFrameToPPM(const char* path);
+
+	// Time Init() spent in each of its stages: device, shaders, resources, deferred contexts, ui and pass timer, with
+	// the steps of each, and the device's own, nested in them
+	const StartupTimer& GetStartupTimer() const { return mStartupTimer; }
+
+	// Time between successive Render() calls, measured on the steady clock
+	const FrameTimeHistogram& GetFrameTimeHistogram() const { return mFrameTimeHistogram; }
+
+	// Device time of the compute pass and of the composite (fullscreen triangle and UI), a few frames behind
+	const GpuPassTimer& GetPassTimer() const { return mPassTimer; }
+
+	// CPU wait, frame latency and throughput of the frames-in-flight pipeline
+	FramePacer& GetFramePacer() { return mFramePacer; }
+	const FramePacer& GetFramePacer() const { return mFramePacer; }
+
+	// Overlap brackets issued, and write hazards found, in the last compute pass, summed over every context that recorded it
+	const UAVHazardTracker::PassStats& GetLastOverlapStats() const { return mLastOverlapStats; }
+
+	// Deferred contexts the per-tile compute pass is recorded on; 0 when it is recorded on the immediate context
+	uint32_t GetRecordThreadCount() const { return (uint32_t)mDeferredContexts.size(); }
+
+	// (Re)builds the tile grid, one immutable constant buffer per tile plus the batched one, and the tile list and
+	// arguments of the indirect dispatch for the given tile size. The constant buffers carry the current workload.
+	bool CreateTileConstantBuffers(uint32_t tileSize);
+	void ReleaseTileConstantBuffers();
 
 	struct SimpleVertex
 	{
-		DirectX::XMFLOAT3 position;
-		DirectX::XMFLOAT2 uv;
+		float position[3];
+		float uv[2];
 	};
 
+	// The gradient shader only reads the first row; the workload shaders read their knobs from the second
 	struct ConstantBuffer
 	{
 		uint32_t dispatchX;
 		uint32_t dispatchY;
 		uint32_t windowWidth;
 		uint32_t windowHeight;
+		ComputeWorkload workload;
 	};
 
-private:
-	HWND mWindow;
-	UINT mWidth;
-	UINT mHeight;
-
-	ID3D11Device* mDevice;
-	ID3D11DeviceContext* mImmediateContext;
-	IDXGISwapChain* mSwapChain;
-
-	ID3D11RenderTargetView* mBackBufferRTV;
-
-	ID3D11VertexShader* mVertexShader;
-	ID3D11PixelShader* mPixelShader;
-	ID3D11ComputeShader* mComputeShader;
-
-	ID3DBlob* mVSBlob;
-	ID3DBlob* mPSBlob;
-	ID3DBlob* mCSBlob;
+	// Workload the compute pass runs; one with every knob at zero runs the gradient shader
+	const ComputeWorkload& GetWorkload() const { return mWorkload; }
 
-	ID3D11InputLayout* mVertexLayout;
-
-	ID3D11Buffer* mVertexBuffer;
-
-	ID3D11Buffer* mConstantBuffer[3600];
-
-	D3D11_VIEWPORT mViewPort;
+	// CPU-side cost of submitting the compute pass, measured each frame
+	struct SubmissionCounters
+	{
+		uint32_t commandCount;
+		double submissionTimeMs;
+		double recordTimeMs;        // Deferred recording only: until the last worker finished its command list
+	};
 
-	ID3D11ShaderResourceView* mSampleSRV;
-	ID3D11UnorderedAccessView* mSampleUAV;
+	const SubmissionCounters& GetComputeCounters() const { return mComputeCounters; }
 
-	INTCExtensionContext* mINTCExtensionContext;
+private:
+	// Splits the per-tile dispatches into one contiguous range per deferred context, records the ranges in parallel and
+	// executes the lists in order. Returns the number of context calls made.
+	uint32_t SubmitComputePassDeferred(GfxShader computeShader, UAVOverlapMode overlapMode);
+	uint32_t RecordTileRange(uint32_t contextIndex, uint32_t begin, uint32_t end, GfxShader computeShader, UAVOverlapMode overlapMode);
+
+	// Render-size dependent resources, (re)built by Init() and Resize(). The sample textures are allocated at
+	// mAllocatedWidth x mAllocatedHeight, and the fullscreen triangle samples their top-left mWidth x mHeight.
+	bool CreateSampleTextures(uint32_t width, uint32_t height);
+	void ReleaseSampleTextures();
+	bool CreateFullscreenTriangle();
+	bool CreateWorkloadSource();
+
+	GraphicsDevice* mDevice;
+	uint32_t mWidth;
+	uint32_t mHeight;
+	uint32_t mAllocatedWidth;
+	uint32_t mAllocatedHeight;
+	ResizeReport mResizeReport;
+
+	GfxView mBackBufferRTV;
+
+	GfxShader mVertexShader;
+	GfxShader mPixelShader;
+	GfxShader mComputeShader[NUM_TILE_SIZES];
+	GfxShader mTileListShader[NUM_TILE_SIZES];
+	GfxShader mWorkloadShader[NUM_TILE_SIZES];
+	GfxShader mWorkloadListShader[NUM_TILE_SIZES];
+
+	GfxInputLayout mVertexLayout;
+
+	GfxBuffer mVertexBuffer;
+
+	TileGrid mTileGrid;
+	std::vector<GfxBuffer> mConstantBuffer;
+	GfxBuffer mBatchedConstantBuffer;
+
+	// Indirect submission: every tile of the grid, and the DispatchIndirect arguments that cover them
+	GfxBuffer mTileListBuffer;
+	GfxView mTileListSRV;
+	GfxBuffer mIndirectArguments;
+
+	// Heavier per-tile work from ComputeWorkload.hlsl, reading a gradient the sample shader writes once at Init
+	ComputeWorkload mWorkload;
+	GfxTexture mWorkloadSource;
+	GfxView mWorkloadSourceSRV;
+
+	// One sample texture per frame in flight, so a frame never writes the texture an earlier frame may still be
+	// compositing from. mFrameSet is the one the current frame records into.
+	GfxTexture mSampleTexture[GFX_MAX_FRAMES_IN_FLIGHT];
+	GfxView mSampleSRV[GFX_MAX_FRAMES_IN_FLIGHT];
+	GfxView mSampleUAV[GFX_MAX_FRAMES_IN_FLIGHT];
+	uint32_t mFrameSet;
+	uint32_t mFramesInFlight;      // Requested; the device clamps it
+	FramePacer mFramePacer;
+
+	SubmissionCounters mComputeCounters;
+
+	GpuPassTimer mPassTimer;
+	UAVHazardTracker mHazardTracker;
+	UAVHazardTracker::PassStats mLastOverlapStats;
+
+	// Multithreaded recording: one deferred context, hazard tracker and call count per recording thread
+	uint32_t mRecordThreadCount;
+	std::unique_ptr<ThreadPool> mRecordPool;
+	std::vector<std::unique_ptr<GfxDeferredContext>> mDeferredContexts;
+	std::vector<UAVHazardTracker> mRecordTrackers;
+	std::vector<uint32_t> mRecordCommandCounts;
+
+	StartupTimer mStartupTimer;
+	FrameTimer mFrameTimer;
+	FrameTimeHistogram mFrameTimeHistogram;
+	float mFrameTimeGraph[FrameTimeHistogram::HISTORY_SIZE];
+	std::string mFrameStatsPath; // Histogram export written by Cleanup(), if set
 
 	bool bUseUAVOverlapExtension;
-	bool bUAVOverlapSupported;
-	bool bIntelGPUPresent;
+	bool bAutoUAVOverlap;          // Bracket only the runs of dispatches the hazard tracker found disjoint
+	bool bUseBatchedDispatch;
+	bool bUseIndirectDispatch;     // Takes precedence over bUseBatchedDispatch
 };
 
 #endif // UAVOVERLAPSAMPLEAPP_H
\ No newline at end of file
@@ -0,0 +1,113 @@
+/***************************************************************************************************************************
+ **	Name:        UIPipeline.h                                                                                             **
+ **	Description: The ImGui renderer's walk over the draw data, against an abstract device context, with an owned-pipeline **
+ **              mode that skips the state backup and restore and drops binds the context already holds                   **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                             **
+ **	Published:   <insert date>                                                                                            **
+ **************************************************************************************************************************/
+
+#ifndef UIPIPELINE_H
+#define UIPIPELINE_H
+
+#include <cstdint>
+
+struct ImDrawData;
+
+// Everything the ImGui renderer binds. The scissor rectangle and texture change per draw; the rest is set up once a
+// frame, and again for ImDrawCallback_ResetRenderState.
+enum UIPipelineSlot
+{
+	UI_SLOT_VIEWPORT,
+	UI_SLOT_INPUT_LAYOUT,
+	UI_SLOT_VERTEX_BUFFER,
+	UI_SLOT_INDEX_BUFFER,
+	UI_SLOT_TOPOLOGY,
+	UI_SLOT_VERTEX_SHADER,
+	UI_SLOT_VS_CONSTANT_BUFFER,
+	UI_SLOT_PIXEL_SHADER,
+	UI_SLOT_PS_SAMPLER,
+	UI_SLOT_GEOMETRY_SHADER,
+	UI_SLOT_HULL_SHADER,
+	UI_SLOT_DOMAIN_SHADER,
+	UI_SLOT_COMPUTE_SHADER,
+	UI_SLOT_BLEND_STATE,
+	UI_SLOT_DEPTH_STENCIL_STATE,
+	UI_SLOT_RASTERIZER_STATE,
+	UI_SLOT_SCISSOR_RECT,
+	UI_SLOT_PS_TEXTURE,
+	UI_SLOT_COUNT
+};
+
+#define UI_SLOT_BIT(slot) (1u << (slot))
+static const uint32_t UI_ALL_SLOTS = (1u << UI_SLOT_COUNT) - 1;
+
+// What a slot is bound to
+struct UIBinding
+{
+	const void* object;           // The renderer's shader, state, buffer or layout, or a command's TextureId
+	int32_t rect[4];              // Scissor rectangle as left, top, right, bottom; the viewport as 0, 0, width, height
+
+	bool operator==(const UIBinding& other) const;
+};
+
+// The context calls the renderer makes. The DX11 backend implements it on an ID3D11DeviceContext, and mocks count and
+// check the calls.
+class UIPipelineContext
+{
+public:
+	virtual ~UIPipelineContext() {}
+
+	// Slots the renderer only clears (the topology and the shader stages it does not use) are bound to null
+	virtual void Bind(UIPipelineSlot slot, const UIBinding& binding) = 0;
+	virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) = 0;
+
+	// Save and put back every slot the renderer binds, around a frame that does not own the pipeline
+	virtual void BackupState() = 0;
+	virtual void RestoreState() = 0;
+	virtual uint32_t GetStateRoundTripCallCount() const = 0;
+};
+
+// Context calls of the last frame
+struct UIPipelineCounters
+{
+	uint32_t issuedCalls;         // Binds, draws and the state round-trip
+	uint32_t skippedBinds;        // Binds dropped because the slot already held the value
+	uint32_t skippedRoundTripCalls;
+
+	uint32_t GetSavedCalls() const { return skippedBinds + skippedRoundTripCalls; }
+};
+
+// By default every frame saves the state, binds everything it needs and restores the state, as the stock backend
+// does. With an owned pipeline the overlay is the last thing drawn, so nothing is saved or restored, and the renderer
+// remembers what it bound: a bind is dropped when the slot already holds the value, within a frame and across frames.
+// The owner reports the slots it has bound since with Invalidate(), and must not rely on the overlay's blend,
+// rasterizer, depth-stencil or sampler state being gone. User callbacks may bind anything, so every slot is unknown
+// after one.
+class UIPipelineRenderer
+{
+public:
+	UIPipelineRenderer();
+
+	void SetOwnedPipeline(bool owned);
+	bool IsOwnedPipeline() const { return bOwnedPipeline; }
+
+	// The slots in slotMask may hold anything, and the next bind of each is issued
+	void Invalidate(uint32_t slotMask = UI_ALL_SLOTS);
+
+	// objects holds the renderer's object for every slot set up once a frame, null for the slots it clears.
+	// vertexOffset and indexOffset are where this frame's data starts in the vertex and index buffers.
+	void Render(const ImDrawData* drawData, const void* const objects[UI_SLOT_COUNT], uint32_t vertexOffset, uint32_t indexOffset, UIPipelineContext& context);
+
+	const UIPipelineCounters& GetLastCounters() const { return mCounters; }
+
+private:
+	void SetupRenderState(const ImDrawData* drawData, const void* const objects[UI_SLOT_COUNT], UIPipelineContext& context);
+	void Bind(UIPipelineSlot slot, const UIBinding& binding, UIPipelineContext& context);
+
+	bool bOwnedPipeline;
+	UIBinding mBound[UI_SLOT_COUNT];
+	uint32_t mKnownSlots;         // Slots whose mBound entry is what the context holds
+	UIPipelineCounters mCounters;
+};
+
+#endif // UIPIPELINE_H
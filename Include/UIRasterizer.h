@@ -0,0 +1,131 @@
+/****************************************************************************************************************
+ **	Name:        UIRasterizer.h                                                                                **
+ **	Description: Software renderer for ImGui draw data on the CPU device: clipped, textured and vertex-        **
+ **              colored triangles, binned into screen tiles and alpha blended tile by tile on the thread pool **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                  **
+ **	Published:   <insert date>                                                                                 **
+ ***************************************************************************************************************/
+
+#ifndef UIRASTERIZER_H
+#define UIRASTERIZER_H
+
+#include <functional>
+#include <vector>
+
+#include "CPUComputeBackend.h"
+#include "ThreadPool.h"
+
+struct ImDrawData;
+
+// One ImGui vertex, with its position in target pixels and its color packed like a texel, red in the low byte
+struct UIVertex
+{
+	float x;
+	float y;
+	float u;
+	float v;
+	uint32_t color;
+};
+
+// The triangles of one ImDrawCmd. Triangle i has the vertices at 3 * (firstTriangle + i) and the two after it.
+struct UIDrawCommand
+{
+	int32_t clipX0;               // Scissor rectangle in target pixels, [clipX0, clipX1) x [clipY0, clipY1)
+	int32_t clipY0;
+	int32_t clipX1;
+	int32_t clipY1;
+	const CPUTexture2D* texture;
+	uint32_t firstTriangle;
+	uint32_t triangleCount;
+};
+
+// A copy of one frame's draw data, which ImGui only keeps until the next NewFrame, so a frame in flight can be
+// drawn after the app has moved on
+struct UIFrame
+{
+	std::vector<UIVertex> vertices;
+	std::vector<UIDrawCommand> commands;
+
+	uint32_t GetTriangleCount() const { return (uint32_t)(vertices.size() / 3); }
+};
+
+// Maps an ImDrawCmd's TextureId to the texture it names, or nullptr
+typedef std::function<const CPUTexture2D*(void* textureId)> UITextureResolver;
+
+// Copies drawData into frame with the indices expanded, relative to DisplayPos. Commands with a user callback, which
+// only make sense on the thread that built the draw data, and commands whose texture does not resolve are skipped.
+void BuildUIFrame(const ImDrawData* drawData, const UITextureResolver& resolveTexture, UIFrame& frame);
+
+// Draws a UIFrame the way the DX11 backend does, without its linear filter:
+//  - pixels are covered when their center is inside the triangle, with a tie-break rule so that triangles sharing an
+//    edge never both draw a pixel on it, and inside the command's scissor rectangle
+//  - color and texture coordinates are interpolated with barycentric weights, except on triangles whose three vertices
+//    agree, which are shaded once from the first; the texture is point sampled with wrap addressing and multiplies
+//    the vertex color
+//  - color is blended SRC_ALPHA / INV_SRC_ALPHA, and alpha becomes srcAlpha * (1 - srcAlpha), as the backend's blend
+//    state writes it
+// Triangles are binned into TILE_SIZE squares, and each tile draws its triangles in submission order, so the result
+// does not depend on how tiles are spread over threads. The SSE2 edge tests cover exactly the pixels the scalar ones
+// do, and shading is shared, so both produce identical images.
+class UIRasterizer
+{
+public:
+	static const uint32_t TILE_SIZE = 64;
+
+	struct Stats
+	{
+		uint32_t triangleCount;   // Triangles that cover at least one tile
+		uint32_t binnedCount;     // Triangle and tile pairs
+		uint32_t tileCount;       // Tiles with anything to draw
+		double setupMs;           // Triangle setup and binning, on the calling thread
+		double rasterMs;          // Drawing the tiles
+	};
+
+	// A null pool draws every tile on the calling thread
+	explicit UIRasterizer(ThreadPool* pool = nullptr);
+
+	// SSE2 is used by default where the build targets it; disabling it selects the scalar edge tests
+	void SetSIMDEnabled(bool enabled);
+	bool IsSIMDEnabled() const { return bUseSIMD; }
+
+	void Render(const UIFrame& frame, CPUTexture2D& target);
+
+	const Stats& GetLastStats() const { return mStats; }
+
+private:
+	// Edge i is opposite vertex i, E_i(x, y) = a[i] * x + (b[i] * y + c[i]), positive inside the triangle
+	struct Triangle
+	{
+		float a[3];
+		float b[3];
+		float c[3];
+		bool bTieInside[3];       // Whether a pixel center exactly on the edge is covered
+		float invArea;
+		int32_t x0;               // Pixel bounds, clipped to the scissor rectangle and the target
+		int32_t y0;
+		int32_t x1;
+		int32_t y1;
+		const UIVertex* vertices;
+		const CPUTexture2D* texture;
+		bool bFlat;               // Same color and texture coordinates at all three vertices
+		uint32_t flatColor;       // Shaded color of a flat triangle
+	};
+
+	void SetupTriangles(const UIFrame& frame, const CPUTexture2D& target);
+	void RasterizeTile(uint32_t tile, CPUTexture2D& target) const;
+	void RasterizeRowScalar(const Triangle& triangle, const float rowE[3], int32_t x0, int32_t x1, uint32_t* row) const;
+	void RasterizeRowSSE2(const Triangle& triangle, const float rowE[3], int32_t x0, int32_t x1, uint32_t* row) const;
+
+	ThreadPool* mPool;
+	bool bUseSIMD;
+
+	// Kept between frames so steady-state frames do not allocate
+	std::vector<Triangle> mTriangles;
+	std::vector<std::vector<uint32_t>> mTileBins;
+	std::vector<uint32_t> mActiveTiles;
+	uint32_t mTilesX;
+
+	Stats mStats;
+};
+
+#endif // UIRASTERIZER_H
@@ -0,0 +1,58 @@
+/********************************************************************************************************************
+ **	Name:        UploadRing.h                                                                                      **
+ **	Description: Sub-allocates per-frame uploads from a dynamic buffer as a ring: NO_OVERWRITE maps while it fits, **
+ **              a DISCARD when it wraps, and geometric growth when one upload no longer leaves room for another   **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                      **
+ **	Published:   <insert date>                                                                                     **
+ *******************************************************************************************************************/
+
+#ifndef UPLOADRING_H
+#define UPLOADRING_H
+
+#include <cstdint>
+
+// Where one upload goes, and how the buffer has to be mapped for it
+struct UploadRingAllocation
+{
+	uint32_t offset;              // First element of the upload
+	bool bRecreate;               // Release the buffer and create one of GetCapacity() elements first
+	bool bDiscard;                // Map with WRITE_DISCARD; otherwise WRITE_NO_OVERWRITE
+};
+
+struct UploadRingStats
+{
+	uint64_t allocationCount;
+	uint64_t recreationCount;     // Buffers created, including the first
+	uint64_t discardCount;        // Wraps onto a discarded buffer, not counting recreations
+	uint64_t bytesUploaded;
+};
+
+// Hands out consecutive ranges of a dynamic buffer, one per upload. A range is never written again until the ring
+// wraps, and a wrap maps the buffer with WRITE_DISCARD, which gives the CPU fresh memory while the GPU finishes
+// reading the old contents. Everything between wraps can therefore be mapped with WRITE_NO_OVERWRITE and the driver
+// never has to rename or wait on the buffer for it.
+// The buffer grows by doubling whenever an upload is more than half of it, so at least two uploads fit between
+// discards and a steadily growing upload recreates the buffer a logarithmic number of times. It never shrinks.
+class UploadRing
+{
+public:
+	UploadRing(uint32_t elementSize, uint32_t initialCapacity);
+
+	UploadRingAllocation Allocate(uint32_t count);
+
+	// The buffer was released, as on device loss; the next allocation recreates it at the current capacity
+	void Invalidate();
+
+	uint32_t GetElementSize() const { return mElementSize; }
+	uint32_t GetCapacity() const { return mCapacity; }
+	const UploadRingStats& GetStats() const { return mStats; }
+
+private:
+	uint32_t mElementSize;
+	uint32_t mCapacity;
+	uint32_t mHead;               // Next free element
+	bool bHasBuffer;
+	UploadRingStats mStats;
+};
+
+#endif // UPLOADRING_H
@@ -16,14 +16,50 @@ cbuffer cbuff : register(b0)
 	uint windowHeight;
 };
 
-[numthreads(16, 16, 1)]
-void CS(uint3 mGroupThreadID : SV_GroupThreadID)
+// Tile-list variants (ComputeShaderList.hlsl and friends) define TILE_LIST. Their tiles come from a list of packed
+// tile coordinates, x in the low 16 bits and y in the high 16, so one Dispatch or DispatchIndirect covers any set of
+// tiles in any order. Group (x, y) runs entry y * TILE_LIST_ROW_GROUPS + x; groups past the end of the list do nothing.
+#ifdef TILE_LIST
+#define TILE_LIST_ROW_GROUPS 1024
+StructuredBuffer<uint> gTiles : register(t0);
+#endif
+
+// Edge length of the square thread group, and so of the tile each group writes.
+// ComputeShaderTile8.hlsl and ComputeShaderTile32.hlsl include this file to build the 8x8 and 32x32 variants.
+#ifndef TILE_SIZE
+#define TILE_SIZE 16
+#endif
+
+// The tile is (dispatchX, dispatchY) offset by SV_GroupID. Per-tile submission issues Dispatch(1,1,1) with a
+// unique constant buffer per tile, so SV_GroupID is always 0. Batched submission binds one constant buffer with
+// dispatchX = dispatchY = 0 and covers the whole frame with a single Dispatch(numTilesX, numTilesY, 1).
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void CS(uint3 mGroupID : SV_GroupID, uint3 mGroupThreadID : SV_GroupThreadID)
 {
+#ifdef TILE_LIST
+	uint tileCount, tileStride;
+	gTiles.GetDimensions(tileCount, tileStride);
+	uint entry = mGroupID.y * TILE_LIST_ROW_GROUPS + mGroupID.x;
+	if (entry >= tileCount)
+	{
+		return;
+	}
+	uint2 tile = uint2(dispatchX + (gTiles[entry] & 0xFFFF), dispatchY + (gTiles[entry] >> 16));
+#else
+	uint2 tile = uint2(dispatchX + mGroupID.x, dispatchY + mGroupID.y);
+#endif
+
 	// Compute screen coordinates for the current thread
-	uint xcoord = dispatchX * 16 + mGroupThreadID.x;
-	uint ycoord = dispatchY * 16 + mGroupThreadID.y;
+	uint xcoord = tile.x * TILE_SIZE + mGroupThreadID.x;
+	uint ycoord = tile.y * TILE_SIZE + mGroupThreadID.y;
 	uint2 coord = uint2(xcoord, ycoord);
 
+	// Tiles on the right and bottom edges overhang the window when its size is not a multiple of TILE_SIZE
+	if (xcoord >= windowWidth || ycoord >= windowHeight)
+	{
+		return;
+	}
+
 	// Write out a color to the bound UAV at this thread's screen coordinate
 	gOutput[coord] = float4((float)xcoord / windowWidth, (float)ycoord / windowHeight, 0.5, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,10 @@
+/**********************************************************************************
+ **	Name:        ComputeShaderList.hlsl                                          **
+ **	Description: Sample Compute Shader reading its tiles from a tile list buffer **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                    **
+ **	Published:   <insert date>                                                   **
+ *********************************************************************************/
+
+#define TILE_LIST
+
+#include "ComputeShader.hlsl"
@@ -0,0 +1,10 @@
+/**********************************************************************************
+ **	Name:        ComputeShaderTile32.hlsl                                        **
+ **	Description: Sample Compute Shader compiled with 32x32 thread groups / tiles **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                    **
+ **	Published:   <insert date>                                                   **
+ *********************************************************************************/
+
+#define TILE_SIZE 32
+
+#include "ComputeShader.hlsl"
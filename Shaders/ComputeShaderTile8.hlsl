@@ -0,0 +1,10 @@
+/********************************************************************************
+ **	Name:        ComputeShaderTile8.hlsl                                       **
+ **	Description: Sample Compute Shader compiled with 8x8 thread groups / tiles **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                  **
+ **	Published:   <insert date>                                                 **
+ *******************************************************************************/
+
+#define TILE_SIZE 8
+
+#include "ComputeShader.hlsl"
@@ -0,0 +1,12 @@
+/***********************************************************************************
+ **	Name:        ComputeShaderTile8List.hlsl                                      **
+ **	Description: Sample Compute Shader reading its tiles from a tile list buffer, **
+ **              compiled with 8x8 thread groups / tiles                          **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                     **
+ **	Published:   <insert date>                                                    **
+ **********************************************************************************/
+
+#define TILE_SIZE 8
+#define TILE_LIST
+
+#include "ComputeShader.hlsl"
@@ -0,0 +1,139 @@
+/*****************************************************************************************************
+ **	Name:        ComputeWorkload.hlsl                                                               **
+ **	Description: Configurable compute workload - the sample's tile pass with ALU loops, SRV reads,  **
+ **              group-shared reductions and partially active tiles, so overlap and batching can be **
+ **              measured against heavier passes than the gradient                                  **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                       **
+ **	Published:   <insert date>                                                                      **
+ ****************************************************************************************************/
+
+RWTexture2D<float4> gOutput : register(u0);
+
+// Read by the SRV loop; the sample binds a gradient texture filled once at startup
+Texture2D<float4> gSource : register(t1);
+
+// The first row is the sample's tile constants, the second the workload knobs (ComputeWorkload in ComputeWorkload.h)
+cbuffer cbuff : register(b0)
+{
+	uint dispatchX;
+	uint dispatchY;
+	uint windowWidth;
+	uint windowHeight;
+	uint aluIterations;
+	uint srvReads;
+	uint flags;
+	uint coverage;
+};
+
+// Mirrors COMPUTE_WORKLOAD_GROUP_REDUCTION and COMPUTE_WORKLOAD_IRREGULAR_TILES
+#define WORKLOAD_GROUP_REDUCTION 1
+#define WORKLOAD_IRREGULAR_TILES 2
+
+#ifdef TILE_LIST
+#define TILE_LIST_ROW_GROUPS 1024
+StructuredBuffer<uint> gTiles : register(t0);
+#endif
+
+#ifndef TILE_SIZE
+#define TILE_SIZE 16
+#endif
+
+#define GROUP_THREADS (TILE_SIZE * TILE_SIZE)
+
+groupshared uint gPartialSums[GROUP_THREADS];
+
+// Integer mixing function; unsigned arithmetic keeps the result bit-exact with the CPU reference kernel
+uint WorkloadHash(uint value)
+{
+	value ^= value >> 16;
+	value *= 0x7feb352d;
+	value ^= value >> 15;
+	value *= 0x846ca68b;
+	value ^= value >> 16;
+	return value;
+}
+
+// Edge, in threads, of the square in the top-left corner of a tile that runs the workload. The other threads of the
+// group only write the gradient, as in a partially covered tile. Irregular tiles each pick an edge between 1 and that.
+uint ActiveEdge(uint2 tile)
+{
+	uint edge = (coverage == 0 || coverage >= 100) ? TILE_SIZE : max(TILE_SIZE * coverage / 100, 1);
+	if (flags & WORKLOAD_IRREGULAR_TILES)
+	{
+		edge = 1 + WorkloadHash(tile.x | (tile.y << 16)) % edge;
+	}
+	return edge;
+}
+
+// Same thread layout and tile lookup as ComputeShader.hlsl. Threads outside the window stay until the reduction is
+// done, because every thread of the group has to reach the barriers.
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void CS(uint3 mGroupID : SV_GroupID, uint3 mGroupThreadID : SV_GroupThreadID, uint mGroupIndex : SV_GroupIndex)
+{
+#ifdef TILE_LIST
+	uint tileCount, tileStride;
+	gTiles.GetDimensions(tileCount, tileStride);
+	uint entry = mGroupID.y * TILE_LIST_ROW_GROUPS + mGroupID.x;
+	if (entry >= tileCount)
+	{
+		return;
+	}
+	uint2 tile = uint2(dispatchX + (gTiles[entry] & 0xFFFF), dispatchY + (gTiles[entry] >> 16));
+#else
+	uint2 tile = uint2(dispatchX + mGroupID.x, dispatchY + mGroupID.y);
+#endif
+
+	uint xcoord = tile.x * TILE_SIZE + mGroupThreadID.x;
+	uint ycoord = tile.y * TILE_SIZE + mGroupThreadID.y;
+	bool inWindow = xcoord < windowWidth && ycoord < windowHeight;
+
+	uint edge = ActiveEdge(tile);
+	bool active = inWindow && mGroupThreadID.x < edge && mGroupThreadID.y < edge;
+
+	uint value = 0;
+	if (active)
+	{
+		value = xcoord | (ycoord << 16);
+		for (uint i = 0; i < aluIterations; i++)
+		{
+			value = WorkloadHash(value + i);
+		}
+
+		// Strided reads that wrap around the source, so neighbouring threads touch neighbouring texels
+		uint sourceWidth, sourceHeight;
+		gSource.GetDimensions(sourceWidth, sourceHeight);
+		sourceWidth = max(sourceWidth, 1);
+		sourceHeight = max(sourceHeight, 1);
+		for (uint j = 0; j < srvReads; j++)
+		{
+			uint2 texelCoord = uint2((xcoord + j * 37) % sourceWidth, (ycoord + j * 11) % sourceHeight);
+			uint4 texel = (uint4)round(saturate(gSource.Load(int3(texelCoord, 0))) * 255.0);
+			value = (value ^ (texel.r | (texel.g << 8) | (texel.b << 16) | (texel.a << 24))) * 16777619;
+		}
+	}
+
+	// Tree reduction of every active thread's value through group shared memory
+	if (flags & WORKLOAD_GROUP_REDUCTION)
+	{
+		gPartialSums[mGroupIndex] = value;
+		GroupMemoryBarrierWithGroupSync();
+		for (uint stride = GROUP_THREADS / 2; stride > 0; stride >>= 1)
+		{
+			if (mGroupIndex < stride)
+			{
+				gPartialSums[mGroupIndex] += gPartialSums[mGroupIndex + stride];
+			}
+			GroupMemoryBarrierWithGroupSync();
+		}
+		value += gPartialSums[0];
+	}
+
+	if (!inWindow)
+	{
+		return;
+	}
+
+	// The workload's result lands in blue, so the gradient stays recognisable
+	float blue = active ? (float)(value & 0xFF) / 255.0 : 0.5;
+	gOutput[uint2(xcoord, ycoord)] = float4((float)xcoord / windowWidth, (float)ycoord / windowHeight, blue, 1.0);
+}
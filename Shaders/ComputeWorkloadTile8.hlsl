@@ -0,0 +1,10 @@
+/***************************************************************************
+ **	Name:        ComputeWorkloadTile8.hlsl                                **
+ **	Description: Compute workload compiled with 8x8 thread groups / tiles **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com             **
+ **	Published:   <insert date>                                            **
+ **************************************************************************/
+
+#define TILE_SIZE 8
+
+#include "ComputeWorkload.hlsl"
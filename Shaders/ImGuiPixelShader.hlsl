@@ -0,0 +1,23 @@
+/********************************************************************************************
+ **	Name:        ImGuiPixelShader.hlsl                                                     **
+ **	Description: ImGui overlay PS, compiled into the DX11 backend at build time.           **
+ **              Same as the source imgui_impl_dx11.cpp compiles at runtime when it is not **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                              **
+ **	Published:   <insert date>                                                             **
+ *******************************************************************************************/
+
+struct PS_INPUT
+{
+	float4 pos : SV_POSITION;
+	float4 col : COLOR0;
+	float2 uv  : TEXCOORD0;
+};
+
+sampler sampler0;
+Texture2D texture0;
+
+float4 main(PS_INPUT input) : SV_Target
+{
+	float4 out_col = input.col * texture0.Sample(sampler0, input.uv);
+	return out_col;
+}
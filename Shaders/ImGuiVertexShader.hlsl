@@ -0,0 +1,35 @@
+/********************************************************************************************
+ **	Name:        ImGuiVertexShader.hlsl                                                    **
+ **	Description: ImGui overlay VS, compiled into the DX11 backend at build time.           **
+ **              Same as the source imgui_impl_dx11.cpp compiles at runtime when it is not **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                              **
+ **	Published:   <insert date>                                                             **
+ *******************************************************************************************/
+
+cbuffer vertexBuffer : register(b0)
+{
+	float4x4 ProjectionMatrix;
+};
+
+struct VS_INPUT
+{
+	float2 pos : POSITION;
+	float4 col : COLOR0;
+	float2 uv  : TEXCOORD0;
+};
+
+struct PS_INPUT
+{
+	float4 pos : SV_POSITION;
+	float4 col : COLOR0;
+	float2 uv  : TEXCOORD0;
+};
+
+PS_INPUT main(VS_INPUT input)
+{
+	PS_INPUT output;
+	output.pos = mul(ProjectionMatrix, float4(input.pos.xy, 0.f, 1.f));
+	output.col = input.col;
+	output.uv  = input.uv;
+	return output;
+}
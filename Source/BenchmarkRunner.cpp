@@ -0,0 +1,425 @@
+/*************************************************************************************************
+ **	Name:        BenchmarkRunner.cpp                                                            **
+ **	Description: Scripted A/B benchmark over overlap, tile size, resolution and submission mode **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                   **
+ **	Published:   <insert date>                                                                  **
+ ************************************************************************************************/
+
+#include "BenchmarkRunner.h"
+#include "SampleUtils.h"
+#include "TileGrid.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// Two-sided 95% quantiles of Student's t distribution for 1 to 30 degrees of freedom
+static const double gStudentT95[30] =
+{
+	12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double StudentT95(size_t degreesOfFreedom)
+{
+	if (degreesOfFreedom == 0)
+	{
+		return 0.0;
+	}
+	if (degreesOfFreedom <= 30)
+	{
+		return gStudentT95[degreesOfFreedom - 1];
+	}
+	// Within 0.005 of the exact quantile from 30 degrees of freedom on
+	return 1.96 + 2.4 / (double)degreesOfFreedom;
+}
+
+// Splits "a,b,c" and hands each item to parse, which returns false if the item is malformed
+static bool ParseList(const std::string& text, const std::function<bool(const std::string&)>& parse)
+{
+	size_t start = 0;
+	while (start <= text.size())
+	{
+		size_t comma = text.find(',', start);
+		if (comma == std::string::npos)
+		{
+			comma = text.size();
+		}
+		if (!parse(text.substr(start, comma - start)))
+		{
+			return false;
+		}
+		start = comma + 1;
+	}
+	return true;
+}
+
+// Indexed by BenchmarkDispatchMode, as given to --bench-dispatch
+static const char* gDispatchModeNames[] = { "tiles", "batched", "indirect" };
+
+bool ExtractBenchmarkOptions(std::vector<std::string>& args, BenchmarkMatrix& matrix)
+{
+	matrix.bEnabled = false;
+	matrix.overlap.clear();
+	matrix.tileSizes.clear();
+	matrix.widths.clear();
+	matrix.heights.clear();
+	matrix.dispatchModes.clear();
+	matrix.framesInFlight.clear();
+	matrix.workloads.clear();
+	matrix.warmupFrames = 30;
+	matrix.measuredFrames = 300;
+	matrix.reportPath.clear();
+
+	std::vector<std::string> remaining;
+	for (size_t i = 0; i < args.size(); i++)
+	{
+		const std::string& arg = args[i];
+		bool hasValue = (i + 1 < args.size());
+		bool ok = true;
+
+		if (arg == "--bench")
+		{
+			matrix.bEnabled = true;
+		}
+		else if (arg == "--bench-overlap" && hasValue)
+		{
+			ok = ParseList(args[++i], [&matrix](const std::string& item)
+			{
+				if (item != "on" && item != "off")
+				{
+					return false;
+				}
+				matrix.overlap.push_back(item == "on");
+				return true;
+			});
+		}
+		else if (arg == "--bench-tiles" && hasValue)
+		{
+			ok = ParseList(args[++i], [&matrix](const std::string& item)
+			{
+				uint32_t tileSize = 0;
+				if (!ParseUIntArgument(item, tileSize) || !TileGrid::IsSupportedTileSize(tileSize))
+				{
+					return false;
+				}
+				matrix.tileSizes.push_back(tileSize);
+				return true;
+			});
+		}
+		else if (arg == "--bench-resolutions" && hasValue)
+		{
+			ok = ParseList(args[++i], [&matrix](const std::string& item)
+			{
+				uint32_t width = 0;
+				uint32_t height = 0;
+				if (!ParseResolution(item, width, height))
+				{
+					return false;
+				}
+				matrix.widths.push_back(width);
+				matrix.heights.push_back(height);
+				return true;
+			});
+		}
+		else if (arg == "--bench-dispatch" && hasValue)
+		{
+			ok = ParseList(args[++i], [&matrix](const std::string& item)
+			{
+				if (item == "tiles")          matrix.dispatchModes.push_back(BENCH_DISPATCH_TILES);
+				else if (item == "batched")   matrix.dispatchModes.push_back(BENCH_DISPATCH_BATCHED);
+				else if (item == "indirect")  matrix.dispatchModes.push_back(BENCH_DISPATCH_INDIRECT);
+				else                          return false;
+				return true;
+			});
+		}
+		else if (arg == "--bench-frames-in-flight" && hasValue)
+		{
+			ok = ParseList(args[++i], [&matrix](const std::string& item)
+			{
+				uint32_t count = 0;
+				if (!ParseUIntArgument(item, count) || count < 1 || count > GFX_MAX_FRAMES_IN_FLIGHT)
+				{
+					return false;
+				}
+				matrix.framesInFlight.push_back(count);
+				return true;
+			});
+		}
+		else if (arg == "--bench-workloads" && hasValue)
+		{
+			ok = ParseList(args[++i], [&matrix](const std::string& item)
+			{
+				ComputeWorkload workload;
+				if (!ParseComputeWorkload(item, workload))
+				{
+					return false;
+				}
+				matrix.workloads.push_back(workload);
+				return true;
+			});
+		}
+		else if (arg == "--bench-warmup" && hasValue)  ok = ParseUIntArgument(args[++i], matrix.warmupFrames);
+		else if (arg == "--bench-frames" && hasValue)  ok = ParseUIntArgument(args[++i], matrix.measuredFrames) && matrix.measuredFrames > 0;
+		else if (arg == "--bench-report" && hasValue)  matrix.reportPath = args[++i];
+		else if (arg.compare(0, 7, "--bench") == 0)    ok = false;
+		else                                           remaining.push_back(arg);
+
+		if (!ok)
+		{
+			return false;
+		}
+	}
+
+	if (matrix.overlap.empty())
+	{
+		matrix.overlap.push_back(false);
+		matrix.overlap.push_back(true);
+	}
+	if (matrix.tileSizes.empty())
+	{
+		matrix.tileSizes.push_back(16);
+	}
+	if (matrix.widths.empty())
+	{
+		matrix.widths.push_back(1280);
+		matrix.heights.push_back(720);
+	}
+	if (matrix.dispatchModes.empty())
+	{
+		matrix.dispatchModes.push_back(BENCH_DISPATCH_TILES);
+	}
+	if (matrix.framesInFlight.empty())
+	{
+		matrix.framesInFlight.push_back(1);
+	}
+	if (matrix.workloads.empty())
+	{
+		matrix.workloads.push_back(ComputeWorkload());
+	}
+
+	args.swap(remaining);
+	return true;
+}
+
+void ComputeSampleStatistics(const std::vector<double>& samples, double& mean, double& stddev, double& ci95Low, double& ci95High)
+{
+	mean = stddev = ci95Low = ci95High = 0.0;
+	if (samples.empty())
+	{
+		return;
+	}
+
+	double total = 0.0;
+	for (double sample : samples)
+	{
+		total += sample;
+	}
+	mean = total / (double)samples.size();
+
+	double squares = 0.0;
+	for (double sample : samples)
+	{
+		squares += (sample - mean) * (sample - mean);
+	}
+	stddev = samples.size() > 1 ? std::sqrt(squares / (double)(samples.size() - 1)) : 0.0;
+
+	double halfWidth = StudentT95(samples.size() - 1) * stddev / std::sqrt((double)samples.size());
+	ci95Low = mean - halfWidth;
+	ci95High = mean + halfWidth;
+}
+
+// Warm-up, then measured frames, of one configuration on a new device
+static void RunConfiguration(const BenchmarkMatrix& matrix, GraphicsDevice* device, BenchmarkResult& result)
+{
+	// An empty command line gives the defaults, which the configuration then overrides
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = result.width;
+	options.height = result.height;
+	options.tileSize = result.tileSize;
+	options.bUseUAVOverlap = result.bOverlap;
+	options.bUseBatchedDispatch = result.bBatched;
+	options.bUseIndirectDispatch = result.bIndirect;
+	options.framesInFlight = result.framesInFlight;
+	options.workload = result.workload;
+
+	UAVOverlapSampleApp app(device, options.width, options.height);
+	app.ApplyOptions(options);
+	if (!app.Init())
+	{
+		result.bFailed = true;
+		app.Cleanup();
+		return;
+	}
+
+	result.bOverlapActive = result.bOverlap && device->IsUAVOverlapSupported();
+
+	// Frame times are handed back to the app for its own overlay, as the interactive loop does
+	double frameTime = 0.0;
+	for (uint32_t frame = 0; frame < matrix.warmupFrames; frame++)
+	{
+		std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+		app.Render(frameTime);
+		frameTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+	}
+
+	app.GetFramePacer().ResetReport();
+
+	std::vector<double> samples;
+	samples.reserve(matrix.measuredFrames);
+	for (uint32_t frame = 0; frame < matrix.measuredFrames; frame++)
+	{
+		std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+		app.Render(frameTime);
+		frameTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+		samples.push_back(frameTime);
+	}
+
+	result.frameCount = (uint32_t)samples.size();
+	ComputeSampleStatistics(samples, result.meanMs, result.stddevMs, result.ci95LowMs, result.ci95HighMs);
+
+	std::sort(samples.begin(), samples.end());
+	result.minMs = samples.front();
+	result.maxMs = samples.back();
+	result.p50Ms = samples[(samples.size() - 1) / 2];
+	result.p99Ms = samples[(size_t)std::ceil(0.99 * (double)samples.size()) - 1];
+
+	result.computeMs = app.GetPassTimer().GetAveragePassMs(PASS_COMPUTE);
+	result.compositeMs = app.GetPassTimer().GetAveragePassMs(PASS_COMPOSITE);
+
+	app.FinishFrames();
+	FramePacer::Report pacing = app.GetFramePacer().GetReport();
+	result.throughputFps = pacing.throughputFps;
+	result.latencyMeanMs = pacing.latency.meanMs;
+	result.latencyP95Ms = pacing.latency.p95Ms;
+
+	app.Cleanup();
+}
+
+bool RunBenchmarkMatrix(const BenchmarkMatrix& matrix, const GraphicsDeviceFactory& createDevice, FILE* log, std::vector<BenchmarkResult>& results)
+{
+	results.clear();
+
+	std::string deviceName = "unknown";
+	bool ok = true;
+
+	fprintf(log, "%-9s %-7s %5s %-10s %-8s %6s %-10s %9s %10s %9s %21s %9s %10s %10s %10s\n", "overlap", "active", "tile", "resolution", "mode", "flight",
+		"workload", "dispatch", "mean ms", "stddev", "95% CI", "p99 ms", "compute", "composite", "latency");
+
+	for (size_t r = 0; r < matrix.widths.size(); r++)
+	{
+		for (uint32_t tileSize : matrix.tileSizes)
+		{
+			for (BenchmarkDispatchMode dispatchMode : matrix.dispatchModes)
+			{
+				for (uint32_t framesInFlight : matrix.framesInFlight)
+				{
+					for (const ComputeWorkload& workload : matrix.workloads)
+					{
+						for (bool overlap : matrix.overlap)
+						{
+							BenchmarkResult result = {};
+							result.bOverlap = overlap;
+							result.tileSize = tileSize;
+							result.width = matrix.widths[r];
+							result.height = matrix.heights[r];
+							result.bBatched = (dispatchMode == BENCH_DISPATCH_BATCHED);
+							result.bIndirect = (dispatchMode == BENCH_DISPATCH_INDIRECT);
+							result.framesInFlight = framesInFlight;
+							result.workload = workload;
+							result.dispatchCount = dispatchMode != BENCH_DISPATCH_TILES ? 1 : TileGrid(result.width, result.height, tileSize).GetTileCount();
+
+							std::unique_ptr<GraphicsDevice> device = createDevice();
+							deviceName = device->GetName();
+							RunConfiguration(matrix, device.get(), result);
+							results.push_back(result);
+
+							if (result.bFailed)
+							{
+								fprintf(log, "%-9s failed to initialize the %s device at %ux%u\n", overlap ? "on" : "off", device->GetName(), result.width, result.height);
+								ok = false;
+								continue;
+							}
+
+							char resolution[32];
+							snprintf(resolution, sizeof(resolution), "%ux%u", result.width, result.height);
+							fprintf(log, "%-9s %-7s %5u %-10s %-8s %6u %-10s %9u %10.4f %9.4f [%9.4f, %9.4f] %9.4f %10.4f %10.4f %10.4f\n",
+								overlap ? "on" : "off", result.bOverlapActive ? "yes" : "no", tileSize, resolution, gDispatchModeNames[dispatchMode], framesInFlight,
+								FormatComputeWorkload(workload).c_str(), result.dispatchCount, result.meanMs, result.stddevMs, result.ci95LowMs, result.ci95HighMs,
+								result.p99Ms, result.computeMs, result.compositeMs, result.latencyMeanMs);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (!matrix.reportPath.empty() && !WriteBenchmarkReport(matrix.reportPath.c_str(), deviceName.c_str(), results))
+	{
+		fprintf(log, "Failed to write %s\n", matrix.reportPath.c_str());
+		ok = false;
+	}
+
+	return ok;
+}
+
+static void WriteBenchmarkCSV(FILE* file, const char* deviceName, const std::vector<BenchmarkResult>& results)
+{
+	fprintf(file, "device,overlap,overlap_active,tile,width,height,batched,indirect,frames_in_flight,workload,dispatches,frames,mean_ms,stddev_ms,ci95_low_ms,"
+		"ci95_high_ms,min_ms,max_ms,p50_ms,p99_ms,compute_ms,composite_ms,throughput_fps,latency_mean_ms,latency_p95_ms,failed\n");
+	for (const BenchmarkResult& result : results)
+	{
+		fprintf(file, "%s,%d,%d,%u,%u,%u,%d,%d,%u,%s,%u,%u,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%d\n", deviceName,
+			result.bOverlap ? 1 : 0, result.bOverlapActive ? 1 : 0, result.tileSize, result.width, result.height, result.bBatched ? 1 : 0, result.bIndirect ? 1 : 0,
+			result.framesInFlight, FormatComputeWorkload(result.workload).c_str(), result.dispatchCount, result.frameCount, result.meanMs, result.stddevMs,
+			result.ci95LowMs, result.ci95HighMs, result.minMs, result.maxMs, result.p50Ms, result.p99Ms, result.computeMs, result.compositeMs,
+			result.throughputFps, result.latencyMeanMs, result.latencyP95Ms, result.bFailed ? 1 : 0);
+	}
+}
+
+static void WriteBenchmarkJSON(FILE* file, const char* deviceName, const std::vector<BenchmarkResult>& results)
+{
+	fprintf(file, "{\n  \"device\": \"%s\",\n  \"configurations\": [", deviceName);
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& result = results[i];
+		fprintf(file, "%s\n    { \"overlap\": %s, \"overlap_active\": %s, \"tile\": %u, \"width\": %u, \"height\": %u, \"batched\": %s, "
+			"\"indirect\": %s, \"frames_in_flight\": %u, \"workload\": \"%s\", \"dispatches\": %u, \"frames\": %u, \"mean_ms\": %.6f, \"stddev_ms\": %.6f, "
+			"\"ci95_ms\": [%.6f, %.6f], "
+			"\"min_ms\": %.6f, \"max_ms\": %.6f, \"p50_ms\": %.6f, \"p99_ms\": %.6f, \"compute_ms\": %.6f, \"composite_ms\": %.6f, \"throughput_fps\": %.6f, "
+			"\"latency_mean_ms\": %.6f, \"latency_p95_ms\": %.6f, \"failed\": %s }",
+			i ? "," : "", result.bOverlap ? "true" : "false", result.bOverlapActive ? "true" : "false", result.tileSize, result.width,
+			result.height, result.bBatched ? "true" : "false", result.bIndirect ? "true" : "false", result.framesInFlight,
+			FormatComputeWorkload(result.workload).c_str(), result.dispatchCount, result.frameCount,
+			result.meanMs, result.stddevMs, result.ci95LowMs, result.ci95HighMs, result.minMs, result.maxMs, result.p50Ms, result.p99Ms, result.computeMs,
+			result.compositeMs, result.throughputFps, result.latencyMeanMs, result.latencyP95Ms, result.bFailed ? "true" : "false");
+	}
+	fprintf(file, "\n  ]\n}\n");
+}
+
+bool WriteBenchmarkReport(const char* path, const char* deviceName, const std::vector<BenchmarkResult>& results)
+{
+	FILE* file = OpenFile(path, "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	size_t length = strlen(path);
+	if (length >= 5 && strcmp(path + length - 5, ".json") == 0)
+	{
+		WriteBenchmarkJSON(file, deviceName, results);
+	}
+	else
+	{
+		WriteBenchmarkCSV(file, deviceName, results);
+	}
+
+	return fclose(file) == 0;
+}
@@ -0,0 +1,121 @@
+/***********************************************************************
+ **	Name:        CPUComputeBackend.cpp                                **
+ **	Description: CPU reference backend for Shaders/ComputeShader.hlsl **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com         **
+ **	Published:   <insert date>                                        **
+ **********************************************************************/
+
+#include "CPUComputeBackend.h"
+#include "ComputeWorkload.h"
+
+#include <atomic>
+
+// Resolved on first use so that CPU detection runs before any dispatch, not during static initialization
+static std::atomic<KernelISA>& KernelISASelection()
+{
+	static std::atomic<KernelISA> selection(GetBestKernelISA());
+	return selection;
+}
+
+uint32_t PackUNorm4x8(float r, float g, float b, float a)
+{
+	return FloatToUNorm8(r) | (FloatToUNorm8(g) << 8) | (FloatToUNorm8(b) << 16) | (FloatToUNorm8(a) << 24);
+}
+
+void CPUComputeBackend::BuildTileConstants(const TileGrid& grid, std::vector<ConstantBuffer>& tiles)
+{
+	tiles.resize(grid.GetTileCount());
+	for (uint32_t i = 0; i < grid.GetTileCount(); i++)
+	{
+		TileGrid::Tile tile = grid.GetTile(i);
+		tiles[i].dispatchX = tile.tileX;
+		tiles[i].dispatchY = tile.tileY;
+		tiles[i].windowWidth = grid.GetWidth();
+		tiles[i].windowHeight = grid.GetHeight();
+	}
+}
+
+bool CPUComputeBackend::SetKernelISA(KernelISA isa)
+{
+	if (!IsKernelISASupported(isa))
+	{
+		return false;
+	}
+	KernelISASelection().store(isa);
+	return true;
+}
+
+KernelISA CPUComputeBackend::GetKernelISA()
+{
+	return KernelISASelection().load();
+}
+
+void CPUComputeBackend::RunThreadGroup(const ConstantBuffer& cb, uint32_t tileSize, uint32_t groupX, uint32_t groupY, CPUTexture2D& uav)
+{
+	// The GPU lowers the divide in the shader to a reciprocal and a multiply, so do the same here
+	float invWidth = 1.0f / (float)cb.windowWidth;
+	float invHeight = 1.0f / (float)cb.windowHeight;
+
+	// Clip the group against the window, and the texture, up front rather than testing every thread
+	uint32_t clipWidth = cb.windowWidth < uav.width ? cb.windowWidth : uav.width;
+	uint32_t clipHeight = cb.windowHeight < uav.height ? cb.windowHeight : uav.height;
+	uint32_t tileX = (cb.dispatchX + groupX) * tileSize;
+	uint32_t tileY = (cb.dispatchY + groupY) * tileSize;
+	if (tileX >= clipWidth || tileY >= clipHeight)
+	{
+		return;
+	}
+	uint32_t threadsX = (tileX + tileSize <= clipWidth) ? tileSize : (clipWidth - tileX);
+	uint32_t threadsY = (tileY + tileSize <= clipHeight) ? tileSize : (clipHeight - tileY);
+
+	// Each row of the group is one kernel call: red varies with x, green, blue and alpha are fixed per row
+	GradientRowKernel kernel = GetGradientRowKernel(GetKernelISA());
+	for (uint32_t groupThreadY = 0; groupThreadY < threadsY; groupThreadY++)
+	{
+		uint32_t ycoord = tileY + groupThreadY;
+		uint32_t rowBits = PackUNorm4x8(0.0f, (float)ycoord * invHeight, 0.5f, 1.0f);
+		kernel(&uav.texels[(size_t)ycoord * uav.width + tileX], tileX, threadsX, invWidth, rowBits);
+	}
+}
+
+void CPUComputeBackend::RunTileListGroup(const ConstantBuffer& cb, uint32_t tileSize, const uint32_t* tiles, uint32_t tileCount, uint32_t groupX, uint32_t groupY, CPUTexture2D& uav,
+	const CPUWorkloadBinding* workload)
+{
+	uint64_t entry = (uint64_t)groupY * CS_TILE_LIST_ROW_GROUPS + groupX;
+	if (entry >= tileCount)
+	{
+		return;
+	}
+	if (workload != nullptr)
+	{
+		RunWorkloadThreadGroup(cb, *workload, tileSize, tiles[entry] & 0xFFFF, tiles[entry] >> 16, uav);
+	}
+	else
+	{
+		RunThreadGroup(cb, tileSize, tiles[entry] & 0xFFFF, tiles[entry] >> 16, uav);
+	}
+}
+
+void CPUComputeBackend::DispatchTiles(const ConstantBuffer* tiles, uint32_t tileCount, CPUTexture2D& uav)
+{
+	uint32_t tileSize = mTileSize;
+	mThreadPool.ParallelFor(tileCount, 0, [tiles, tileSize, &uav](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			RunThreadGroup(tiles[i], tileSize, 0, 0, uav);
+		}
+	});
+}
+
+void CPUComputeBackend::Dispatch(const ConstantBuffer& cb, uint32_t groupsX, uint32_t groupsY, CPUTexture2D& uav)
+{
+	uint32_t tileSize = mTileSize;
+	mThreadPool.ParallelFor(groupsX * groupsY, 0, [&cb, tileSize, groupsX, &uav](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; i++)
+		{
+			RunThreadGroup(cb, tileSize, i % groupsX, i / groupsX, uav);
+		}
+	});
+}
@@ -0,0 +1,1155 @@
+/*****************************************************************
+ **	Name:        CPUGraphicsDevice.cpp                          **
+ **	Description: CPU reference implementation of GraphicsDevice **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com   **
+ **	Published:   <insert date>                                  **
+ ****************************************************************/
+
+#include "CPUGraphicsDevice.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "imgui.h"
+
+#ifdef UAVOVERLAP_INTC_STUB
+#include "IntelExtensionsStub.h"
+#endif
+
+CPUGraphicsDevice::CPUGraphicsDevice(uint32_t threadCount, FrameClockFn clock) : mThreadPool(threadCount), mBackend(mThreadPool), mScheduler(mBackend),
+	mUIRasterizer(&mThreadPool)
+{
+	mLastFrameStats = DispatchScheduler::Stats();
+	mLastUIStats = UIRasterizer::Stats();
+	bRasterizeUI = false;
+	mWidth = 0;
+	mHeight = 0;
+	mBackBuffer = GFX_NULL_HANDLE;
+	mBackBufferRTV = GFX_NULL_HANDLE;
+	mFontTexture = GFX_NULL_HANDLE;
+	mStartupTimer = nullptr;
+
+	mBoundCS = GFX_NULL_HANDLE;
+	mBoundUAV = GFX_NULL_HANDLE;
+	mBoundConstantBuffer = GFX_NULL_HANDLE;
+	mBoundCSSRV = GFX_NULL_HANDLE;
+	mBoundCSSource = GFX_NULL_HANDLE;
+	mBoundVS = GFX_NULL_HANDLE;
+	mBoundPS = GFX_NULL_HANDLE;
+	mBoundSRV = GFX_NULL_HANDLE;
+	mBoundRTV = GFX_NULL_HANDLE;
+	mBoundInputLayout = GFX_NULL_HANDLE;
+	mBoundVertexBuffer = GFX_NULL_HANDLE;
+	mViewportWidth = 0.0f;
+	mViewportHeight = 0.0f;
+
+	mClock = clock;
+	mQueryLatency = 0;
+	mPresentCount = 0;
+
+	mMaxFramesInFlight = 1;
+	for (uint64_t& value : mFrameFenceValues)
+	{
+		value = 0;
+	}
+
+	mINTCExtensionContext = nullptr;
+	bUAVOverlapSupported = false;
+}
+
+CPUGraphicsDevice::~CPUGraphicsDevice()
+{
+	// The timeline runs what was submitted before it goes, and may queue more on the pool while it does
+	mTimeline.reset();
+	mThreadPool.Wait();
+}
+
+bool CPUGraphicsDevice::Init(uint32_t width, uint32_t height)
+{
+	mWidth = width;
+	mHeight = height;
+
+	// The CPU backend never presents, so the back buffer is always offscreen
+	BeginStartupPhase(mStartupTimer, "back buffer");
+	mBackBuffer = CreateTexture2D(width, height, GFX_BIND_RENDER_TARGET);
+	mBackBufferRTV = CreateRenderTargetView(mBackBuffer);
+	EndStartupPhase(mStartupTimer);
+
+	BeginStartupPhase(mStartupTimer, "extension context");
+#ifdef UAVOVERLAP_INTC_STUB
+	// Negotiate the extension exactly as the D3D11 device does; there is no D3D11 device to pass
+	bUAVOverlapSupported = CreateIntelExtensionContext(nullptr, &mINTCExtensionContext);
+	if (bUAVOverlapSupported)
+	{
+		INTCStub_SetOverlapHandler(mINTCExtensionContext, OnUAVOverlapBracket, this);
+	}
+#else
+	bUAVOverlapSupported = true;
+#endif
+	EndStartupPhase(mStartupTimer);
+
+	if (mMaxFramesInFlight > 1)
+	{
+		mTimeline.reset(new DeviceTimeline());
+	}
+
+	mScheduler.BeginFrame();
+	return mBackBufferRTV != GFX_NULL_HANDLE;
+}
+
+bool CPUGraphicsDevice::ResizeBuffers(uint32_t width, uint32_t height)
+{
+	if (width == 0 || height == 0 || !IsObject(mBackBuffer, OBJECT_TEXTURE))
+	{
+		return false;
+	}
+
+	// Recorded clears and draws point at the old back buffer. Both handles stay, now holding the new texture.
+	WaitForIdle();
+	std::shared_ptr<CPUTexture2D> backBuffer = std::make_shared<CPUTexture2D>(width, height);
+	mObjects.Get(mBackBuffer).texture = backBuffer;
+	mObjects.Get(mBackBufferRTV).texture = backBuffer;
+	mBoundRTV = GFX_NULL_HANDLE;
+
+	mWidth = width;
+	mHeight = height;
+	return true;
+}
+
+void CPUGraphicsDevice::Cleanup()
+{
+	WaitForIdle();
+	mTimeline.reset();
+
+#ifdef UAVOVERLAP_INTC_STUB
+	DestroyIntelExtensionContext(&mINTCExtensionContext);
+#endif
+	bUAVOverlapSupported = false;
+
+	mObjects.Clear();
+	mBackBuffer = GFX_NULL_HANDLE;
+	mBackBufferRTV = GFX_NULL_HANDLE;
+}
+
+GfxTexture CPUGraphicsDevice::CreateTexture2D(uint32_t width, uint32_t height, uint32_t bindFlags)
+{
+	Object object;
+	object.type = OBJECT_TEXTURE;
+	object.bindFlags = bindFlags;
+	object.texture = std::make_shared<CPUTexture2D>(width, height);
+	return mObjects.Add(object);
+}
+
+GfxView CPUGraphicsDevice::CreateView(GfxTexture texture, ObjectType viewType, uint32_t requiredBindFlag)
+{
+	if (!IsObject(texture, OBJECT_TEXTURE) || (mObjects.Get(texture).bindFlags & requiredBindFlag) == 0)
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	// Views share ownership of the texture, as D3D11 views hold a reference on their resource
+	Object object;
+	object.type = viewType;
+	object.texture = mObjects.Get(texture).texture;
+	return mObjects.Add(object);
+}
+
+GfxView CPUGraphicsDevice::CreateShaderResourceView(GfxTexture texture)
+{
+	if (IsObject(texture, OBJECT_BUFFER) && mObjects.Get(texture).stride > 0)
+	{
+		Object object;
+		object.type = OBJECT_BUFFER_SRV;
+		object.buffer = texture;
+		return mObjects.Add(object);
+	}
+	return CreateView(texture, OBJECT_SRV, GFX_BIND_SHADER_RESOURCE);
+}
+
+GfxView CPUGraphicsDevice::CreateUnorderedAccessView(GfxTexture texture)
+{
+	return CreateView(texture, OBJECT_UAV, GFX_BIND_UNORDERED_ACCESS);
+}
+
+GfxView CPUGraphicsDevice::CreateRenderTargetView(GfxTexture texture)
+{
+	return CreateView(texture, OBJECT_RTV, GFX_BIND_RENDER_TARGET);
+}
+
+GfxBuffer CPUGraphicsDevice::CreateConstantBuffer(const void* data, uint32_t byteWidth)
+{
+	Object object;
+	object.type = OBJECT_BUFFER;
+	object.data.assign((const uint8_t*)data, (const uint8_t*)data + byteWidth);
+	return mObjects.Add(object);
+}
+
+GfxBuffer CPUGraphicsDevice::CreateVertexBuffer(const void* data, uint32_t byteWidth)
+{
+	return CreateConstantBuffer(data, byteWidth);
+}
+
+GfxBuffer CPUGraphicsDevice::CreateStructuredBuffer(const void* data, uint32_t stride, uint32_t count)
+{
+	if (data == nullptr || stride == 0 || count == 0)
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.type = OBJECT_BUFFER;
+	object.stride = stride;
+	object.data.assign((const uint8_t*)data, (const uint8_t*)data + (size_t)stride * count);
+	return mObjects.Add(object);
+}
+
+GfxBuffer CPUGraphicsDevice::CreateIndirectArgumentBuffer(const void* data, uint32_t byteWidth)
+{
+	Object object;
+	object.type = OBJECT_BUFFER;
+	object.bIndirectArguments = true;
+	object.data.assign(byteWidth, 0);
+	if (data != nullptr)
+	{
+		memcpy(object.data.data(), data, byteWidth);
+	}
+	return mObjects.Add(object);
+}
+
+GfxShader CPUGraphicsDevice::CreateShader(const char* name, ObjectType type)
+{
+	Object object;
+	object.type = type;
+
+	if (type == OBJECT_COMPUTE_SHADER)
+	{
+		if (strcmp(name, "ComputeShader") == 0)             object.tileSize = 16;
+		else if (strcmp(name, "ComputeShaderTile8") == 0)   object.tileSize = 8;
+		else if (strcmp(name, "ComputeShaderTile32") == 0)  object.tileSize = 32;
+		else if (strcmp(name, "ComputeShaderList") == 0)        { object.tileSize = 16; object.bTileList = true; }
+		else if (strcmp(name, "ComputeShaderTile8List") == 0)   { object.tileSize = 8; object.bTileList = true; }
+		else if (strcmp(name, "ComputeShaderTile32List") == 0)  { object.tileSize = 32; object.bTileList = true; }
+		else if (strcmp(name, "ComputeWorkload") == 0)             { object.tileSize = 16; object.bWorkload = true; }
+		else if (strcmp(name, "ComputeWorkloadTile8") == 0)        { object.tileSize = 8; object.bWorkload = true; }
+		else if (strcmp(name, "ComputeWorkloadTile32") == 0)       { object.tileSize = 32; object.bWorkload = true; }
+		else if (strcmp(name, "ComputeWorkloadList") == 0)         { object.tileSize = 16; object.bTileList = true; object.bWorkload = true; }
+		else if (strcmp(name, "ComputeWorkloadTile8List") == 0)    { object.tileSize = 8; object.bTileList = true; object.bWorkload = true; }
+		else if (strcmp(name, "ComputeWorkloadTile32List") == 0)   { object.tileSize = 32; object.bTileList = true; object.bWorkload = true; }
+		else return GFX_NULL_HANDLE;
+	}
+	else if (type == OBJECT_VERTEX_SHADER && strcmp(name, "VertexShader") != 0)
+	{
+		return GFX_NULL_HANDLE;
+	}
+	else if (type == OBJECT_PIXEL_SHADER && strcmp(name, "PixelShader") != 0)
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	return mObjects.Add(object);
+}
+
+GfxShader CPUGraphicsDevice::CreateComputeShader(const char* name)
+{
+	return CreateShader(name, OBJECT_COMPUTE_SHADER);
+}
+
+GfxShader CPUGraphicsDevice::CreateVertexShader(const char* name)
+{
+	return CreateShader(name, OBJECT_VERTEX_SHADER);
+}
+
+GfxShader CPUGraphicsDevice::CreatePixelShader(const char* name)
+{
+	return CreateShader(name, OBJECT_PIXEL_SHADER);
+}
+
+GfxInputLayout CPUGraphicsDevice::CreateInputLayout(GfxShader vertexShader)
+{
+	if (!IsObject(vertexShader, OBJECT_VERTEX_SHADER))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.type = OBJECT_INPUT_LAYOUT;
+	return mObjects.Add(object);
+}
+
+void CPUGraphicsDevice::Release(GfxHandle handle)
+{
+	if (mObjects.IsValid(handle))
+	{
+		// In-flight dispatches may still be writing to a texture that is about to go away, and recorded work may
+		// still point into the object
+		WaitForIdle();
+		mObjects.Remove(handle);
+	}
+}
+
+CPUTexture2D* CPUGraphicsDevice::GetTexture(GfxHandle handle, ObjectType type)
+{
+	return IsObject(handle, type) ? mObjects.Get(handle).texture.get() : nullptr;
+}
+
+void CPUGraphicsDevice::CSSetShaderResource(uint32_t slot, GfxView view)
+{
+	if (slot == 0)
+	{
+		mBoundCSSRV = view;
+	}
+	else if (slot == 1)
+	{
+		mBoundCSSource = view;
+		if (IsObject(view, OBJECT_SRV))
+		{
+			RunOnTimeline([this]() { mScheduler.Barrier(); });
+		}
+	}
+}
+
+void CPUGraphicsDevice::Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+{
+	ComputeBindings bindings = { mBoundCS, mBoundUAV, mBoundConstantBuffer, mBoundCSSRV, mBoundCSSource };
+	RunDispatch(bindings, groupsX, groupsY, groupsZ);
+}
+
+void CPUGraphicsDevice::DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset)
+{
+	uint32_t groups[3];
+	if (ReadIndirectArguments(arguments, byteOffset, groups))
+	{
+		ComputeBindings bindings = { mBoundCS, mBoundUAV, mBoundConstantBuffer, mBoundCSSRV, mBoundCSSource };
+		RunDispatch(bindings, groups[0], groups[1], groups[2]);
+	}
+}
+
+bool CPUGraphicsDevice::ReadIndirectArguments(GfxBuffer arguments, uint32_t byteOffset, uint32_t groups[3]) const
+{
+	// D3D11 requires a 4-byte aligned offset with all three arguments inside the buffer
+	if (!IsObject(arguments, OBJECT_BUFFER) || !mObjects.Get(arguments).bIndirectArguments || (byteOffset & 3) != 0 ||
+		(uint64_t)byteOffset + 3 * sizeof(uint32_t) > mObjects.Get(arguments).data.size())
+	{
+		return false;
+	}
+
+	memcpy(groups, mObjects.Get(arguments).data.data() + byteOffset, 3 * sizeof(uint32_t));
+	return true;
+}
+
+void CPUGraphicsDevice::RunDispatch(const ComputeBindings& bindings, uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+{
+	CPUTexture2D* uav = GetTexture(bindings.uav, OBJECT_UAV);
+	if (!IsObject(bindings.shader, OBJECT_COMPUTE_SHADER) || !IsObject(bindings.constantBuffer, OBJECT_BUFFER) || uav == nullptr)
+	{
+		// D3D11 drops a dispatch with missing bindings too, it just reports it through the debug layer
+		return;
+	}
+
+	const std::vector<uint8_t>& data = mObjects.Get(bindings.constantBuffer).data;
+	if (data.size() < sizeof(CPUComputeBackend::ConstantBuffer))
+	{
+		return;
+	}
+
+	CPUComputeBackend::ConstantBuffer cb;
+	memcpy(&cb, data.data(), sizeof(cb));
+
+	// The kernel ignores SV_GroupID.z, so extra Z slices would only repeat the same writes
+	const Object& shader = mObjects.Get(bindings.shader);
+	if (groupsZ == 0)
+	{
+		return;
+	}
+
+	// The workload shaders read their knobs from the second row of the constant buffer, and their source from t1
+	CPUWorkloadBinding workload = {};
+	if (shader.bWorkload)
+	{
+		if (data.size() < sizeof(cb) + sizeof(ComputeWorkload))
+		{
+			return;
+		}
+		memcpy(&workload.workload, data.data() + sizeof(cb), sizeof(ComputeWorkload));
+		workload.source = GetTexture(bindings.source, OBJECT_SRV);
+	}
+	const CPUWorkloadBinding* workloadBinding = shader.bWorkload ? &workload : nullptr;
+
+	if (!shader.bTileList)
+	{
+		QueueDispatch(cb, shader.tileSize, groupsX, groupsY, *uav, workloadBinding);
+		return;
+	}
+
+	// The tile-list variants read a structured buffer of uint32 entries from t0
+	if (!IsObject(bindings.tileList, OBJECT_BUFFER_SRV) || !IsObject(mObjects.Get(bindings.tileList).buffer, OBJECT_BUFFER))
+	{
+		return;
+	}
+	const Object& tiles = mObjects.Get(mObjects.Get(bindings.tileList).buffer);
+	if (tiles.stride != sizeof(uint32_t))
+	{
+		return;
+	}
+
+	uint32_t tileSize = shader.tileSize;
+	const uint32_t* tileList = (const uint32_t*)tiles.data.data();
+	uint32_t tileCount = (uint32_t)(tiles.data.size() / sizeof(uint32_t));
+	bool hasWorkload = shader.bWorkload;
+	RunOnTimeline([this, cb, tileSize, tileList, tileCount, groupsX, groupsY, uav, hasWorkload, workload]()
+	{
+		if (tileSize != mBackend.GetTileSize())
+		{
+			mScheduler.Barrier();
+			mBackend.SetTileSize(tileSize);
+		}
+		mScheduler.DispatchTileList(cb, tileList, tileCount, groupsX, groupsY, *uav, hasWorkload ? &workload : nullptr);
+	});
+}
+
+void CPUGraphicsDevice::QueueDispatch(const CPUComputeBackend::ConstantBuffer& cb, uint32_t tileSize, uint32_t groupsX, uint32_t groupsY, CPUTexture2D& uav,
+	const CPUWorkloadBinding* workload)
+{
+	CPUTexture2D* target = &uav;
+	bool hasWorkload = workload != nullptr;
+	CPUWorkloadBinding binding = hasWorkload ? *workload : CPUWorkloadBinding();
+	RunOnTimeline([this, cb, tileSize, groupsX, groupsY, target, hasWorkload, binding]()
+	{
+		// The shader's thread group size is fixed at compile time; switch the kernel over to it before queueing
+		if (tileSize != mBackend.GetTileSize())
+		{
+			mScheduler.Barrier();
+			mBackend.SetTileSize(tileSize);
+		}
+		mScheduler.Dispatch(cb, groupsX, groupsY, *target, hasWorkload ? &binding : nullptr);
+	});
+}
+
+void CPUGraphicsDevice::BeginUAVOverlap()
+{
+	if (!bUAVOverlapSupported)
+	{
+		return;
+	}
+#ifdef UAVOVERLAP_INTC_STUB
+	INTC_D3D11_BeginUAVOverlap(mINTCExtensionContext);
+#else
+	RunOnTimeline([this]() { mScheduler.BeginUAVOverlap(); });
+#endif
+}
+
+void CPUGraphicsDevice::EndUAVOverlap()
+{
+	if (!bUAVOverlapSupported)
+	{
+		return;
+	}
+#ifdef UAVOVERLAP_INTC_STUB
+	INTC_D3D11_EndUAVOverlap(mINTCExtensionContext);
+#else
+	RunOnTimeline([this]() { mScheduler.EndUAVOverlap(); });
+#endif
+}
+
+void CPUGraphicsDevice::OnUAVOverlapBracket(void* userData, bool begin)
+{
+	// The extension call is made when the bracket is recorded; the scheduler sees it when the timeline gets there
+	CPUGraphicsDevice* device = static_cast<CPUGraphicsDevice*>(userData);
+	if (begin)
+	{
+		device->RunOnTimeline([device]() { device->mScheduler.BeginUAVOverlap(); });
+	}
+	else
+	{
+		device->RunOnTimeline([device]() { device->mScheduler.EndUAVOverlap(); });
+	}
+}
+
+// Records resolved dispatches: validation and the constant buffer fetch happen on the recording thread, and the list
+// holds on to the UAV textures it writes. It only reads the device's object table, which is why objects must not be
+// created or released while a context is recording. Tile-list and indirect dispatches are recorded by handle instead
+// and resolved when the list executes, because their arguments live in buffers that are read on the GPU timeline.
+class CPUGraphicsDevice::DeferredContext : public GfxDeferredContext
+{
+public:
+	struct Command
+	{
+		enum Type
+		{
+			DISPATCH,
+			DISPATCH_BOUND,
+			DISPATCH_INDIRECT,
+			BEGIN_UAV_OVERLAP,
+			END_UAV_OVERLAP,
+			BIND_SOURCE
+		};
+
+		Type type;
+		CPUComputeBackend::ConstantBuffer cb;
+		uint32_t tileSize;
+		uint32_t groupsX;
+		uint32_t groupsY;
+		uint32_t groupsZ;                       // DISPATCH_BOUND
+		CPUTexture2D* uav;
+		bool bWorkload;                         // DISPATCH
+		CPUWorkloadBinding workload;            // DISPATCH
+		ComputeBindings bindings;               // DISPATCH_BOUND and DISPATCH_INDIRECT
+		GfxBuffer arguments;                    // DISPATCH_INDIRECT
+		uint32_t byteOffset;                    // DISPATCH_INDIRECT
+	};
+
+	struct CommandList
+	{
+		std::vector<Command> commands;
+		std::vector<std::shared_ptr<CPUTexture2D>> textures;
+	};
+
+	explicit DeferredContext(CPUGraphicsDevice* device) : mDevice(device)
+	{
+		ResetBindings();
+	}
+
+	virtual bool IsUAVOverlapSupported() const { return mDevice->IsUAVOverlapSupported(); }
+
+	virtual void CSSetShader(GfxShader shader)
+	{
+		mBindings.shader = shader;
+		mTileSize = mDevice->IsObject(shader, OBJECT_COMPUTE_SHADER) ? mDevice->mObjects.Get(shader).tileSize : 0;
+		mTileList = mTileSize != 0 && mDevice->mObjects.Get(shader).bTileList;
+		mWorkload = mTileSize != 0 && mDevice->mObjects.Get(shader).bWorkload;
+	}
+
+	virtual void CSSetUnorderedAccessView(uint32_t slot, GfxView view)
+	{
+		if (slot != 0)
+		{
+			return;
+		}
+
+		mBindings.uav = view;
+		mUAV = mDevice->IsObject(view, OBJECT_UAV) ? mDevice->mObjects.Get(view).texture : nullptr;
+		if (mUAV && (mRecording.textures.empty() || mRecording.textures.back() != mUAV))
+		{
+			mRecording.textures.push_back(mUAV);
+		}
+	}
+
+	virtual void CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer)
+	{
+		if (slot != 0)
+		{
+			return;
+		}
+
+		mBindings.constantBuffer = buffer;
+		// Constant buffers are immutable, so their contents can be read now rather than when the list executes
+		mConstantBuffer = nullptr;
+		mConstantBufferSize = 0;
+		if (mDevice->IsObject(buffer, OBJECT_BUFFER) && mDevice->mObjects.Get(buffer).data.size() >= sizeof(CPUComputeBackend::ConstantBuffer))
+		{
+			mConstantBuffer = mDevice->mObjects.Get(buffer).data.data();
+			mConstantBufferSize = mDevice->mObjects.Get(buffer).data.size();
+		}
+	}
+
+	virtual void CSSetShaderResource(uint32_t slot, GfxView view)
+	{
+		if (slot == 0)
+		{
+			mBindings.tileList = view;
+		}
+		else if (slot == 1)
+		{
+			// The list holds on to the source like it does to its UAVs, and waits for its writers when it executes
+			mBindings.source = view;
+			mSource = mDevice->IsObject(view, OBJECT_SRV) ? mDevice->mObjects.Get(view).texture : nullptr;
+			if (mSource)
+			{
+				mRecording.textures.push_back(mSource);
+				Command command = {};
+				command.type = Command::BIND_SOURCE;
+				mRecording.commands.push_back(command);
+			}
+		}
+	}
+
+	virtual void Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+	{
+		if (mTileList)
+		{
+			Command command = {};
+			command.type = Command::DISPATCH_BOUND;
+			command.groupsX = groupsX;
+			command.groupsY = groupsY;
+			command.groupsZ = groupsZ;
+			RecordBound(command);
+			return;
+		}
+
+		// Dropped for the same reasons CPUGraphicsDevice::Dispatch drops them
+		if (mTileSize == 0 || mConstantBuffer == nullptr || !mUAV || groupsZ == 0 ||
+			(mWorkload && mConstantBufferSize < sizeof(CPUComputeBackend::ConstantBuffer) + sizeof(ComputeWorkload)))
+		{
+			return;
+		}
+
+		Command command = {};
+		command.type = Command::DISPATCH;
+		memcpy(&command.cb, mConstantBuffer, sizeof(command.cb));
+		command.bWorkload = mWorkload;
+		if (mWorkload)
+		{
+			memcpy(&command.workload.workload, mConstantBuffer + sizeof(command.cb), sizeof(ComputeWorkload));
+			command.workload.source = mSource.get();
+		}
+		command.tileSize = mTileSize;
+		command.groupsX = groupsX;
+		command.groupsY = groupsY;
+		command.uav = mUAV.get();
+		mRecording.commands.push_back(command);
+	}
+
+	virtual void DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset)
+	{
+		Command command = {};
+		command.type = Command::DISPATCH_INDIRECT;
+		command.arguments = arguments;
+		command.byteOffset = byteOffset;
+		RecordBound(command);
+	}
+
+	virtual void BeginUAVOverlap() { RecordBracket(Command::BEGIN_UAV_OVERLAP); }
+	virtual void EndUAVOverlap() { RecordBracket(Command::END_UAV_OVERLAP); }
+
+	virtual void FinishCommandList()
+	{
+		mFinished = std::move(mRecording);
+		mRecording = CommandList();
+		ResetBindings();
+	}
+
+	void TakeCommandList(CommandList& list)
+	{
+		list = std::move(mFinished);
+		mFinished = CommandList();
+	}
+
+private:
+	void ResetBindings()
+	{
+		mBindings.shader = GFX_NULL_HANDLE;
+		mBindings.uav = GFX_NULL_HANDLE;
+		mBindings.constantBuffer = GFX_NULL_HANDLE;
+		mBindings.tileList = GFX_NULL_HANDLE;
+		mBindings.source = GFX_NULL_HANDLE;
+		mTileList = false;
+		mWorkload = false;
+		mTileSize = 0;
+		mUAV = nullptr;
+		mSource = nullptr;
+		mConstantBuffer = nullptr;
+		mConstantBufferSize = 0;
+	}
+
+	void RecordBracket(Command::Type type)
+	{
+		if (IsUAVOverlapSupported())
+		{
+			Command command = {};
+			command.type = type;
+			mRecording.commands.push_back(command);
+		}
+	}
+
+	void RecordBound(Command& command)
+	{
+		command.bindings = mBindings;
+		mRecording.commands.push_back(command);
+	}
+
+	CPUGraphicsDevice* mDevice;
+
+	ComputeBindings mBindings;
+	bool mTileList;
+	bool mWorkload;
+	uint32_t mTileSize;
+	std::shared_ptr<CPUTexture2D> mUAV;
+	std::shared_ptr<CPUTexture2D> mSource;
+	const uint8_t* mConstantBuffer;
+	size_t mConstantBufferSize;
+
+	CommandList mRecording;
+	CommandList mFinished;
+};
+
+std::unique_ptr<GfxDeferredContext> CPUGraphicsDevice::CreateDeferredContext()
+{
+	return std::unique_ptr<GfxDeferredContext>(new DeferredContext(this));
+}
+
+void CPUGraphicsDevice::ExecuteCommandList(GfxDeferredContext* context)
+{
+	if (context == nullptr)
+	{
+		return;
+	}
+
+	DeferredContext::CommandList list;
+	static_cast<DeferredContext*>(context)->TakeCommandList(list);
+
+	for (const DeferredContext::Command& command : list.commands)
+	{
+		switch (command.type)
+		{
+		case DeferredContext::Command::DISPATCH:
+			QueueDispatch(command.cb, command.tileSize, command.groupsX, command.groupsY, *command.uav, command.bWorkload ? &command.workload : nullptr);
+			break;
+		case DeferredContext::Command::DISPATCH_BOUND:
+			RunDispatch(command.bindings, command.groupsX, command.groupsY, command.groupsZ);
+			break;
+		case DeferredContext::Command::DISPATCH_INDIRECT:
+		{
+			uint32_t groups[3];
+			if (ReadIndirectArguments(command.arguments, command.byteOffset, groups))
+			{
+				RunDispatch(command.bindings, groups[0], groups[1], groups[2]);
+			}
+			break;
+		}
+		case DeferredContext::Command::BEGIN_UAV_OVERLAP:
+			BeginUAVOverlap();
+			break;
+		case DeferredContext::Command::END_UAV_OVERLAP:
+			EndUAVOverlap();
+			break;
+		case DeferredContext::Command::BIND_SOURCE:
+			RunOnTimeline([this]() { mScheduler.Barrier(); });
+			break;
+		}
+	}
+
+	// A texture released while the list was pending goes away with the list, so its writes must land first. The list's
+	// references travel down the timeline with its dispatches.
+	std::shared_ptr<std::vector<std::shared_ptr<CPUTexture2D>>> textures = std::make_shared<std::vector<std::shared_ptr<CPUTexture2D>>>(std::move(list.textures));
+	RunOnTimeline([this, textures]()
+	{
+		for (const std::shared_ptr<CPUTexture2D>& texture : *textures)
+		{
+			if (texture.use_count() == 1)
+			{
+				mScheduler.Barrier();
+				break;
+			}
+		}
+	});
+
+	// Like ExecuteCommandList(list, FALSE) on D3D11, leave nothing bound
+	mBoundCS = GFX_NULL_HANDLE;
+	mBoundUAV = GFX_NULL_HANDLE;
+	mBoundConstantBuffer = GFX_NULL_HANDLE;
+	mBoundCSSRV = GFX_NULL_HANDLE;
+	mBoundCSSource = GFX_NULL_HANDLE;
+	mBoundVS = GFX_NULL_HANDLE;
+	mBoundPS = GFX_NULL_HANDLE;
+	mBoundSRV = GFX_NULL_HANDLE;
+	mBoundRTV = GFX_NULL_HANDLE;
+	mBoundInputLayout = GFX_NULL_HANDLE;
+	mBoundVertexBuffer = GFX_NULL_HANDLE;
+	mViewportWidth = 0.0f;
+	mViewportHeight = 0.0f;
+}
+
+void CPUGraphicsDevice::ClearRenderTargetView(GfxView view, const float color[4])
+{
+	CPUTexture2D* target = GetTexture(view, OBJECT_RTV);
+	if (target != nullptr)
+	{
+		uint32_t value = PackUNorm4x8(color[0], color[1], color[2], color[3]);
+		RunOnTimeline([this, target, value]()
+		{
+			mScheduler.Barrier();
+			target->Clear(value);
+		});
+	}
+}
+
+// Bilinear, clamped sample of an RGBA8 texture at normalized coordinates (u, v)
+static uint32_t SampleBilinear(const CPUTexture2D& texture, float u, float v)
+{
+	float x = u * texture.width - 0.5f;
+	float y = v * texture.height - 0.5f;
+	float x0f = floorf(x);
+	float y0f = floorf(y);
+	float fx = x - x0f;
+	float fy = y - y0f;
+
+	int32_t maxX = (int32_t)texture.width - 1;
+	int32_t maxY = (int32_t)texture.height - 1;
+	int32_t x0 = (int32_t)x0f < 0 ? 0 : ((int32_t)x0f > maxX ? maxX : (int32_t)x0f);
+	int32_t y0 = (int32_t)y0f < 0 ? 0 : ((int32_t)y0f > maxY ? maxY : (int32_t)y0f);
+	int32_t x1 = x0 + 1 > maxX ? maxX : x0 + 1;
+	int32_t y1 = y0 + 1 > maxY ? maxY : y0 + 1;
+
+	uint32_t t00 = texture.texels[(size_t)y0 * texture.width + x0];
+	uint32_t t10 = texture.texels[(size_t)y0 * texture.width + x1];
+	uint32_t t01 = texture.texels[(size_t)y1 * texture.width + x0];
+	uint32_t t11 = texture.texels[(size_t)y1 * texture.width + x1];
+
+	float channels[4];
+	for (uint32_t c = 0; c < 4; c++)
+	{
+		uint32_t shift = c * 8;
+		float top = ((t00 >> shift) & 0xFF) * (1.0f - fx) + ((t10 >> shift) & 0xFF) * fx;
+		float bottom = ((t01 >> shift) & 0xFF) * (1.0f - fx) + ((t11 >> shift) & 0xFF) * fx;
+		channels[c] = (top * (1.0f - fy) + bottom * fy) / 255.0f;
+	}
+
+	return PackUNorm4x8(channels[0], channels[1], channels[2], channels[3]);
+}
+
+// Layout of UAVOverlapSampleApp::SimpleVertex, the only one CreateInputLayout() describes
+struct CPUVertex
+{
+	float position[3];
+	float uv[2];
+};
+
+void CPUGraphicsDevice::Draw(uint32_t vertexCount, uint32_t startVertex)
+{
+	// The only draw in the sample is the fullscreen triangle that samples the compute output
+	CPUTexture2D* source = GetTexture(mBoundSRV, OBJECT_SRV);
+	CPUTexture2D* target = GetTexture(mBoundRTV, OBJECT_RTV);
+	if (vertexCount != 3 || startVertex != 0 || source == nullptr || target == nullptr ||
+		!IsObject(mBoundVS, OBJECT_VERTEX_SHADER) || !IsObject(mBoundPS, OBJECT_PIXEL_SHADER) || !IsObject(mBoundVertexBuffer, OBJECT_BUFFER) ||
+		mObjects.Get(mBoundVertexBuffer).data.size() < 3 * sizeof(CPUVertex))
+	{
+		return;
+	}
+
+	uint32_t width = (uint32_t)mViewportWidth < target->width ? (uint32_t)mViewportWidth : target->width;
+	uint32_t height = (uint32_t)mViewportHeight < target->height ? (uint32_t)mViewportHeight : target->height;
+
+	// Texture coordinates are affine in screen space across a triangle: solve for the plane through the three vertices,
+	// in pixels, so the app can sample just part of a larger texture
+	CPUVertex vertices[3];
+	memcpy(vertices, mObjects.Get(mBoundVertexBuffer).data.data(), sizeof(vertices));
+	float px[3];
+	float py[3];
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		px[i] = (vertices[i].position[0] + 1.0f) * 0.5f * mViewportWidth;
+		py[i] = (1.0f - vertices[i].position[1]) * 0.5f * mViewportHeight;
+	}
+	float area = (px[1] - px[0]) * (py[2] - py[0]) - (px[2] - px[0]) * (py[1] - py[0]);
+	if (area == 0.0f)
+	{
+		return;
+	}
+
+	// uv(x, y) = uv[0] + dx * (x - px[0]) + dy * (y - py[0]), per component
+	float dx[2];
+	float dy[2];
+	float origin[2];
+	for (uint32_t c = 0; c < 2; c++)
+	{
+		float d1 = vertices[1].uv[c] - vertices[0].uv[c];
+		float d2 = vertices[2].uv[c] - vertices[0].uv[c];
+		dx[c] = (d1 * (py[2] - py[0]) - d2 * (py[1] - py[0])) / area;
+		dy[c] = (d2 * (px[1] - px[0]) - d1 * (px[2] - px[0])) / area;
+		origin[c] = vertices[0].uv[c] - dx[c] * px[0] - dy[c] * py[0];
+	}
+
+	// Pixel centers landing on the texel centers of the texture's top-left corner need no filtering
+	const float tolerance = 1e-4f;
+	bool copy = width <= source->width && height <= source->height &&
+		fabsf(dx[0] * source->width - 1.0f) < tolerance && fabsf(dy[0]) * source->width < tolerance &&
+		fabsf(dy[1] * source->height - 1.0f) < tolerance && fabsf(dx[1]) * source->height < tolerance &&
+		fabsf((origin[0] + 0.5f * (dx[0] + dy[0])) * source->width - 0.5f) < tolerance &&
+		fabsf((origin[1] + 0.5f * (dx[1] + dy[1])) * source->height - 0.5f) < tolerance;
+
+	RunOnTimeline([this, source, target, width, height, copy, dx, dy, origin]()
+	{
+		// The SRV is the UAV the compute pass just wrote
+		mScheduler.Barrier();
+
+		if (copy && source->width == width && target->width == width)
+		{
+			memcpy(target->texels.data(), source->texels.data(), (size_t)width * height * sizeof(uint32_t));
+			return;
+		}
+
+		mThreadPool.ParallelFor(height, 0, [source, target, width, copy, dx, dy, origin](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t y = begin; y < end; y++)
+			{
+				uint32_t* row = &target->texels[(size_t)y * target->width];
+				if (copy)
+				{
+					memcpy(row, &source->texels[(size_t)y * source->width], width * sizeof(uint32_t));
+					continue;
+				}
+
+				float u = origin[0] + dx[0] * 0.5f + dy[0] * (y + 0.5f);
+				float v = origin[1] + dx[1] * 0.5f + dy[1] * (y + 0.5f);
+				for (uint32_t x = 0; x < width; x++)
+				{
+					row[x] = SampleBilinear(*source, u + dx[0] * x, v + dx[1] * x);
+				}
+			}
+		});
+	});
+}
+
+GfxQuery CPUGraphicsDevice::CreateQuery(GfxQueryType type)
+{
+	Object object;
+	object.type = (type == GFX_QUERY_TIMESTAMP) ? OBJECT_TIMESTAMP_QUERY : OBJECT_DISJOINT_QUERY;
+	if (type == GFX_QUERY_TIMESTAMP)
+	{
+		object.timestamp = std::make_shared<uint64_t>(0);
+	}
+	return mObjects.Add(object);
+}
+
+void CPUGraphicsDevice::Begin(GfxQuery query)
+{
+	// Only disjoint queries have a Begin(); reissuing one discards its previous result
+	if (IsObject(query, OBJECT_DISJOINT_QUERY))
+	{
+		mObjects.Get(query).bEnded = false;
+	}
+}
+
+void CPUGraphicsDevice::End(GfxQuery query)
+{
+	if (!IsObject(query, OBJECT_TIMESTAMP_QUERY) && !IsObject(query, OBJECT_DISJOINT_QUERY))
+	{
+		return;
+	}
+
+	Object& object = mObjects.Get(query);
+	if (object.type == OBJECT_TIMESTAMP_QUERY)
+	{
+		uint64_t* timestamp = object.timestamp.get();
+		RunOnTimeline([this, timestamp]()
+		{
+			mScheduler.Barrier();
+			*timestamp = mClock();
+		});
+	}
+	object.readyFrame = mPresentCount + mQueryLatency;
+	object.readyFence = mTimeline ? mTimeline->GetSubmittedValue() + 1 : 0;
+	object.bEnded = true;
+}
+
+bool CPUGraphicsDevice::GetTimestamp(GfxQuery query, uint64_t& ticks)
+{
+	if (!IsObject(query, OBJECT_TIMESTAMP_QUERY))
+	{
+		return false;
+	}
+
+	const Object& object = mObjects.Get(query);
+	if (!object.bEnded || mPresentCount < object.readyFrame || (mTimeline && mTimeline->GetCompletedValue() < object.readyFence))
+	{
+		return false;
+	}
+	ticks = *object.timestamp;
+	return true;
+}
+
+bool CPUGraphicsDevice::GetTimestampDisjoint(GfxQuery query, uint64_t& frequency, bool& disjoint)
+{
+	if (!IsObject(query, OBJECT_DISJOINT_QUERY))
+	{
+		return false;
+	}
+
+	const Object& object = mObjects.Get(query);
+	if (!object.bEnded || mPresentCount < object.readyFrame || (mTimeline && mTimeline->GetCompletedValue() < object.readyFence))
+	{
+		return false;
+	}
+
+	// Nanosecond clock readings that never jump
+	frequency = 1000000000;
+	disjoint = false;
+	return true;
+}
+
+void CPUGraphicsDevice::InitUI()
+{
+	ImGuiIO& io = ImGui::GetIO();
+	io.BackendRendererName = "cpu";
+	io.IniFilename = nullptr;
+	io.DisplaySize = ImVec2((float)mWidth, (float)mHeight);
+
+	// Build the font atlas, as a renderer backend must before the first NewFrame
+	BeginStartupPhase(mStartupTimer, "font atlas");
+	unsigned char* pixels = nullptr;
+	int width = 0;
+	int height = 0;
+	io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+	EndStartupPhase(mStartupTimer);
+
+	BeginStartupPhase(mStartupTimer, "font texture");
+	mFontTexture = CreateTexture2D((uint32_t)width, (uint32_t)height, GFX_BIND_SHADER_RESOURCE);
+	memcpy(mObjects.Get(mFontTexture).texture->texels.data(), pixels, (size_t)width * height * sizeof(uint32_t));
+	io.Fonts->TexID = (ImTextureID)(intptr_t)mFontTexture;
+	EndStartupPhase(mStartupTimer);
+
+	mLastUIFrameTime = std::chrono::steady_clock::now();
+}
+
+void CPUGraphicsDevice::ShutdownUI()
+{
+	if (mFontTexture != GFX_NULL_HANDLE)
+	{
+		Release(mFontTexture);
+		mFontTexture = GFX_NULL_HANDLE;
+	}
+}
+
+void CPUGraphicsDevice::NewUIFrame()
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	float deltaTime = std::chrono::duration<float>(now - mLastUIFrameTime).count();
+	mLastUIFrameTime = now;
+
+	ImGuiIO& io = ImGui::GetIO();
+	io.DisplaySize = ImVec2((float)mWidth, (float)mHeight);
+	io.DeltaTime = deltaTime > 0.0f ? deltaTime : 1.0f / 60.0f;
+}
+
+void CPUGraphicsDevice::RenderUI(ImDrawData* drawData)
+{
+	CPUTexture2D* target = GetTexture(mBoundRTV, OBJECT_RTV);
+	if (!bRasterizeUI || target == nullptr)
+	{
+		return;
+	}
+
+	// ImGui reuses its draw lists on the next NewFrame, which may come before the timeline gets to this frame
+	std::shared_ptr<UIFrame> frame = std::make_shared<UIFrame>();
+	BuildUIFrame(drawData, [this](void* textureId) { return GetTexture((GfxHandle)(intptr_t)textureId, OBJECT_TEXTURE); }, *frame);
+
+	RunOnTimeline([this, frame, target]()
+	{
+		// Drawn over the composite, whose source the compute pass may still be writing
+		mScheduler.Barrier();
+		mUIRasterizer.Render(*frame, *target);
+
+		std::lock_guard<std::mutex> guard(mStatsLock);
+		mLastUIStats = mUIRasterizer.GetLastStats();
+	});
+}
+
+UIRasterizer::Stats CPUGraphicsDevice::GetLastUIStats() const
+{
+	std::lock_guard<std::mutex> guard(mStatsLock);
+	return mLastUIStats;
+}
+
+void CPUGraphicsDevice::SetMaxFramesInFlight(uint32_t count)
+{
+	mMaxFramesInFlight = count < 1 ? 1 : (count > GFX_MAX_FRAMES_IN_FLIGHT ? GFX_MAX_FRAMES_IN_FLIGHT : count);
+}
+
+uint64_t CPUGraphicsDevice::GetCompletedFrame()
+{
+	// Present() has waited for every frame older than the ones whose fence values are still kept
+	uint64_t oldestInFlight = mPresentCount >= mMaxFramesInFlight ? mPresentCount - mMaxFramesInFlight + 2 : 1;
+	if (!mTimeline || oldestInFlight > mPresentCount)
+	{
+		return mPresentCount;
+	}
+
+	uint64_t completedValue = mTimeline->GetCompletedValue();
+	for (uint64_t frame = mPresentCount; frame >= oldestInFlight; frame--)
+	{
+		if (mFrameFenceValues[frame % GFX_MAX_FRAMES_IN_FLIGHT] <= completedValue)
+		{
+			return frame;
+		}
+	}
+	return oldestInFlight - 1;
+}
+
+void CPUGraphicsDevice::WaitForFrame(uint64_t frame)
+{
+	if (frame > mPresentCount)
+	{
+		frame = mPresentCount;
+	}
+	if (mTimeline && frame > 0 && frame + GFX_MAX_FRAMES_IN_FLIGHT > mPresentCount)
+	{
+		mTimeline->Wait(mFrameFenceValues[frame % GFX_MAX_FRAMES_IN_FLIGHT]);
+	}
+}
+
+uint64_t CPUGraphicsDevice::SubmitRecordedWork()
+{
+	size_t recordedCount = mRecordedWork.size();
+	uint64_t value = mTimeline->Submit(std::move(mRecordedWork));
+
+	// Frames record about the same amount of work, so start the next batch at this one's size
+	mRecordedWork = std::vector<DeviceTimeline::Work>();
+	mRecordedWork.reserve(recordedCount);
+	return value;
+}
+
+void CPUGraphicsDevice::WaitForIdle()
+{
+	if (mTimeline)
+	{
+		if (!mRecordedWork.empty())
+		{
+			SubmitRecordedWork();
+		}
+		mTimeline->WaitIdle();
+	}
+	mScheduler.Barrier();
+}
+
+void CPUGraphicsDevice::Present()
+{
+	RunOnTimeline([this]()
+	{
+		DispatchScheduler::Stats stats = mScheduler.EndFrame();
+		mScheduler.BeginFrame();
+
+		std::lock_guard<std::mutex> guard(mStatsLock);
+		mLastFrameStats = stats;
+	});
+	mPresentCount++;
+
+	if (mTimeline)
+	{
+		mFrameFenceValues[mPresentCount % GFX_MAX_FRAMES_IN_FLIGHT] = SubmitRecordedWork();
+
+		// The CPU may run at most mMaxFramesInFlight frames ahead, counting the one it records next
+		if (mPresentCount >= mMaxFramesInFlight)
+		{
+			WaitForFrame(mPresentCount - mMaxFramesInFlight + 1);
+		}
+	}
+}
+
+DispatchScheduler::Stats CPUGraphicsDevice::GetLastFrameStats() const
+{
+	std::lock_guard<std::mutex> guard(mStatsLock);
+	return mLastFrameStats;
+}
+
+bool CPUGraphicsDevice::ReadBackBuffer(std::vector<uint32_t>& texels)
+{
+	CPUTexture2D* backBuffer = GetTexture(mBackBuffer, OBJECT_TEXTURE);
+	if (backBuffer == nullptr)
+	{
+		return false;
+	}
+
+	WaitForIdle();
+	texels = backBuffer->texels;
+	return true;
+}
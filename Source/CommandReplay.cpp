@@ -0,0 +1,598 @@
+/******************************************************************************************************
+ **	Name:        CommandReplay.cpp                                                                   **
+ **	Description: Replays a captured CommandStream on a GraphicsDevice and analyzes its state changes **
+ **              and UAV hazards                                                                     **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                        **
+ **	Published:   <insert date>                                                                       **
+ *****************************************************************************************************/
+
+#include "CommandReplay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+// Arguments of each opcode in stream order: bytes or text first, then uints, then floats
+struct CommandLayout
+{
+	uint8_t uintCount;
+	uint8_t floatCount;
+	bool bBytes;
+	bool bText;
+};
+
+static const CommandLayout gCommandLayouts[CMD_COUNT] =
+{
+	{ 0, 0, false, false },   // invalid
+	{ 2, 0, false, false },   // CMD_INIT
+	{ 0, 0, false, false },   // CMD_CLEANUP
+	{ 4, 0, false, false },   // CMD_CREATE_TEXTURE2D
+	{ 2, 0, false, false },   // CMD_CREATE_SRV
+	{ 2, 0, false, false },   // CMD_CREATE_UAV
+	{ 2, 0, false, false },   // CMD_CREATE_RTV
+	{ 1, 0, true, false },    // CMD_CREATE_CONSTANT_BUFFER
+	{ 1, 0, true, false },    // CMD_CREATE_VERTEX_BUFFER
+	{ 1, 0, false, true },    // CMD_CREATE_COMPUTE_SHADER
+	{ 1, 0, false, true },    // CMD_CREATE_VERTEX_SHADER
+	{ 1, 0, false, true },    // CMD_CREATE_PIXEL_SHADER
+	{ 2, 0, false, false },   // CMD_CREATE_INPUT_LAYOUT
+	{ 2, 0, false, false },   // CMD_CREATE_QUERY
+	{ 1, 0, false, false },   // CMD_RELEASE
+	{ 1, 0, false, false },   // CMD_GET_BACK_BUFFER_RTV
+	{ 1, 0, false, false },   // CMD_CS_SET_SHADER
+	{ 2, 0, false, false },   // CMD_CS_SET_UAV
+	{ 2, 0, false, false },   // CMD_CS_SET_CONSTANT_BUFFER
+	{ 3, 0, false, false },   // CMD_DISPATCH
+	{ 0, 0, false, false },   // CMD_BEGIN_UAV_OVERLAP
+	{ 0, 0, false, false },   // CMD_END_UAV_OVERLAP
+	{ 1, 4, false, false },   // CMD_CLEAR_RTV
+	{ 1, 0, false, false },   // CMD_OM_SET_RENDER_TARGET
+	{ 0, 2, false, false },   // CMD_RS_SET_VIEWPORT
+	{ 1, 0, false, false },   // CMD_IA_SET_INPUT_LAYOUT
+	{ 4, 0, false, false },   // CMD_IA_SET_VERTEX_BUFFER
+	{ 1, 0, false, false },   // CMD_VS_SET_SHADER
+	{ 1, 0, false, false },   // CMD_PS_SET_SHADER
+	{ 2, 0, false, false },   // CMD_PS_SET_SHADER_RESOURCE
+	{ 2, 0, false, false },   // CMD_DRAW
+	{ 1, 0, false, false },   // CMD_BEGIN_QUERY
+	{ 1, 0, false, false },   // CMD_END_QUERY
+	{ 0, 0, false, false },   // CMD_INIT_UI
+	{ 0, 0, false, false },   // CMD_SHUTDOWN_UI
+	{ 0, 0, false, false },   // CMD_NEW_UI_FRAME
+	{ 0, 0, false, false },   // CMD_RENDER_UI
+	{ 0, 0, false, false },   // CMD_PRESENT
+	{ 2, 0, true, false },    // CMD_CREATE_STRUCTURED_BUFFER
+	{ 1, 0, true, false },    // CMD_CREATE_INDIRECT_ARGS
+	{ 2, 0, false, false },   // CMD_CS_SET_SHADER_RESOURCE
+	{ 2, 0, false, false },   // CMD_DISPATCH_INDIRECT
+	{ 2, 0, false, false }    // CMD_RESIZE_BUFFERS
+};
+
+struct DecodedCommand
+{
+	CommandOpcode opcode;
+	uint32_t u[4];
+	float f[4];
+	std::vector<uint8_t> bytes;
+	std::string text;
+};
+
+// Texel rectangle [x0, x1) x [y0, y1)
+struct Footprint
+{
+	uint32_t x0, y0, x1, y1;
+
+	bool Intersects(const Footprint& other) const { return x0 < other.x1 && other.x0 < x1 && y0 < other.y1 && other.y0 < y1; }
+};
+
+class CommandReplayer
+{
+public:
+	CommandReplayer(GraphicsDevice* device, ReplayReport& report) : mDevice(device), mReport(report), bInitialized(false), bCleanedUp(false), mComputeShader(GFX_NULL_HANDLE), mBracket(0), mBracketCount(0) {}
+
+	bool Run(CommandStreamReader& reader);
+
+private:
+	bool Decode(CommandStreamReader& reader, DecodedCommand& command);
+	bool Execute(const DecodedCommand& command);
+	void Analyze(uint32_t index, const DecodedCommand& command);
+
+	GfxHandle Map(uint32_t captured);
+	void AddMapping(uint32_t captured, GfxHandle replayed);
+	bool IsRedundantSet(const DecodedCommand& command);
+	Footprint GetDispatchFootprint(uint32_t texture, uint32_t groupsX, uint32_t groupsY);
+
+	GraphicsDevice* mDevice;
+	ReplayReport& mReport;
+	bool bInitialized;
+	bool bCleanedUp;
+
+	// Captured handle -> replayed handle
+	std::unordered_map<uint32_t, GfxHandle> mHandles;
+
+	// Everything below is keyed by captured handles
+	std::map<uint64_t, std::vector<uint32_t>> mBindings;           // (opcode, slot) -> last arguments
+	std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> mTextureSizes;
+	std::unordered_map<uint32_t, uint32_t> mViewTextures;
+	std::unordered_map<uint32_t, std::vector<uint8_t>> mConstantBuffers;
+	std::unordered_map<uint32_t, uint32_t> mShaderTileSizes;
+	std::unordered_set<uint32_t> mTileListShaders;
+	uint32_t mComputeShader;
+	std::map<uint32_t, uint32_t> mBoundUAVs;                        // Slot -> view
+	std::map<uint32_t, uint32_t> mBoundConstantBuffers;
+	std::map<uint32_t, uint32_t> mBoundSRVs;
+
+	struct LastDispatch
+	{
+		uint32_t command;
+		Footprint footprint;
+		uint32_t bracket;
+	};
+	std::unordered_map<uint32_t, LastDispatch> mLastDispatch;       // Texture -> last dispatch that wrote it
+	std::unordered_set<uint32_t> mWrittenSinceRead;
+	uint32_t mBracket;                                              // 0 outside an overlap bracket
+	uint32_t mBracketCount;
+};
+
+// Reads the tile size from names like "ComputeShaderTile8"; the sample's default shader uses 16x16 tiles
+static uint32_t TileSizeFromShaderName(const std::string& name)
+{
+	size_t tile = name.rfind("Tile");
+	if (tile != std::string::npos)
+	{
+		uint32_t size = 0;
+		for (size_t i = tile + 4; i < name.size() && name[i] >= '0' && name[i] <= '9'; i++)
+		{
+			size = size * 10 + (uint32_t)(name[i] - '0');
+		}
+		if (size > 0)
+		{
+			return size;
+		}
+	}
+	return 16;
+}
+
+GfxHandle CommandReplayer::Map(uint32_t captured)
+{
+	if (captured == GFX_NULL_HANDLE)
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	std::unordered_map<uint32_t, GfxHandle>::const_iterator it = mHandles.find(captured);
+	if (it == mHandles.end())
+	{
+		mReport.unmappedHandleCount++;
+		return GFX_NULL_HANDLE;
+	}
+	return it->second;
+}
+
+void CommandReplayer::AddMapping(uint32_t captured, GfxHandle replayed)
+{
+	if (captured != GFX_NULL_HANDLE)
+	{
+		mHandles[captured] = replayed;
+	}
+}
+
+bool CommandReplayer::Decode(CommandStreamReader& reader, DecodedCommand& command)
+{
+	if (!reader.ReadOpcode(command.opcode))
+	{
+		return false;
+	}
+
+	const CommandLayout& layout = gCommandLayouts[command.opcode];
+	if ((layout.bBytes && !reader.ReadBytes(command.bytes)) || (layout.bText && !reader.ReadString(command.text)))
+	{
+		return false;
+	}
+	for (uint32_t i = 0; i < layout.uintCount; i++)
+	{
+		if (!reader.ReadUInt(command.u[i]))
+		{
+			return false;
+		}
+	}
+	for (uint32_t i = 0; i < layout.floatCount; i++)
+	{
+		if (!reader.ReadFloat(command.f[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool CommandReplayer::Execute(const DecodedCommand& command)
+{
+	const uint32_t* u = command.u;
+	switch (command.opcode)
+	{
+	case CMD_INIT:
+		if (!mDevice->Init(u[0], u[1]))
+		{
+			return false;
+		}
+		bInitialized = true;
+		break;
+	case CMD_CLEANUP:
+		mDevice->Cleanup();
+		bCleanedUp = true;
+		break;
+	case CMD_CREATE_TEXTURE2D:
+		AddMapping(u[3], mDevice->CreateTexture2D(u[0], u[1], u[2]));
+		break;
+	case CMD_CREATE_SRV:
+		AddMapping(u[1], mDevice->CreateShaderResourceView(Map(u[0])));
+		break;
+	case CMD_CREATE_UAV:
+		AddMapping(u[1], mDevice->CreateUnorderedAccessView(Map(u[0])));
+		break;
+	case CMD_CREATE_RTV:
+		AddMapping(u[1], mDevice->CreateRenderTargetView(Map(u[0])));
+		break;
+	case CMD_CREATE_CONSTANT_BUFFER:
+		AddMapping(u[0], mDevice->CreateConstantBuffer(command.bytes.data(), (uint32_t)command.bytes.size()));
+		break;
+	case CMD_CREATE_VERTEX_BUFFER:
+		AddMapping(u[0], mDevice->CreateVertexBuffer(command.bytes.data(), (uint32_t)command.bytes.size()));
+		break;
+	case CMD_CREATE_STRUCTURED_BUFFER:
+		AddMapping(u[1], mDevice->CreateStructuredBuffer(command.bytes.empty() ? nullptr : command.bytes.data(), u[0],
+			u[0] ? (uint32_t)command.bytes.size() / u[0] : 0));
+		break;
+	case CMD_CREATE_INDIRECT_ARGS:
+		AddMapping(u[0], mDevice->CreateIndirectArgumentBuffer(command.bytes.data(), (uint32_t)command.bytes.size()));
+		break;
+	case CMD_CREATE_COMPUTE_SHADER:
+		AddMapping(u[0], mDevice->CreateComputeShader(command.text.c_str()));
+		break;
+	case CMD_CREATE_VERTEX_SHADER:
+		AddMapping(u[0], mDevice->CreateVertexShader(command.text.c_str()));
+		break;
+	case CMD_CREATE_PIXEL_SHADER:
+		AddMapping(u[0], mDevice->CreatePixelShader(command.text.c_str()));
+		break;
+	case CMD_CREATE_INPUT_LAYOUT:
+		AddMapping(u[1], mDevice->CreateInputLayout(Map(u[0])));
+		break;
+	case CMD_CREATE_QUERY:
+		AddMapping(u[1], mDevice->CreateQuery((GfxQueryType)u[0]));
+		break;
+	case CMD_RELEASE:
+		mDevice->Release(Map(u[0]));
+		mHandles.erase(u[0]);
+		break;
+	case CMD_GET_BACK_BUFFER_RTV:
+		AddMapping(u[0], mDevice->GetBackBufferRTV());
+		break;
+	case CMD_RESIZE_BUFFERS:
+		if (!mDevice->ResizeBuffers(u[0], u[1]))
+		{
+			return false;
+		}
+		break;
+	case CMD_CS_SET_SHADER:
+		mDevice->CSSetShader(Map(u[0]));
+		break;
+	case CMD_CS_SET_UAV:
+		mDevice->CSSetUnorderedAccessView(u[0], Map(u[1]));
+		break;
+	case CMD_CS_SET_CONSTANT_BUFFER:
+		mDevice->CSSetConstantBuffer(u[0], Map(u[1]));
+		break;
+	case CMD_CS_SET_SHADER_RESOURCE:
+		mDevice->CSSetShaderResource(u[0], Map(u[1]));
+		break;
+	case CMD_DISPATCH:
+		mDevice->Dispatch(u[0], u[1], u[2]);
+		break;
+	case CMD_DISPATCH_INDIRECT:
+		mDevice->DispatchIndirect(Map(u[0]), u[1]);
+		break;
+	case CMD_BEGIN_UAV_OVERLAP:
+		mDevice->BeginUAVOverlap();
+		break;
+	case CMD_END_UAV_OVERLAP:
+		mDevice->EndUAVOverlap();
+		break;
+	case CMD_CLEAR_RTV:
+		mDevice->ClearRenderTargetView(Map(u[0]), command.f);
+		break;
+	case CMD_OM_SET_RENDER_TARGET:
+		mDevice->OMSetRenderTarget(Map(u[0]));
+		break;
+	case CMD_RS_SET_VIEWPORT:
+		mDevice->RSSetViewport(command.f[0], command.f[1]);
+		break;
+	case CMD_IA_SET_INPUT_LAYOUT:
+		mDevice->IASetInputLayout(Map(u[0]));
+		break;
+	case CMD_IA_SET_VERTEX_BUFFER:
+		mDevice->IASetVertexBuffer(u[0], Map(u[1]), u[2], u[3]);
+		break;
+	case CMD_VS_SET_SHADER:
+		mDevice->VSSetShader(Map(u[0]));
+		break;
+	case CMD_PS_SET_SHADER:
+		mDevice->PSSetShader(Map(u[0]));
+		break;
+	case CMD_PS_SET_SHADER_RESOURCE:
+		mDevice->PSSetShaderResource(u[0], Map(u[1]));
+		break;
+	case CMD_DRAW:
+		mDevice->Draw(u[0], u[1]);
+		break;
+	case CMD_BEGIN_QUERY:
+		mDevice->Begin(Map(u[0]));
+		break;
+	case CMD_END_QUERY:
+		mDevice->End(Map(u[0]));
+		break;
+	case CMD_PRESENT:
+		mDevice->Present();
+		mReport.frameCount++;
+		break;
+	default:
+		// UI calls: without the draw data there is nothing meaningful to replay
+		mReport.skippedCount++;
+		break;
+	}
+	return true;
+}
+
+bool CommandReplayer::IsRedundantSet(const DecodedCommand& command)
+{
+	// Calls that bind per slot carry the slot first; the rest bind a single piece of state
+	bool bSlotted = (command.opcode == CMD_CS_SET_UAV || command.opcode == CMD_CS_SET_CONSTANT_BUFFER ||
+		command.opcode == CMD_IA_SET_VERTEX_BUFFER || command.opcode == CMD_PS_SET_SHADER_RESOURCE ||
+		command.opcode == CMD_CS_SET_SHADER_RESOURCE);
+
+	const CommandLayout& layout = gCommandLayouts[command.opcode];
+	std::vector<uint32_t> values(command.u + (bSlotted ? 1 : 0), command.u + layout.uintCount);
+	for (uint32_t i = 0; i < layout.floatCount; i++)
+	{
+		uint32_t bits;
+		memcpy(&bits, &command.f[i], sizeof(bits));
+		values.push_back(bits);
+	}
+
+	uint64_t key = ((uint64_t)command.opcode << 32) | (bSlotted ? command.u[0] : 0);
+	std::map<uint64_t, std::vector<uint32_t>>::iterator it = mBindings.find(key);
+	if (it != mBindings.end() && it->second == values)
+	{
+		return true;
+	}
+	mBindings[key] = values;
+	return false;
+}
+
+Footprint CommandReplayer::GetDispatchFootprint(uint32_t texture, uint32_t groupsX, uint32_t groupsY)
+{
+	std::pair<uint32_t, uint32_t> size = mTextureSizes[texture];
+	Footprint footprint = { 0, 0, size.first, size.second };
+
+	// Tile-list shaders take their tiles from a buffer, so only the whole texture bounds what they write
+	if (mTileListShaders.count(mComputeShader))
+	{
+		return footprint;
+	}
+
+	std::map<uint32_t, uint32_t>::const_iterator bound = mBoundConstantBuffers.find(0);
+	if (bound == mBoundConstantBuffers.end())
+	{
+		return footprint;
+	}
+	std::unordered_map<uint32_t, std::vector<uint8_t>>::const_iterator cb = mConstantBuffers.find(bound->second);
+	if (cb == mConstantBuffers.end() || cb->second.size() < 4 * sizeof(uint32_t))
+	{
+		return footprint;
+	}
+
+	// dispatchX, dispatchY, windowWidth, windowHeight
+	uint32_t constants[4];
+	memcpy(constants, cb->second.data(), sizeof(constants));
+	uint32_t tileSize = mShaderTileSizes.count(mComputeShader) ? mShaderTileSizes[mComputeShader] : 16;
+	uint32_t clipWidth = std::min(constants[2], size.first);
+	uint32_t clipHeight = std::min(constants[3], size.second);
+
+	footprint.x0 = std::min((uint64_t)constants[0] * tileSize, (uint64_t)clipWidth);
+	footprint.y0 = std::min((uint64_t)constants[1] * tileSize, (uint64_t)clipHeight);
+	footprint.x1 = (uint32_t)std::min((uint64_t)footprint.x0 + (uint64_t)groupsX * tileSize, (uint64_t)clipWidth);
+	footprint.y1 = (uint32_t)std::min((uint64_t)footprint.y0 + (uint64_t)groupsY * tileSize, (uint64_t)clipHeight);
+	return footprint;
+}
+
+void CommandReplayer::Analyze(uint32_t index, const DecodedCommand& command)
+{
+	const uint32_t* u = command.u;
+	switch (command.opcode)
+	{
+	case CMD_CREATE_TEXTURE2D:
+		mTextureSizes[u[3]] = std::make_pair(u[0], u[1]);
+		break;
+	case CMD_CREATE_SRV:
+	case CMD_CREATE_UAV:
+		mViewTextures[u[1]] = u[0];
+		break;
+	case CMD_CREATE_CONSTANT_BUFFER:
+		mConstantBuffers[u[0]] = command.bytes;
+		break;
+	case CMD_CREATE_COMPUTE_SHADER:
+		mShaderTileSizes[u[0]] = TileSizeFromShaderName(command.text);
+		if (command.text.size() >= 4 && command.text.compare(command.text.size() - 4, 4, "List") == 0)
+		{
+			mTileListShaders.insert(u[0]);
+		}
+		break;
+	case CMD_CS_SET_SHADER:
+		mComputeShader = u[0];
+		break;
+	case CMD_CS_SET_UAV:
+		mBoundUAVs[u[0]] = u[1];
+		break;
+	case CMD_CS_SET_CONSTANT_BUFFER:
+		mBoundConstantBuffers[u[0]] = u[1];
+		break;
+	case CMD_PS_SET_SHADER_RESOURCE:
+		mBoundSRVs[u[0]] = u[1];
+		break;
+	case CMD_BEGIN_UAV_OVERLAP:
+		mBracket = ++mBracketCount;
+		break;
+	case CMD_END_UAV_OVERLAP:
+		mBracket = 0;
+		break;
+	case CMD_DISPATCH:
+	case CMD_DISPATCH_INDIRECT:
+		for (std::map<uint32_t, uint32_t>::const_iterator uav = mBoundUAVs.begin(); uav != mBoundUAVs.end(); ++uav)
+		{
+			if (uav->second == GFX_NULL_HANDLE || !mViewTextures.count(uav->second))
+			{
+				continue;
+			}
+
+			uint32_t texture = mViewTextures[uav->second];
+			// The group counts of an indirect dispatch are only known on the GPU
+			Footprint footprint = GetDispatchFootprint(texture, u[0], u[1]);
+			if (command.opcode == CMD_DISPATCH_INDIRECT)
+			{
+				footprint.x0 = footprint.y0 = 0;
+				footprint.x1 = mTextureSizes[texture].first;
+				footprint.y1 = mTextureSizes[texture].second;
+			}
+
+			std::unordered_map<uint32_t, LastDispatch>::const_iterator last = mLastDispatch.find(texture);
+			if (last != mLastDispatch.end())
+			{
+				bool bIntersects = footprint.Intersects(last->second.footprint);
+				if (mBracket != 0 && last->second.bracket == mBracket)
+				{
+					mReport.overlapEdges++;
+					if (bIntersects)
+					{
+						mReport.overlapHazards++;
+						if (mReport.hazards.size() < ReplayReport::MAX_REPORTED_HAZARDS)
+						{
+							ReplayHazard hazard = { last->second.command, index };
+							mReport.hazards.push_back(hazard);
+						}
+					}
+				}
+				else
+				{
+					mReport.syncEdges++;
+					if (!bIntersects)
+					{
+						mReport.unnecessarySyncEdges++;
+					}
+				}
+			}
+
+			LastDispatch dispatch = { index, footprint, mBracket };
+			mLastDispatch[texture] = dispatch;
+			mWrittenSinceRead.insert(texture);
+		}
+		break;
+	case CMD_DRAW:
+		for (std::map<uint32_t, uint32_t>::const_iterator srv = mBoundSRVs.begin(); srv != mBoundSRVs.end(); ++srv)
+		{
+			if (srv->second != GFX_NULL_HANDLE && mViewTextures.count(srv->second) && mWrittenSinceRead.erase(mViewTextures[srv->second]))
+			{
+				mReport.uavToSrvEdges++;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+bool CommandReplayer::Run(CommandStreamReader& reader)
+{
+	DecodedCommand command;
+	bool ok = true;
+	while (ok && !reader.AtEnd())
+	{
+		if (!Decode(reader, command))
+		{
+			ok = false;
+			break;
+		}
+
+		bool bSet = (command.opcode >= CMD_CS_SET_SHADER && command.opcode <= CMD_CS_SET_CONSTANT_BUFFER) ||
+			(command.opcode >= CMD_OM_SET_RENDER_TARGET && command.opcode <= CMD_PS_SET_SHADER_RESOURCE) ||
+			command.opcode == CMD_CS_SET_SHADER_RESOURCE;
+
+		ReplayOpcodeStats& stats = mReport.opcodes[command.opcode];
+		stats.count++;
+		if (bSet && IsRedundantSet(command))
+		{
+			stats.redundantCount++;
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		ok = Execute(command);
+		double callMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		stats.totalMs += callMs;
+		mReport.totalMs += callMs;
+
+		if (ok)
+		{
+			Analyze(mReport.commandCount, command);
+			mReport.commandCount++;
+		}
+	}
+
+	// A stream that fails part way still leaves the device as it found it
+	if (bInitialized && !bCleanedUp)
+	{
+		mDevice->Cleanup();
+	}
+	return ok;
+}
+
+bool ReplayCommandStream(const std::vector<uint8_t>& stream, GraphicsDevice* device, ReplayReport& report)
+{
+	report = ReplayReport();
+	CommandStreamReader reader(stream.data(), stream.size());
+	CommandReplayer replayer(device, report);
+	return replayer.Run(reader);
+}
+
+void PrintReplayReport(FILE* file, const ReplayReport& report)
+{
+	fprintf(file, "commands=%u frames=%u replay=%.3f ms", report.commandCount, report.frameCount, report.totalMs);
+	if (report.skippedCount)
+	{
+		fprintf(file, " skipped=%u (UI draw data is not captured)", report.skippedCount);
+	}
+	if (report.unmappedHandleCount)
+	{
+		fprintf(file, " unmapped-handles=%u", report.unmappedHandleCount);
+	}
+	fprintf(file, "\n\n%-28s %8s %10s %12s %10s\n", "call", "count", "redundant", "total ms", "mean us");
+	for (uint32_t op = 1; op < CMD_COUNT; op++)
+	{
+		const ReplayOpcodeStats& stats = report.opcodes[op];
+		if (stats.count)
+		{
+			fprintf(file, "%-28s %8u %10u %12.4f %10.3f\n", GetCommandOpcodeName((CommandOpcode)op), stats.count, stats.redundantCount,
+				stats.totalMs, stats.totalMs * 1000.0 / stats.count);
+		}
+	}
+
+	fprintf(file, "\nUAV sync edges:            %u (%u between disjoint footprints, which overlap could remove)\n", report.syncEdges, report.unnecessarySyncEdges);
+	fprintf(file, "Overlapped dispatch edges: %u (%u hazards, footprints intersect)\n", report.overlapEdges, report.overlapHazards);
+	for (size_t i = 0; i < report.hazards.size(); i++)
+	{
+		fprintf(file, "    hazard: commands %u and %u\n", report.hazards[i].firstCommand, report.hazards[i].secondCommand);
+	}
+	fprintf(file, "UAV to SRV transitions:    %u\n", report.uavToSrvEdges);
+}
@@ -0,0 +1,215 @@
+/**************************************************************************************
+ **	Name:        CommandStream.cpp                                                   **
+ **	Description: Binary encoding of GraphicsDevice calls and the capture file format **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                        **
+ **	Published:   <insert date>                                                       **
+ *************************************************************************************/
+
+#include "CommandStream.h"
+#include "SampleUtils.h"
+
+#include <cstring>
+
+static const char* gCommandOpcodeNames[CMD_COUNT] =
+{
+	"invalid",
+	"Init",
+	"Cleanup",
+	"CreateTexture2D",
+	"CreateShaderResourceView",
+	"CreateUnorderedAccessView",
+	"CreateRenderTargetView",
+	"CreateConstantBuffer",
+	"CreateVertexBuffer",
+	"CreateComputeShader",
+	"CreateVertexShader",
+	"CreatePixelShader",
+	"CreateInputLayout",
+	"CreateQuery",
+	"Release",
+	"GetBackBufferRTV",
+	"CSSetShader",
+	"CSSetUnorderedAccessView",
+	"CSSetConstantBuffer",
+	"Dispatch",
+	"BeginUAVOverlap",
+	"EndUAVOverlap",
+	"ClearRenderTargetView",
+	"OMSetRenderTarget",
+	"RSSetViewport",
+	"IASetInputLayout",
+	"IASetVertexBuffer",
+	"VSSetShader",
+	"PSSetShader",
+	"PSSetShaderResource",
+	"Draw",
+	"Begin",
+	"End",
+	"InitUI",
+	"ShutdownUI",
+	"NewUIFrame",
+	"RenderUI",
+	"Present",
+	"CreateStructuredBuffer",
+	"CreateIndirectArgumentBuffer",
+	"CSSetShaderResource",
+	"DispatchIndirect",
+	"ResizeBuffers"
+};
+
+const char* GetCommandOpcodeName(CommandOpcode opcode)
+{
+	return (opcode > 0 && opcode < CMD_COUNT) ? gCommandOpcodeNames[opcode] : "invalid";
+}
+
+void CommandStreamWriter::WriteUInt(uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		mData.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	mData.push_back((uint8_t)value);
+}
+
+void CommandStreamWriter::WriteFloat(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		mData.push_back((uint8_t)(bits >> (i * 8)));
+	}
+}
+
+void CommandStreamWriter::WriteBytes(const void* data, uint32_t size)
+{
+	WriteUInt(size);
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	mData.insert(mData.end(), bytes, bytes + size);
+}
+
+void CommandStreamWriter::WriteString(const char* text)
+{
+	WriteBytes(text, (uint32_t)strlen(text));
+}
+
+bool CommandStreamReader::ReadOpcode(CommandOpcode& opcode)
+{
+	if (bFailed || mOffset >= mSize || mData[mOffset] == 0 || mData[mOffset] >= CMD_COUNT)
+	{
+		return Fail();
+	}
+	opcode = (CommandOpcode)mData[mOffset++];
+	return true;
+}
+
+bool CommandStreamReader::ReadUInt(uint32_t& value)
+{
+	value = 0;
+	for (uint32_t shift = 0; shift < 35; shift += 7)
+	{
+		if (bFailed || mOffset >= mSize)
+		{
+			return Fail();
+		}
+		uint8_t byte = mData[mOffset++];
+		value |= (uint32_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return Fail();
+}
+
+bool CommandStreamReader::ReadFloat(float& value)
+{
+	if (bFailed || mSize - mOffset < 4)
+	{
+		return Fail();
+	}
+	uint32_t bits = 0;
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		bits |= (uint32_t)mData[mOffset++] << (i * 8);
+	}
+	memcpy(&value, &bits, sizeof(value));
+	return true;
+}
+
+bool CommandStreamReader::ReadBytes(std::vector<uint8_t>& bytes)
+{
+	uint32_t size = 0;
+	if (!ReadUInt(size) || mSize - mOffset < size)
+	{
+		return Fail();
+	}
+	bytes.assign(mData + mOffset, mData + mOffset + size);
+	mOffset += size;
+	return true;
+}
+
+bool CommandStreamReader::ReadString(std::string& text)
+{
+	std::vector<uint8_t> bytes;
+	if (!ReadBytes(bytes))
+	{
+		return false;
+	}
+	text.assign(bytes.begin(), bytes.end());
+	return true;
+}
+
+static void WriteUInt32LE(FILE* file, uint32_t value)
+{
+	uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+	fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+bool WriteCommandStreamFile(const char* path, const std::vector<uint8_t>& commands)
+{
+	FILE* file = OpenFile(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	WriteUInt32LE(file, COMMAND_STREAM_MAGIC);
+	WriteUInt32LE(file, COMMAND_STREAM_VERSION);
+	bool ok = commands.empty() || fwrite(commands.data(), 1, commands.size(), file) == commands.size();
+
+	return fclose(file) == 0 && ok;
+}
+
+bool ReadCommandStreamFile(const char* path, std::vector<uint8_t>& commands)
+{
+	FILE* file = OpenFile(path, "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> data;
+	uint8_t chunk[65536];
+	size_t read;
+	while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+	{
+		data.insert(data.end(), chunk, chunk + read);
+	}
+	fclose(file);
+
+	if (data.size() < 8)
+	{
+		return false;
+	}
+	uint32_t magic = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+	uint32_t version = data[4] | (data[5] << 8) | (data[6] << 16) | ((uint32_t)data[7] << 24);
+	if (magic != COMMAND_STREAM_MAGIC || version < COMMAND_STREAM_MIN_VERSION || version > COMMAND_STREAM_VERSION)
+	{
+		return false;
+	}
+
+	commands.assign(data.begin() + 8, data.end());
+	return true;
+}
@@ -0,0 +1,233 @@
+/**********************************************************************************************************
+ **	Name:        ComputeWorkload.cpp                                                                     **
+ **	Description: Workload presets, parsing and the CPU reference kernel for Shaders/ComputeWorkload.hlsl **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                            **
+ **	Published:   <insert date>                                                                           **
+ *********************************************************************************************************/
+
+#include "ComputeWorkload.h"
+#include "HeadlessRun.h"
+
+#include <cstdio>
+
+struct ComputeWorkloadPreset
+{
+	const char* name;
+	ComputeWorkload workload;
+};
+
+// Each preset leans on one part of the machine, apart from "mixed"; the ALU counts keep a frame in the tens of
+// milliseconds on the CPU backend at 1280x720
+static const ComputeWorkloadPreset gPresets[] =
+{
+	{ "none",      { 0,   0,  0, 0 } },
+	{ "alu",       { 256, 0,  0, 0 } },
+	{ "bandwidth", { 0,   16, 0, 0 } },
+	{ "reduction", { 16,  0,  COMPUTE_WORKLOAD_GROUP_REDUCTION, 0 } },
+	{ "partial",   { 256, 0,  0, 50 } },
+	{ "irregular", { 256, 0,  COMPUTE_WORKLOAD_IRREGULAR_TILES, 0 } },
+	{ "mixed",     { 64,  4,  COMPUTE_WORKLOAD_GROUP_REDUCTION | COMPUTE_WORKLOAD_IRREGULAR_TILES, 0 } }
+};
+
+static const uint32_t gPresetCount = sizeof(gPresets) / sizeof(gPresets[0]);
+
+// Largest thread group D3D11 allows is 1024 threads, so no compiled variant has a tile edge above 32
+static const uint32_t gMaxTileSize = 32;
+
+uint32_t GetComputeWorkloadPresetCount()
+{
+	return gPresetCount;
+}
+
+const char* GetComputeWorkloadPresetName(uint32_t index)
+{
+	return index < gPresetCount ? gPresets[index].name : nullptr;
+}
+
+ComputeWorkload GetComputeWorkloadPreset(uint32_t index)
+{
+	return index < gPresetCount ? gPresets[index].workload : gPresets[0].workload;
+}
+
+bool ParseComputeWorkload(const std::string& text, ComputeWorkload& workload)
+{
+	for (uint32_t i = 0; i < gPresetCount; i++)
+	{
+		if (text == gPresets[i].name)
+		{
+			workload = gPresets[i].workload;
+			return true;
+		}
+	}
+
+	ComputeWorkload parsed = {};
+	size_t start = 0;
+	while (start <= text.size())
+	{
+		size_t plus = text.find('+', start);
+		if (plus == std::string::npos)
+		{
+			plus = text.size();
+		}
+		std::string item = text.substr(start, plus - start);
+		start = plus + 1;
+
+		size_t equals = item.find('=');
+		std::string key = item.substr(0, equals);
+		std::string value = equals == std::string::npos ? std::string() : item.substr(equals + 1);
+
+		if (key == "reduce" && equals == std::string::npos)          parsed.flags |= COMPUTE_WORKLOAD_GROUP_REDUCTION;
+		else if (key == "irregular" && equals == std::string::npos)  parsed.flags |= COMPUTE_WORKLOAD_IRREGULAR_TILES;
+		else if (key == "alu")       { if (!ParseUIntArgument(value, parsed.aluIterations)) return false; }
+		else if (key == "reads")     { if (!ParseUIntArgument(value, parsed.srvReads)) return false; }
+		else if (key == "coverage")  { if (!ParseUIntArgument(value, parsed.coverage) || parsed.coverage > 100) return false; }
+		else return false;
+	}
+
+	workload = parsed;
+	return true;
+}
+
+std::string FormatComputeWorkload(const ComputeWorkload& workload)
+{
+	for (uint32_t i = 0; i < gPresetCount; i++)
+	{
+		if (workload == gPresets[i].workload)
+		{
+			return gPresets[i].name;
+		}
+	}
+
+	// Only the fields that are set, in the order ParseComputeWorkload accepts them
+	std::string text;
+	char field[32];
+	if (workload.aluIterations)
+	{
+		snprintf(field, sizeof(field), "+alu=%u", workload.aluIterations);
+		text += field;
+	}
+	if (workload.srvReads)
+	{
+		snprintf(field, sizeof(field), "+reads=%u", workload.srvReads);
+		text += field;
+	}
+	if (workload.coverage)
+	{
+		snprintf(field, sizeof(field), "+coverage=%u", workload.coverage);
+		text += field;
+	}
+	if (workload.flags & COMPUTE_WORKLOAD_GROUP_REDUCTION)
+	{
+		text += "+reduce";
+	}
+	if (workload.flags & COMPUTE_WORKLOAD_IRREGULAR_TILES)
+	{
+		text += "+irregular";
+	}
+	return text.substr(1);
+}
+
+// WorkloadHash in ComputeWorkload.hlsl
+static uint32_t WorkloadHash(uint32_t value)
+{
+	value ^= value >> 16;
+	value *= 0x7feb352du;
+	value ^= value >> 15;
+	value *= 0x846ca68bu;
+	value ^= value >> 16;
+	return value;
+}
+
+// ActiveEdge in ComputeWorkload.hlsl
+static uint32_t ActiveEdge(const ComputeWorkload& workload, uint32_t tileSize, uint32_t tileX, uint32_t tileY)
+{
+	uint32_t edge = tileSize;
+	if (workload.coverage != 0 && workload.coverage < 100)
+	{
+		edge = tileSize * workload.coverage / 100;
+		edge = edge > 0 ? edge : 1;
+	}
+	if (workload.flags & COMPUTE_WORKLOAD_IRREGULAR_TILES)
+	{
+		edge = 1 + WorkloadHash(tileX | (tileY << 16)) % edge;
+	}
+	return edge;
+}
+
+// The value one active thread carries into the reduction: the ALU loop, then the SRV loop
+static uint32_t ThreadValue(const ComputeWorkload& workload, const CPUTexture2D* source, uint32_t xcoord, uint32_t ycoord)
+{
+	uint32_t value = xcoord | (ycoord << 16);
+	for (uint32_t i = 0; i < workload.aluIterations; i++)
+	{
+		value = WorkloadHash(value + i);
+	}
+
+	// GetDimensions of an unbound SRV is 0x0, which the shader clamps to 1x1; the load itself then returns zero
+	uint32_t sourceWidth = (source != nullptr && source->width > 0) ? source->width : 1;
+	uint32_t sourceHeight = (source != nullptr && source->height > 0) ? source->height : 1;
+	bool bound = source != nullptr && !source->texels.empty();
+	for (uint32_t j = 0; j < workload.srvReads; j++)
+	{
+		uint32_t texel = 0;
+		if (bound)
+		{
+			texel = source->texels[(size_t)((ycoord + j * 11) % sourceHeight) * source->width + (xcoord + j * 37) % sourceWidth];
+		}
+		value = (value ^ texel) * 16777619u;
+	}
+	return value;
+}
+
+void RunWorkloadThreadGroup(const CPUComputeBackend::ConstantBuffer& cb, const CPUWorkloadBinding& binding, uint32_t tileSize, uint32_t groupX, uint32_t groupY, CPUTexture2D& uav)
+{
+	// Threads outside the active square only write the gradient, so lay that down for the whole group first
+	CPUComputeBackend::RunThreadGroup(cb, tileSize, groupX, groupY, uav);
+
+	const ComputeWorkload& workload = binding.workload;
+	uint32_t tileX = cb.dispatchX + groupX;
+	uint32_t tileY = cb.dispatchY + groupY;
+	uint32_t originX = tileX * tileSize;
+	uint32_t originY = tileY * tileSize;
+	if (originX >= cb.windowWidth || originY >= cb.windowHeight)
+	{
+		return;
+	}
+
+	// Only threads inside the window take part, as in the shader, where the others carry zero into the reduction
+	uint32_t edge = ActiveEdge(workload, tileSize, tileX, tileY);
+	edge = edge < gMaxTileSize ? edge : gMaxTileSize;
+	uint32_t activeX = (originX + edge <= cb.windowWidth) ? edge : (cb.windowWidth - originX);
+	uint32_t activeY = (originY + edge <= cb.windowHeight) ? edge : (cb.windowHeight - originY);
+
+	uint32_t values[gMaxTileSize * gMaxTileSize];
+	uint32_t sum = 0;
+	for (uint32_t y = 0; y < activeY; y++)
+	{
+		for (uint32_t x = 0; x < activeX; x++)
+		{
+			uint32_t value = ThreadValue(workload, binding.source, originX + x, originY + y);
+			values[y * activeX + x] = value;
+			sum += value;
+		}
+	}
+
+	// Unsigned addition wraps and commutes, so a serial sum matches the shader's tree reduction exactly
+	if (!(workload.flags & COMPUTE_WORKLOAD_GROUP_REDUCTION))
+	{
+		sum = 0;
+	}
+
+	float invWidth = 1.0f / (float)cb.windowWidth;
+	float invHeight = 1.0f / (float)cb.windowHeight;
+	for (uint32_t y = 0; y < activeY; y++)
+	{
+		for (uint32_t x = 0; x < activeX; x++)
+		{
+			uint32_t xcoord = originX + x;
+			uint32_t ycoord = originY + y;
+			float blue = (float)((values[y * activeX + x] + sum) & 0xFF) / 255.0f;
+			uav.Store(xcoord, ycoord, PackUNorm4x8((float)xcoord * invWidth, (float)ycoord * invHeight, blue, 1.0f));
+		}
+	}
+}
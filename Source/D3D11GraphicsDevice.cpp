@@ -0,0 +1,1161 @@
+/*************************************************************************************
+ **	Name:        D3D11GraphicsDevice.cpp                                            **
+ **	Description: D3D11 device, swap chain, Intel extension and ImGui backend setup, **
+ **              plus the D3D11 mapping of the GraphicsDevice calls                 **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                       **
+ **	Published:   <insert date>                                                      **
+ ************************************************************************************/
+
+#include "D3D11GraphicsDevice.h"
+
+#include "imgui.h"
+#include "imgui_impl_win32.h"
+#include "imgui_impl_dx11.h"
+
+#include <cstdio>
+#include <string>
+
+D3D11GraphicsDevice::D3D11GraphicsDevice(HWND window) : mWindow(window)
+{
+	mWidth = 0;
+	mHeight = 0;
+	mDevice = nullptr;
+	mImmediateContext = nullptr;
+	mSwapChain = nullptr;
+	mOffscreenTarget = nullptr;
+	for (uint32_t i = 0; i < GFX_MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		mFrameFences[i] = nullptr;
+	}
+	mMaxFramesInFlight = 1;
+	mSubmittedFrame = 0;
+	mCompletedFrame = 0;
+	mBackBufferRTV = GFX_NULL_HANDLE;
+	mINTCExtensionContext = nullptr;
+	mStartupTimer = nullptr;
+	bUAVOverlapSupported = false;
+	bIntelGPUPresent = false;
+	bUIOwnedPipeline = false;
+	bUIStateBound = false;
+	mUIDirtySlots = UI_ALL_SLOTS;
+}
+
+bool D3D11GraphicsDevice::Init(uint32_t width, uint32_t height)
+{
+	mWidth = width;
+	mHeight = height;
+
+	BeginStartupPhase(mStartupTimer, "dxgi factory");
+	IDXGIFactory1* factory;
+	ThrowIfFailed(CreateDXGIFactory1(__uuidof(IDXGIFactory1), (LPVOID*)&factory));
+	EndStartupPhase(mStartupTimer);
+
+	UINT createDeviceFlags = 0;
+#ifdef _DEBUG
+	//    createDeviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+
+	IDXGIAdapter1* adapter = nullptr;
+	D3D_FEATURE_LEVEL featureLevels[] = { D3D_FEATURE_LEVEL_11_1, D3D_FEATURE_LEVEL_11_0 };
+	D3D_FEATURE_LEVEL createdFeatureLevel;
+
+	// Attempt to find an Intel GPU among the enumerated adapaters and create a device for it
+	BeginStartupPhase(mStartupTimer, "adapters and device");
+	for (UINT32 i = 0; factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; ++i)
+	{
+		DXGI_ADAPTER_DESC1 desc;
+		adapter->GetDesc1(&desc);
+
+		if (desc.VendorId != 0x8086) // INTEL VendorId
+		{
+			continue;
+		}
+
+		ThrowIfFailed(D3D11CreateDevice(adapter, D3D_DRIVER_TYPE_UNKNOWN, NULL, createDeviceFlags, featureLevels, _countof(featureLevels), D3D11_SDK_VERSION, &mDevice, &createdFeatureLevel, &mImmediateContext));
+		bIntelGPUPresent = true;
+		break;
+	}
+
+	// If no Intel GPU was found, create a device with the default adapter, but warn the user that 
+	// the Intel UAV Overlap extension will not be useable. 
+	if (mDevice == nullptr)
+	{
+		if (IsHeadless())
+		{
+			fprintf(stderr, "No Intel GPU found: the UAV Overlap extension will not be used.\n");
+		}
+		else
+		{
+			MessageBox(mWindow, L"An Intel GPU is required to use the Intel D3D Extension demonstrated in this sample.", L"No Intel GPU Found", MB_ICONERROR);
+		}
+		bIntelGPUPresent = false;
+
+		for (UINT32 i = 0; factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; ++i)
+		{
+			DXGI_ADAPTER_DESC1 desc;
+			adapter->GetDesc1(&desc);
+
+			ThrowIfFailed(D3D11CreateDevice(adapter, D3D_DRIVER_TYPE_UNKNOWN, NULL, createDeviceFlags, featureLevels, _countof(featureLevels), D3D11_SDK_VERSION, &mDevice, &createdFeatureLevel, &mImmediateContext));
+
+			break;
+		}
+	}
+	EndStartupPhase(mStartupTimer);
+
+	if (!IsHeadless())
+	{
+		// Create the swap chain
+		BeginStartupPhase(mStartupTimer, "swap chain");
+		DXGI_SWAP_CHAIN_DESC sd;
+		ZeroMemory(&sd, sizeof(sd));
+		sd.BufferCount = mMaxFramesInFlight;
+		sd.BufferDesc.Width = mWidth;
+		sd.BufferDesc.Height = mHeight;
+		sd.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		sd.BufferDesc.RefreshRate.Numerator = 60;
+		sd.BufferDesc.RefreshRate.Denominator = 1;
+		sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+		sd.OutputWindow = mWindow;
+		sd.SampleDesc.Count = 1;
+		sd.SampleDesc.Quality = 0;
+		sd.Windowed = TRUE;
+
+		ThrowIfFailed(factory->CreateSwapChain(mDevice, &sd, &mSwapChain));
+
+		// Let DXGI queue as many frames as the fences below allow, rather than its default of three
+		IDXGIDevice1* dxgiDevice = nullptr;
+		if (SUCCEEDED(mDevice->QueryInterface(__uuidof(IDXGIDevice1), (void**)&dxgiDevice)))
+		{
+			dxgiDevice->SetMaximumFrameLatency(mMaxFramesInFlight);
+			dxgiDevice->Release();
+		}
+		EndStartupPhase(mStartupTimer);
+	}
+
+	factory->Release();
+
+	// One event query per frame in flight, ended after each Present(). They pace the CPU in both modes: without a
+	// swap chain nothing else would, and with one they bound the latency whatever the driver queues.
+	BeginStartupPhase(mStartupTimer, "frame fences and back buffer");
+	for (uint32_t i = 0; i < GFX_MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		D3D11_QUERY_DESC queryDesc = {};
+		queryDesc.Query = D3D11_QUERY_EVENT;
+		ThrowIfFailed(mDevice->CreateQuery(&queryDesc, &mFrameFences[i]));
+	}
+	mSubmittedFrame = 0;
+	mCompletedFrame = 0;
+
+	ID3D11RenderTargetView* backBufferRTV = nullptr;
+	CreateBackBufferView(&backBufferRTV);
+
+	Object rtv;
+	rtv.object = backBufferRTV;
+	mBackBufferRTV = mObjects.Add(rtv);
+	EndStartupPhase(mStartupTimer);
+
+	// The sample only draws triangle lists, and the ImGui backend restores this after rendering
+	mImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	mUIDirtySlots = UI_ALL_SLOTS;
+	bUIStateBound = false;
+
+	// Initialize the Intel Driver Extensions Framework for use of the UAV Overlap extension.
+	// The stub runtime stands in for the driver, so with it the extension path is exercised on any adapter.
+#ifdef UAVOVERLAP_INTC_STUB
+	bool useExtensions = true;
+#else
+	bool useExtensions = bIntelGPUPresent;
+#endif
+	BeginStartupPhase(mStartupTimer, "extension context");
+	if (useExtensions)
+	{
+		bUAVOverlapSupported = CreateIntelExtensionContext(mDevice, &mINTCExtensionContext);
+	}
+	else
+	{
+		bUAVOverlapSupported = false;
+	}
+	EndStartupPhase(mStartupTimer);
+
+	return true;
+}
+
+bool D3D11GraphicsDevice::CreateBackBufferView(ID3D11RenderTargetView** backBufferRTV)
+{
+	if (IsHeadless())
+	{
+		// No window to present to: render into an offscreen texture with the same format as the back buffer would have
+		D3D11_TEXTURE2D_DESC offscreenDesc;
+		ZeroMemory(&offscreenDesc, sizeof(offscreenDesc));
+		offscreenDesc.Width = mWidth;
+		offscreenDesc.Height = mHeight;
+		offscreenDesc.MipLevels = 1;
+		offscreenDesc.ArraySize = 1;
+		offscreenDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		offscreenDesc.SampleDesc.Count = 1;
+		offscreenDesc.SampleDesc.Quality = 0;
+		offscreenDesc.Usage = D3D11_USAGE_DEFAULT;
+		offscreenDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+
+		ThrowIfFailed(mDevice->CreateTexture2D(&offscreenDesc, NULL, &mOffscreenTarget));
+		ThrowIfFailed(mDevice->CreateRenderTargetView(mOffscreenTarget, NULL, backBufferRTV));
+	}
+	else
+	{
+		// Create a render target view to the swap chain back buffer
+		ID3D11Texture2D* backBuffer = NULL;
+		ThrowIfFailed(mSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), (LPVOID*)&backBuffer));
+		ThrowIfFailed(mDevice->CreateRenderTargetView(backBuffer, NULL, backBufferRTV));
+		backBuffer->Release();
+	}
+	return true;
+}
+
+bool D3D11GraphicsDevice::ResizeBuffers(uint32_t width, uint32_t height)
+{
+	if (width == 0 || height == 0 || !mObjects.IsValid(mBackBufferRTV))
+	{
+		return false;
+	}
+	WaitForFrame(mSubmittedFrame);
+
+	// The swap chain can only resize its buffers once nothing references them, bound or not
+	mImmediateContext->OMSetRenderTargets(0, NULL, NULL);
+	Object& rtv = mObjects.Get(mBackBufferRTV);
+	rtv.object->Release();
+	rtv.object = nullptr;
+	if (mOffscreenTarget != nullptr)
+	{
+		mOffscreenTarget->Release();
+		mOffscreenTarget = nullptr;
+	}
+
+	mWidth = width;
+	mHeight = height;
+	if (!IsHeadless())
+	{
+		// Keeps the buffer count and format
+		ThrowIfFailed(mSwapChain->ResizeBuffers(0, mWidth, mHeight, DXGI_FORMAT_UNKNOWN, 0));
+	}
+	ID3D11RenderTargetView* backBufferRTV = nullptr;
+	CreateBackBufferView(&backBufferRTV);
+	rtv.object = backBufferRTV;
+
+	// The Win32 platform backend reads the window size every frame; headless ImGui only knows what it was told
+	if (IsHeadless() && ImGui::GetCurrentContext() != nullptr)
+	{
+		ImGui::GetIO().DisplaySize = ImVec2((float)mWidth, (float)mHeight);
+	}
+	return true;
+}
+
+void D3D11GraphicsDevice::Cleanup()
+{
+	mObjects.ForEach([](GfxHandle, Object& object)
+	{
+		object.object->Release();
+		if (object.blob != nullptr)
+		{
+			object.blob->Release();
+		}
+	});
+	mObjects.Clear();
+	mBackBufferRTV = GFX_NULL_HANDLE;
+
+	for (uint32_t i = 0; i < GFX_MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		if (mFrameFences[i] != nullptr)
+		{
+			mFrameFences[i]->Release();
+			mFrameFences[i] = nullptr;
+		}
+	}
+	if (mOffscreenTarget != nullptr)
+	{
+		mOffscreenTarget->Release();
+		mOffscreenTarget = nullptr;
+	}
+	if (mSwapChain != nullptr)
+	{
+		mSwapChain->Release();
+		mSwapChain = nullptr;
+	}
+	if (mImmediateContext != nullptr)
+	{
+		mImmediateContext->ClearState();
+		mImmediateContext->Release();
+		mImmediateContext = nullptr;
+	}
+
+	// Release the resources used by the framework and unload the extensions library
+	if (!DestroyIntelExtensionContext(&mINTCExtensionContext))
+	{
+		throw std::exception("Failed to destroy INTC_DEVICEEXTENSIONCONTEXT");
+	}
+
+	if (mDevice != nullptr)
+	{
+		mDevice->Release();
+		mDevice = nullptr;
+	}
+}
+
+GfxTexture D3D11GraphicsDevice::CreateTexture2D(uint32_t width, uint32_t height, uint32_t bindFlags)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	textureDesc.Width = width;
+	textureDesc.Height = height;
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.SampleDesc.Quality = 0;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = 0;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = 0;
+
+	if (bindFlags & GFX_BIND_SHADER_RESOURCE)
+	{
+		textureDesc.BindFlags |= D3D11_BIND_SHADER_RESOURCE;
+	}
+	if (bindFlags & GFX_BIND_UNORDERED_ACCESS)
+	{
+		textureDesc.BindFlags |= D3D11_BIND_UNORDERED_ACCESS;
+	}
+	if (bindFlags & GFX_BIND_RENDER_TARGET)
+	{
+		textureDesc.BindFlags |= D3D11_BIND_RENDER_TARGET;
+	}
+
+	ID3D11Texture2D* texture = nullptr;
+	if (FAILED(mDevice->CreateTexture2D(&textureDesc, NULL, &texture)))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = texture;
+	return mObjects.Add(object);
+}
+
+GfxView D3D11GraphicsDevice::CreateShaderResourceView(GfxTexture texture)
+{
+	ID3D11Resource* resource = Get<ID3D11Resource>(texture);
+	if (resource == nullptr)
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+	D3D11_RESOURCE_DIMENSION dimension;
+	resource->GetType(&dimension);
+	if (dimension == D3D11_RESOURCE_DIMENSION_BUFFER)
+	{
+		// A view of every element of a structured buffer
+		D3D11_BUFFER_DESC bufferDesc;
+		static_cast<ID3D11Buffer*>(resource)->GetDesc(&bufferDesc);
+		if ((bufferDesc.MiscFlags & D3D11_RESOURCE_MISC_BUFFER_STRUCTURED) == 0)
+		{
+			return GFX_NULL_HANDLE;
+		}
+
+		srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+		srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+		srvDesc.Buffer.FirstElement = 0;
+		srvDesc.Buffer.NumElements = bufferDesc.ByteWidth / bufferDesc.StructureByteStride;
+	}
+	else
+	{
+		srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+		srvDesc.Texture2D.MostDetailedMip = 0;
+		srvDesc.Texture2D.MipLevels = 1;
+	}
+
+	ID3D11ShaderResourceView* view = nullptr;
+	if (FAILED(mDevice->CreateShaderResourceView(resource, &srvDesc, &view)))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = view;
+	return mObjects.Add(object);
+}
+
+GfxView D3D11GraphicsDevice::CreateUnorderedAccessView(GfxTexture texture)
+{
+	ID3D11Texture2D* resource = Get<ID3D11Texture2D>(texture);
+	if (resource == nullptr)
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc;
+	uavDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	uavDesc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+	uavDesc.Texture2D.MipSlice = 0;
+
+	ID3D11UnorderedAccessView* view = nullptr;
+	if (FAILED(mDevice->CreateUnorderedAccessView(resource, &uavDesc, &view)))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = view;
+	return mObjects.Add(object);
+}
+
+GfxView D3D11GraphicsDevice::CreateRenderTargetView(GfxTexture texture)
+{
+	ID3D11Texture2D* resource = Get<ID3D11Texture2D>(texture);
+	if (resource == nullptr)
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	ID3D11RenderTargetView* view = nullptr;
+	if (FAILED(mDevice->CreateRenderTargetView(resource, NULL, &view)))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = view;
+	return mObjects.Add(object);
+}
+
+GfxBuffer D3D11GraphicsDevice::CreateConstantBuffer(const void* data, uint32_t byteWidth)
+{
+	D3D11_BUFFER_DESC desc;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.ByteWidth = ((byteWidth + 15) & ~15);
+	desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+	desc.StructureByteStride = 0;
+
+	// Immutable buffers are created from their initial data in one go, so pad it out to the rounded-up size
+	std::vector<uint8_t> padded(desc.ByteWidth, 0);
+	memcpy(padded.data(), data, byteWidth);
+
+	D3D11_SUBRESOURCE_DATA initialData = {};
+	initialData.pSysMem = padded.data();
+
+	ID3D11Buffer* buffer = nullptr;
+	if (FAILED(mDevice->CreateBuffer(&desc, &initialData, &buffer)))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = buffer;
+	return mObjects.Add(object);
+}
+
+GfxBuffer D3D11GraphicsDevice::CreateVertexBuffer(const void* data, uint32_t byteWidth)
+{
+	D3D11_BUFFER_DESC vertexBufferDesc;
+	ZeroMemory(&vertexBufferDesc, sizeof(vertexBufferDesc));
+	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	vertexBufferDesc.ByteWidth = byteWidth;
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags = 0;
+
+	D3D11_SUBRESOURCE_DATA initDataVB;
+	ZeroMemory(&initDataVB, sizeof(initDataVB));
+	initDataVB.pSysMem = data;
+
+	ID3D11Buffer* buffer = nullptr;
+	if (FAILED(mDevice->CreateBuffer(&vertexBufferDesc, &initDataVB, &buffer)))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = buffer;
+	return mObjects.Add(object);
+}
+
+GfxBuffer D3D11GraphicsDevice::CreateStructuredBuffer(const void* data, uint32_t stride, uint32_t count)
+{
+	if (data == nullptr || stride == 0 || count == 0)
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	D3D11_BUFFER_DESC desc;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.ByteWidth = stride * count;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	desc.StructureByteStride = stride;
+
+	D3D11_SUBRESOURCE_DATA initialData = {};
+	initialData.pSysMem = data;
+
+	ID3D11Buffer* buffer = nullptr;
+	if (FAILED(mDevice->CreateBuffer(&desc, &initialData, &buffer)))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = buffer;
+	return mObjects.Add(object);
+}
+
+GfxBuffer D3D11GraphicsDevice::CreateIndirectArgumentBuffer(const void* data, uint32_t byteWidth)
+{
+	// Default usage with a UAV bind, so that a compute pass could also write the arguments on the GPU
+	D3D11_BUFFER_DESC desc;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.ByteWidth = byteWidth;
+	desc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_DRAWINDIRECT_ARGS;
+	desc.StructureByteStride = 0;
+
+	D3D11_SUBRESOURCE_DATA initialData = {};
+	initialData.pSysMem = data;
+
+	ID3D11Buffer* buffer = nullptr;
+	if (FAILED(mDevice->CreateBuffer(&desc, data != nullptr ? &initialData : NULL, &buffer)))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = buffer;
+	return mObjects.Add(object);
+}
+
+bool D3D11GraphicsDevice::LoadShaderBlob(const char* name, ID3DBlob** blob)
+{
+	// Load the pre-compiled shader byte code
+	wchar_t path[MAX_PATH];
+	swprintf_s(path, MAX_PATH, L"Shaders/%hs.cso", name);
+
+	std::string phase = std::string("read ") + name + ".cso";
+	StartupPhaseScope scope(mStartupTimer, phase.c_str());
+	return SUCCEEDED(D3DReadFileToBlob(path, blob));
+}
+
+GfxShader D3D11GraphicsDevice::CreateComputeShader(const char* name)
+{
+	ID3DBlob* blob = nullptr;
+	if (!LoadShaderBlob(name, &blob))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	ID3D11ComputeShader* shader = nullptr;
+	HRESULT hr = mDevice->CreateComputeShader(blob->GetBufferPointer(), blob->GetBufferSize(), NULL, &shader);
+	blob->Release();
+
+	if (FAILED(hr))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = shader;
+	return mObjects.Add(object);
+}
+
+GfxShader D3D11GraphicsDevice::CreateVertexShader(const char* name)
+{
+	ID3DBlob* blob = nullptr;
+	if (!LoadShaderBlob(name, &blob))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	ID3D11VertexShader* shader = nullptr;
+	if (FAILED(mDevice->CreateVertexShader(blob->GetBufferPointer(), blob->GetBufferSize(), NULL, &shader)))
+	{
+		blob->Release();
+		return GFX_NULL_HANDLE;
+	}
+
+	// Keep the byte code around, the input layout is validated against it
+	Object object;
+	object.object = shader;
+	object.blob = blob;
+	return mObjects.Add(object);
+}
+
+GfxShader D3D11GraphicsDevice::CreatePixelShader(const char* name)
+{
+	ID3DBlob* blob = nullptr;
+	if (!LoadShaderBlob(name, &blob))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	ID3D11PixelShader* shader = nullptr;
+	HRESULT hr = mDevice->CreatePixelShader(blob->GetBufferPointer(), blob->GetBufferSize(), NULL, &shader);
+	blob->Release();
+
+	if (FAILED(hr))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = shader;
+	return mObjects.Add(object);
+}
+
+GfxInputLayout D3D11GraphicsDevice::CreateInputLayout(GfxShader vertexShader)
+{
+	if (!mObjects.IsValid(vertexShader) || mObjects.Get(vertexShader).blob == nullptr)
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	ID3DBlob* vsBlob = mObjects.Get(vertexShader).blob;
+
+	// Define the input layout
+	D3D11_INPUT_ELEMENT_DESC layout[] =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+	};
+	UINT numElements = ARRAYSIZE(layout);
+
+	ID3D11InputLayout* inputLayout = nullptr;
+	if (FAILED(mDevice->CreateInputLayout(layout, numElements, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), &inputLayout)))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = inputLayout;
+	return mObjects.Add(object);
+}
+
+void D3D11GraphicsDevice::Release(GfxHandle handle)
+{
+	if (!mObjects.IsValid(handle) || handle == mBackBufferRTV)
+	{
+		return;
+	}
+
+	Object& object = mObjects.Get(handle);
+	object.object->Release();
+	if (object.blob != nullptr)
+	{
+		object.blob->Release();
+	}
+	mObjects.Remove(handle);
+}
+
+void D3D11GraphicsDevice::CSSetShader(GfxShader shader)
+{
+	mUIDirtySlots |= UI_SLOT_BIT(UI_SLOT_COMPUTE_SHADER);
+	mImmediateContext->CSSetShader(Get<ID3D11ComputeShader>(shader), NULL, 0);
+}
+
+void D3D11GraphicsDevice::CSSetUnorderedAccessView(uint32_t slot, GfxView view)
+{
+	ID3D11UnorderedAccessView* uav = Get<ID3D11UnorderedAccessView>(view);
+	mImmediateContext->CSSetUnorderedAccessViews(slot, 1, &uav, 0);
+}
+
+void D3D11GraphicsDevice::CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer)
+{
+	ID3D11Buffer* constantBuffer = Get<ID3D11Buffer>(buffer);
+	mImmediateContext->CSSetConstantBuffers(slot, 1, &constantBuffer);
+}
+
+void D3D11GraphicsDevice::CSSetShaderResource(uint32_t slot, GfxView view)
+{
+	ID3D11ShaderResourceView* srv = Get<ID3D11ShaderResourceView>(view);
+	mImmediateContext->CSSetShaderResources(slot, 1, &srv);
+}
+
+void D3D11GraphicsDevice::Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+{
+	mImmediateContext->Dispatch(groupsX, groupsY, groupsZ);
+}
+
+void D3D11GraphicsDevice::DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset)
+{
+	ID3D11Buffer* buffer = Get<ID3D11Buffer>(arguments);
+	if (buffer != nullptr)
+	{
+		mImmediateContext->DispatchIndirect(buffer, byteOffset);
+	}
+}
+
+void D3D11GraphicsDevice::BeginUAVOverlap()
+{
+	if (bUAVOverlapSupported)
+	{
+		INTC_D3D11_BeginUAVOverlap(mINTCExtensionContext);
+	}
+}
+
+void D3D11GraphicsDevice::EndUAVOverlap()
+{
+	if (bUAVOverlapSupported)
+	{
+		INTC_D3D11_EndUAVOverlap(mINTCExtensionContext);
+	}
+}
+
+// Wraps a deferred ID3D11DeviceContext. Resolving handles only reads the device's object table.
+class D3D11GraphicsDevice::DeferredContext : public GfxDeferredContext
+{
+public:
+	DeferredContext(D3D11GraphicsDevice* device, ID3D11DeviceContext* context) : mDevice(device), mContext(context), mCommandList(nullptr) {}
+
+	virtual ~DeferredContext()
+	{
+		if (mCommandList != nullptr)
+		{
+			mCommandList->Release();
+		}
+		mContext->Release();
+	}
+
+	virtual bool IsUAVOverlapSupported() const { return false; }
+
+	virtual void CSSetShader(GfxShader shader)
+	{
+		mContext->CSSetShader(mDevice->Get<ID3D11ComputeShader>(shader), NULL, 0);
+	}
+
+	virtual void CSSetUnorderedAccessView(uint32_t slot, GfxView view)
+	{
+		ID3D11UnorderedAccessView* uav = mDevice->Get<ID3D11UnorderedAccessView>(view);
+		mContext->CSSetUnorderedAccessViews(slot, 1, &uav, 0);
+	}
+
+	virtual void CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer)
+	{
+		ID3D11Buffer* constantBuffer = mDevice->Get<ID3D11Buffer>(buffer);
+		mContext->CSSetConstantBuffers(slot, 1, &constantBuffer);
+	}
+
+	virtual void CSSetShaderResource(uint32_t slot, GfxView view)
+	{
+		ID3D11ShaderResourceView* srv = mDevice->Get<ID3D11ShaderResourceView>(view);
+		mContext->CSSetShaderResources(slot, 1, &srv);
+	}
+
+	virtual void Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+	{
+		mContext->Dispatch(groupsX, groupsY, groupsZ);
+	}
+
+	virtual void DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset)
+	{
+		ID3D11Buffer* buffer = mDevice->Get<ID3D11Buffer>(arguments);
+		if (buffer != nullptr)
+		{
+			mContext->DispatchIndirect(buffer, byteOffset);
+		}
+	}
+
+	virtual void BeginUAVOverlap() {}
+	virtual void EndUAVOverlap() {}
+
+	virtual void FinishCommandList()
+	{
+		if (mCommandList != nullptr)
+		{
+			mCommandList->Release();
+			mCommandList = nullptr;
+		}
+		if (FAILED(mContext->FinishCommandList(FALSE, &mCommandList)))
+		{
+			mCommandList = nullptr;
+		}
+	}
+
+	// The caller takes over the reference
+	ID3D11CommandList* TakeCommandList()
+	{
+		ID3D11CommandList* commandList = mCommandList;
+		mCommandList = nullptr;
+		return commandList;
+	}
+
+private:
+	D3D11GraphicsDevice* mDevice;
+	ID3D11DeviceContext* mContext;
+	ID3D11CommandList* mCommandList;
+};
+
+std::unique_ptr<GfxDeferredContext> D3D11GraphicsDevice::CreateDeferredContext()
+{
+	ID3D11DeviceContext* context = nullptr;
+	if (mDevice == nullptr || FAILED(mDevice->CreateDeferredContext(0, &context)))
+	{
+		return nullptr;
+	}
+	return std::unique_ptr<GfxDeferredContext>(new DeferredContext(this, context));
+}
+
+void D3D11GraphicsDevice::ExecuteCommandList(GfxDeferredContext* context)
+{
+	ID3D11CommandList* commandList = (context != nullptr) ? static_cast<DeferredContext*>(context)->TakeCommandList() : nullptr;
+	if (commandList == nullptr)
+	{
+		return;
+	}
+
+	// Not restoring the context state is the cheaper option, and clears it instead
+	mImmediateContext->ExecuteCommandList(commandList, FALSE);
+	commandList->Release();
+
+	// Topology is set once at Init
+	mImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	mUIDirtySlots = UI_ALL_SLOTS;
+	bUIStateBound = false;
+}
+
+void D3D11GraphicsDevice::ClearRenderTargetView(GfxView view, const float color[4])
+{
+	ID3D11RenderTargetView* rtv = Get<ID3D11RenderTargetView>(view);
+	if (rtv != nullptr)
+	{
+		mImmediateContext->ClearRenderTargetView(rtv, color);
+	}
+}
+
+void D3D11GraphicsDevice::OMSetRenderTarget(GfxView view)
+{
+	ID3D11RenderTargetView* rtv = Get<ID3D11RenderTargetView>(view);
+	mImmediateContext->OMSetRenderTargets(1, &rtv, NULL);
+}
+
+void D3D11GraphicsDevice::RSSetViewport(float width, float height)
+{
+	D3D11_VIEWPORT viewPort;
+	viewPort.Width = width;
+	viewPort.Height = height;
+	viewPort.MinDepth = 0.0f;
+	viewPort.MaxDepth = 1.0f;
+	viewPort.TopLeftX = 0;
+	viewPort.TopLeftY = 0;
+	mImmediateContext->RSSetViewports(1, &viewPort);
+	mUIDirtySlots |= UI_SLOT_BIT(UI_SLOT_VIEWPORT);
+}
+
+void D3D11GraphicsDevice::IASetInputLayout(GfxInputLayout layout)
+{
+	mImmediateContext->IASetInputLayout(Get<ID3D11InputLayout>(layout));
+	mUIDirtySlots |= UI_SLOT_BIT(UI_SLOT_INPUT_LAYOUT);
+}
+
+void D3D11GraphicsDevice::IASetVertexBuffer(uint32_t slot, GfxBuffer buffer, uint32_t stride, uint32_t offset)
+{
+	ID3D11Buffer* vertexBuffer = Get<ID3D11Buffer>(buffer);
+	UINT strides[1] = { stride };
+	UINT offsets[1] = { offset };
+	mImmediateContext->IASetVertexBuffers(slot, 1, &vertexBuffer, strides, offsets);
+	mUIDirtySlots |= (slot == 0) ? UI_SLOT_BIT(UI_SLOT_VERTEX_BUFFER) : 0;
+}
+
+void D3D11GraphicsDevice::VSSetShader(GfxShader shader)
+{
+	mImmediateContext->VSSetShader(Get<ID3D11VertexShader>(shader), NULL, 0);
+	mUIDirtySlots |= UI_SLOT_BIT(UI_SLOT_VERTEX_SHADER);
+}
+
+void D3D11GraphicsDevice::PSSetShader(GfxShader shader)
+{
+	mImmediateContext->PSSetShader(Get<ID3D11PixelShader>(shader), NULL, 0);
+	mUIDirtySlots |= UI_SLOT_BIT(UI_SLOT_PIXEL_SHADER);
+}
+
+void D3D11GraphicsDevice::PSSetShaderResource(uint32_t slot, GfxView view)
+{
+	ID3D11ShaderResourceView* srv = Get<ID3D11ShaderResourceView>(view);
+	mImmediateContext->PSSetShaderResources(slot, 1, &srv);
+	mUIDirtySlots |= (slot == 0) ? UI_SLOT_BIT(UI_SLOT_PS_TEXTURE) : 0;
+}
+
+void D3D11GraphicsDevice::Draw(uint32_t vertexCount, uint32_t startVertex)
+{
+	if (bUIStateBound)
+	{
+		ResetUIState();
+	}
+	mImmediateContext->Draw(vertexCount, startVertex);
+}
+
+void D3D11GraphicsDevice::ResetUIState()
+{
+	ID3D11SamplerState* sampler = NULL;
+	mImmediateContext->OMSetBlendState(NULL, NULL, 0xFFFFFFFF);
+	mImmediateContext->OMSetDepthStencilState(NULL, 0);
+	mImmediateContext->RSSetState(NULL);
+	mImmediateContext->PSSetSamplers(0, 1, &sampler);
+	mUIDirtySlots |= UI_SLOT_BIT(UI_SLOT_BLEND_STATE) | UI_SLOT_BIT(UI_SLOT_DEPTH_STENCIL_STATE) | UI_SLOT_BIT(UI_SLOT_RASTERIZER_STATE) | UI_SLOT_BIT(UI_SLOT_PS_SAMPLER);
+	bUIStateBound = false;
+}
+
+GfxQuery D3D11GraphicsDevice::CreateQuery(GfxQueryType type)
+{
+	D3D11_QUERY_DESC desc;
+	desc.Query = (type == GFX_QUERY_TIMESTAMP) ? D3D11_QUERY_TIMESTAMP : D3D11_QUERY_TIMESTAMP_DISJOINT;
+	desc.MiscFlags = 0;
+
+	ID3D11Query* query = nullptr;
+	if (FAILED(mDevice->CreateQuery(&desc, &query)))
+	{
+		return GFX_NULL_HANDLE;
+	}
+
+	Object object;
+	object.object = query;
+	return mObjects.Add(object);
+}
+
+void D3D11GraphicsDevice::Begin(GfxQuery query)
+{
+	ID3D11Query* d3dQuery = Get<ID3D11Query>(query);
+	if (d3dQuery != nullptr)
+	{
+		mImmediateContext->Begin(d3dQuery);
+	}
+}
+
+void D3D11GraphicsDevice::End(GfxQuery query)
+{
+	ID3D11Query* d3dQuery = Get<ID3D11Query>(query);
+	if (d3dQuery != nullptr)
+	{
+		mImmediateContext->End(d3dQuery);
+	}
+}
+
+bool D3D11GraphicsDevice::GetTimestamp(GfxQuery query, uint64_t& ticks)
+{
+	ID3D11Query* d3dQuery = Get<ID3D11Query>(query);
+	if (d3dQuery == nullptr)
+	{
+		return false;
+	}
+
+	// DONOTFLUSH keeps polling from kicking off a command buffer submission mid-frame; Present() flushes anyway
+	UINT64 timestamp = 0;
+	if (mImmediateContext->GetData(d3dQuery, &timestamp, sizeof(timestamp), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+	{
+		return false;
+	}
+	ticks = timestamp;
+	return true;
+}
+
+bool D3D11GraphicsDevice::GetTimestampDisjoint(GfxQuery query, uint64_t& frequency, bool& disjoint)
+{
+	ID3D11Query* d3dQuery = Get<ID3D11Query>(query);
+	if (d3dQuery == nullptr)
+	{
+		return false;
+	}
+
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT data;
+	if (mImmediateContext->GetData(d3dQuery, &data, sizeof(data), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+	{
+		return false;
+	}
+	frequency = data.Frequency;
+	disjoint = data.Disjoint != FALSE;
+	return true;
+}
+
+void D3D11GraphicsDevice::InitUI()
+{
+	if (IsHeadless())
+	{
+		// Without the Win32 platform backend ImGui has to be told the display size directly
+		ImGui::GetIO().DisplaySize = ImVec2((float)mWidth, (float)mHeight);
+	}
+	else
+	{
+		ImGui_ImplWin32_Init(mWindow);
+	}
+	ImGui_ImplDX11_Init(mDevice, mImmediateContext);
+	ImGui_ImplDX11_SetOwnedPipeline(bUIOwnedPipeline);
+
+	// The backend would create its shaders and font texture in the first NewFrame(); doing it here counts them as startup
+	BeginStartupPhase(mStartupTimer, "imgui device objects");
+	ImGui_ImplDX11_CreateDeviceObjects();
+	EndStartupPhase(mStartupTimer);
+}
+
+void D3D11GraphicsDevice::ShutdownUI()
+{
+	ImGui_ImplDX11_Shutdown();
+	if (!IsHeadless())
+	{
+		ImGui_ImplWin32_Shutdown();
+	}
+}
+
+void D3D11GraphicsDevice::NewUIFrame()
+{
+	ImGui_ImplDX11_NewFrame();
+	if (!IsHeadless())
+	{
+		ImGui_ImplWin32_NewFrame();
+	}
+}
+
+void D3D11GraphicsDevice::RenderUI(ImDrawData* drawData)
+{
+	if (bUIOwnedPipeline)
+	{
+		ImGui_ImplDX11_InvalidatePipelineState(mUIDirtySlots);
+		mUIDirtySlots = 0;
+	}
+	ImGui_ImplDX11_RenderDrawData(drawData);
+	bUIStateBound = bUIOwnedPipeline;
+}
+
+bool D3D11GraphicsDevice::IsUIShaderPrecompiled() const
+{
+	return ImGui_ImplDX11_UsesPrecompiledShaders();
+}
+
+void D3D11GraphicsDevice::GetUIUploadStats(UploadRingStats& vertexStats, UploadRingStats& indexStats) const
+{
+	ImGui_ImplDX11_GetUploadStats(&vertexStats, &indexStats);
+}
+
+void D3D11GraphicsDevice::SetUIOwnedPipeline(bool owned)
+{
+	bUIOwnedPipeline = owned;
+	ImGui_ImplDX11_SetOwnedPipeline(owned);
+	if (!owned && bUIStateBound && mImmediateContext != nullptr)
+	{
+		ResetUIState();
+	}
+}
+
+void D3D11GraphicsDevice::GetUIPipelineCounters(UIPipelineCounters& counters) const
+{
+	ImGui_ImplDX11_GetPipelineCounters(&counters);
+}
+
+void D3D11GraphicsDevice::SetMaxFramesInFlight(uint32_t count)
+{
+	mMaxFramesInFlight = count < 1 ? 1 : (count > GFX_MAX_FRAMES_IN_FLIGHT ? GFX_MAX_FRAMES_IN_FLIGHT : count);
+}
+
+uint64_t D3D11GraphicsDevice::GetCompletedFrame()
+{
+	// Event queries complete in submission order, so polling can stop at the first frame still executing.
+	// DONOTFLUSH keeps polling from kicking off a command buffer submission mid-frame.
+	while (mCompletedFrame < mSubmittedFrame)
+	{
+		ID3D11Query* fence = mFrameFences[(mCompletedFrame + 1) % GFX_MAX_FRAMES_IN_FLIGHT];
+		BOOL complete = FALSE;
+		if (mImmediateContext->GetData(fence, &complete, sizeof(complete), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+		{
+			break;
+		}
+		mCompletedFrame++;
+	}
+	return mCompletedFrame;
+}
+
+void D3D11GraphicsDevice::WaitForFrame(uint64_t frame)
+{
+	if (frame > mSubmittedFrame)
+	{
+		frame = mSubmittedFrame;
+	}
+
+	// Each fence is only ever reused after the frame that last ended it has been waited for, so the slot still belongs to frame
+	while (mCompletedFrame < frame)
+	{
+		ID3D11Query* fence = mFrameFences[(mCompletedFrame + 1) % GFX_MAX_FRAMES_IN_FLIGHT];
+		BOOL complete = FALSE;
+		while (mImmediateContext->GetData(fence, &complete, sizeof(complete), 0) == S_FALSE)
+		{
+			YieldProcessor();
+		}
+		mCompletedFrame++;
+	}
+}
+
+void D3D11GraphicsDevice::Present()
+{
+	if (!IsHeadless())
+	{
+		mSwapChain->Present(0, 0);
+	}
+
+	mSubmittedFrame++;
+	mImmediateContext->End(mFrameFences[mSubmittedFrame % GFX_MAX_FRAMES_IN_FLIGHT]);
+
+	// Without a swap chain nothing else hands the frame to the GPU
+	if (IsHeadless())
+	{
+		mImmediateContext->Flush();
+	}
+
+	// With one frame in flight this waits for the frame just presented, so headless frame times cover its execution
+	if (mSubmittedFrame >= mMaxFramesInFlight)
+	{
+		WaitForFrame(mSubmittedFrame - mMaxFramesInFlight + 1);
+	}
+}
+
+bool D3D11GraphicsDevice::ReadBackBuffer(std::vector<uint32_t>& texels)
+{
+	ID3D11Texture2D* backBuffer = nullptr;
+	if (mOffscreenTarget != nullptr)
+	{
+		backBuffer = mOffscreenTarget;
+		backBuffer->AddRef();
+	}
+	else if (mSwapChain == nullptr || FAILED(mSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), (LPVOID*)&backBuffer)))
+	{
+		return false;
+	}
+
+	// Copy the back buffer into a CPU-readable staging texture
+	D3D11_TEXTURE2D_DESC stagingDesc;
+	backBuffer->GetDesc(&stagingDesc);
+	stagingDesc.Usage = D3D11_USAGE_STAGING;
+	stagingDesc.BindFlags = 0;
+	stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+	stagingDesc.MiscFlags = 0;
+
+	ID3D11Texture2D* staging = nullptr;
+	if (FAILED(mDevice->CreateTexture2D(&stagingDesc, NULL, &staging)))
+	{
+		backBuffer->Release();
+		return false;
+	}
+
+	mImmediateContext->CopyResource(staging, backBuffer);
+	backBuffer->Release();
+
+	bool read = false;
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	if (SUCCEEDED(mImmediateContext->Map(staging, 0, D3D11_MAP_READ, 0, &mapped)))
+	{
+		texels.resize((size_t)stagingDesc.Width * stagingDesc.Height);
+		for (UINT y = 0; y < stagingDesc.Height; y++)
+		{
+			memcpy(&texels[(size_t)y * stagingDesc.Width], (const uint8_t*)mapped.pData + (size_t)y * mapped.RowPitch, stagingDesc.Width * sizeof(uint32_t));
+		}
+		mImmediateContext->Unmap(staging, 0);
+		read = true;
+	}
+
+	staging->Release();
+	return read;
+}
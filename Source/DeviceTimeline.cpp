@@ -0,0 +1,86 @@
+/***************************************************************************************************
+ **	Name:        DeviceTimeline.cpp                                                               **
+ **	Description: In-order batch execution on a worker thread with fence-style completion tracking **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                     **
+ **	Published:   <insert date>                                                                    **
+ **************************************************************************************************/
+
+#include "DeviceTimeline.h"
+
+DeviceTimeline::DeviceTimeline() : mSubmittedValue(0), mCompletedValue(0), bShutdown(false)
+{
+	mWorker = std::thread(&DeviceTimeline::WorkerMain, this);
+}
+
+DeviceTimeline::~DeviceTimeline()
+{
+	{
+		std::lock_guard<std::mutex> guard(mLock);
+		bShutdown = true;
+	}
+	mWorkCondition.notify_one();
+	mWorker.join();
+}
+
+uint64_t DeviceTimeline::Submit(std::vector<Work>&& batch)
+{
+	uint64_t value;
+	{
+		std::lock_guard<std::mutex> guard(mLock);
+		mBatches.push_back(std::move(batch));
+		value = ++mSubmittedValue;
+	}
+	mWorkCondition.notify_one();
+	return value;
+}
+
+uint64_t DeviceTimeline::GetSubmittedValue() const
+{
+	std::lock_guard<std::mutex> guard(mLock);
+	return mSubmittedValue;
+}
+
+uint64_t DeviceTimeline::GetCompletedValue() const
+{
+	std::lock_guard<std::mutex> guard(mLock);
+	return mCompletedValue;
+}
+
+void DeviceTimeline::Wait(uint64_t value)
+{
+	std::unique_lock<std::mutex> guard(mLock);
+	if (value > mSubmittedValue)
+	{
+		value = mSubmittedValue;
+	}
+	mCompleteCondition.wait(guard, [this, value] { return mCompletedValue >= value; });
+}
+
+void DeviceTimeline::WorkerMain()
+{
+	std::unique_lock<std::mutex> guard(mLock);
+	for (;;)
+	{
+		// Drain the queue before honouring shutdown, so destruction never drops submitted work
+		mWorkCondition.wait(guard, [this] { return bShutdown || !mBatches.empty(); });
+		if (mBatches.empty())
+		{
+			return;
+		}
+
+		std::vector<Work> batch = std::move(mBatches.front());
+		mBatches.pop_front();
+
+		guard.unlock();
+		for (Work& work : batch)
+		{
+			work();
+		}
+		batch.clear();
+		guard.lock();
+
+		// Batches run in order, so the fence is just a count of the ones finished
+		mCompletedValue++;
+		mCompleteCondition.notify_all();
+	}
+}
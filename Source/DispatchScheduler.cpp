@@ -0,0 +1,169 @@
+/***************************************************************************************
+ **	Name:        DispatchScheduler.cpp                                                **
+ **	Description: Serialized vs. UAV-overlapped dispatch scheduling on the CPU backend **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                         **
+ **	Published:   <insert date>                                                        **
+ **************************************************************************************/
+
+#include "DispatchScheduler.h"
+
+DispatchScheduler::DispatchScheduler(CPUComputeBackend& backend) : mBackend(backend), bInUAVOverlap(false), bDispatchOutstanding(false)
+{
+	mStats = Stats();
+}
+
+void DispatchScheduler::BeginFrame()
+{
+	mStats.wallTimeMs = 0.0;
+	mStats.dispatchCount = 0;
+	mStats.barrierCount = 0;
+	mStats.workerIdleMs.assign(mBackend.GetThreadPool().GetThreadCount(), 0.0);
+
+	mBackend.GetThreadPool().ResetWorkerStats();
+	mFrameStart = std::chrono::steady_clock::now();
+}
+
+const DispatchScheduler::Stats& DispatchScheduler::EndFrame()
+{
+	// End of frame always drains, same as the composite pass reading the UAV as an SRV
+	Barrier();
+
+	mStats.wallTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mFrameStart).count();
+
+	ThreadPool& pool = mBackend.GetThreadPool();
+	for (uint32_t i = 0; i < pool.GetThreadCount(); i++)
+	{
+		double idleMs = mStats.wallTimeMs - pool.GetWorkerBusySeconds(i) * 1000.0;
+		mStats.workerIdleMs[i] = idleMs > 0.0 ? idleMs : 0.0;
+	}
+
+	return mStats;
+}
+
+void DispatchScheduler::BeginUAVOverlap()
+{
+	bInUAVOverlap = true;
+}
+
+void DispatchScheduler::EndUAVOverlap()
+{
+	// Re-enabling UAV syncs means anything after the bracket must see every write made inside it
+	bInUAVOverlap = false;
+	Barrier();
+}
+
+void DispatchScheduler::Barrier()
+{
+	if (bDispatchOutstanding)
+	{
+		mBackend.GetThreadPool().Wait();
+		mStats.barrierCount++;
+		bDispatchOutstanding = false;
+	}
+}
+
+void DispatchScheduler::Dispatch(const CPUComputeBackend::ConstantBuffer& cb, uint32_t groupsX, uint32_t groupsY, CPUTexture2D& uav, const CPUWorkloadBinding* workload)
+{
+	if (!bInUAVOverlap)
+	{
+		Barrier();
+	}
+
+	// One task per row of thread groups keeps large dispatches from flooding the queues with tiny tasks
+	CPUComputeBackend::ConstantBuffer constants = cb;
+	CPUTexture2D* target = &uav;
+	uint32_t tileSize = mBackend.GetTileSize();
+	bool hasWorkload = workload != nullptr;
+	CPUWorkloadBinding binding = hasWorkload ? *workload : CPUWorkloadBinding();
+	for (uint32_t groupY = 0; groupY < groupsY; groupY++)
+	{
+		mBackend.GetThreadPool().Submit([constants, tileSize, groupsX, groupY, target, hasWorkload, binding]
+		{
+			for (uint32_t groupX = 0; groupX < groupsX; groupX++)
+			{
+				if (hasWorkload)
+				{
+					RunWorkloadThreadGroup(constants, binding, tileSize, groupX, groupY, *target);
+				}
+				else
+				{
+					CPUComputeBackend::RunThreadGroup(constants, tileSize, groupX, groupY, *target);
+				}
+			}
+		});
+	}
+
+	bDispatchOutstanding = true;
+	mStats.dispatchCount++;
+}
+
+void DispatchScheduler::DispatchTileList(const CPUComputeBackend::ConstantBuffer& cb, const uint32_t* tiles, uint32_t tileCount, uint32_t groupsX, uint32_t groupsY, CPUTexture2D& uav,
+	const CPUWorkloadBinding* workload)
+{
+	if (!bInUAVOverlap)
+	{
+		Barrier();
+	}
+
+	// A row of a tile-list dispatch can hold a thousand groups, so split the groups into fixed-size tasks instead
+	const uint32_t groupsPerTask = 64;
+	CPUComputeBackend::ConstantBuffer constants = cb;
+	CPUTexture2D* target = &uav;
+	uint32_t tileSize = mBackend.GetTileSize();
+	bool hasWorkload = workload != nullptr;
+	CPUWorkloadBinding binding = hasWorkload ? *workload : CPUWorkloadBinding();
+	// Rows past the end of the list would only run groups that do nothing
+	uint32_t listRows = (uint32_t)(((uint64_t)tileCount + CS_TILE_LIST_ROW_GROUPS - 1) / CS_TILE_LIST_ROW_GROUPS);
+	if (groupsX <= CS_TILE_LIST_ROW_GROUPS && groupsY > listRows)
+	{
+		groupsY = listRows;
+	}
+	uint64_t groupCount = (uint64_t)groupsX * groupsY;
+	for (uint64_t first = 0; first < groupCount; first += groupsPerTask)
+	{
+		uint64_t last = (first + groupsPerTask < groupCount) ? first + groupsPerTask : groupCount;
+		mBackend.GetThreadPool().Submit([constants, tileSize, tiles, tileCount, groupsX, first, last, target, hasWorkload, binding]
+		{
+			for (uint64_t group = first; group < last; group++)
+			{
+				CPUComputeBackend::RunTileListGroup(constants, tileSize, tiles, tileCount, (uint32_t)(group % groupsX), (uint32_t)(group / groupsX), *target,
+					hasWorkload ? &binding : nullptr);
+			}
+		});
+	}
+
+	bDispatchOutstanding = true;
+	mStats.dispatchCount++;
+}
+
+const DispatchScheduler::Stats& DispatchScheduler::RunTileFrame(const CPUComputeBackend::ConstantBuffer* tiles, uint32_t tileCount, CPUTexture2D& uav, bool useUAVOverlap)
+{
+	BeginFrame();
+
+	if (useUAVOverlap)
+	{
+		BeginUAVOverlap();
+	}
+
+	for (uint32_t i = 0; i < tileCount; i++)
+	{
+		Dispatch(tiles[i], 1, 1, uav);
+	}
+
+	if (useUAVOverlap)
+	{
+		EndUAVOverlap();
+	}
+
+	return EndFrame();
+}
+
+const DispatchScheduler::Stats& DispatchScheduler::RunBatchedFrame(uint32_t numTilesX, uint32_t numTilesY, CPUTexture2D& uav)
+{
+	BeginFrame();
+
+	CPUComputeBackend::ConstantBuffer cbuffer = { 0, 0, uav.width, uav.height };
+	Dispatch(cbuffer, numTilesX, numTilesY, uav);
+
+	return EndFrame();
+}
@@ -0,0 +1,140 @@
+/*****************************************************************************************************
+ **	Name:        FramePacer.cpp                                                                     **
+ **	Description: Frames-in-flight pacing, per-frame resource sets and the latency/throughput report **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                       **
+ **	Published:   <insert date>                                                                      **
+ ****************************************************************************************************/
+
+#include "FramePacer.h"
+
+FramePacer::FramePacer(FrameClockFn clock) : mDevice(nullptr), mClock(clock), mFramesInFlight(1)
+{
+	for (uint32_t i = 0; i < GFX_MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		mSetFrames[i] = 0;
+		mFrameStartNs[i] = 0;
+	}
+	mCollectedFrame = 0;
+	ResetReport();
+}
+
+void FramePacer::Init(GraphicsDevice* device)
+{
+	mDevice = device;
+	mFramesInFlight = device->GetMaxFramesInFlight();
+	if (mFramesInFlight < 1 || mFramesInFlight > GFX_MAX_FRAMES_IN_FLIGHT)
+	{
+		mFramesInFlight = 1;
+	}
+
+	for (uint32_t i = 0; i < GFX_MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		mSetFrames[i] = 0;
+	}
+	mCollectedFrame = device->GetSubmittedFrame();
+	ResetReport();
+}
+
+void FramePacer::ResetReport()
+{
+	// Frames already begun started before the reset, so the report starts with the next one
+	mFirstFrame = (mDevice != nullptr ? mDevice->GetSubmittedFrame() : 0) + 1;
+	mFirstStartNs = 0;
+	mLastCompleteNs = 0;
+	mWaitNs = 0;
+	mMaxWaitNs = 0;
+	mWaitFrames = 0;
+	mFrameWaitNs = 0;
+	mLatency.Reset();
+}
+
+uint32_t FramePacer::BeginFrame()
+{
+	uint64_t frame = mDevice->GetSubmittedFrame() + 1;
+	uint32_t set = (uint32_t)(frame % mFramesInFlight);
+
+	// Present() normally has the device throttled far enough already, so this rarely blocks
+	uint64_t start = mClock();
+	mDevice->WaitForFrame(mSetFrames[set]);
+	uint64_t now = mClock();
+	mSetFrames[set] = frame;
+
+	mFrameStartNs[frame % GFX_MAX_FRAMES_IN_FLIGHT] = now;
+	if (frame == mFirstFrame)
+	{
+		mFirstStartNs = now;
+	}
+	mFrameWaitNs = now - start;
+
+	CollectCompletedFrames();
+	return set;
+}
+
+void FramePacer::Present()
+{
+	uint64_t start = mClock();
+	mDevice->Present();
+	mFrameWaitNs += mClock() - start;
+
+	mWaitNs += mFrameWaitNs;
+	mMaxWaitNs = mFrameWaitNs > mMaxWaitNs ? mFrameWaitNs : mMaxWaitNs;
+	mWaitFrames++;
+
+	CollectCompletedFrames();
+}
+
+void FramePacer::Flush()
+{
+	if (mDevice != nullptr)
+	{
+		mDevice->WaitForFrame(mDevice->GetSubmittedFrame());
+		CollectCompletedFrames();
+	}
+}
+
+void FramePacer::CollectCompletedFrames()
+{
+	uint64_t completed = mDevice->GetCompletedFrame();
+	if (completed <= mCollectedFrame)
+	{
+		return;
+	}
+
+	// Every frame finishing since the last poll is stamped with the time of this poll
+	uint64_t now = mClock();
+	for (uint64_t frame = mCollectedFrame + 1; frame <= completed; frame++)
+	{
+		if (frame >= mFirstFrame)
+		{
+			mLatency.Record(now - mFrameStartNs[frame % GFX_MAX_FRAMES_IN_FLIGHT]);
+			mLastCompleteNs = now;
+		}
+	}
+	mCollectedFrame = completed;
+}
+
+FramePacer::Report FramePacer::GetReport() const
+{
+	Report report = {};
+	report.framesInFlight = mFramesInFlight;
+	report.latency = mLatency.GetSummary();
+	report.frameCount = report.latency.count;
+	if (report.frameCount > 0 && mLastCompleteNs > mFirstStartNs)
+	{
+		report.throughputFps = (double)report.frameCount * 1.0e9 / (double)(mLastCompleteNs - mFirstStartNs);
+	}
+	if (mWaitFrames > 0)
+	{
+		report.meanCpuWaitMs = (double)mWaitNs / 1.0e6 / (double)mWaitFrames;
+		report.maxCpuWaitMs = (double)mMaxWaitNs / 1.0e6;
+	}
+	return report;
+}
+
+void FramePacer::PrintReport(FILE* file) const
+{
+	Report report = GetReport();
+	fprintf(file, "frames in flight=%u finished=%llu throughput=%.2f fps latency mean=%.4f ms p95=%.4f ms max=%.4f ms cpu wait mean=%.4f ms max=%.4f ms\n",
+		report.framesInFlight, (unsigned long long)report.frameCount, report.throughputFps, report.latency.meanMs, report.latency.p95Ms,
+		report.latency.maxMs, report.meanCpuWaitMs, report.maxCpuWaitMs);
+}
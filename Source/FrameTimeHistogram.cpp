@@ -0,0 +1,377 @@
+/*************************************************************************
+ **	Name:        FrameTimeHistogram.cpp                                 **
+ **	Description: Lock-free frame time histogram, percentiles and export **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com           **
+ **	Published:   <insert date>                                          **
+ ************************************************************************/
+
+#include "FrameTimeHistogram.h"
+#include "SampleUtils.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static const uint64_t EMPTY_SLOT = ~0ull;
+
+// Index of the highest set bit; value must be non-zero
+static uint32_t HighestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return (uint32_t)index;
+#else
+	return 63 - (uint32_t)__builtin_clzll(value);
+#endif
+}
+
+static double NsToMs(uint64_t ns)
+{
+	return (double)ns / 1.0e6;
+}
+
+uint64_t SteadyClockNanoseconds()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t FrameTimer::Tick()
+{
+	uint64_t now = mClock();
+	uint64_t elapsed = bStarted ? now - mLastTick : 0;
+	mLastTick = now;
+	bStarted = true;
+	return elapsed;
+}
+
+FrameTimeHistogram::FrameTimeHistogram()
+{
+	Reset();
+}
+
+void FrameTimeHistogram::Reset()
+{
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		mCounts[i].store(0, std::memory_order_relaxed);
+		mRollingCounts[i].store(0, std::memory_order_relaxed);
+	}
+	for (uint32_t i = 0; i < HISTORY_SIZE; i++)
+	{
+		mHistory[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+	}
+	mHistoryWriteIndex.store(0, std::memory_order_relaxed);
+	mCount.store(0, std::memory_order_relaxed);
+	mSumNs.store(0, std::memory_order_relaxed);
+	mMinNs.store(EMPTY_SLOT, std::memory_order_relaxed);
+	mMaxNs.store(0, std::memory_order_release);
+}
+
+uint32_t FrameTimeHistogram::GetBucketIndex(uint64_t valueNs)
+{
+	if (valueNs > MAX_TRACKABLE_NS)
+	{
+		valueNs = MAX_TRACKABLE_NS;
+	}
+	if (valueNs < SUB_BUCKET_COUNT)
+	{
+		return (uint32_t)valueNs;
+	}
+
+	// Position of the highest set bit picks the power of two, the next SUB_BUCKET_BITS bits pick the linear bucket
+	uint32_t shift = HighestBit(valueNs) - SUB_BUCKET_BITS;
+	return (shift + 1) * SUB_BUCKET_COUNT + (uint32_t)(valueNs >> shift) - SUB_BUCKET_COUNT;
+}
+
+uint64_t FrameTimeHistogram::GetBucketLowerBound(uint32_t index)
+{
+	uint32_t range = index / SUB_BUCKET_COUNT;
+	uint64_t subBucket = index % SUB_BUCKET_COUNT;
+	if (range == 0)
+	{
+		return subBucket;
+	}
+	return (SUB_BUCKET_COUNT + subBucket) << (range - 1);
+}
+
+uint64_t FrameTimeHistogram::GetBucketUpperBound(uint32_t index)
+{
+	uint32_t range = index / SUB_BUCKET_COUNT;
+	return GetBucketLowerBound(index) + (range == 0 ? 1 : (1ull << (range - 1)));
+}
+
+void FrameTimeHistogram::Record(uint64_t frameTimeNs)
+{
+	if (frameTimeNs > MAX_TRACKABLE_NS)
+	{
+		frameTimeNs = MAX_TRACKABLE_NS;
+	}
+
+	mCounts[GetBucketIndex(frameTimeNs)].fetch_add(1, std::memory_order_relaxed);
+	mSumNs.fetch_add(frameTimeNs, std::memory_order_relaxed);
+
+	uint64_t current = mMinNs.load(std::memory_order_relaxed);
+	while (frameTimeNs < current && !mMinNs.compare_exchange_weak(current, frameTimeNs, std::memory_order_relaxed))
+	{
+	}
+	current = mMaxNs.load(std::memory_order_relaxed);
+	while (frameTimeNs > current && !mMaxNs.compare_exchange_weak(current, frameTimeNs, std::memory_order_relaxed))
+	{
+	}
+
+	// Each writer claims its own slot; whatever frame it displaces leaves the rolling histogram
+	uint64_t slot = mHistoryWriteIndex.fetch_add(1, std::memory_order_relaxed) % HISTORY_SIZE;
+	uint64_t evicted = mHistory[slot].exchange(frameTimeNs, std::memory_order_relaxed);
+	mRollingCounts[GetBucketIndex(frameTimeNs)].fetch_add(1, std::memory_order_relaxed);
+	if (evicted != EMPTY_SLOT)
+	{
+		mRollingCounts[GetBucketIndex(evicted)].fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	mCount.fetch_add(1, std::memory_order_release);
+}
+
+void FrameTimeHistogram::RecordMs(double frameTimeMs)
+{
+	Record(frameTimeMs > 0.0 ? (uint64_t)(frameTimeMs * 1.0e6 + 0.5) : 0);
+}
+
+double FrameTimeHistogram::PercentileFromCounts(const uint32_t* counts, double percentile, uint64_t minNs, uint64_t maxNs)
+{
+	uint64_t total = 0;
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		total += counts[i];
+	}
+	if (total == 0)
+	{
+		return 0.0;
+	}
+
+	uint64_t rank = (uint64_t)std::ceil(percentile / 100.0 * (double)total);
+	if (rank < 1)
+	{
+		rank = 1;
+	}
+	if (rank > total)
+	{
+		rank = total;
+	}
+
+	uint64_t cumulative = 0;
+	uint32_t index = 0;
+	for (; index < BUCKET_COUNT - 1; index++)
+	{
+		cumulative += counts[index];
+		if (cumulative >= rank)
+		{
+			break;
+		}
+	}
+
+	uint64_t midpoint = (GetBucketLowerBound(index) + GetBucketUpperBound(index) - 1) / 2;
+	if (midpoint < minNs)
+	{
+		midpoint = minNs;
+	}
+	if (midpoint > maxNs)
+	{
+		midpoint = maxNs;
+	}
+	return NsToMs(midpoint);
+}
+
+double FrameTimeHistogram::GetPercentileMs(double percentile) const
+{
+	// The total and the walk read the same copy of the counts, so a concurrent Record() cannot push the rank past them
+	uint32_t counts[BUCKET_COUNT];
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		counts[i] = mCounts[i].load(std::memory_order_relaxed);
+	}
+	return PercentileFromCounts(counts, percentile, mMinNs.load(std::memory_order_relaxed), mMaxNs.load(std::memory_order_relaxed));
+}
+
+double FrameTimeHistogram::GetRollingPercentileMs(double percentile) const
+{
+	uint64_t minNs, maxNs, sumNs, count;
+	GetRollingRange(minNs, maxNs, sumNs, count);
+
+	uint32_t counts[BUCKET_COUNT];
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		int32_t value = mRollingCounts[i].load(std::memory_order_relaxed);
+		counts[i] = value > 0 ? (uint32_t)value : 0;
+	}
+	return PercentileFromCounts(counts, percentile, minNs, maxNs);
+}
+
+void FrameTimeHistogram::GetRollingRange(uint64_t& minNs, uint64_t& maxNs, uint64_t& sumNs, uint64_t& count) const
+{
+	minNs = EMPTY_SLOT;
+	maxNs = 0;
+	sumNs = 0;
+	count = 0;
+	for (uint32_t i = 0; i < HISTORY_SIZE; i++)
+	{
+		uint64_t value = mHistory[i].load(std::memory_order_relaxed);
+		if (value == EMPTY_SLOT)
+		{
+			continue;
+		}
+		minNs = value < minNs ? value : minNs;
+		maxNs = value > maxNs ? value : maxNs;
+		sumNs += value;
+		count++;
+	}
+	if (count == 0)
+	{
+		minNs = 0;
+	}
+}
+
+FrameTimeHistogram::Summary FrameTimeHistogram::GetSummary() const
+{
+	Summary summary;
+	summary.count = mCount.load(std::memory_order_acquire);
+	summary.minMs = summary.count ? NsToMs(mMinNs.load(std::memory_order_relaxed)) : 0.0;
+	summary.maxMs = NsToMs(mMaxNs.load(std::memory_order_relaxed));
+	summary.meanMs = summary.count ? NsToMs(mSumNs.load(std::memory_order_relaxed)) / (double)summary.count : 0.0;
+	summary.p50Ms = GetPercentileMs(50.0);
+	summary.p95Ms = GetPercentileMs(95.0);
+	summary.p99Ms = GetPercentileMs(99.0);
+	return summary;
+}
+
+FrameTimeHistogram::Summary FrameTimeHistogram::GetRollingSummary() const
+{
+	uint64_t minNs, maxNs, sumNs, count;
+	GetRollingRange(minNs, maxNs, sumNs, count);
+
+	Summary summary;
+	summary.count = count;
+	summary.minMs = NsToMs(minNs);
+	summary.maxMs = NsToMs(maxNs);
+	summary.meanMs = count ? NsToMs(sumNs) / (double)count : 0.0;
+	summary.p50Ms = GetRollingPercentileMs(50.0);
+	summary.p95Ms = GetRollingPercentileMs(95.0);
+	summary.p99Ms = GetRollingPercentileMs(99.0);
+	return summary;
+}
+
+uint32_t FrameTimeHistogram::GetHistoryMs(float* values, uint32_t count) const
+{
+	uint64_t written = mHistoryWriteIndex.load(std::memory_order_acquire);
+	uint64_t available = written < HISTORY_SIZE ? written : HISTORY_SIZE;
+	if (count > available)
+	{
+		count = (uint32_t)available;
+	}
+
+	uint32_t filled = 0;
+	for (uint64_t i = written - count; i < written; i++)
+	{
+		uint64_t value = mHistory[i % HISTORY_SIZE].load(std::memory_order_relaxed);
+		if (value != EMPTY_SLOT)
+		{
+			values[filled++] = (float)NsToMs(value);
+		}
+	}
+	return filled;
+}
+
+bool FrameTimeHistogram::WriteCSV(const char* path) const
+{
+	FILE* file = OpenFile(path, "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	Summary summary = GetSummary();
+	fprintf(file, "# frames=%llu min_ms=%.6f max_ms=%.6f mean_ms=%.6f p50_ms=%.6f p95_ms=%.6f p99_ms=%.6f\n", (unsigned long long)summary.count,
+		summary.minMs, summary.maxMs, summary.meanMs, summary.p50Ms, summary.p95Ms, summary.p99Ms);
+	fprintf(file, "lower_ms,upper_ms,count,cumulative_fraction\n");
+
+	uint64_t cumulative = 0;
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		uint32_t count = mCounts[i].load(std::memory_order_relaxed);
+		if (count == 0)
+		{
+			continue;
+		}
+		cumulative += count;
+		fprintf(file, "%.6f,%.6f,%u,%.6f\n", NsToMs(GetBucketLowerBound(i)), NsToMs(GetBucketUpperBound(i)), count,
+			summary.count ? (double)cumulative / (double)summary.count : 0.0);
+	}
+
+	return fclose(file) == 0;
+}
+
+static void WriteSummaryJSON(FILE* file, const char* name, const FrameTimeHistogram::Summary& summary)
+{
+	fprintf(file, "  \"%s\": { \"frames\": %llu, \"min_ms\": %.6f, \"max_ms\": %.6f, \"mean_ms\": %.6f, \"p50_ms\": %.6f, \"p95_ms\": %.6f, \"p99_ms\": %.6f },\n",
+		name, (unsigned long long)summary.count, summary.minMs, summary.maxMs, summary.meanMs, summary.p50Ms, summary.p95Ms, summary.p99Ms);
+}
+
+bool FrameTimeHistogram::WriteJSON(const char* path) const
+{
+	FILE* file = OpenFile(path, "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	fprintf(file, "{\n");
+	WriteSummaryJSON(file, "lifetime", GetSummary());
+	WriteSummaryJSON(file, "rolling", GetRollingSummary());
+
+	fprintf(file, "  \"buckets\": [");
+	bool first = true;
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		uint32_t count = mCounts[i].load(std::memory_order_relaxed);
+		if (count == 0)
+		{
+			continue;
+		}
+		fprintf(file, "%s\n    { \"lower_ms\": %.6f, \"upper_ms\": %.6f, \"count\": %u }", first ? "" : ",",
+			NsToMs(GetBucketLowerBound(i)), NsToMs(GetBucketUpperBound(i)), count);
+		first = false;
+	}
+	fprintf(file, "\n  ],\n");
+
+	float history[HISTORY_SIZE];
+	uint32_t historyCount = GetHistoryMs(history, HISTORY_SIZE);
+	fprintf(file, "  \"history_ms\": [");
+	for (uint32_t i = 0; i < historyCount; i++)
+	{
+		fprintf(file, "%s%.6f", i ? ", " : "", history[i]);
+	}
+	fprintf(file, "]\n}\n");
+
+	return fclose(file) == 0;
+}
+
+bool FrameTimeHistogram::WriteFile(const char* path) const
+{
+	size_t length = strlen(path);
+	if (length >= 5 && strcmp(path + length - 5, ".json") == 0)
+	{
+		return WriteJSON(path);
+	}
+	return WriteCSV(path);
+}
+
+void FrameTimeHistogram::PrintSummary(FILE* file) const
+{
+	Summary summary = GetSummary();
+	fprintf(file, "p50=%.4f ms p95=%.4f ms p99=%.4f ms (histogram of %llu frames)\n", summary.p50Ms, summary.p95Ms, summary.p99Ms,
+		(unsigned long long)summary.count);
+}
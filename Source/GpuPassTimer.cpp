@@ -0,0 +1,214 @@
+/***********************************************************************
+ **	Name:        GpuPassTimer.cpp                                     **
+ **	Description: Per-pass GPU timing from a ring of timestamp queries **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com         **
+ **	Published:   <insert date>                                        **
+ **********************************************************************/
+
+#include "GpuPassTimer.h"
+
+GpuPassTimer::GpuPassTimer()
+{
+	mDevice = nullptr;
+	mPassCount = 0;
+	mRingSize = 0;
+	for (uint32_t i = 0; i < MAX_RING_SIZE; i++)
+	{
+		mFrames[i].disjoint = GFX_NULL_HANDLE;
+		for (uint32_t t = 0; t <= MAX_PASSES; t++)
+		{
+			mFrames[i].timestamps[t] = GFX_NULL_HANDLE;
+		}
+		mFrames[i].frameIndex = 0;
+	}
+	Release();
+}
+
+bool GpuPassTimer::Init(GraphicsDevice* device, uint32_t passCount, uint32_t ringSize)
+{
+	Release();
+	if (device == nullptr || passCount == 0 || passCount > MAX_PASSES || ringSize == 0 || ringSize > MAX_RING_SIZE)
+	{
+		return false;
+	}
+
+	mDevice = device;
+	mPassCount = passCount;
+	mRingSize = ringSize;
+
+	for (uint32_t i = 0; i < mRingSize; i++)
+	{
+		mFrames[i].disjoint = mDevice->CreateQuery(GFX_QUERY_TIMESTAMP_DISJOINT);
+		if (mFrames[i].disjoint == GFX_NULL_HANDLE)
+		{
+			Release();
+			return false;
+		}
+		for (uint32_t t = 0; t <= mPassCount; t++)
+		{
+			mFrames[i].timestamps[t] = mDevice->CreateQuery(GFX_QUERY_TIMESTAMP);
+			if (mFrames[i].timestamps[t] == GFX_NULL_HANDLE)
+			{
+				Release();
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void GpuPassTimer::Release()
+{
+	for (uint32_t i = 0; i < MAX_RING_SIZE; i++)
+	{
+		if (mDevice != nullptr)
+		{
+			mDevice->Release(mFrames[i].disjoint);
+			for (uint32_t t = 0; t <= MAX_PASSES; t++)
+			{
+				mDevice->Release(mFrames[i].timestamps[t]);
+			}
+		}
+		mFrames[i].disjoint = GFX_NULL_HANDLE;
+		for (uint32_t t = 0; t <= MAX_PASSES; t++)
+		{
+			mFrames[i].timestamps[t] = GFX_NULL_HANDLE;
+		}
+	}
+
+	mDevice = nullptr;
+	mPassCount = 0;
+	mRingSize = 0;
+	mFrameIndex = 0;
+	mIssueIndex = 0;
+	mOldestPending = 0;
+	bFrameActive = false;
+
+	for (uint32_t pass = 0; pass < MAX_PASSES; pass++)
+	{
+		mLastPassMs[pass] = 0.0;
+		for (uint32_t i = 0; i < AVERAGE_FRAMES; i++)
+		{
+			mHistoryMs[pass][i] = 0.0;
+		}
+	}
+	mHistoryCount = 0;
+	mResultLatency = 0;
+
+	mResolvedFrames = 0;
+	mSkippedFrames = 0;
+	mDisjointFrames = 0;
+}
+
+void GpuPassTimer::BeginFrame()
+{
+	bFrameActive = false;
+	if (mDevice == nullptr)
+	{
+		return;
+	}
+
+	// Every set of queries is in flight: give the oldest one last chance, otherwise leave this frame untimed
+	if (mIssueIndex - mOldestPending == mRingSize)
+	{
+		if (!TryResolve(mFrames[mOldestPending % mRingSize]))
+		{
+			mSkippedFrames++;
+			return;
+		}
+		mOldestPending++;
+	}
+
+	FrameQueries& frame = mFrames[mIssueIndex % mRingSize];
+	frame.frameIndex = mFrameIndex;
+	mDevice->Begin(frame.disjoint);
+	mDevice->End(frame.timestamps[0]);
+	bFrameActive = true;
+}
+
+void GpuPassTimer::EndPass(uint32_t pass)
+{
+	if (bFrameActive && pass < mPassCount)
+	{
+		mDevice->End(mFrames[mIssueIndex % mRingSize].timestamps[pass + 1]);
+	}
+}
+
+void GpuPassTimer::EndFrame()
+{
+	if (mDevice == nullptr)
+	{
+		return;
+	}
+
+	if (bFrameActive)
+	{
+		mDevice->End(mFrames[mIssueIndex % mRingSize].disjoint);
+		mIssueIndex++;
+		bFrameActive = false;
+	}
+
+	// Results arrive in submission order, so stop at the first frame that is still in flight
+	while (mOldestPending < mIssueIndex && TryResolve(mFrames[mOldestPending % mRingSize]))
+	{
+		mOldestPending++;
+	}
+
+	mFrameIndex++;
+}
+
+bool GpuPassTimer::TryResolve(FrameQueries& frame)
+{
+	uint64_t frequency = 0;
+	bool disjoint = false;
+	if (!mDevice->GetTimestampDisjoint(frame.disjoint, frequency, disjoint))
+	{
+		return false;
+	}
+
+	uint64_t ticks[MAX_PASSES + 1];
+	for (uint32_t t = 0; t <= mPassCount; t++)
+	{
+		if (!mDevice->GetTimestamp(frame.timestamps[t], ticks[t]))
+		{
+			return false;
+		}
+	}
+
+	mResultLatency = (uint32_t)(mFrameIndex - frame.frameIndex);
+
+	// A disjoint frame (clock change, power event) or a zero frequency makes the timestamps meaningless
+	if (disjoint || frequency == 0)
+	{
+		mDisjointFrames++;
+		return true;
+	}
+
+	uint32_t historySlot = mHistoryCount % AVERAGE_FRAMES;
+	for (uint32_t pass = 0; pass < mPassCount; pass++)
+	{
+		uint64_t elapsed = ticks[pass + 1] > ticks[pass] ? ticks[pass + 1] - ticks[pass] : 0;
+		mLastPassMs[pass] = (double)elapsed * 1000.0 / (double)frequency;
+		mHistoryMs[pass][historySlot] = mLastPassMs[pass];
+	}
+	mHistoryCount++;
+	mResolvedFrames++;
+	return true;
+}
+
+double GpuPassTimer::GetAveragePassMs(uint32_t pass) const
+{
+	uint32_t count = mHistoryCount < AVERAGE_FRAMES ? mHistoryCount : AVERAGE_FRAMES;
+	if (pass >= mPassCount || count == 0)
+	{
+		return 0.0;
+	}
+
+	double total = 0.0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		total += mHistoryMs[pass][i];
+	}
+	return total / count;
+}
@@ -0,0 +1,252 @@
+/*****************************************************************
+ **	Name:        GradientKernels.cpp                            **
+ **	Description: Gradient row kernels and CPU feature detection **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com   **
+ **	Published:   <insert date>                                  **
+ ****************************************************************/
+
+#include "GradientKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GRADIENT_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2/AVX-512 instructions inside functions that ask for them; MSVC always can.
+// Keeping the wide kernels to per-function targets means nothing else in the build picks up those instructions.
+#if defined(GRADIENT_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define TARGET_AVX2
+#define TARGET_AVX512
+#endif
+
+static const char* gKernelISANames[KERNEL_ISA_COUNT] = { "scalar", "sse2", "avx2", "avx512" };
+
+static void GradientRowScalar(uint32_t* dst, uint32_t x, uint32_t count, float invWidth, uint32_t rowBits)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		dst[i] = FloatToUNorm8((float)(x + i) * invWidth) | rowBits;
+	}
+}
+
+#ifdef GRADIENT_KERNELS_X86
+
+// All three vector kernels follow the same sequence, 16 pixels per loop iteration:
+//     red = (int)(min(max(float(x) * invWidth, 0), 1) * 255 + 0.5)
+// max() returns its second operand for NaN, so NaN saturates to 0 exactly like FloatToUNorm8, and a saturated
+// value scales to 0.5 or 255.5, which truncate to the same 0 and 255 the scalar early-outs return.
+// The integer x converts to float exactly, and there is no FMA, so every step rounds as the scalar code does.
+
+// Red for four consecutive columns starting at xi, or'ed with the row's other channels
+static inline __m128i GradientTexelsSSE2(__m128i xi, __m128 inv, __m128i bits)
+{
+	__m128 v = _mm_mul_ps(_mm_cvtepi32_ps(xi), inv);
+	v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	__m128i red = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+	return _mm_or_si128(red, bits);
+}
+
+static void GradientRowSSE2(uint32_t* dst, uint32_t x, uint32_t count, float invWidth, uint32_t rowBits)
+{
+	const __m128 inv = _mm_set1_ps(invWidth);
+	const __m128i bits = _mm_set1_epi32((int)rowBits);
+	const __m128i four = _mm_set1_epi32(4);
+
+	__m128i xi = _mm_add_epi32(_mm_set1_epi32((int)x), _mm_setr_epi32(0, 1, 2, 3));
+
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i xi1 = _mm_add_epi32(xi, four);
+		__m128i xi2 = _mm_add_epi32(xi1, four);
+		__m128i xi3 = _mm_add_epi32(xi2, four);
+		_mm_storeu_si128((__m128i*)(dst + i), GradientTexelsSSE2(xi, inv, bits));
+		_mm_storeu_si128((__m128i*)(dst + i + 4), GradientTexelsSSE2(xi1, inv, bits));
+		_mm_storeu_si128((__m128i*)(dst + i + 8), GradientTexelsSSE2(xi2, inv, bits));
+		_mm_storeu_si128((__m128i*)(dst + i + 12), GradientTexelsSSE2(xi3, inv, bits));
+		xi = _mm_add_epi32(xi3, four);
+	}
+	for (; i + 4 <= count; i += 4)
+	{
+		_mm_storeu_si128((__m128i*)(dst + i), GradientTexelsSSE2(xi, inv, bits));
+		xi = _mm_add_epi32(xi, four);
+	}
+
+	GradientRowScalar(dst + i, x + i, count - i, invWidth, rowBits);
+}
+
+TARGET_AVX2 static inline __m256i GradientTexelsAVX2(__m256i xi, __m256 inv, __m256i bits)
+{
+	__m256 v = _mm256_mul_ps(_mm256_cvtepi32_ps(xi), inv);
+	v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+	__m256i red = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f)));
+	return _mm256_or_si256(red, bits);
+}
+
+TARGET_AVX2 static void GradientRowAVX2(uint32_t* dst, uint32_t x, uint32_t count, float invWidth, uint32_t rowBits)
+{
+	const __m256 inv = _mm256_set1_ps(invWidth);
+	const __m256i bits = _mm256_set1_epi32((int)rowBits);
+	const __m256i eight = _mm256_set1_epi32(8);
+
+	__m256i xi = _mm256_add_epi32(_mm256_set1_epi32((int)x), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m256i xi1 = _mm256_add_epi32(xi, eight);
+		_mm256_storeu_si256((__m256i*)(dst + i), GradientTexelsAVX2(xi, inv, bits));
+		_mm256_storeu_si256((__m256i*)(dst + i + 8), GradientTexelsAVX2(xi1, inv, bits));
+		xi = _mm256_add_epi32(xi1, eight);
+	}
+	if (i + 8 <= count)
+	{
+		_mm256_storeu_si256((__m256i*)(dst + i), GradientTexelsAVX2(xi, inv, bits));
+		i += 8;
+	}
+
+	GradientRowScalar(dst + i, x + i, count - i, invWidth, rowBits);
+}
+
+// GCC 12 flags the _mm512_undefined_epi32() inside _mm512_cvttps_epi32 as maybe-uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+TARGET_AVX512 static void GradientRowAVX512(uint32_t* dst, uint32_t x, uint32_t count, float invWidth, uint32_t rowBits)
+{
+	const __m512 inv = _mm512_set1_ps(invWidth);
+	const __m512 zero = _mm512_setzero_ps();
+	const __m512 one = _mm512_set1_ps(1.0f);
+	const __m512 scale = _mm512_set1_ps(255.0f);
+	const __m512 half = _mm512_set1_ps(0.5f);
+	const __m512i bits = _mm512_set1_epi32((int)rowBits);
+	const __m512i sixteen = _mm512_set1_epi32(16);
+
+	__m512i xi = _mm512_add_epi32(_mm512_set1_epi32((int)x), _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+
+	// Partial rows (clipped edge tiles, 8x8 tiles) finish with a masked store instead of a scalar tail
+	for (uint32_t i = 0; i < count; i += 16)
+	{
+		__m512 v = _mm512_mul_ps(_mm512_cvtepi32_ps(xi), inv);
+		v = _mm512_min_ps(_mm512_max_ps(v, zero), one);
+		__m512i red = _mm512_cvttps_epi32(_mm512_add_ps(_mm512_mul_ps(v, scale), half));
+		__m512i texels = _mm512_or_si512(red, bits);
+
+		uint32_t remaining = count - i;
+		if (remaining >= 16)
+		{
+			_mm512_storeu_si512(dst + i, texels);
+		}
+		else
+		{
+			_mm512_mask_storeu_epi32(dst + i, (__mmask16)((1u << remaining) - 1), texels);
+		}
+		xi = _mm512_add_epi32(xi, sixteen);
+	}
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+static bool QueryCPUFeature(KernelISA isa)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse2 = (info[3] & (1 << 26)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if (isa == KERNEL_ISA_SSE2)
+	{
+		return sse2;
+	}
+	if (!osxsave || !avx || maxLeaf < 7)
+	{
+		return false;
+	}
+
+	// The OS must save the YMM (and for AVX-512, the opmask and ZMM) state on context switches
+	unsigned long long xcr0 = _xgetbv(0);
+	__cpuidex(info, 7, 0);
+	if (isa == KERNEL_ISA_AVX2)
+	{
+		return (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0;
+	}
+	return (xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0;
+#else
+	__builtin_cpu_init();
+	switch (isa)
+	{
+	case KERNEL_ISA_SSE2:   return __builtin_cpu_supports("sse2");
+	case KERNEL_ISA_AVX2:   return __builtin_cpu_supports("avx2");
+	case KERNEL_ISA_AVX512: return __builtin_cpu_supports("avx512f");
+	default:                return false;
+	}
+#endif
+}
+
+#endif // GRADIENT_KERNELS_X86
+
+bool IsKernelISASupported(KernelISA isa)
+{
+	if (isa == KERNEL_ISA_SCALAR)
+	{
+		return true;
+	}
+#ifdef GRADIENT_KERNELS_X86
+	if (isa < KERNEL_ISA_COUNT)
+	{
+		// Detected once; the answer cannot change while the process runs
+		static bool supported[KERNEL_ISA_COUNT] = { true, QueryCPUFeature(KERNEL_ISA_SSE2), QueryCPUFeature(KERNEL_ISA_AVX2), QueryCPUFeature(KERNEL_ISA_AVX512) };
+		return supported[isa];
+	}
+#endif
+	return false;
+}
+
+KernelISA GetBestKernelISA()
+{
+	for (int isa = KERNEL_ISA_COUNT - 1; isa > KERNEL_ISA_SCALAR; isa--)
+	{
+		if (IsKernelISASupported((KernelISA)isa))
+		{
+			return (KernelISA)isa;
+		}
+	}
+	return KERNEL_ISA_SCALAR;
+}
+
+const char* GetKernelISAName(KernelISA isa)
+{
+	return isa < KERNEL_ISA_COUNT ? gKernelISANames[isa] : "unknown";
+}
+
+GradientRowKernel GetGradientRowKernel(KernelISA isa)
+{
+	if (!IsKernelISASupported(isa))
+	{
+		return nullptr;
+	}
+
+	switch (isa)
+	{
+#ifdef GRADIENT_KERNELS_X86
+	case KERNEL_ISA_SSE2:   return GradientRowSSE2;
+	case KERNEL_ISA_AVX2:   return GradientRowAVX2;
+	case KERNEL_ISA_AVX512: return GradientRowAVX512;
+#endif
+	default:                return GradientRowScalar;
+	}
+}
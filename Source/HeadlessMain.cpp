@@ -0,0 +1,280 @@
+/*********************************************************************************************
+ **	Name:        HeadlessMain.cpp                                                           **
+ **	Description: UAV Overlap Sample - headless entrypoint for hosts without D3D11, runs the **
+ **              sample frame on the CPU reference graphics device                          **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                               **
+ **	Published:   <insert date>                                                              **
+ ********************************************************************************************/
+
+#include "BenchmarkRunner.h"
+#include "CPUGraphicsDevice.h"
+#include "RecordingGraphicsDevice.h"
+#include "StartupBench.h"
+#include "StateFilterGraphicsDevice.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <chrono>
+#include <cstdlib>
+
+#ifdef UAVOVERLAP_INTC_STUB
+#include "IntelExtensionsStub.h"
+
+// Pulls the stub runtime options out of args: --intc-versions 1.2.0,1.1.0 and --intc-fail entrypoint[:skipCalls]
+static bool ApplyStubOptions(std::vector<std::string>& args)
+{
+	std::vector<std::string> remaining;
+	for (size_t i = 0; i < args.size(); i++)
+	{
+		bool hasValue = (i + 1 < args.size());
+		if (args[i] == "--intc-versions" && hasValue)
+		{
+			std::vector<INTCExtensionVersion> versions;
+			if (!INTCStub_ParseVersionList(args[++i], versions))
+			{
+				return false;
+			}
+			INTCStub_SetSupportedVersions(versions);
+		}
+		else if (args[i] == "--intc-fail" && hasValue)
+		{
+			std::string value = args[++i];
+			uint32_t skipCalls = 0;
+			size_t colon = value.find(':');
+			if (colon != std::string::npos)
+			{
+				skipCalls = (uint32_t)strtoul(value.c_str() + colon + 1, nullptr, 10);
+				value = value.substr(0, colon);
+			}
+
+			INTCStubEntrypoint entrypoint;
+			if (!INTCStub_ParseEntrypoint(value, entrypoint))
+			{
+				return false;
+			}
+			INTCStub_SetFailure(entrypoint, E_FAIL, skipCalls);
+		}
+		else
+		{
+			remaining.push_back(args[i]);
+		}
+	}
+
+	args.swap(remaining);
+	return true;
+}
+#endif
+
+// Pulls --isa scalar|sse2|avx2|avx512 out of args and selects that row kernel for the CPU compute backend
+static bool ApplyKernelOptions(std::vector<std::string>& args)
+{
+	std::vector<std::string> remaining;
+	for (size_t i = 0; i < args.size(); i++)
+	{
+		if (args[i] == "--isa" && i + 1 < args.size())
+		{
+			const std::string& name = args[++i];
+			int isa = KERNEL_ISA_SCALAR;
+			while (isa < KERNEL_ISA_COUNT && name != GetKernelISAName((KernelISA)isa))
+			{
+				isa++;
+			}
+			if (isa == KERNEL_ISA_COUNT || !CPUComputeBackend::SetKernelISA((KernelISA)isa))
+			{
+				fprintf(stderr, "Kernel ISA '%s' is unknown or not supported by this CPU\n", name.c_str());
+				return false;
+			}
+		}
+		else
+		{
+			remaining.push_back(args[i]);
+		}
+	}
+
+	args.swap(remaining);
+	return true;
+}
+
+static void PrintUsage()
+{
+	fprintf(stderr, "usage: UAVOverlapSampleCPU [--headless] [--frames N] [--width N] [--height N] [--tile 8|16|32]\n");
+	fprintf(stderr, "                           [--overlap] [--auto-overlap] [--batched] [--indirect] [--no-state-filter] [--threads N]\n");
+	fprintf(stderr, "                           [--output frame.ppm] [--frame-stats file.csv|file.json] [--isa scalar|sse2|avx2|avx512]\n");
+	fprintf(stderr, "                           [--capture file.uavc] [--capture-frames N] [--record-threads N] [--frames-in-flight 1|2|3]\n");
+	fprintf(stderr, "                           [--workload none|alu|bandwidth|reduction|partial|irregular|mixed|alu=N+reads=N+coverage=N+reduce+irregular]\n");
+	fprintf(stderr, "                           [--resize WxH,WxH,...] [--resize-interval N] [--ui] [--startup-trace file.json]\n");
+	fprintf(stderr, "       UAVOverlapSampleCPU --bench [--bench-overlap off,on] [--bench-tiles 8,16,32] [--bench-resolutions 1280x720,...]\n");
+	fprintf(stderr, "                           [--bench-dispatch tiles,batched,indirect] [--bench-frames-in-flight 1,2,3] [--bench-workloads none,alu,...]\n");
+	fprintf(stderr, "                           [--bench-warmup N] [--bench-frames N] [--bench-report file.json|file.csv]\n");
+	fprintf(stderr, "       UAVOverlapSampleCPU --startup-bench N [--startup-trace file.json] [sample options]\n");
+#ifdef UAVOVERLAP_INTC_STUB
+	fprintf(stderr, "                           [--intc-versions 1.2.0,...] [--intc-fail load|versions|create|begin|end|...[:skipCalls]]\n");
+#endif
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::string> args(argv + 1, argv + argc);
+
+#ifdef UAVOVERLAP_INTC_STUB
+	if (!ApplyStubOptions(args))
+	{
+		PrintUsage();
+		return 1;
+	}
+#endif
+
+	HeadlessOptions options;
+	BenchmarkMatrix matrix;
+	if (!ApplyKernelOptions(args) || !ExtractBenchmarkOptions(args, matrix) || !ParseHeadlessOptions(args, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	if (matrix.bEnabled)
+	{
+		uint32_t threadCount = options.threadCount;
+		std::vector<BenchmarkResult> results;
+		bool ok = RunBenchmarkMatrix(matrix, [threadCount]() { return std::unique_ptr<GraphicsDevice>(new CPUGraphicsDevice(threadCount)); }, stdout, results);
+		return ok ? 0 : 1;
+	}
+
+	// There is no window or swap chain on this backend, so every run is headless
+	options.bHeadless = true;
+	if (!TileGrid::IsSupportedTileSize(options.tileSize))
+	{
+		options.tileSize = 16;
+	}
+
+	// Each startup run creates and destroys its own device, without the state filter or recorder in front
+	if (options.startupBenchRuns > 0)
+	{
+		uint32_t threadCount = options.threadCount;
+		bool rasterizeUI = options.bRasterizeUI;
+		std::vector<StartupTimer> runs;
+		bool ok = RunStartupBench(options, [threadCount, rasterizeUI]()
+		{
+			CPUGraphicsDevice* device = new CPUGraphicsDevice(threadCount);
+			device->SetUIRasterizationEnabled(rasterizeUI);
+			return std::unique_ptr<GraphicsDevice>(device);
+		}, stdout, runs);
+		return ok ? 0 : 1;
+	}
+
+	// app -> recorder (--capture) -> state filter -> CPU device, so a capture holds every call the app made
+	CPUGraphicsDevice cpuDevice(options.threadCount);
+	cpuDevice.SetUIRasterizationEnabled(options.bRasterizeUI);
+	StateFilterGraphicsDevice stateFilter(&cpuDevice);
+	GraphicsDevice* filtered = options.bUseStateFilter ? static_cast<GraphicsDevice*>(&stateFilter) : &cpuDevice;
+	RecordingGraphicsDevice recorder(filtered, options.captureFrames);
+	GraphicsDevice& device = options.capturePath.empty() ? *filtered : recorder;
+
+	UAVOverlapSampleApp app(&device, options.width, options.height);
+	app.ApplyOptions(options);
+
+	if (!app.Init())
+	{
+		fprintf(stderr, "Failed to initialize the %s device\n", device.GetName());
+		app.Cleanup();
+		return 1;
+	}
+
+	int result = 0;
+	if (!options.startupTracePath.empty() && !WriteStartupTrace(options.startupTracePath.c_str(), std::vector<StartupTimer>(1, app.GetStartupTimer())))
+	{
+		fprintf(stderr, "Failed to write %s\n", options.startupTracePath.c_str());
+		result = 1;
+	}
+
+	HeadlessFrameStats stats;
+	double frameTime = 0.0;
+	for (uint32_t frame = 0; frame < options.frameCount; frame++)
+	{
+		// Resize latency is reported on its own rather than counted in the frame time
+		uint32_t resizeWidth = 0;
+		uint32_t resizeHeight = 0;
+		if (GetHeadlessResize(options, frame, resizeWidth, resizeHeight) && !app.Resize(resizeWidth, resizeHeight))
+		{
+			fprintf(stderr, "Failed to resize to %ux%u\n", resizeWidth, resizeHeight);
+			app.Cleanup();
+			return 1;
+		}
+
+		std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+
+		app.Render(frameTime);
+
+		frameTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+		stats.AddFrame(frameTime);
+	}
+	app.FinishFrames();
+
+	stats.Print(stdout, options, device.GetName());
+	app.GetStartupTimer().PrintReport(stdout);
+	app.GetFrameTimeHistogram().PrintSummary(stdout);
+	app.GetFramePacer().PrintReport(stdout);
+	printf("compute=%.4f ms composite=%.4f ms (device timestamps, mean of the last %u resolved frames)\n",
+		app.GetPassTimer().GetAveragePassMs(PASS_COMPUTE), app.GetPassTimer().GetAveragePassMs(PASS_COMPOSITE), GpuPassTimer::AVERAGE_FRAMES);
+	printf("kernel=%s\n", GetKernelISAName(CPUComputeBackend::GetKernelISA()));
+	if (app.GetResizeReport().GetCount() > 0)
+	{
+		app.GetResizeReport().Print(stdout);
+	}
+	if (options.bRasterizeUI)
+	{
+		UIRasterizer::Stats uiStats = cpuDevice.GetLastUIStats();
+		printf("ui: triangles=%u tiles=%u binned=%u setup=%.4f ms raster=%.4f ms (last frame)\n", uiStats.triangleCount, uiStats.tileCount, uiStats.binnedCount,
+			uiStats.setupMs, uiStats.rasterMs);
+	}
+	if (options.bUseStateFilter)
+	{
+		printf("state changes: forwarded=%llu filtered=%llu\n", (unsigned long long)stateFilter.GetForwardedCount(), (unsigned long long)stateFilter.GetFilteredCount());
+	}
+	if ((options.bUseUAVOverlap || options.bAutoUAVOverlap) && !device.IsUAVOverlapSupported())
+	{
+		printf("UAV overlap was requested but the extension is unavailable; dispatches were serialized\n");
+	}
+	else if (options.bUseUAVOverlap || options.bAutoUAVOverlap)
+	{
+		const UAVHazardTracker::PassStats& overlapStats = app.GetLastOverlapStats();
+		printf("last compute pass: dispatches=%u overlap brackets=%u hazards=%u longest run=%u\n", overlapStats.dispatchCount,
+			overlapStats.bracketCount, overlapStats.hazardCount, overlapStats.longestRun);
+	}
+
+	if (options.recordThreadCount > 0 && app.GetRecordThreadCount() == 0)
+	{
+		printf("deferred recording was requested but is unavailable (no deferred contexts, or capturing); dispatches were recorded on the immediate context\n");
+	}
+	else if (options.recordThreadCount > 0)
+	{
+		printf("deferred recording: threads=%u last record=%.4f ms last submit=%.4f ms\n", app.GetRecordThreadCount(),
+			app.GetComputeCounters().recordTimeMs, app.GetComputeCounters().submissionTimeMs);
+	}
+
+	if (!options.outputPath.empty() && !app.WriteFrameToPPM(options.outputPath.c_str()))
+	{
+		fprintf(stderr, "Failed to write %s\n", options.outputPath.c_str());
+		result = 1;
+	}
+
+	app.Cleanup();
+
+	if (!options.capturePath.empty())
+	{
+		if (recorder.WriteToFile(options.capturePath.c_str()))
+		{
+			printf("captured %u frame(s), %zu bytes, to %s\n", recorder.GetRecordedFrameCount(), recorder.GetCommandStream().size(), options.capturePath.c_str());
+		}
+		else
+		{
+			fprintf(stderr, "Failed to write %s\n", options.capturePath.c_str());
+			result = 1;
+		}
+	}
+
+#ifdef UAVOVERLAP_INTC_STUB
+	INTCStub_PrintCallStats(stdout);
+#endif
+
+	return result;
+}
@@ -0,0 +1,175 @@
+/**********************************************************************************
+ **	Name:        HeadlessRun.cpp                                                 **
+ **	Description: Command line options and frame timing summary for headless runs **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                    **
+ **	Published:   <insert date>                                                   **
+ *********************************************************************************/
+
+#include "HeadlessRun.h"
+#include "GraphicsDevice.h"
+#include "SampleUtils.h"
+
+#include <cstdlib>
+
+bool ParseUIntArgument(const std::string& text, uint32_t& value)
+{
+	char* end = nullptr;
+	unsigned long parsed = strtoul(text.c_str(), &end, 10);
+	if (text.empty() || *end != '\0')
+	{
+		return false;
+	}
+	value = (uint32_t)parsed;
+	return true;
+}
+
+bool ParseResolution(const std::string& text, uint32_t& width, uint32_t& height)
+{
+	size_t x = text.find('x');
+	return x != std::string::npos && ParseUIntArgument(text.substr(0, x), width) && ParseUIntArgument(text.substr(x + 1), height) &&
+		width > 0 && height > 0;
+}
+
+bool GetHeadlessResize(const HeadlessOptions& options, uint32_t frame, uint32_t& width, uint32_t& height)
+{
+	if (options.resizeWidths.empty() || options.resizeInterval == 0 || frame == 0 || frame % options.resizeInterval != 0)
+	{
+		return false;
+	}
+	size_t index = (frame / options.resizeInterval - 1) % options.resizeWidths.size();
+	width = options.resizeWidths[index];
+	height = options.resizeHeights[index];
+	return true;
+}
+
+bool ParseHeadlessOptions(const std::vector<std::string>& args, HeadlessOptions& options)
+{
+	options.bHeadless = false;
+	options.frameCount = 100;
+	options.width = 1280;
+	options.height = 720;
+	options.tileSize = 16;
+	options.bUseUAVOverlap = false;
+	options.bAutoUAVOverlap = false;
+	options.bUseBatchedDispatch = false;
+	options.bUseIndirectDispatch = false;
+	options.bUseStateFilter = true;
+	options.threadCount = 0;
+	options.bRasterizeUI = false;
+	options.bUIOwnedPipeline = false;
+	options.recordThreadCount = 0;
+	options.framesInFlight = 1;
+	options.workload = ComputeWorkload();
+	options.outputPath.clear();
+	options.frameStatsPath.clear();
+	options.capturePath.clear();
+	options.captureFrames = 1;
+	options.resizeWidths.clear();
+	options.resizeHeights.clear();
+	options.resizeInterval = 10;
+	options.startupBenchRuns = 0;
+	options.startupTracePath.clear();
+
+	for (size_t i = 0; i < args.size(); i++)
+	{
+		const std::string& arg = args[i];
+		bool hasValue = (i + 1 < args.size());
+
+		if (arg == "--headless")                  options.bHeadless = true;
+		else if (arg == "--overlap")              options.bUseUAVOverlap = true;
+		else if (arg == "--auto-overlap")         options.bAutoUAVOverlap = true;
+		else if (arg == "--batched")              options.bUseBatchedDispatch = true;
+		else if (arg == "--indirect")             options.bUseIndirectDispatch = true;
+		else if (arg == "--no-state-filter")      options.bUseStateFilter = false;
+		else if (arg == "--ui")                   options.bRasterizeUI = true;
+		else if (arg == "--ui-owned-pipeline")    options.bUIOwnedPipeline = true;
+		else if (arg == "--frames" && hasValue)   { if (!ParseUIntArgument(args[++i], options.frameCount)) return false; }
+		else if (arg == "--width" && hasValue)    { if (!ParseUIntArgument(args[++i], options.width)) return false; }
+		else if (arg == "--height" && hasValue)   { if (!ParseUIntArgument(args[++i], options.height)) return false; }
+		else if (arg == "--tile" && hasValue)     { if (!ParseUIntArgument(args[++i], options.tileSize)) return false; }
+		else if (arg == "--threads" && hasValue)  { if (!ParseUIntArgument(args[++i], options.threadCount)) return false; }
+		else if (arg == "--record-threads" && hasValue) { if (!ParseUIntArgument(args[++i], options.recordThreadCount)) return false; }
+		else if (arg == "--frames-in-flight" && hasValue) { if (!ParseUIntArgument(args[++i], options.framesInFlight)) return false; }
+		else if (arg == "--workload" && hasValue) { if (!ParseComputeWorkload(args[++i], options.workload)) return false; }
+		else if (arg == "--output" && hasValue)   options.outputPath = args[++i];
+		else if (arg == "--frame-stats" && hasValue) options.frameStatsPath = args[++i];
+		else if (arg == "--capture" && hasValue)  options.capturePath = args[++i];
+		else if (arg == "--capture-frames" && hasValue) { if (!ParseUIntArgument(args[++i], options.captureFrames)) return false; }
+		else if (arg == "--resize-interval" && hasValue) { if (!ParseUIntArgument(args[++i], options.resizeInterval)) return false; }
+		else if (arg == "--startup-bench" && hasValue) { if (!ParseUIntArgument(args[++i], options.startupBenchRuns)) return false; }
+		else if (arg == "--startup-trace" && hasValue) options.startupTracePath = args[++i];
+		else if (arg == "--resize" && hasValue)
+		{
+			// Comma-separated sizes
+			std::string list = args[++i];
+			size_t start = 0;
+			while (start <= list.size())
+			{
+				size_t comma = list.find(',', start);
+				std::string item = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+				uint32_t width = 0;
+				uint32_t height = 0;
+				if (!ParseResolution(item, width, height))
+				{
+					return false;
+				}
+				options.resizeWidths.push_back(width);
+				options.resizeHeights.push_back(height);
+				start = (comma == std::string::npos) ? list.size() + 1 : comma + 1;
+			}
+		}
+		else return false;
+	}
+
+	return options.width > 0 && options.height > 0 && options.framesInFlight >= 1 && options.framesInFlight <= GFX_MAX_FRAMES_IN_FLIGHT;
+}
+
+void HeadlessFrameStats::AddFrame(double frameTimeMs)
+{
+	if (mFrameCount == 0 || frameTimeMs < mMinMs)
+	{
+		mMinMs = frameTimeMs;
+	}
+	if (mFrameCount == 0 || frameTimeMs > mMaxMs)
+	{
+		mMaxMs = frameTimeMs;
+	}
+	mTotalMs += frameTimeMs;
+	mFrameCount++;
+}
+
+void HeadlessFrameStats::Print(FILE* file, const HeadlessOptions& options, const char* backendName) const
+{
+	fprintf(file, "backend=%s resolution=%ux%u tile=%u overlap=%s batched=%d indirect=%d frames_in_flight=%u workload=%s\n", backendName, options.width,
+		options.height, options.tileSize, options.bAutoUAVOverlap ? "auto" : (options.bUseUAVOverlap ? "1" : "0"), options.bUseBatchedDispatch ? 1 : 0,
+		options.bUseIndirectDispatch ? 1 : 0, options.framesInFlight, FormatComputeWorkload(options.workload).c_str());
+	fprintf(file, "frames=%u total=%.3f ms mean=%.4f ms min=%.4f ms max=%.4f ms fps=%.2f\n", mFrameCount, mTotalMs,
+		GetMeanMs(), mMinMs, mMaxMs, GetMeanMs() > 0.0 ? 1000.0 / GetMeanMs() : 0.0);
+}
+
+bool WriteRGBA8ToPPM(const char* path, const uint32_t* texels, uint32_t width, uint32_t height, uint32_t rowPitchInTexels)
+{
+	FILE* file = OpenFile(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	fprintf(file, "P6\n%u %u\n255\n", width, height);
+
+	std::vector<unsigned char> row((size_t)width * 3);
+	for (uint32_t y = 0; y < height; y++)
+	{
+		const uint32_t* src = texels + (size_t)y * rowPitchInTexels;
+		for (uint32_t x = 0; x < width; x++)
+		{
+			row[x * 3 + 0] = (unsigned char)(src[x] & 0xFF);
+			row[x * 3 + 1] = (unsigned char)((src[x] >> 8) & 0xFF);
+			row[x * 3 + 2] = (unsigned char)((src[x] >> 16) & 0xFF);
+		}
+		fwrite(row.data(), 1, row.size(), file);
+	}
+
+	fclose(file);
+	return true;
+}
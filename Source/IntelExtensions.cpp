@@ -0,0 +1,88 @@
+/*****************************************************************************
+ **	Name:        IntelExtensions.cpp                                        **
+ **	Description: Intel Extensions Framework loading and version negotiation **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com               **
+ **	Published:   <insert date>                                              **
+ ****************************************************************************/
+
+#include "IntelExtensions.h"
+
+#include <cstring>
+
+// Accepted when every field is at or above the required one
+static bool IsVersionAtLeast(const INTCExtensionVersion& version, const INTCExtensionVersion& required)
+{
+	return (version.HWFeatureLevel >= required.HWFeatureLevel) &&
+		(version.APIVersion >= required.APIVersion) &&
+		(version.Revision >= required.Revision);
+}
+
+bool CreateIntelExtensionContext(ID3D11Device* device, INTCExtensionContext** context)
+{
+	*context = nullptr;
+
+	if (FAILED(INTC_LoadExtensionsLibrary()))
+	{
+		return false;
+	}
+
+	INTCExtensionVersion requiredVersion = INTC_UAV_OVERLAP_REQUIRED_VERSION;
+
+	INTCExtensionVersion* pSupportedExtVersions = nullptr;
+	uint32_t supportedExtVersionCount = 0;
+
+	// First, query the number of supported versions
+	if (FAILED(INTC_D3D11_GetSupportedVersions(device, pSupportedExtVersions, &supportedExtVersionCount)) || supportedExtVersionCount == 0)
+	{
+		INTC_UnloadExtensionsLibrary();
+		return false;
+	}
+
+	INTCExtensionInfo intcExtensionInfo = {};
+
+	//Next, use returned value for supportedExtVersionCount to allocate space for the supported extensions
+	pSupportedExtVersions = new INTCExtensionVersion[supportedExtVersionCount];
+	memset(pSupportedExtVersions, 0, sizeof(INTCExtensionVersion) * supportedExtVersionCount);
+
+	//Next populate the list of supported version and iterate until you find the needed version
+	bool versionFound = false;
+	if (SUCCEEDED(INTC_D3D11_GetSupportedVersions(device, pSupportedExtVersions, &supportedExtVersionCount)))
+	{
+		for (uint32_t i = 0; i < supportedExtVersionCount; i++)
+		{
+			if (IsVersionAtLeast(pSupportedExtVersions[i], requiredVersion))
+			{
+				intcExtensionInfo.RequestedExtensionVersion = pSupportedExtVersions[i];
+				versionFound = true;
+				break;
+			}
+		}
+	}
+
+	delete[] pSupportedExtVersions;
+
+	if (versionFound && SUCCEEDED(INTC_D3D11_CreateDeviceExtensionContext(device, context, &intcExtensionInfo, nullptr)))
+	{
+		return true;
+	}
+
+	*context = nullptr;
+	INTC_UnloadExtensionsLibrary();
+	return false;
+}
+
+bool DestroyIntelExtensionContext(INTCExtensionContext** context)
+{
+	if (*context == nullptr)
+	{
+		return true;
+	}
+
+	// Release the resources used by the framework
+	bool destroyed = SUCCEEDED(INTC_DestroyDeviceExtensionContext(context));
+	*context = nullptr;
+
+	// Unload the extensions library
+	INTC_UnloadExtensionsLibrary();
+	return destroyed;
+}
@@ -0,0 +1,411 @@
+/***************************************************************************************
+ **	Name:        IntelExtensionsStub.cpp                                              **
+ **	Description: Stand-in implementation of the igdext entrypoints used by the sample **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                         **
+ **	Published:   <insert date>                                                        **
+ **************************************************************************************/
+
+#include "IntelExtensionsStub.h"
+
+#include <chrono>
+#include <cstdlib>
+
+// The framework only hands out pointers to this, so the stub is free to define it
+struct INTCExtensionContext
+{
+	ID3D11Device* device;
+	INTCExtensionVersion version;
+	uint32_t overlapDepth;
+	INTCStubOverlapHandler overlapHandler;
+	void* overlapUserData;
+};
+
+struct StubFailure
+{
+	bool bEnabled;
+	HRESULT result;
+	uint32_t skipCalls;
+};
+
+static const char* gEntrypointNames[INTC_STUB_ENTRYPOINT_COUNT] =
+{
+	"INTC_LoadExtensionsLibrary",
+	"INTC_UnloadExtensionsLibrary",
+	"INTC_D3D11_GetSupportedVersions",
+	"INTC_D3D11_CreateDeviceExtensionContext",
+	"INTC_DestroyDeviceExtensionContext",
+	"INTC_D3D11_BeginUAVOverlap",
+	"INTC_D3D11_EndUAVOverlap"
+};
+
+static const char* gEntrypointShortNames[INTC_STUB_ENTRYPOINT_COUNT] = { "load", "unload", "versions", "create", "destroy", "begin", "end" };
+
+static std::vector<INTCExtensionVersion> gSupportedVersions(1, INTCExtensionVersion(INTC_UAV_OVERLAP_REQUIRED_VERSION));
+static StubFailure gFailures[INTC_STUB_ENTRYPOINT_COUNT] = {};
+static INTCStubCallStats gCallStats[INTC_STUB_ENTRYPOINT_COUNT] = {};
+static uint32_t gLoadCount = 0;
+
+// Counts and times one call into the stub, and decides whether it should fail
+class StubCall
+{
+public:
+	explicit StubCall(INTCStubEntrypoint entrypoint) : mEntrypoint(entrypoint), mStart(std::chrono::steady_clock::now()), bFinished(false)
+	{
+		gCallStats[entrypoint].callCount++;
+	}
+
+	~StubCall()
+	{
+		Finish();
+	}
+
+	// Stops the clock; called before handing control to the overlap handler so only the stub's own cost is counted
+	void Finish()
+	{
+		if (!bFinished)
+		{
+			gCallStats[mEntrypoint].totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStart).count();
+			bFinished = true;
+		}
+	}
+
+	// The injected result for this call, or S_OK if it should go ahead
+	HRESULT Inject()
+	{
+		StubFailure& failure = gFailures[mEntrypoint];
+		if (!failure.bEnabled)
+		{
+			return S_OK;
+		}
+		if (failure.skipCalls > 0)
+		{
+			failure.skipCalls--;
+			return S_OK;
+		}
+		return Fail(failure.result);
+	}
+
+	HRESULT Fail(HRESULT result)
+	{
+		gCallStats[mEntrypoint].failureCount++;
+		return result;
+	}
+
+private:
+	INTCStubEntrypoint mEntrypoint;
+	std::chrono::steady_clock::time_point mStart;
+	bool bFinished;
+};
+
+static bool IsSupportedVersion(const INTCExtensionVersion& version)
+{
+	for (const INTCExtensionVersion& supported : gSupportedVersions)
+	{
+		if (supported.HWFeatureLevel == version.HWFeatureLevel && supported.APIVersion == version.APIVersion && supported.Revision == version.Revision)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+HRESULT INTC_LoadExtensionsLibrary(bool /*useCurrentProcessDir*/)
+{
+	StubCall call(INTC_STUB_LOAD_LIBRARY);
+
+	HRESULT result = call.Inject();
+	if (SUCCEEDED(result))
+	{
+		gLoadCount++;
+	}
+	return result;
+}
+
+void INTC_UnloadExtensionsLibrary()
+{
+	StubCall call(INTC_STUB_UNLOAD_LIBRARY);
+
+	if (FAILED(call.Inject()))
+	{
+		return;
+	}
+	if (gLoadCount == 0)
+	{
+		call.Fail(E_FAIL);
+		return;
+	}
+	gLoadCount--;
+}
+
+HRESULT INTC_D3D11_GetSupportedVersions(ID3D11Device* /*pDevice*/, INTCExtensionVersion* pSupportedExtVersions, uint32_t* pSupportedExtVersionsCount)
+{
+	StubCall call(INTC_STUB_GET_SUPPORTED_VERSIONS);
+
+	HRESULT result = call.Inject();
+	if (FAILED(result))
+	{
+		return result;
+	}
+	if (gLoadCount == 0 || pSupportedExtVersionsCount == nullptr)
+	{
+		return call.Fail(gLoadCount == 0 ? E_FAIL : E_INVALIDARG);
+	}
+
+	// First call returns the count, second call fills in the caller's table
+	if (pSupportedExtVersions == nullptr)
+	{
+		*pSupportedExtVersionsCount = (uint32_t)gSupportedVersions.size();
+		return S_OK;
+	}
+
+	uint32_t count = *pSupportedExtVersionsCount < gSupportedVersions.size() ? *pSupportedExtVersionsCount : (uint32_t)gSupportedVersions.size();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		pSupportedExtVersions[i] = gSupportedVersions[i];
+	}
+	*pSupportedExtVersionsCount = count;
+	return S_OK;
+}
+
+HRESULT INTC_D3D11_CreateDeviceExtensionContext(ID3D11Device* pDevice, INTCExtensionContext** ppExtensionContext, INTCExtensionInfo* pExtensionInfo, INTCExtensionAppInfo* /*pExtensionAppInfo*/)
+{
+	StubCall call(INTC_STUB_CREATE_CONTEXT);
+
+	HRESULT result = call.Inject();
+	if (FAILED(result))
+	{
+		return result;
+	}
+	if (gLoadCount == 0)
+	{
+		return call.Fail(E_FAIL);
+	}
+
+	// There may be no D3D11 device behind the stub (the CPU backend has none), so only the version is validated
+	if (ppExtensionContext == nullptr || pExtensionInfo == nullptr || !IsSupportedVersion(pExtensionInfo->RequestedExtensionVersion))
+	{
+		return call.Fail(E_INVALIDARG);
+	}
+
+	INTCExtensionContext* context = new INTCExtensionContext();
+	context->device = pDevice;
+	context->version = pExtensionInfo->RequestedExtensionVersion;
+	context->overlapDepth = 0;
+	context->overlapHandler = nullptr;
+	context->overlapUserData = nullptr;
+
+	pExtensionInfo->IntelDeviceInfo = INTCDeviceInfo();
+	const wchar_t generationName[] = L"igdext stub";
+	for (size_t i = 0; i < sizeof(generationName) / sizeof(wchar_t); i++)
+	{
+		pExtensionInfo->IntelDeviceInfo.GTGenerationName[i] = generationName[i];
+	}
+	pExtensionInfo->pDeviceDriverDesc = L"Intel Extensions Framework stub";
+	pExtensionInfo->pDeviceDriverVersion = L"0.0.0.0";
+	pExtensionInfo->DeviceDriverBuildNumber = 0;
+
+	*ppExtensionContext = context;
+	return S_OK;
+}
+
+HRESULT INTC_DestroyDeviceExtensionContext(INTCExtensionContext** ppExtensionContext)
+{
+	StubCall call(INTC_STUB_DESTROY_CONTEXT);
+
+	HRESULT result = call.Inject();
+	if (FAILED(result))
+	{
+		return result;
+	}
+	if (ppExtensionContext == nullptr || *ppExtensionContext == nullptr)
+	{
+		return call.Fail(E_INVALIDARG);
+	}
+
+	delete *ppExtensionContext;
+	*ppExtensionContext = nullptr;
+	return S_OK;
+}
+
+HRESULT INTC_D3D11_BeginUAVOverlap(INTCExtensionContext* pExtensionContext)
+{
+	StubCall call(INTC_STUB_BEGIN_UAV_OVERLAP);
+
+	if (pExtensionContext == nullptr)
+	{
+		return call.Fail(E_INVALIDARG);
+	}
+
+	HRESULT result = call.Inject();
+	if (FAILED(result))
+	{
+		return result;
+	}
+
+	// Brackets do not nest
+	if (pExtensionContext->overlapDepth != 0)
+	{
+		return call.Fail(E_FAIL);
+	}
+
+	pExtensionContext->overlapDepth = 1;
+	call.Finish();
+	if (pExtensionContext->overlapHandler != nullptr)
+	{
+		pExtensionContext->overlapHandler(pExtensionContext->overlapUserData, true);
+	}
+	return S_OK;
+}
+
+HRESULT INTC_D3D11_EndUAVOverlap(INTCExtensionContext* pExtensionContext)
+{
+	StubCall call(INTC_STUB_END_UAV_OVERLAP);
+
+	if (pExtensionContext == nullptr)
+	{
+		return call.Fail(E_INVALIDARG);
+	}
+
+	HRESULT result = call.Inject();
+	if (FAILED(result))
+	{
+		return result;
+	}
+
+	if (pExtensionContext->overlapDepth == 0)
+	{
+		return call.Fail(E_FAIL);
+	}
+
+	pExtensionContext->overlapDepth = 0;
+	call.Finish();
+	if (pExtensionContext->overlapHandler != nullptr)
+	{
+		pExtensionContext->overlapHandler(pExtensionContext->overlapUserData, false);
+	}
+	return S_OK;
+}
+
+void INTCStub_Reset()
+{
+	gSupportedVersions.assign(1, INTCExtensionVersion(INTC_UAV_OVERLAP_REQUIRED_VERSION));
+	INTCStub_ClearFailures();
+	INTCStub_ResetCallStats();
+}
+
+void INTCStub_SetSupportedVersions(const std::vector<INTCExtensionVersion>& versions)
+{
+	gSupportedVersions = versions;
+}
+
+void INTCStub_SetFailure(INTCStubEntrypoint entrypoint, HRESULT result, uint32_t skipCalls)
+{
+	gFailures[entrypoint].bEnabled = true;
+	gFailures[entrypoint].result = result;
+	gFailures[entrypoint].skipCalls = skipCalls;
+}
+
+void INTCStub_ClearFailures()
+{
+	for (uint32_t i = 0; i < INTC_STUB_ENTRYPOINT_COUNT; i++)
+	{
+		gFailures[i] = StubFailure();
+	}
+}
+
+void INTCStub_SetOverlapHandler(INTCExtensionContext* context, INTCStubOverlapHandler handler, void* userData)
+{
+	context->overlapHandler = handler;
+	context->overlapUserData = userData;
+}
+
+uint32_t INTCStub_GetOverlapDepth(const INTCExtensionContext* context)
+{
+	return context->overlapDepth;
+}
+
+INTCStubCallStats INTCStub_GetCallStats(INTCStubEntrypoint entrypoint)
+{
+	return gCallStats[entrypoint];
+}
+
+void INTCStub_ResetCallStats()
+{
+	for (uint32_t i = 0; i < INTC_STUB_ENTRYPOINT_COUNT; i++)
+	{
+		gCallStats[i] = INTCStubCallStats();
+	}
+}
+
+const char* INTCStub_GetEntrypointName(INTCStubEntrypoint entrypoint)
+{
+	return gEntrypointNames[entrypoint];
+}
+
+bool INTCStub_ParseEntrypoint(const std::string& name, INTCStubEntrypoint& entrypoint)
+{
+	for (uint32_t i = 0; i < INTC_STUB_ENTRYPOINT_COUNT; i++)
+	{
+		if (name == gEntrypointShortNames[i] || name == gEntrypointNames[i])
+		{
+			entrypoint = (INTCStubEntrypoint)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool INTCStub_ParseVersionList(const std::string& text, std::vector<INTCExtensionVersion>& versions)
+{
+	versions.clear();
+
+	size_t start = 0;
+	while (start <= text.size())
+	{
+		size_t end = text.find(',', start);
+		if (end == std::string::npos)
+		{
+			end = text.size();
+		}
+
+		// Each item is exactly three dot-separated decimal numbers
+		std::string item = text.substr(start, end - start);
+		uint32_t fields[3] = {};
+		const char* cursor = item.c_str();
+		for (uint32_t field = 0; field < 3; field++)
+		{
+			char* fieldEnd = nullptr;
+			if (*cursor < '0' || *cursor > '9')
+			{
+				return false;
+			}
+			fields[field] = (uint32_t)strtoul(cursor, &fieldEnd, 10);
+			if (*fieldEnd != (field < 2 ? '.' : '\0'))
+			{
+				return false;
+			}
+			cursor = fieldEnd + (field < 2 ? 1 : 0);
+		}
+
+		INTCExtensionVersion version = { fields[0], fields[1], fields[2] };
+		versions.push_back(version);
+		start = end + 1;
+	}
+
+	return !versions.empty();
+}
+
+void INTCStub_PrintCallStats(FILE* file)
+{
+	for (uint32_t i = 0; i < INTC_STUB_ENTRYPOINT_COUNT; i++)
+	{
+		const INTCStubCallStats& stats = gCallStats[i];
+		if (stats.callCount == 0)
+		{
+			continue;
+		}
+
+		fprintf(file, "%-40s calls %8llu  failures %6llu  total %9.3f ms  mean %8.1f ns\n", gEntrypointNames[i],
+			(unsigned long long)stats.callCount, (unsigned long long)stats.failureCount, stats.totalMs, stats.totalMs * 1.0e6 / stats.callCount);
+	}
+}
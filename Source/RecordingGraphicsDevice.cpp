@@ -0,0 +1,372 @@
+/***************************************************************************************************
+ **	Name:        RecordingGraphicsDevice.cpp                                                      **
+ **	Description: GraphicsDevice decorator that captures every forwarded call into a CommandStream **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                     **
+ **	Published:   <insert date>                                                                    **
+ **************************************************************************************************/
+
+#include "RecordingGraphicsDevice.h"
+
+RecordingGraphicsDevice::RecordingGraphicsDevice(GraphicsDevice* inner, uint32_t maxFrames) : GraphicsDeviceDecorator(inner), mMaxFrames(maxFrames), mRecordedFrames(0)
+{
+}
+
+bool RecordingGraphicsDevice::Record(CommandOpcode opcode)
+{
+	if (!IsRecording())
+	{
+		return false;
+	}
+	mWriter.WriteOpcode(opcode);
+	return true;
+}
+
+void RecordingGraphicsDevice::Record(CommandOpcode opcode, uint32_t a)
+{
+	if (Record(opcode))
+	{
+		mWriter.WriteUInt(a);
+	}
+}
+
+void RecordingGraphicsDevice::Record(CommandOpcode opcode, uint32_t a, uint32_t b)
+{
+	if (Record(opcode))
+	{
+		mWriter.WriteUInt(a);
+		mWriter.WriteUInt(b);
+	}
+}
+
+bool RecordingGraphicsDevice::Init(uint32_t width, uint32_t height)
+{
+	Record(CMD_INIT, width, height);
+	return mInner->Init(width, height);
+}
+
+void RecordingGraphicsDevice::Cleanup()
+{
+	Record(CMD_CLEANUP);
+	mInner->Cleanup();
+}
+
+GfxTexture RecordingGraphicsDevice::CreateTexture2D(uint32_t width, uint32_t height, uint32_t bindFlags)
+{
+	GfxTexture texture = mInner->CreateTexture2D(width, height, bindFlags);
+	if (Record(CMD_CREATE_TEXTURE2D))
+	{
+		mWriter.WriteUInt(width);
+		mWriter.WriteUInt(height);
+		mWriter.WriteUInt(bindFlags);
+		mWriter.WriteUInt(texture);
+	}
+	return texture;
+}
+
+GfxView RecordingGraphicsDevice::CreateShaderResourceView(GfxTexture texture)
+{
+	GfxView view = mInner->CreateShaderResourceView(texture);
+	Record(CMD_CREATE_SRV, texture, view);
+	return view;
+}
+
+GfxView RecordingGraphicsDevice::CreateUnorderedAccessView(GfxTexture texture)
+{
+	GfxView view = mInner->CreateUnorderedAccessView(texture);
+	Record(CMD_CREATE_UAV, texture, view);
+	return view;
+}
+
+GfxView RecordingGraphicsDevice::CreateRenderTargetView(GfxTexture texture)
+{
+	GfxView view = mInner->CreateRenderTargetView(texture);
+	Record(CMD_CREATE_RTV, texture, view);
+	return view;
+}
+
+GfxBuffer RecordingGraphicsDevice::CreateConstantBuffer(const void* data, uint32_t byteWidth)
+{
+	GfxBuffer buffer = mInner->CreateConstantBuffer(data, byteWidth);
+	if (Record(CMD_CREATE_CONSTANT_BUFFER))
+	{
+		mWriter.WriteBytes(data, byteWidth);
+		mWriter.WriteUInt(buffer);
+	}
+	return buffer;
+}
+
+GfxBuffer RecordingGraphicsDevice::CreateVertexBuffer(const void* data, uint32_t byteWidth)
+{
+	GfxBuffer buffer = mInner->CreateVertexBuffer(data, byteWidth);
+	if (Record(CMD_CREATE_VERTEX_BUFFER))
+	{
+		mWriter.WriteBytes(data, byteWidth);
+		mWriter.WriteUInt(buffer);
+	}
+	return buffer;
+}
+
+GfxBuffer RecordingGraphicsDevice::CreateStructuredBuffer(const void* data, uint32_t stride, uint32_t count)
+{
+	GfxBuffer buffer = mInner->CreateStructuredBuffer(data, stride, count);
+	if (Record(CMD_CREATE_STRUCTURED_BUFFER))
+	{
+		mWriter.WriteBytes(data, data != nullptr ? stride * count : 0);
+		mWriter.WriteUInt(stride);
+		mWriter.WriteUInt(buffer);
+	}
+	return buffer;
+}
+
+GfxBuffer RecordingGraphicsDevice::CreateIndirectArgumentBuffer(const void* data, uint32_t byteWidth)
+{
+	GfxBuffer buffer = mInner->CreateIndirectArgumentBuffer(data, byteWidth);
+	if (Record(CMD_CREATE_INDIRECT_ARGS))
+	{
+		// Without initial data the buffer starts zeroed, which replays the same way
+		std::vector<uint8_t> zeroes;
+		if (data == nullptr)
+		{
+			zeroes.assign(byteWidth, 0);
+			data = zeroes.data();
+		}
+		mWriter.WriteBytes(data, byteWidth);
+		mWriter.WriteUInt(buffer);
+	}
+	return buffer;
+}
+
+GfxShader RecordingGraphicsDevice::CreateComputeShader(const char* name)
+{
+	GfxShader shader = mInner->CreateComputeShader(name);
+	if (Record(CMD_CREATE_COMPUTE_SHADER))
+	{
+		mWriter.WriteString(name);
+		mWriter.WriteUInt(shader);
+	}
+	return shader;
+}
+
+GfxShader RecordingGraphicsDevice::CreateVertexShader(const char* name)
+{
+	GfxShader shader = mInner->CreateVertexShader(name);
+	if (Record(CMD_CREATE_VERTEX_SHADER))
+	{
+		mWriter.WriteString(name);
+		mWriter.WriteUInt(shader);
+	}
+	return shader;
+}
+
+GfxShader RecordingGraphicsDevice::CreatePixelShader(const char* name)
+{
+	GfxShader shader = mInner->CreatePixelShader(name);
+	if (Record(CMD_CREATE_PIXEL_SHADER))
+	{
+		mWriter.WriteString(name);
+		mWriter.WriteUInt(shader);
+	}
+	return shader;
+}
+
+GfxInputLayout RecordingGraphicsDevice::CreateInputLayout(GfxShader vertexShader)
+{
+	GfxInputLayout layout = mInner->CreateInputLayout(vertexShader);
+	Record(CMD_CREATE_INPUT_LAYOUT, vertexShader, layout);
+	return layout;
+}
+
+void RecordingGraphicsDevice::Release(GfxHandle handle)
+{
+	Record(CMD_RELEASE, handle);
+	mInner->Release(handle);
+}
+
+GfxView RecordingGraphicsDevice::GetBackBufferRTV()
+{
+	GfxView view = mInner->GetBackBufferRTV();
+	Record(CMD_GET_BACK_BUFFER_RTV, view);
+	return view;
+}
+
+bool RecordingGraphicsDevice::ResizeBuffers(uint32_t width, uint32_t height)
+{
+	Record(CMD_RESIZE_BUFFERS, width, height);
+	return mInner->ResizeBuffers(width, height);
+}
+
+void RecordingGraphicsDevice::CSSetShader(GfxShader shader)
+{
+	Record(CMD_CS_SET_SHADER, shader);
+	mInner->CSSetShader(shader);
+}
+
+void RecordingGraphicsDevice::CSSetUnorderedAccessView(uint32_t slot, GfxView view)
+{
+	Record(CMD_CS_SET_UAV, slot, view);
+	mInner->CSSetUnorderedAccessView(slot, view);
+}
+
+void RecordingGraphicsDevice::CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer)
+{
+	Record(CMD_CS_SET_CONSTANT_BUFFER, slot, buffer);
+	mInner->CSSetConstantBuffer(slot, buffer);
+}
+
+void RecordingGraphicsDevice::CSSetShaderResource(uint32_t slot, GfxView view)
+{
+	Record(CMD_CS_SET_SHADER_RESOURCE, slot, view);
+	mInner->CSSetShaderResource(slot, view);
+}
+
+void RecordingGraphicsDevice::Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+{
+	if (Record(CMD_DISPATCH))
+	{
+		mWriter.WriteUInt(groupsX);
+		mWriter.WriteUInt(groupsY);
+		mWriter.WriteUInt(groupsZ);
+	}
+	mInner->Dispatch(groupsX, groupsY, groupsZ);
+}
+
+void RecordingGraphicsDevice::DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset)
+{
+	Record(CMD_DISPATCH_INDIRECT, arguments, byteOffset);
+	mInner->DispatchIndirect(arguments, byteOffset);
+}
+
+void RecordingGraphicsDevice::BeginUAVOverlap()
+{
+	Record(CMD_BEGIN_UAV_OVERLAP);
+	mInner->BeginUAVOverlap();
+}
+
+void RecordingGraphicsDevice::EndUAVOverlap()
+{
+	Record(CMD_END_UAV_OVERLAP);
+	mInner->EndUAVOverlap();
+}
+
+void RecordingGraphicsDevice::ClearRenderTargetView(GfxView view, const float color[4])
+{
+	if (Record(CMD_CLEAR_RTV))
+	{
+		mWriter.WriteUInt(view);
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			mWriter.WriteFloat(color[i]);
+		}
+	}
+	mInner->ClearRenderTargetView(view, color);
+}
+
+void RecordingGraphicsDevice::OMSetRenderTarget(GfxView view)
+{
+	Record(CMD_OM_SET_RENDER_TARGET, view);
+	mInner->OMSetRenderTarget(view);
+}
+
+void RecordingGraphicsDevice::RSSetViewport(float width, float height)
+{
+	if (Record(CMD_RS_SET_VIEWPORT))
+	{
+		mWriter.WriteFloat(width);
+		mWriter.WriteFloat(height);
+	}
+	mInner->RSSetViewport(width, height);
+}
+
+void RecordingGraphicsDevice::IASetInputLayout(GfxInputLayout layout)
+{
+	Record(CMD_IA_SET_INPUT_LAYOUT, layout);
+	mInner->IASetInputLayout(layout);
+}
+
+void RecordingGraphicsDevice::IASetVertexBuffer(uint32_t slot, GfxBuffer buffer, uint32_t stride, uint32_t offset)
+{
+	if (Record(CMD_IA_SET_VERTEX_BUFFER))
+	{
+		mWriter.WriteUInt(slot);
+		mWriter.WriteUInt(buffer);
+		mWriter.WriteUInt(stride);
+		mWriter.WriteUInt(offset);
+	}
+	mInner->IASetVertexBuffer(slot, buffer, stride, offset);
+}
+
+void RecordingGraphicsDevice::VSSetShader(GfxShader shader)
+{
+	Record(CMD_VS_SET_SHADER, shader);
+	mInner->VSSetShader(shader);
+}
+
+void RecordingGraphicsDevice::PSSetShader(GfxShader shader)
+{
+	Record(CMD_PS_SET_SHADER, shader);
+	mInner->PSSetShader(shader);
+}
+
+void RecordingGraphicsDevice::PSSetShaderResource(uint32_t slot, GfxView view)
+{
+	Record(CMD_PS_SET_SHADER_RESOURCE, slot, view);
+	mInner->PSSetShaderResource(slot, view);
+}
+
+void RecordingGraphicsDevice::Draw(uint32_t vertexCount, uint32_t startVertex)
+{
+	Record(CMD_DRAW, vertexCount, startVertex);
+	mInner->Draw(vertexCount, startVertex);
+}
+
+GfxQuery RecordingGraphicsDevice::CreateQuery(GfxQueryType type)
+{
+	GfxQuery query = mInner->CreateQuery(type);
+	Record(CMD_CREATE_QUERY, (uint32_t)type, query);
+	return query;
+}
+
+void RecordingGraphicsDevice::Begin(GfxQuery query)
+{
+	Record(CMD_BEGIN_QUERY, query);
+	mInner->Begin(query);
+}
+
+void RecordingGraphicsDevice::End(GfxQuery query)
+{
+	Record(CMD_END_QUERY, query);
+	mInner->End(query);
+}
+
+void RecordingGraphicsDevice::InitUI()
+{
+	Record(CMD_INIT_UI);
+	mInner->InitUI();
+}
+
+void RecordingGraphicsDevice::ShutdownUI()
+{
+	Record(CMD_SHUTDOWN_UI);
+	mInner->ShutdownUI();
+}
+
+void RecordingGraphicsDevice::NewUIFrame()
+{
+	Record(CMD_NEW_UI_FRAME);
+	mInner->NewUIFrame();
+}
+
+void RecordingGraphicsDevice::RenderUI(ImDrawData* drawData)
+{
+	Record(CMD_RENDER_UI);
+	mInner->RenderUI(drawData);
+}
+
+void RecordingGraphicsDevice::Present()
+{
+	if (Record(CMD_PRESENT))
+	{
+		mRecordedFrames++;
+	}
+	mInner->Present();
+}
@@ -0,0 +1,76 @@
+/*****************************************************************************************************
+ **	Name:        ReplayMain.cpp                                                                     **
+ **	Description: UAV Overlap Sample - replays a captured command stream on the CPU reference device **
+ **              and prints per-call timing, redundant state changes and UAV hazard edges           **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                       **
+ **	Published:   <insert date>                                                                      **
+ ****************************************************************************************************/
+
+#include "CommandReplay.h"
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+
+#include <algorithm>
+#include <cstring>
+
+static void PrintUsage()
+{
+	fprintf(stderr, "usage: UAVOverlapReplay capture.uavc [--repeat N] [--threads N]\n");
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const char* path = argv[1];
+	uint32_t repeat = 1;
+	uint32_t threadCount = 0;
+	for (int i = 2; i < argc; i++)
+	{
+		bool hasValue = (i + 1 < argc);
+		if (strcmp(argv[i], "--repeat") == 0 && hasValue && ParseUIntArgument(argv[i + 1], repeat) && repeat > 0)
+		{
+			i++;
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && hasValue && ParseUIntArgument(argv[i + 1], threadCount))
+		{
+			i++;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	std::vector<uint8_t> stream;
+	if (!ReadCommandStreamFile(path, stream))
+	{
+		fprintf(stderr, "%s is missing or is not a version %u command stream\n", path, COMMAND_STREAM_VERSION);
+		return 1;
+	}
+
+	// Each repetition replays the whole capture on a fresh device; the report of the last one is printed
+	ReplayReport report;
+	double minMs = 0.0;
+	double totalMs = 0.0;
+	for (uint32_t i = 0; i < repeat; i++)
+	{
+		CPUGraphicsDevice device(threadCount);
+		if (!ReplayCommandStream(stream, &device, report))
+		{
+			fprintf(stderr, "Replay of %s failed after %u commands\n", path, report.commandCount);
+			return 1;
+		}
+		minMs = (i == 0) ? report.totalMs : std::min(minMs, report.totalMs);
+		totalMs += report.totalMs;
+	}
+
+	printf("%s: %zu bytes, replayed %u time(s) on cpu, min %.3f ms mean %.3f ms\n", path, stream.size(), repeat, minMs, totalMs / repeat);
+	PrintReplayReport(stdout, report);
+	return 0;
+}
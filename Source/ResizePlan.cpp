@@ -0,0 +1,61 @@
+/***********************************************************************************
+ **	Name:        ResizePlan.cpp                                                   **
+ **	Description: Resize planning for the sample's render-size dependent resources **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                     **
+ **	Published:   <insert date>                                                    **
+ **********************************************************************************/
+
+#include "ResizePlan.h"
+
+ResizePlan PlanResize(uint32_t width, uint32_t height, uint32_t allocatedWidth, uint32_t allocatedHeight, uint32_t newWidth, uint32_t newHeight)
+{
+	ResizePlan plan = {};
+	plan.width = newWidth;
+	plan.height = newHeight;
+	plan.allocatedWidth = allocatedWidth;
+	plan.allocatedHeight = allocatedHeight;
+	if (newWidth == width && newHeight == height)
+	{
+		return plan;
+	}
+
+	uint32_t grownWidth = newWidth > allocatedWidth ? newWidth : allocatedWidth;
+	uint32_t grownHeight = newHeight > allocatedHeight ? newHeight : allocatedHeight;
+	if ((uint64_t)newWidth * newHeight * 4 < (uint64_t)grownWidth * grownHeight)
+	{
+		grownWidth = newWidth;
+		grownHeight = newHeight;
+	}
+
+	plan.allocatedWidth = grownWidth;
+	plan.allocatedHeight = grownHeight;
+	plan.bResizeBuffers = true;
+	plan.bReallocateTextures = (grownWidth != allocatedWidth || grownHeight != allocatedHeight);
+
+	// The triangle samples [0, width / allocatedWidth] x [0, height / allocatedHeight] of the texture
+	plan.bUpdateTexCoords = (uint64_t)newWidth * allocatedWidth != (uint64_t)width * grownWidth ||
+		(uint64_t)newHeight * allocatedHeight != (uint64_t)height * grownHeight;
+
+	// Every tile's constant buffer carries the render size, and the source's size sets the workload's read pattern
+	plan.bRebuildTiles = true;
+	plan.bRebuildSource = true;
+	return plan;
+}
+
+void ResizeReport::Record(const ResizePlan& plan, double latencyMs)
+{
+	if (mCount == 0 || latencyMs > mMaxMs)
+	{
+		mMaxMs = latencyMs;
+	}
+	mCount++;
+	mReallocationCount += plan.bReallocateTextures ? 1 : 0;
+	mTotalMs += latencyMs;
+	mLastMs = latencyMs;
+}
+
+void ResizeReport::Print(FILE* file) const
+{
+	fprintf(file, "resizes=%u reallocated=%u reused=%u latency mean=%.4f ms max=%.4f ms last=%.4f ms\n", mCount, mReallocationCount,
+		mCount - mReallocationCount, GetMeanMs(), mMaxMs, mLastMs);
+}
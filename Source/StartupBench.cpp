@@ -0,0 +1,167 @@
+/****************************************************************************************
+ **	Name:        StartupBench.cpp                                                      **
+ **	Description: Repeated startup runs for --startup-bench and their per-phase summary **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                          **
+ **	Published:   <insert date>                                                         **
+ ***************************************************************************************/
+
+#include "StartupBench.h"
+#include "UAVOverlapSampleApp.h"
+
+#include <algorithm>
+
+bool RunStartupBench(const HeadlessOptions& options, const GraphicsDeviceFactory& createDevice, FILE* log, std::vector<StartupTimer>& runs)
+{
+	runs.clear();
+
+	bool ok = true;
+	std::string deviceName = "unknown";
+	for (uint32_t r = 0; r < options.startupBenchRuns; r++)
+	{
+		StartupTimer timer;
+
+		timer.BeginPhase("device constructor");
+		std::unique_ptr<GraphicsDevice> device = createDevice();
+		timer.EndPhase();
+		deviceName = device->GetName();
+
+		bool initialized = false;
+		{
+			UAVOverlapSampleApp app(device.get(), options.width, options.height);
+			app.ApplyOptions(options);
+
+			timer.BeginPhase("Init()");
+			initialized = app.Init();
+			timer.Append(app.GetStartupTimer());
+			timer.EndPhase();
+
+			timer.BeginPhase("Cleanup()");
+			app.Cleanup();
+			timer.EndPhase();
+		}
+
+		timer.BeginPhase("device destructor");
+		device.reset();
+		timer.EndPhase();
+
+		if (!initialized)
+		{
+			fprintf(log, "run %u: failed to initialize the %s device at %ux%u\n", r + 1, deviceName.c_str(), options.width, options.height);
+			ok = false;
+		}
+		else
+		{
+			fprintf(log, "run %u: %.3f ms\n", r + 1, timer.GetTotalMs());
+		}
+		runs.push_back(timer);
+	}
+
+	std::vector<StartupPhaseSummary> summary;
+	SummarizeStartupRuns(runs, summary);
+	fprintf(log, "\nstartup bench: %s device, %ux%u, %u runs\n", deviceName.c_str(), options.width, options.height, options.startupBenchRuns);
+	PrintStartupSummary(log, summary);
+
+	if (!options.startupTracePath.empty())
+	{
+		if (WriteStartupTrace(options.startupTracePath.c_str(), runs))
+		{
+			fprintf(log, "Wrote %s\n", options.startupTracePath.c_str());
+		}
+		else
+		{
+			fprintf(log, "Failed to write %s\n", options.startupTracePath.c_str());
+			ok = false;
+		}
+	}
+
+	return ok;
+}
+
+void SummarizeStartupRuns(const std::vector<StartupTimer>& runs, std::vector<StartupPhaseSummary>& summary)
+{
+	summary.clear();
+
+	// Milliseconds of each summary entry, one per run that ended it, in run order
+	std::vector<std::vector<double>> times;
+	for (const StartupTimer& run : runs)
+	{
+		std::vector<std::string> enclosing;
+		std::vector<bool> seen(summary.size(), false);
+		for (const StartupTimer::Phase& phase : run.GetPhases())
+		{
+			enclosing.resize(phase.depth);
+			std::string path;
+			for (const std::string& name : enclosing)
+			{
+				path += name + "/";
+			}
+			path += phase.name;
+			enclosing.push_back(phase.name);
+			if (phase.bOpen)
+			{
+				continue;
+			}
+
+			size_t index = 0;
+			while (index < summary.size() && summary[index].path != path)
+			{
+				index++;
+			}
+			if (index == summary.size())
+			{
+				StartupPhaseSummary entry = {};
+				entry.path = path;
+				entry.name = phase.name;
+				entry.depth = phase.depth;
+				summary.push_back(entry);
+				times.push_back(std::vector<double>());
+				seen.push_back(false);
+			}
+
+			// A phase repeated in one run, such as a shader read twice, counts as one longer phase
+			double ms = phase.durationNs / 1.0e6;
+			if (seen[index])
+			{
+				times[index].back() += ms;
+			}
+			else
+			{
+				times[index].push_back(ms);
+				seen[index] = true;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < summary.size(); i++)
+	{
+		StartupPhaseSummary& entry = summary[i];
+		const std::vector<double>& samples = times[i];
+		entry.runCount = (uint32_t)samples.size();
+		entry.firstMs = samples[0];
+
+		// The first run pays for cold caches and one-time driver work; the rest show the steady cost
+		size_t begin = samples.size() > 1 ? 1 : 0;
+		double total = 0.0;
+		entry.minMs = samples[begin];
+		entry.maxMs = samples[begin];
+		for (size_t s = begin; s < samples.size(); s++)
+		{
+			total += samples[s];
+			entry.minMs = std::min(entry.minMs, samples[s]);
+			entry.maxMs = std::max(entry.maxMs, samples[s]);
+		}
+		entry.meanMs = total / (samples.size() - begin);
+	}
+}
+
+void PrintStartupSummary(FILE* file, const std::vector<StartupPhaseSummary>& summary)
+{
+	fprintf(file, "first: the first run, cold; mean, min and max: the other runs, or the first when it is the only one\n");
+	fprintf(file, "%-40s %5s %10s %10s %10s %10s\n", "phase", "runs", "first ms", "mean ms", "min ms", "max ms");
+	for (const StartupPhaseSummary& entry : summary)
+	{
+		int indent = (int)(2 * entry.depth);
+		fprintf(file, "%*s%-*s %5u %10.3f %10.3f %10.3f %10.3f\n", indent, "", indent < 40 ? 40 - indent : 0, entry.name.c_str(), entry.runCount,
+			entry.firstMs, entry.meanMs, entry.minMs, entry.maxMs);
+	}
+}
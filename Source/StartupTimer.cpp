@@ -0,0 +1,158 @@
+/******************************************************************************
+ **	Name:        StartupTimer.cpp                                            **
+ **	Description: Nested startup phase timing, report and Chrome trace output **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                **
+ **	Published:   <insert date>                                               **
+ *****************************************************************************/
+
+#include "StartupTimer.h"
+#include "SampleUtils.h"
+
+StartupTimer::StartupTimer(FrameClockFn clock) : mClock(clock), mOriginNs(0)
+{
+}
+
+void StartupTimer::BeginPhase(const char* name)
+{
+	uint64_t now = mClock();
+	if (mPhases.empty())
+	{
+		mOriginNs = now;
+	}
+
+	Phase phase;
+	phase.name = name;
+	phase.depth = (uint32_t)mOpenPhases.size();
+	phase.startNs = now - mOriginNs;
+	phase.durationNs = 0;
+	phase.bOpen = true;
+	mOpenPhases.push_back((uint32_t)mPhases.size());
+	mPhases.push_back(phase);
+}
+
+void StartupTimer::EndPhase()
+{
+	if (mOpenPhases.empty())
+	{
+		return;
+	}
+
+	Phase& phase = mPhases[mOpenPhases.back()];
+	mOpenPhases.pop_back();
+	phase.durationNs = (mClock() - mOriginNs) - phase.startNs;
+	phase.bOpen = false;
+}
+
+void StartupTimer::Reset()
+{
+	mOriginNs = 0;
+	mPhases.clear();
+	mOpenPhases.clear();
+}
+
+void StartupTimer::Append(const StartupTimer& other)
+{
+	if (other.mPhases.empty())
+	{
+		return;
+	}
+	if (mPhases.empty())
+	{
+		mOriginNs = other.mOriginNs;
+	}
+
+	// A timer that started earlier than this one is clamped to this one's start
+	uint64_t offsetNs = other.mOriginNs > mOriginNs ? other.mOriginNs - mOriginNs : 0;
+	uint32_t depth = (uint32_t)mOpenPhases.size();
+	for (const Phase& phase : other.mPhases)
+	{
+		Phase appended = phase;
+		appended.depth += depth;
+		appended.startNs += offsetNs;
+		mPhases.push_back(appended);
+	}
+}
+
+uint64_t StartupTimer::GetTotalNs() const
+{
+	uint64_t total = 0;
+	for (const Phase& phase : mPhases)
+	{
+		if (phase.depth == 0 && !phase.bOpen)
+		{
+			total += phase.durationNs;
+		}
+	}
+	return total;
+}
+
+void StartupTimer::PrintReport(FILE* file) const
+{
+	uint64_t total = GetTotalNs();
+	fprintf(file, "startup: %.3f ms\n", total / 1.0e6);
+	for (const Phase& phase : mPhases)
+	{
+		if (phase.bOpen)
+		{
+			continue;
+		}
+		int indent = (int)(2 * phase.depth);
+		fprintf(file, "  %*s%-*s %10.3f ms %6.1f%%\n", indent, "", indent < 32 ? 32 - indent : 0, phase.name.c_str(),
+			phase.durationNs / 1.0e6, total ? 100.0 * phase.durationNs / total : 0.0);
+	}
+}
+
+// Phase names are plain text, but a shader or file name could still hold a quote or a backslash
+static void WriteJSONString(FILE* file, const std::string& text)
+{
+	fputc('"', file);
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+		{
+			fprintf(file, "\\%c", c);
+		}
+		else if ((unsigned char)c < 0x20)
+		{
+			fprintf(file, "\\u%04x", (unsigned)c);
+		}
+		else
+		{
+			fputc(c, file);
+		}
+	}
+	fputc('"', file);
+}
+
+bool WriteStartupTrace(const char* path, const std::vector<StartupTimer>& runs)
+{
+	FILE* file = OpenFile(path, "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// Timestamps are in microseconds; the thread name metadata labels each run
+	fprintf(file, "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [");
+	bool first = true;
+	for (size_t run = 0; run < runs.size(); run++)
+	{
+		fprintf(file, "%s\n    { \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %zu, \"args\": { \"name\": \"run %zu\" } }",
+			first ? "" : ",", run + 1, run + 1);
+		first = false;
+		for (const StartupTimer::Phase& phase : runs[run].GetPhases())
+		{
+			if (phase.bOpen)
+			{
+				continue;
+			}
+			fprintf(file, ",\n    { \"name\": ");
+			WriteJSONString(file, phase.name);
+			fprintf(file, ", \"cat\": \"startup\", \"ph\": \"X\", \"pid\": 1, \"tid\": %zu, \"ts\": %.3f, \"dur\": %.3f, \"args\": { \"depth\": %u } }",
+				run + 1, phase.startNs / 1.0e3, phase.durationNs / 1.0e3, phase.depth);
+		}
+	}
+	fprintf(file, "\n  ]\n}\n");
+
+	return fclose(file) == 0;
+}
@@ -0,0 +1,349 @@
+/******************************************************************************
+ **	Name:        StateFilterGraphicsDevice.cpp                               **
+ **	Description: GraphicsDevice decorator that drops redundant state changes **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                **
+ **	Published:   <insert date>                                               **
+ *****************************************************************************/
+
+#include "StateFilterGraphicsDevice.h"
+
+StateFilterGraphicsDevice::StateFilterGraphicsDevice(GraphicsDevice* inner) : GraphicsDeviceDecorator(inner), mForwardedCount(0), mFilteredCount(0)
+{
+	Invalidate();
+}
+
+void StateFilterGraphicsDevice::Invalidate()
+{
+	ResetBindings(UNKNOWN_HANDLE);
+}
+
+void StateFilterGraphicsDevice::ResetBindings(GfxHandle value)
+{
+	mComputeShader = value;
+	for (uint32_t i = 0; i < MAX_UAV_SLOTS; i++)
+	{
+		mUAVs[i] = value;
+	}
+	for (uint32_t i = 0; i < MAX_CONSTANT_BUFFER_SLOTS; i++)
+	{
+		mConstantBuffers[i] = value;
+	}
+
+	mRenderTarget = value;
+	bViewportKnown = false;
+	mInputLayout = value;
+	for (uint32_t i = 0; i < MAX_VERTEX_BUFFER_SLOTS; i++)
+	{
+		mVertexBuffers[i].buffer = value;
+		mVertexBuffers[i].stride = 0;
+		mVertexBuffers[i].offset = 0;
+	}
+	mVertexShader = value;
+	mPixelShader = value;
+	for (uint32_t i = 0; i < MAX_SRV_SLOTS; i++)
+	{
+		mSRVs[i] = value;
+	}
+}
+
+bool StateFilterGraphicsDevice::IsRedundant(GfxHandle& cached, GfxHandle value)
+{
+	if (cached == value)
+	{
+		mFilteredCount++;
+		return true;
+	}
+	cached = value;
+	return false;
+}
+
+GfxTexture StateFilterGraphicsDevice::GetViewTexture(GfxView view) const
+{
+	std::unordered_map<GfxView, GfxTexture>::const_iterator it = mViewTextures.find(view);
+	return it != mViewTextures.end() ? it->second : GFX_NULL_HANDLE;
+}
+
+void StateFilterGraphicsDevice::UnbindShaderResources(GfxTexture texture)
+{
+	for (uint32_t i = 0; i < MAX_SRV_SLOTS; i++)
+	{
+		if (mSRVs[i] != GFX_NULL_HANDLE && (texture == GFX_NULL_HANDLE || GetViewTexture(mSRVs[i]) == texture))
+		{
+			mSRVs[i] = UNKNOWN_HANDLE;
+		}
+	}
+}
+
+bool StateFilterGraphicsDevice::IsBoundForOutput(GfxTexture texture) const
+{
+	if (mRenderTarget == UNKNOWN_HANDLE || (mRenderTarget != GFX_NULL_HANDLE && GetViewTexture(mRenderTarget) == texture))
+	{
+		return true;
+	}
+	for (uint32_t i = 0; i < MAX_UAV_SLOTS; i++)
+	{
+		if (mUAVs[i] == UNKNOWN_HANDLE || (mUAVs[i] != GFX_NULL_HANDLE && GetViewTexture(mUAVs[i]) == texture))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool StateFilterGraphicsDevice::Init(uint32_t width, uint32_t height)
+{
+	mViewTextures.clear();
+	if (!mInner->Init(width, height))
+	{
+		Invalidate();
+		return false;
+	}
+
+	// A freshly initialized device has nothing bound
+	ResetBindings(GFX_NULL_HANDLE);
+	return true;
+}
+
+void StateFilterGraphicsDevice::Cleanup()
+{
+	mInner->Cleanup();
+	Invalidate();
+	mViewTextures.clear();
+}
+
+GfxView StateFilterGraphicsDevice::CreateShaderResourceView(GfxTexture texture)
+{
+	GfxView view = mInner->CreateShaderResourceView(texture);
+	mViewTextures[view] = texture;
+	return view;
+}
+
+GfxView StateFilterGraphicsDevice::CreateUnorderedAccessView(GfxTexture texture)
+{
+	GfxView view = mInner->CreateUnorderedAccessView(texture);
+	mViewTextures[view] = texture;
+	return view;
+}
+
+GfxView StateFilterGraphicsDevice::CreateRenderTargetView(GfxTexture texture)
+{
+	GfxView view = mInner->CreateRenderTargetView(texture);
+	mViewTextures[view] = texture;
+	return view;
+}
+
+void StateFilterGraphicsDevice::Release(GfxHandle handle)
+{
+	// The handle may be reused by the next object created, which must not look already bound
+	GfxHandle* caches[] = { &mComputeShader, &mRenderTarget, &mInputLayout, &mVertexShader, &mPixelShader };
+	for (GfxHandle* cached : caches)
+	{
+		if (*cached == handle)
+		{
+			*cached = UNKNOWN_HANDLE;
+		}
+	}
+	for (uint32_t i = 0; i < MAX_UAV_SLOTS; i++)
+	{
+		mUAVs[i] = (mUAVs[i] == handle) ? UNKNOWN_HANDLE : mUAVs[i];
+	}
+	for (uint32_t i = 0; i < MAX_CONSTANT_BUFFER_SLOTS; i++)
+	{
+		mConstantBuffers[i] = (mConstantBuffers[i] == handle) ? UNKNOWN_HANDLE : mConstantBuffers[i];
+	}
+	for (uint32_t i = 0; i < MAX_VERTEX_BUFFER_SLOTS; i++)
+	{
+		mVertexBuffers[i].buffer = (mVertexBuffers[i].buffer == handle) ? UNKNOWN_HANDLE : mVertexBuffers[i].buffer;
+	}
+	for (uint32_t i = 0; i < MAX_SRV_SLOTS; i++)
+	{
+		mSRVs[i] = (mSRVs[i] == handle) ? UNKNOWN_HANDLE : mSRVs[i];
+	}
+	mViewTextures.erase(handle);
+
+	mInner->Release(handle);
+}
+
+void StateFilterGraphicsDevice::CSSetShader(GfxShader shader)
+{
+	if (IsRedundant(mComputeShader, shader))
+	{
+		return;
+	}
+	CountForwarded();
+	mInner->CSSetShader(shader);
+}
+
+void StateFilterGraphicsDevice::CSSetUnorderedAccessView(uint32_t slot, GfxView view)
+{
+	if (slot < MAX_UAV_SLOTS)
+	{
+		if (IsRedundant(mUAVs[slot], view))
+		{
+			return;
+		}
+		if (view != GFX_NULL_HANDLE)
+		{
+			UnbindShaderResources(GetViewTexture(view));
+		}
+	}
+	else
+	{
+		// Whatever an untracked slot binds may collide with any SRV
+		UnbindShaderResources(GFX_NULL_HANDLE);
+	}
+	CountForwarded();
+	mInner->CSSetUnorderedAccessView(slot, view);
+}
+
+void StateFilterGraphicsDevice::CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer)
+{
+	if (slot < MAX_CONSTANT_BUFFER_SLOTS && IsRedundant(mConstantBuffers[slot], buffer))
+	{
+		return;
+	}
+	CountForwarded();
+	mInner->CSSetConstantBuffer(slot, buffer);
+}
+
+void StateFilterGraphicsDevice::CSSetShaderResource(uint32_t slot, GfxView view)
+{
+	CountForwarded();
+	mInner->CSSetShaderResource(slot, view);
+}
+
+bool StateFilterGraphicsDevice::ResizeBuffers(uint32_t width, uint32_t height)
+{
+	bool resized = mInner->ResizeBuffers(width, height);
+	mRenderTarget = resized ? GFX_NULL_HANDLE : UNKNOWN_HANDLE;
+	return resized;
+}
+
+void StateFilterGraphicsDevice::ExecuteCommandList(GfxDeferredContext* context)
+{
+	CountForwarded();
+	mInner->ExecuteCommandList(context);
+	ResetBindings(GFX_NULL_HANDLE);
+}
+
+void StateFilterGraphicsDevice::OMSetRenderTarget(GfxView view)
+{
+	if (IsRedundant(mRenderTarget, view))
+	{
+		return;
+	}
+	// The back buffer RTV has no texture handle, and no SRV can be made of it
+	GfxTexture texture = GetViewTexture(view);
+	if (texture != GFX_NULL_HANDLE)
+	{
+		UnbindShaderResources(texture);
+	}
+	CountForwarded();
+	mInner->OMSetRenderTarget(view);
+}
+
+void StateFilterGraphicsDevice::RSSetViewport(float width, float height)
+{
+	if (bViewportKnown && mViewportWidth == width && mViewportHeight == height)
+	{
+		mFilteredCount++;
+		return;
+	}
+	bViewportKnown = true;
+	mViewportWidth = width;
+	mViewportHeight = height;
+	CountForwarded();
+	mInner->RSSetViewport(width, height);
+}
+
+void StateFilterGraphicsDevice::IASetInputLayout(GfxInputLayout layout)
+{
+	if (IsRedundant(mInputLayout, layout))
+	{
+		return;
+	}
+	CountForwarded();
+	mInner->IASetInputLayout(layout);
+}
+
+void StateFilterGraphicsDevice::IASetVertexBuffer(uint32_t slot, GfxBuffer buffer, uint32_t stride, uint32_t offset)
+{
+	if (slot < MAX_VERTEX_BUFFER_SLOTS)
+	{
+		VertexBufferBinding& binding = mVertexBuffers[slot];
+		if (binding.buffer == buffer && binding.stride == stride && binding.offset == offset)
+		{
+			mFilteredCount++;
+			return;
+		}
+		binding.buffer = buffer;
+		binding.stride = stride;
+		binding.offset = offset;
+	}
+	CountForwarded();
+	mInner->IASetVertexBuffer(slot, buffer, stride, offset);
+}
+
+void StateFilterGraphicsDevice::VSSetShader(GfxShader shader)
+{
+	if (IsRedundant(mVertexShader, shader))
+	{
+		return;
+	}
+	CountForwarded();
+	mInner->VSSetShader(shader);
+}
+
+void StateFilterGraphicsDevice::PSSetShader(GfxShader shader)
+{
+	if (IsRedundant(mPixelShader, shader))
+	{
+		return;
+	}
+	CountForwarded();
+	mInner->PSSetShader(shader);
+}
+
+void StateFilterGraphicsDevice::PSSetShaderResource(uint32_t slot, GfxView view)
+{
+	if (slot < MAX_SRV_SLOTS)
+	{
+		if (IsRedundant(mSRVs[slot], view))
+		{
+			return;
+		}
+
+		// D3D11 binds null instead of an SRV whose texture is bound for output, so what ends up bound is unknown
+		GfxTexture texture = GetViewTexture(view);
+		if (view != GFX_NULL_HANDLE && (texture == GFX_NULL_HANDLE || IsBoundForOutput(texture)))
+		{
+			mSRVs[slot] = UNKNOWN_HANDLE;
+		}
+	}
+	CountForwarded();
+	mInner->PSSetShaderResource(slot, view);
+}
+
+void StateFilterGraphicsDevice::RenderUI(ImDrawData* drawData)
+{
+	mInner->RenderUI(drawData);
+	if (mInner->IsUIStatePreserved())
+	{
+		return;
+	}
+
+	mComputeShader = UNKNOWN_HANDLE;
+	bViewportKnown = false;
+	mInputLayout = UNKNOWN_HANDLE;
+	mVertexBuffers[0].buffer = UNKNOWN_HANDLE;
+	mVertexShader = UNKNOWN_HANDLE;
+	mPixelShader = UNKNOWN_HANDLE;
+	mSRVs[0] = UNKNOWN_HANDLE;
+}
+
+void StateFilterGraphicsDevice::Present()
+{
+	// Flip model swap chains unbind the back buffer on Present
+	mInner->Present();
+	mRenderTarget = UNKNOWN_HANDLE;
+}
@@ -0,0 +1,168 @@
+/***********************************************************************************************
+ **	Name:        ThreadPool.cpp                                                               **
+ **	Description: Work-stealing thread pool - per-worker deques, idle workers steal from peers **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                 **
+ **	Published:   <insert date>                                                                **
+ **********************************************************************************************/
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+ThreadPool::ThreadPool(uint32_t numThreads) : mNextQueue(0), mQueuedTasks(0), mPendingTasks(0), mStealCount(0), bShutdown(false)
+{
+	if (numThreads == 0)
+	{
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (uint32_t i = 0; i < numThreads; i++)
+	{
+		mQueues.emplace_back(new WorkerQueue());
+	}
+
+	for (uint32_t i = 0; i < numThreads; i++)
+	{
+		mWorkers.emplace_back(&ThreadPool::WorkerMain, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	Wait();
+
+	{
+		std::lock_guard<std::mutex> guard(mSleepLock);
+		bShutdown = true;
+	}
+	mWakeCondition.notify_all();
+
+	for (std::thread& worker : mWorkers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::Submit(Task task)
+{
+	uint32_t queueIndex = mNextQueue.fetch_add(1, std::memory_order_relaxed) % (uint32_t)mQueues.size();
+
+	mPendingTasks.fetch_add(1);
+
+	// Publish the queued count under the sleep lock so a worker cannot miss the wakeup between checking and sleeping
+	{
+		std::lock_guard<std::mutex> guard(mSleepLock);
+		mQueuedTasks.fetch_add(1);
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(mQueues[queueIndex]->lock);
+		mQueues[queueIndex]->tasks.push_back(std::move(task));
+	}
+	mWakeCondition.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	std::unique_lock<std::mutex> guard(mSleepLock);
+	mIdleCondition.wait(guard, [this] { return mPendingTasks.load() == 0; });
+}
+
+void ThreadPool::ParallelFor(uint32_t count, uint32_t grainSize, const RangeTask& func)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (grainSize == 0)
+	{
+		grainSize = std::max(1u, count / (GetThreadCount() * 8));
+	}
+
+	for (uint32_t begin = 0; begin < count; begin += grainSize)
+	{
+		uint32_t end = std::min(count, begin + grainSize);
+		Submit([&func, begin, end] { func(begin, end); });
+	}
+
+	Wait();
+}
+
+double ThreadPool::GetWorkerBusySeconds(uint32_t workerIndex) const
+{
+	return mQueues[workerIndex]->busyNanoseconds.load() * 1.0e-9;
+}
+
+void ThreadPool::ResetWorkerStats()
+{
+	for (const std::unique_ptr<WorkerQueue>& queue : mQueues)
+	{
+		queue->busyNanoseconds.store(0);
+	}
+	mStealCount.store(0);
+}
+
+bool ThreadPool::PopTask(uint32_t workerIndex, Task& task)
+{
+	// Own queue first, newest task first, to keep the working set warm
+	{
+		WorkerQueue& queue = *mQueues[workerIndex];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		if (!queue.tasks.empty())
+		{
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+			return true;
+		}
+	}
+
+	// Then steal the oldest task from a peer
+	uint32_t numQueues = (uint32_t)mQueues.size();
+	for (uint32_t i = 1; i < numQueues; i++)
+	{
+		WorkerQueue& victim = *mQueues[(workerIndex + i) % numQueues];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			mStealCount.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::WorkerMain(uint32_t workerIndex)
+{
+	for (;;)
+	{
+		Task task;
+		if (PopTask(workerIndex, task))
+		{
+			mQueuedTasks.fetch_sub(1);
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			task();
+			std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+			mQueues[workerIndex]->busyNanoseconds.fetch_add((uint64_t)elapsed.count(), std::memory_order_relaxed);
+
+			if (mPendingTasks.fetch_sub(1) == 1)
+			{
+				std::lock_guard<std::mutex> guard(mSleepLock);
+				mIdleCondition.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock<std::mutex> guard(mSleepLock);
+		mWakeCondition.wait(guard, [this] { return bShutdown || mQueuedTasks.load() > 0; });
+		if (bShutdown && mQueuedTasks.load() == 0)
+		{
+			return;
+		}
+	}
+}
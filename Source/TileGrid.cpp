@@ -0,0 +1,34 @@
+/***********************************************************************************************
+ **	Name:        TileGrid.cpp                                                                 **
+ **	Description: Resolution-independent grid of square compute tiles covering a render target **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                 **
+ **	Published:   <insert date>                                                                **
+ **********************************************************************************************/
+
+#include "TileGrid.h"
+
+void TileGrid::Resize(uint32_t width, uint32_t height, uint32_t tileSize)
+{
+	mWidth = width;
+	mHeight = height;
+	mTileSize = IsSupportedTileSize(tileSize) ? tileSize : 16;
+	mTilesX = CeilDiv(width, mTileSize);
+	mTilesY = CeilDiv(height, mTileSize);
+}
+
+TileGrid::Tile TileGrid::GetTile(uint32_t index) const
+{
+	Tile tile;
+	tile.tileX = index / mTilesY;
+	tile.tileY = index % mTilesY;
+	tile.x = tile.tileX * mTileSize;
+	tile.y = tile.tileY * mTileSize;
+	tile.width = (tile.x + mTileSize <= mWidth) ? mTileSize : (mWidth - tile.x);
+	tile.height = (tile.y + mTileSize <= mHeight) ? mTileSize : (mHeight - tile.y);
+	return tile;
+}
+
+bool TileGrid::IsEdgeTile(uint32_t tileX, uint32_t tileY) const
+{
+	return ((tileX + 1) * mTileSize > mWidth) || ((tileY + 1) * mTileSize > mHeight);
+}
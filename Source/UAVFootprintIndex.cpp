@@ -0,0 +1,106 @@
+/******************************************************************************************
+ **	Name:        UAVFootprintIndex.cpp                                                   **
+ **	Description: Uniform grid index of the UAV footprints written by a run of dispatches **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                            **
+ **	Published:   <insert date>                                                           **
+ *****************************************************************************************/
+
+#include "UAVFootprintIndex.h"
+
+#include "TileGrid.h"
+
+void UAVFootprintIndex::Reset(uint32_t width, uint32_t height, uint32_t cellSize)
+{
+	mCellSize = cellSize > 0 ? cellSize : 32;
+	mCellsX = TileGrid::CeilDiv(width > 0 ? width : 1, mCellSize);
+	mCellsY = TileGrid::CeilDiv(height > 0 ? height : 1, mCellSize);
+	mCells.assign((size_t)mCellsX * mCellsY, Cell());
+	mGeneration = 1;
+	mFootprints.clear();
+}
+
+void UAVFootprintIndex::Clear()
+{
+	mFootprints.clear();
+
+	// Cells stamped with the new generation would look current again once the counter wraps, so start over instead
+	if (++mGeneration == 0)
+	{
+		for (Cell& cell : mCells)
+		{
+			cell.generation = 0;
+			cell.footprints.clear();
+		}
+		mGeneration = 1;
+	}
+}
+
+void UAVFootprintIndex::GetCellRange(const UAVFootprint& footprint, uint32_t& cellX0, uint32_t& cellY0, uint32_t& cellX1, uint32_t& cellY1) const
+{
+	// Inclusive cell range, clamped so footprints past the texture land in the edge cells
+	cellX0 = footprint.x0 / mCellSize;
+	cellY0 = footprint.y0 / mCellSize;
+	cellX1 = (footprint.x1 - 1) / mCellSize;
+	cellY1 = (footprint.y1 - 1) / mCellSize;
+	cellX0 = cellX0 < mCellsX ? cellX0 : mCellsX - 1;
+	cellY0 = cellY0 < mCellsY ? cellY0 : mCellsY - 1;
+	cellX1 = cellX1 < mCellsX ? cellX1 : mCellsX - 1;
+	cellY1 = cellY1 < mCellsY ? cellY1 : mCellsY - 1;
+}
+
+bool UAVFootprintIndex::Intersects(const UAVFootprint& footprint) const
+{
+	if (footprint.IsEmpty() || mFootprints.empty())
+	{
+		return false;
+	}
+
+	uint32_t cellX0, cellY0, cellX1, cellY1;
+	GetCellRange(footprint, cellX0, cellY0, cellX1, cellY1);
+	for (uint32_t cellY = cellY0; cellY <= cellY1; cellY++)
+	{
+		for (uint32_t cellX = cellX0; cellX <= cellX1; cellX++)
+		{
+			const Cell& cell = mCells[(size_t)cellY * mCellsX + cellX];
+			if (cell.generation != mGeneration)
+			{
+				continue;
+			}
+			for (uint32_t index : cell.footprints)
+			{
+				if (mFootprints[index].Intersects(footprint))
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+void UAVFootprintIndex::Insert(const UAVFootprint& footprint)
+{
+	if (footprint.IsEmpty() || mCells.empty())
+	{
+		return;
+	}
+
+	uint32_t index = (uint32_t)mFootprints.size();
+	mFootprints.push_back(footprint);
+
+	uint32_t cellX0, cellY0, cellX1, cellY1;
+	GetCellRange(footprint, cellX0, cellY0, cellX1, cellY1);
+	for (uint32_t cellY = cellY0; cellY <= cellY1; cellY++)
+	{
+		for (uint32_t cellX = cellX0; cellX <= cellX1; cellX++)
+		{
+			Cell& cell = mCells[(size_t)cellY * mCellsX + cellX];
+			if (cell.generation != mGeneration)
+			{
+				cell.generation = mGeneration;
+				cell.footprints.clear();
+			}
+			cell.footprints.push_back(index);
+		}
+	}
+}
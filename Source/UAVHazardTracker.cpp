@@ -0,0 +1,120 @@
+/***************************************************************************
+ **	Name:        UAVHazardTracker.cpp                                     **
+ **	Description: Brackets hazard-free runs of dispatches with UAV overlap **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com             **
+ **	Published:   <insert date>                                            **
+ **************************************************************************/
+
+#include "UAVHazardTracker.h"
+
+static const UAVHazardTracker::PassStats gEmptyPassStats = { 0, 0, 0, 0 };
+
+UAVHazardTracker::UAVHazardTracker() : mContext(nullptr), mMode(UAV_OVERLAP_OFF), bBracketOpen(false), mRunLength(0), mWidth(0), mHeight(0),
+	mPass(gEmptyPassStats), mLastPass(gEmptyPassStats)
+{
+}
+
+uint32_t UAVHazardTracker::BeginPass(GfxComputeContext* context, UAVOverlapMode mode, uint32_t width, uint32_t height)
+{
+	mContext = context;
+	mMode = mode;
+	mPass = gEmptyPassStats;
+	mRunLength = 0;
+
+	if (mode == UAV_OVERLAP_OFF)
+	{
+		return 0;
+	}
+
+	// Only rebuild the grid when the UAV changes size; otherwise clearing it is enough
+	if (width != mWidth || height != mHeight)
+	{
+		mRun.Reset(width, height);
+		mWidth = width;
+		mHeight = height;
+	}
+	else
+	{
+		mRun.Clear();
+	}
+
+	if (mode == UAV_OVERLAP_ALWAYS)
+	{
+		mContext->BeginUAVOverlap();
+		bBracketOpen = true;
+		mPass.bracketCount++;
+		return 1;
+	}
+	return 0;
+}
+
+uint32_t UAVHazardTracker::Dispatch(const UAVFootprint& footprint, uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+{
+	uint32_t calls = TrackDispatch(footprint);
+	mContext->Dispatch(groupsX, groupsY, groupsZ);
+	return calls + 1;
+}
+
+uint32_t UAVHazardTracker::DispatchIndirect(const UAVFootprint& footprint, GfxBuffer arguments, uint32_t byteOffset)
+{
+	uint32_t calls = TrackDispatch(footprint);
+	mContext->DispatchIndirect(arguments, byteOffset);
+	return calls + 1;
+}
+
+uint32_t UAVHazardTracker::TrackDispatch(const UAVFootprint& footprint)
+{
+	uint32_t calls = 0;
+	mPass.dispatchCount++;
+
+	if (mMode != UAV_OVERLAP_OFF)
+	{
+		if (mRun.Intersects(footprint))
+		{
+			mPass.hazardCount++;
+
+			// Closing the bracket makes the device sync before this dispatch, which then starts a new run. With
+			// the bracket held open for the whole pass, every earlier dispatch stays a potential conflict.
+			if (mMode == UAV_OVERLAP_AUTO)
+			{
+				mRun.Clear();
+				mRunLength = 0;
+				if (bBracketOpen)
+				{
+					mContext->EndUAVOverlap();
+					bBracketOpen = false;
+					calls++;
+				}
+			}
+		}
+
+		if (mMode == UAV_OVERLAP_AUTO && !bBracketOpen)
+		{
+			mContext->BeginUAVOverlap();
+			bBracketOpen = true;
+			mPass.bracketCount++;
+			calls++;
+		}
+
+		mRun.Insert(footprint);
+		mRunLength++;
+		mPass.longestRun = mRunLength > mPass.longestRun ? mRunLength : mPass.longestRun;
+	}
+
+	return calls;
+}
+
+uint32_t UAVHazardTracker::EndPass()
+{
+	uint32_t calls = 0;
+	if (bBracketOpen)
+	{
+		mContext->EndUAVOverlap();
+		bBracketOpen = false;
+		calls++;
+	}
+
+	mLastPass = mPass;
+	mContext = nullptr;
+	return calls;
+}
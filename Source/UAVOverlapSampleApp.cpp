@@ -6,385 +6,706 @@
  *******************************************************************************/
 
 #include "UAVOverlapSampleApp.h"
+#include "CPUComputeBackend.h"
 
-UAVOverlapSampleApp::UAVOverlapSampleApp(HWND window, uint32_t width, uint32_t height) : mWindow(window), mWidth(width), mHeight(height) 
-{ 
-	bUseUAVOverlapExtension = false;
-	bUAVOverlapSupported = false;
-	bIntelGPUPresent = false;
-}
+#include <chrono>
+
+static const uint32_t gTileSizes[NUM_TILE_SIZES] = { 8, 16, 32 };
+static const char* gComputeShaderNames[NUM_TILE_SIZES] = { "ComputeShaderTile8", "ComputeShader", "ComputeShaderTile32" };
+static const char* gTileListShaderNames[NUM_TILE_SIZES] = { "ComputeShaderTile8List", "ComputeShaderList", "ComputeShaderTile32List" };
+static const char* gWorkloadShaderNames[NUM_TILE_SIZES] = { "ComputeWorkloadTile8", "ComputeWorkload", "ComputeWorkloadTile32" };
+static const char* gWorkloadListShaderNames[NUM_TILE_SIZES] = { "ComputeWorkloadTile8List", "ComputeWorkloadList", "ComputeWorkloadTile32List" };
 
-bool UAVOverlapSampleApp::InitIntelExtensions()
+static uint32_t TileSizeIndex(uint32_t tileSize)
 {
-	if (SUCCEEDED(INTC_LoadExtensionsLibrary()))
+	for (uint32_t i = 0; i < NUM_TILE_SIZES; i++)
+	{
+		if (gTileSizes[i] == tileSize)
+		{
+			return i;
+		}
+	}
+	return 1;
+}
+
+UAVOverlapSampleApp::UAVOverlapSampleApp(GraphicsDevice* device, uint32_t width, uint32_t height) : mDevice(device), mWidth(width), mHeight(height),
+	mAllocatedWidth(width), mAllocatedHeight(height)
+{ 
+	mBackBufferRTV = GFX_NULL_HANDLE;
+	mVertexShader = GFX_NULL_HANDLE;
+	mPixelShader = GFX_NULL_HANDLE;
+	for (uint32_t i = 0; i < NUM_TILE_SIZES; i++)
 	{
-		INTCExtensionVersion requiredVersion = { 1, 2, 0 };
+		mComputeShader[i] = GFX_NULL_HANDLE;
+		mTileListShader[i] = GFX_NULL_HANDLE;
+		mWorkloadShader[i] = GFX_NULL_HANDLE;
+		mWorkloadListShader[i] = GFX_NULL_HANDLE;
+	}
+	mVertexLayout = GFX_NULL_HANDLE;
+	mVertexBuffer = GFX_NULL_HANDLE;
+	mBatchedConstantBuffer = GFX_NULL_HANDLE;
+	mTileListBuffer = GFX_NULL_HANDLE;
+	mTileListSRV = GFX_NULL_HANDLE;
+	mIndirectArguments = GFX_NULL_HANDLE;
+	mWorkload = ComputeWorkload();
+	mWorkloadSource = GFX_NULL_HANDLE;
+	mWorkloadSourceSRV = GFX_NULL_HANDLE;
+	for (uint32_t i = 0; i < GFX_MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		mSampleTexture[i] = GFX_NULL_HANDLE;
+		mSampleSRV[i] = GFX_NULL_HANDLE;
+		mSampleUAV[i] = GFX_NULL_HANDLE;
+	}
+	mFrameSet = 0;
+	mFramesInFlight = 1;
+	mTileGrid.Resize(width, height, 16);
 
-		INTCExtensionVersion* pSupportedExtVersions = nullptr;
-		uint32_t supportedExtVersionCount = 0;
+	bUseUAVOverlapExtension = false;
+	bAutoUAVOverlap = false;
+	bUseBatchedDispatch = false;
+	bUseIndirectDispatch = false;
+	mComputeCounters = {};
+	mLastOverlapStats = {};
+	mRecordThreadCount = 0;
+}
 
-		INTC_D3D11_GetSupportedVersions(mDevice, pSupportedExtVersions, &supportedExtVersionCount);
+void UAVOverlapSampleApp::ApplyOptions(const HeadlessOptions& options)
+{
+	bUseUAVOverlapExtension = options.bUseUAVOverlap || options.bAutoUAVOverlap;
+	bAutoUAVOverlap = options.bAutoUAVOverlap;
+	mFrameStatsPath = options.frameStatsPath;
+	bUseBatchedDispatch = options.bUseBatchedDispatch;
+	bUseIndirectDispatch = options.bUseIndirectDispatch;
+	mRecordThreadCount = options.recordThreadCount;
+	mFramesInFlight = options.framesInFlight;
+	mWorkload = options.workload;
+	mTileGrid.Resize(mWidth, mHeight, options.tileSize);
+}
 
-		INTCExtensionInfo intcExtensionInfo = {};
+bool UAVOverlapSampleApp::CreateTileConstantBuffers(uint32_t tileSize)
+{
+	ReleaseTileConstantBuffers();
 
-		//Next, use returned value for supportedExtVersionCount to allocate space for the supported extensions
-		pSupportedExtVersions = new INTCExtensionVersion[supportedExtVersionCount];
-		memset(pSupportedExtVersions, 0, sizeof(INTCExtensionVersion) * supportedExtVersionCount);
+	// The grid rounds up, so any resolution is covered; edge tiles are clipped by the compute shader
+	mTileGrid.Resize(mWidth, mHeight, tileSize);
+	mConstantBuffer.resize(mTileGrid.GetTileCount(), GFX_NULL_HANDLE);
 
-		//Next populate the list of supported version and iterate until you find the needed version
-		INTC_D3D11_GetSupportedVersions(mDevice, pSupportedExtVersions, &supportedExtVersionCount);
+	// Entries pack the tile's x in the low 16 bits and its y in the high 16, in the order the per-tile pass dispatches them
+	std::vector<uint32_t> tileList;
+	tileList.reserve(mTileGrid.GetTileCount());
 
-		for (uint32_t i = 0; i < supportedExtVersionCount; i++)
+	for (uint32_t x = 0; x < mTileGrid.GetTilesX(); x++)
+	{
+		for (uint32_t y = 0; y < mTileGrid.GetTilesY(); y++)
 		{
+			tileList.push_back(PackTileListEntry(x, y));
+
+			ConstantBuffer cbuffer = {};
+			cbuffer.dispatchX = x;
+			cbuffer.dispatchY = y;
+			cbuffer.windowWidth = mWidth;
+			cbuffer.windowHeight = mHeight;
+			cbuffer.workload = mWorkload;
 
-			if ((pSupportedExtVersions[i].HWFeatureLevel >= requiredVersion.HWFeatureLevel) &&
-				(pSupportedExtVersions[i].APIVersion >= requiredVersion.APIVersion) &&
-				(pSupportedExtVersions[i].Revision >= requiredVersion.Revision))
+			GfxBuffer buffer = mDevice->CreateConstantBuffer(&cbuffer, sizeof(cbuffer));
+			if (buffer == GFX_NULL_HANDLE)
 			{
-				intcExtensionInfo.RequestedExtensionVersion = pSupportedExtVersions[i];
-				break;
+				return false;
 			}
+			mConstantBuffer[mTileGrid.GetTileIndex(x, y)] = buffer;
 		}
+	}
 
-		delete[] pSupportedExtVersions;
-
-		if (SUCCEEDED(INTC_D3D11_CreateDeviceExtensionContext(mDevice, &mINTCExtensionContext, &intcExtensionInfo, nullptr)))
-		{
-			return true;
-		}
-		else
+	// Batched submission uses a single constant buffer at tile (0,0) and lets SV_GroupID select the tile
+	{
+		ConstantBuffer cbuffer = {};
+		cbuffer.dispatchX = 0;
+		cbuffer.dispatchY = 0;
+		cbuffer.windowWidth = mWidth;
+		cbuffer.windowHeight = mHeight;
+		cbuffer.workload = mWorkload;
+
+		mBatchedConstantBuffer = mDevice->CreateConstantBuffer(&cbuffer, sizeof(cbuffer));
+		if (mBatchedConstantBuffer == GFX_NULL_HANDLE)
 		{
-			INTC_UnloadExtensionsLibrary();
 			return false;
 		}
 	}
-	else
+
+	// One group per entry, in rows of CS_TILE_LIST_ROW_GROUPS
+	uint32_t tileCount = (uint32_t)tileList.size();
+	uint32_t arguments[3] = { tileCount < CS_TILE_LIST_ROW_GROUPS ? tileCount : CS_TILE_LIST_ROW_GROUPS, (tileCount + CS_TILE_LIST_ROW_GROUPS - 1) / CS_TILE_LIST_ROW_GROUPS, 1 };
+
+	mTileListBuffer = mDevice->CreateStructuredBuffer(tileList.data(), sizeof(uint32_t), tileCount);
+	mTileListSRV = mDevice->CreateShaderResourceView(mTileListBuffer);
+	mIndirectArguments = mDevice->CreateIndirectArgumentBuffer(arguments, sizeof(arguments));
+	return mTileListSRV != GFX_NULL_HANDLE && mIndirectArguments != GFX_NULL_HANDLE;
+}
+
+void UAVOverlapSampleApp::ReleaseTileConstantBuffers()
+{
+	for (GfxBuffer buffer : mConstantBuffer)
+	{
+		mDevice->Release(buffer);
+	}
+	mConstantBuffer.clear();
+
+	GfxHandle handles[] = { mBatchedConstantBuffer, mTileListSRV, mTileListBuffer, mIndirectArguments };
+	for (GfxHandle handle : handles)
 	{
-		return false;
+		mDevice->Release(handle);
 	}
+	mBatchedConstantBuffer = mTileListSRV = mTileListBuffer = mIndirectArguments = GFX_NULL_HANDLE;
 }
 
-HRESULT UAVOverlapSampleApp::Init()
+bool UAVOverlapSampleApp::Init()
 {
-	IDXGIFactory1* factory;
-	ThrowIfFailed(CreateDXGIFactory1(__uuidof(IDXGIFactory1), (LPVOID*)&factory));
-
-	UINT createDeviceFlags = 0;
-#ifdef _DEBUG
-	//    createDeviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
-#endif
+	// A phase left open by a failed stage is left out of the report. The device nests its own stages in the app's
+	// until the end of Init(), or until Cleanup() after a failure.
+	mStartupTimer.Reset();
+	mDevice->SetStartupTimer(&mStartupTimer);
+	mStartupTimer.BeginPhase("device");
+	mDevice->SetMaxFramesInFlight(mFramesInFlight);
+	if (!mDevice->Init(mWidth, mHeight))
+	{
+		return false;
+	}
+	mFramePacer.Init(mDevice);
+	mStartupTimer.EndPhase();
 
-	IDXGIAdapter1* adapter = nullptr;
-	D3D_FEATURE_LEVEL featureLevels[] = { D3D_FEATURE_LEVEL_11_1, D3D_FEATURE_LEVEL_11_0 };
-	D3D_FEATURE_LEVEL createdFeatureLevel;
+	mBackBufferRTV = mDevice->GetBackBufferRTV();
 
-	// Attempt to find an Intel GPU among the enumerated adapaters and create a device for it
-	for (UINT32 i = 0; factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; ++i)
+	// Create the shaders used by this sample from their pre-compiled byte code
+	mStartupTimer.BeginPhase("shaders");
+	mVertexShader = mDevice->CreateVertexShader("VertexShader");
+	mPixelShader = mDevice->CreatePixelShader("PixelShader");
+	for (uint32_t i = 0; i < NUM_TILE_SIZES; i++)
 	{
-		DXGI_ADAPTER_DESC1 desc;
-		adapter->GetDesc1(&desc);
-
-		if (desc.VendorId != 0x8086) // INTEL VendorId
+		mComputeShader[i] = mDevice->CreateComputeShader(gComputeShaderNames[i]);
+		mTileListShader[i] = mDevice->CreateComputeShader(gTileListShaderNames[i]);
+		mWorkloadShader[i] = mDevice->CreateComputeShader(gWorkloadShaderNames[i]);
+		mWorkloadListShader[i] = mDevice->CreateComputeShader(gWorkloadListShaderNames[i]);
+		if (mComputeShader[i] == GFX_NULL_HANDLE || mTileListShader[i] == GFX_NULL_HANDLE || mWorkloadShader[i] == GFX_NULL_HANDLE ||
+			mWorkloadListShader[i] == GFX_NULL_HANDLE)
 		{
-			continue;
+			return false;
 		}
-
-		ThrowIfFailed(D3D11CreateDevice(adapter, D3D_DRIVER_TYPE_UNKNOWN, NULL, createDeviceFlags, featureLevels, _countof(featureLevels), D3D11_SDK_VERSION, &mDevice, &createdFeatureLevel, &mImmediateContext));
-		bIntelGPUPresent = true;
-		break;
+	}
+	if (mVertexShader == GFX_NULL_HANDLE || mPixelShader == GFX_NULL_HANDLE)
+	{
+		return false;
 	}
 
-	// If no Intel GPU was found, create a device with the default adapter, but warn the user that 
-	// the Intel UAV Overlap extension will not be useable. 
-	if (mDevice == nullptr)
+	// Create the input layout
+	mStartupTimer.BeginPhase("input layout");
+	mVertexLayout = mDevice->CreateInputLayout(mVertexShader);
+	if (mVertexLayout == GFX_NULL_HANDLE)
 	{
-		MessageBox(mWindow, L"An Intel GPU is required to use the Intel D3D Extension demonstrated in this sample.", L"No Intel GPU Found", MB_ICONERROR);
-		bIntelGPUPresent = false;
+		return false;
+	}
+	mStartupTimer.EndPhase();
+	mStartupTimer.EndPhase();
+
+	mStartupTimer.BeginPhase("resources");
+	mAllocatedWidth = mWidth;
+	mAllocatedHeight = mHeight;
+	mStartupTimer.BeginPhase("sample textures");
+	if (!CreateSampleTextures(mAllocatedWidth, mAllocatedHeight))
+	{
+		return false;
+	}
+	mStartupTimer.EndPhase();
+	mStartupTimer.BeginPhase("tile constant buffers");
+	if (!CreateTileConstantBuffers(mTileGrid.GetTileSize()))
+	{
+		return false;
+	}
+	mStartupTimer.EndPhase();
+	mStartupTimer.BeginPhase("workload source");
+	if (!CreateWorkloadSource())
+	{
+		return false;
+	}
+	mStartupTimer.EndPhase();
+	mStartupTimer.BeginPhase("fullscreen triangle");
+	if (!CreateFullscreenTriangle())
+	{
+		return false;
+	}
+	mStartupTimer.EndPhase();
+	mStartupTimer.EndPhase();
 
-		for (UINT32 i = 0; factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; ++i)
+	// Devices that can only record on the immediate context hand out no deferred contexts; the pass then stays serial
+	mStartupTimer.BeginPhase("deferred contexts");
+	for (uint32_t i = 0; i < mRecordThreadCount; i++)
+	{
+		std::unique_ptr<GfxDeferredContext> context = mDevice->CreateDeferredContext();
+		if (!context)
 		{
-			DXGI_ADAPTER_DESC1 desc;
-			adapter->GetDesc1(&desc);
-
-			ThrowIfFailed(D3D11CreateDevice(adapter, D3D_DRIVER_TYPE_UNKNOWN, NULL, createDeviceFlags, featureLevels, _countof(featureLevels), D3D11_SDK_VERSION, &mDevice, &createdFeatureLevel, &mImmediateContext));
-
+			mDeferredContexts.clear();
 			break;
 		}
+		mDeferredContexts.push_back(std::move(context));
+	}
+	if (!mDeferredContexts.empty())
+	{
+		mRecordPool.reset(new ThreadPool((uint32_t)mDeferredContexts.size()));
+		mRecordTrackers.resize(mDeferredContexts.size());
+		mRecordCommandCounts.resize(mDeferredContexts.size(), 0);
 	}
+	mStartupTimer.EndPhase();
 
-	// Create the swap chain
-	DXGI_SWAP_CHAIN_DESC sd;
-	ZeroMemory(&sd, sizeof(sd));
-	sd.BufferCount = 1;
-	sd.BufferDesc.Width = mWidth;
-	sd.BufferDesc.Height = mHeight;
-	sd.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	sd.BufferDesc.RefreshRate.Numerator = 60;
-	sd.BufferDesc.RefreshRate.Denominator = 1;
-	sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-	sd.OutputWindow = mWindow;
-	sd.SampleDesc.Count = 1;
-	sd.SampleDesc.Quality = 0;
-	sd.Windowed = TRUE;
-
-	ThrowIfFailed(factory->CreateSwapChain(mDevice, &sd, &mSwapChain));
-
-	// Create a render target view to the swap chain back buffer
-	ID3D11Texture2D* backBuffer = NULL;
-	ThrowIfFailed(mSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), (LPVOID*)&backBuffer));
-	ThrowIfFailed(mDevice->CreateRenderTargetView(backBuffer, NULL, &mBackBufferRTV));
-	backBuffer->Release();
-
-	// Setup the viewport
-	mViewPort.Width = (FLOAT)mWidth;
-	mViewPort.Height = (FLOAT)mHeight;
-	mViewPort.MinDepth = 0.0f;
-	mViewPort.MaxDepth = 1.0f;
-	mViewPort.TopLeftX = 0;
-	mViewPort.TopLeftY = 0;
-
-	// Load the pre-compiled shader byte code
-	ThrowIfFailed(D3DReadFileToBlob(L"Shaders/VertexShader.cso", &mVSBlob));
-	ThrowIfFailed(D3DReadFileToBlob(L"Shaders/PixelShader.cso", &mPSBlob));
-	ThrowIfFailed(D3DReadFileToBlob(L"Shaders/ComputeShader.cso", &mCSBlob));
-
-	// Create the shaders used by this sample
-	ThrowIfFailed(mDevice->CreateVertexShader(mVSBlob->GetBufferPointer(), mVSBlob->GetBufferSize(), NULL, &mVertexShader));
-	ThrowIfFailed(mDevice->CreatePixelShader(mPSBlob->GetBufferPointer(), mPSBlob->GetBufferSize(), NULL, &mPixelShader));
-	ThrowIfFailed(mDevice->CreateComputeShader(mCSBlob->GetBufferPointer(), mCSBlob->GetBufferSize(), NULL, &mComputeShader));
-
-	// Define the input layout
-	D3D11_INPUT_ELEMENT_DESC layout[] =
-	{
-		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-	};
-	UINT numElements = ARRAYSIZE(layout);
+	// Initialize IMGUI
+	mStartupTimer.BeginPhase("ui");
+	mStartupTimer.BeginPhase("imgui context");
+	ImGui::CreateContext();
+	mStartupTimer.EndPhase();
+	mStartupTimer.BeginPhase("ui backend");
+	mDevice->InitUI();
+	mStartupTimer.EndPhase();
+	mStartupTimer.EndPhase();
+
+	// Pass timing is informational; without queries the Performance window just shows zeros
+	mStartupTimer.BeginPhase("pass timer");
+	mPassTimer.Init(mDevice, PASS_COUNT);
+	mStartupTimer.EndPhase();
+
+	mDevice->SetStartupTimer(nullptr);
+	return true;
+}
 
-	// Create the input layout
-	ThrowIfFailed(mDevice->CreateInputLayout(layout, numElements, mVSBlob->GetBufferPointer(), mVSBlob->GetBufferSize(), &mVertexLayout));
-
-	// Set the input layout
-	mImmediateContext->IASetInputLayout(mVertexLayout);
-
-	D3D11_TEXTURE2D_DESC sampleTextureDesc;
-	sampleTextureDesc.Width = mWidth;
-	sampleTextureDesc.Height = mHeight;
-	sampleTextureDesc.MipLevels = 1;
-	sampleTextureDesc.ArraySize = 1;
-	sampleTextureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	sampleTextureDesc.SampleDesc.Count = 1;
-	sampleTextureDesc.SampleDesc.Quality = 0;
-	sampleTextureDesc.Usage = D3D11_USAGE_DEFAULT;
-	sampleTextureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
-	sampleTextureDesc.CPUAccessFlags = 0;
-	sampleTextureDesc.MiscFlags = 0;
-
-	D3D11_SHADER_RESOURCE_VIEW_DESC sampleSRVDesc;
-	sampleSRVDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	sampleSRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-	sampleSRVDesc.Texture2D.MostDetailedMip = 0;
-	sampleSRVDesc.Texture2D.MipLevels = 1;
-
-	D3D11_UNORDERED_ACCESS_VIEW_DESC sampleUAVDesc;
-	sampleUAVDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	sampleUAVDesc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
-	sampleUAVDesc.Texture2D.MipSlice = 0;
-
-	ID3D11Texture2D* sampleTexture = 0;
-	ThrowIfFailed(mDevice->CreateTexture2D(&sampleTextureDesc, 0, &sampleTexture));
-	ThrowIfFailed(mDevice->CreateShaderResourceView(sampleTexture, &sampleSRVDesc, &mSampleSRV));
-	ThrowIfFailed(mDevice->CreateUnorderedAccessView(sampleTexture, &sampleUAVDesc, &mSampleUAV));
-
-	sampleTexture->Release();
-
-	D3D11_BUFFER_DESC desc;
-	desc.Usage = D3D11_USAGE_IMMUTABLE;
-	desc.ByteWidth = ((sizeof(ConstantBuffer) + 15) & ~15);
-	desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	desc.CPUAccessFlags = 0;
-	desc.MiscFlags = 0;
-	desc.StructureByteStride = 0;
-
-	uint32_t numDispatchesX = mWidth / 16;
-	uint32_t numDispatchesY = mHeight / 16;
-
-	for (uint32_t x = 0; x < numDispatchesX; x++)
-	{
-		for (uint32_t y = 0; y < numDispatchesY; y++)
+bool UAVOverlapSampleApp::CreateSampleTextures(uint32_t width, uint32_t height)
+{
+	for (uint32_t i = 0; i < mFramePacer.GetFramesInFlight(); i++)
+	{
+		mSampleTexture[i] = mDevice->CreateTexture2D(width, height, GFX_BIND_SHADER_RESOURCE | GFX_BIND_UNORDERED_ACCESS);
+		mSampleSRV[i] = mDevice->CreateShaderResourceView(mSampleTexture[i]);
+		mSampleUAV[i] = mDevice->CreateUnorderedAccessView(mSampleTexture[i]);
+		if (mSampleSRV[i] == GFX_NULL_HANDLE || mSampleUAV[i] == GFX_NULL_HANDLE)
 		{
-			ConstantBuffer cbuffer = {};
-			cbuffer.dispatchX = x;
-			cbuffer.dispatchY = y;
-			cbuffer.windowWidth = mWidth;
-			cbuffer.windowHeight = mHeight;
-
-			D3D11_SUBRESOURCE_DATA initialData = {};
-			initialData.pSysMem = &cbuffer;
-
-			ThrowIfFailed(mDevice->CreateBuffer(&desc, &initialData, &mConstantBuffer[(x * numDispatchesY) + y]));
+			return false;
 		}
 	}
+	return true;
+}
 
-	// Create vertex and index buffers for a fullscreen triangle
-	SimpleVertex vertices[3];
+void UAVOverlapSampleApp::ReleaseSampleTextures()
+{
+	for (uint32_t i = 0; i < GFX_MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		mDevice->Release(mSampleUAV[i]);
+		mDevice->Release(mSampleSRV[i]);
+		mDevice->Release(mSampleTexture[i]);
+		mSampleUAV[i] = mSampleSRV[i] = mSampleTexture[i] = GFX_NULL_HANDLE;
+	}
+}
 
-	vertices[0].position = DirectX::XMFLOAT3(-1.0f, -3.0f, 0.0f);
-	vertices[1].position = DirectX::XMFLOAT3(-1.0f, +1.0f, 0.0f);
-	vertices[2].position = DirectX::XMFLOAT3(+3.0f, +1.0f, 0.0f);
+bool UAVOverlapSampleApp::CreateFullscreenTriangle()
+{
+	// Texture coordinates run to 2 at the vertices off screen, so 1 lands on the screen edge. Scaling them by the part
+	// of the pooled textures in use keeps pixel centers on texel centers.
+	float uScale = 2.0f * (float)mWidth / (float)mAllocatedWidth;
+	float vScale = 2.0f * (float)mHeight / (float)mAllocatedHeight;
+	SimpleVertex vertices[3] =
+	{
+		{ { -1.0f, -3.0f, 0.0f }, { 0.0f, vScale } },
+		{ { -1.0f, +1.0f, 0.0f }, { 0.0f, 0.0f } },
+		{ { +3.0f, +1.0f, 0.0f }, { uScale, 0.0f } }
+	};
 
-	vertices[0].uv = DirectX::XMFLOAT2(0.0f, 2.0f);
-	vertices[1].uv = DirectX::XMFLOAT2(0.0f, 0.0f);
-	vertices[2].uv = DirectX::XMFLOAT2(2.0f, 0.0f);
+	mVertexBuffer = mDevice->CreateVertexBuffer(vertices, sizeof(vertices));
+	return mVertexBuffer != GFX_NULL_HANDLE;
+}
 
-	D3D11_BUFFER_DESC vertexBufferDesc;
-	ZeroMemory(&vertexBufferDesc, sizeof(vertexBufferDesc));
-	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	vertexBufferDesc.ByteWidth = sizeof(SimpleVertex) * 3;
-	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vertexBufferDesc.CPUAccessFlags = 0;
+bool UAVOverlapSampleApp::CreateWorkloadSource()
+{
+	// The texture the workload shaders read from t1 holds the sample's gradient, written once here by a batched dispatch
+	mWorkloadSource = mDevice->CreateTexture2D(mWidth, mHeight, GFX_BIND_SHADER_RESOURCE | GFX_BIND_UNORDERED_ACCESS);
+	mWorkloadSourceSRV = mDevice->CreateShaderResourceView(mWorkloadSource);
+	GfxView sourceUAV = mDevice->CreateUnorderedAccessView(mWorkloadSource);
+	if (mWorkloadSourceSRV == GFX_NULL_HANDLE || sourceUAV == GFX_NULL_HANDLE)
+	{
+		mDevice->Release(sourceUAV);
+		return false;
+	}
 
-	D3D11_SUBRESOURCE_DATA initDataVB;
-	ZeroMemory(&initDataVB, sizeof(initDataVB));
-	initDataVB.pSysMem = vertices;
+	mDevice->CSSetShader(mComputeShader[TileSizeIndex(mTileGrid.GetTileSize())]);
+	mDevice->CSSetUnorderedAccessView(0, sourceUAV);
+	mDevice->CSSetConstantBuffer(0, mBatchedConstantBuffer);
+	mDevice->Dispatch(mTileGrid.GetTilesX(), mTileGrid.GetTilesY(), 1);
+	mDevice->CSSetShader(GFX_NULL_HANDLE);
+	mDevice->CSSetUnorderedAccessView(0, GFX_NULL_HANDLE);
+	mDevice->CSSetConstantBuffer(0, GFX_NULL_HANDLE);
+	mDevice->Release(sourceUAV);
+	return true;
+}
 
-	ThrowIfFailed(mDevice->CreateBuffer(&vertexBufferDesc, &initDataVB, &mVertexBuffer));
+bool UAVOverlapSampleApp::Resize(uint32_t width, uint32_t height)
+{
+	ResizePlan plan = PlanResize(mWidth, mHeight, mAllocatedWidth, mAllocatedHeight, width, height);
+	if (width == 0 || height == 0 || !plan.bResizeBuffers)
+	{
+		return true;
+	}
 
-	// Initialize IMGUI
-	ImGui::CreateContext();
-	ImGuiIO& io = ImGui::GetIO();
+	std::chrono::steady_clock::time_point resizeStart = std::chrono::steady_clock::now();
 
-	ImGui_ImplWin32_Init(mWindow);
-	ImGui_ImplDX11_Init(mDevice, mImmediateContext);
+	// Frames in flight may still be reading everything that is about to be released or written at the new size
+	mFramePacer.Flush();
+	if (!mDevice->ResizeBuffers(width, height))
+	{
+		return false;
+	}
+	mBackBufferRTV = mDevice->GetBackBufferRTV();
+	mWidth = width;
+	mHeight = height;
+	mAllocatedWidth = plan.allocatedWidth;
+	mAllocatedHeight = plan.allocatedHeight;
 
-	// Initialize the Intel Driver Extensions Framework for use of the UAV Overlap extension
-	if (bIntelGPUPresent == true)
+	if (plan.bReallocateTextures)
+	{
+		ReleaseSampleTextures();
+		if (!CreateSampleTextures(mAllocatedWidth, mAllocatedHeight))
+		{
+			return false;
+		}
+	}
+	if (plan.bUpdateTexCoords)
+	{
+		mDevice->Release(mVertexBuffer);
+		if (!CreateFullscreenTriangle())
+		{
+			return false;
+		}
+	}
+	if (plan.bRebuildTiles && !CreateTileConstantBuffers(mTileGrid.GetTileSize()))
 	{
-		bUAVOverlapSupported = InitIntelExtensions();
+		return false;
 	}
-	else
+	if (plan.bRebuildSource)
 	{
-		bUAVOverlapSupported = false;
+		mDevice->Release(mWorkloadSourceSRV);
+		mDevice->Release(mWorkloadSource);
+		if (!CreateWorkloadSource())
+		{
+			return false;
+		}
 	}
 
-	return S_OK;
+	mResizeReport.Record(plan, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - resizeStart).count());
+	return true;
 }
 
 void UAVOverlapSampleApp::Cleanup()
 {
-	// Shutdown IMGUI
-	ImGui_ImplDX11_Shutdown();
-	ImGui_ImplWin32_Shutdown();
-	ImGui::DestroyContext();
+	mDevice->SetStartupTimer(nullptr);
+
+	if (!mFrameStatsPath.empty() && mFrameTimeHistogram.GetSummary().count > 0 && !mFrameTimeHistogram.WriteFile(mFrameStatsPath.c_str()))
+	{
+		fprintf(stderr, "Failed to write %s\n", mFrameStatsPath.c_str());
+	}
+
+	mRecordPool.reset();
+	mDeferredContexts.clear();
+	mRecordTrackers.clear();
+	mRecordCommandCounts.clear();
+
+	ReleaseTileConstantBuffers();
+	mPassTimer.Release();
+
+	GfxHandle handles[] = { mWorkloadSourceSRV, mWorkloadSource, mVertexBuffer, mVertexLayout, mVertexShader, mPixelShader };
+	for (GfxHandle handle : handles)
+	{
+		mDevice->Release(handle);
+	}
+	ReleaseSampleTextures();
+	for (uint32_t i = 0; i < NUM_TILE_SIZES; i++)
+	{
+		mDevice->Release(mComputeShader[i]);
+		mDevice->Release(mTileListShader[i]);
+		mDevice->Release(mWorkloadShader[i]);
+		mDevice->Release(mWorkloadListShader[i]);
+		mComputeShader[i] = mTileListShader[i] = mWorkloadShader[i] = mWorkloadListShader[i] = GFX_NULL_HANDLE;
+	}
+	mWorkloadSourceSRV = mWorkloadSource = mVertexBuffer = mVertexLayout = mVertexShader = mPixelShader = GFX_NULL_HANDLE;
 
-	// Release the resources used by the framework
-	if (!SUCCEEDED(INTC_DestroyDeviceExtensionContext(&mINTCExtensionContext)))
+	// Shutdown IMGUI
+	if (ImGui::GetCurrentContext() != nullptr)
 	{
-		INTC_UnloadExtensionsLibrary();
-		throw std::exception("Failed to destroy INTC_DEVICEEXTENSIONCONTEXT");
+		mDevice->ShutdownUI();
+		ImGui::DestroyContext();
 	}
 
-	// Unload the extensions library
-	INTC_UnloadExtensionsLibrary();
+	mDevice->Cleanup();
 }
 
 void UAVOverlapSampleApp::Render(double frameTime)
 {
-	ImGui_ImplDX11_NewFrame();
-	ImGui_ImplWin32_NewFrame();
+	// Waits, if it has to, until the device is done with the sample texture this frame is about to write
+	mFrameSet = mFramePacer.BeginFrame();
+
+	// Every frame goes into the histogram; frameTime is whatever average the caller chose to display
+	uint64_t frameIntervalNs = mFrameTimer.Tick();
+	if (frameIntervalNs > 0)
+	{
+		mFrameTimeHistogram.Record(frameIntervalNs);
+	}
+
+	mDevice->NewUIFrame();
 	ImGui::NewFrame();
 
 	// IMGUI Performance Window
 	{
+		FrameTimeHistogram::Summary rolling = mFrameTimeHistogram.GetRollingSummary();
+		FramePacer::Report pacing = mFramePacer.GetReport();
+		uint32_t graphCount = mFrameTimeHistogram.GetHistoryMs(mFrameTimeGraph, FrameTimeHistogram::HISTORY_SIZE);
+
 		ImGui::Begin("Performance", 0, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
 		ImGui::SetWindowPos(ImVec2(0, 0));
-		ImGui::SetWindowSize(ImVec2(250, 75));
+		ImGui::SetWindowSize(ImVec2(250, 294));
 		ImGui::Text("Frame Time: %lf ms", frameTime);
 		ImGui::Text("FPS       : %lf fps", 1000 / frameTime);
+		ImGui::Text("Compute   : %.3f ms", mPassTimer.GetAveragePassMs(PASS_COMPUTE));
+		ImGui::Text("Composite : %.3f ms", mPassTimer.GetAveragePassMs(PASS_COMPOSITE));
+		ImGui::Text("p50/95/99 : %.2f / %.2f / %.2f ms", rolling.p50Ms, rolling.p95Ms, rolling.p99Ms);
+		ImGui::Text("Min/Max   : %.2f / %.2f ms", rolling.minMs, rolling.maxMs);
+		ImGui::Text("Latency   : %.2f ms, %u in flight", pacing.latency.meanMs, pacing.framesInFlight);
+		ImGui::Text("Resize    : %.2f ms, %u done", mResizeReport.GetLastMs(), mResizeReport.GetCount());
+		ImGui::PlotLines("##FrameTimes", mFrameTimeGraph, (int)graphCount, 0, "last 256 frames", 0.0f, (float)rolling.maxMs * 1.25f, ImVec2(234, 60));
+		ImGui::Text("CS Cmds   : %u", mComputeCounters.commandCount);
+		ImGui::Text("CS Submit : %lf ms", mComputeCounters.submissionTimeMs);
 		ImGui::End();
 	}
 
 	// IMGUI Sample Settings Window
 	{
 		ImGui::Begin("Settings", 0, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
-		ImGui::SetWindowPos(ImVec2(0, 75));
-		ImGui::SetWindowSize(ImVec2(250, 100));
+		ImGui::SetWindowPos(ImVec2(0, 294));
+		ImGui::SetWindowSize(ImVec2(250, 244));
 		ImGui::Text("UAV Overlap Extension");
 
-		int enableButtonValue = bUseUAVOverlapExtension ? 1 : 0;
+		int enableButtonValue = bUseUAVOverlapExtension ? (bAutoUAVOverlap ? 2 : 1) : 0;
 		ImGui::RadioButton("Disabled", (int*)&enableButtonValue, 0);
 
-		// If not running on an Intel GPU, disable the button that would enable use of the UAV Overlap extension
+		// If the device cannot overlap dispatches (e.g. D3D11 without an Intel GPU), disable the button that would enable it
 		// IMGUI does this by push an item flag and a style var, then popping after the radio button
-		if (bIntelGPUPresent == false)
+		bool overlapSupported = mDevice->IsUAVOverlapSupported();
+		if (overlapSupported == false)
 		{
 			ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
 			ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
 		}
 		ImGui::RadioButton("Enabled", (int*)&enableButtonValue, 1);
-		if (bIntelGPUPresent == false)
+		ImGui::SameLine();
+		ImGui::RadioButton("Automatic", (int*)&enableButtonValue, 2);
+		if (overlapSupported == false)
 		{
 			ImGui::PopItemFlag();
 			ImGui::PopStyleVar();
 		}
 
 		bUseUAVOverlapExtension = (enableButtonValue != 0);
+		bAutoUAVOverlap = (enableButtonValue == 2);
+
+		ImGui::Text("Brackets %u, hazards %u", mLastOverlapStats.bracketCount, mLastOverlapStats.hazardCount);
+
+		ImGui::Text("Dispatch Submission");
+
+		int submissionButtonValue = bUseIndirectDispatch ? 2 : (bUseBatchedDispatch ? 1 : 0);
+		ImGui::RadioButton("Per-tile", (int*)&submissionButtonValue, 0);
+		ImGui::RadioButton("Batched", (int*)&submissionButtonValue, 1);
+		ImGui::SameLine();
+		ImGui::RadioButton("Indirect", (int*)&submissionButtonValue, 2);
+
+		bUseBatchedDispatch = (submissionButtonValue == 1);
+		bUseIndirectDispatch = (submissionButtonValue == 2);
+
+		ImGui::Text("Tile Size");
+
+		int tileSizeButtonValue = (int)mTileGrid.GetTileSize();
+		ImGui::RadioButton("8x8", &tileSizeButtonValue, 8);
+		ImGui::SameLine();
+		ImGui::RadioButton("16x16", &tileSizeButtonValue, 16);
+		ImGui::SameLine();
+		ImGui::RadioButton("32x32", &tileSizeButtonValue, 32);
+
+		// Presets only; a custom workload from the command line shows up as an extra entry until another is picked
+		std::vector<const char*> workloadNames;
+		int workloadIndex = -1;
+		for (uint32_t i = 0; i < GetComputeWorkloadPresetCount(); i++)
+		{
+			workloadNames.push_back(GetComputeWorkloadPresetName(i));
+			if (GetComputeWorkloadPreset(i) == mWorkload)
+			{
+				workloadIndex = (int)i;
+			}
+		}
+		if (workloadIndex < 0)
+		{
+			workloadIndex = (int)workloadNames.size();
+			workloadNames.push_back("custom");
+		}
+
+		int workloadSelection = workloadIndex;
+		ImGui::Combo("Workload", &workloadSelection, workloadNames.data(), (int)workloadNames.size());
+
+		bool workloadChanged = workloadSelection != workloadIndex;
+		if ((uint32_t)tileSizeButtonValue != mTileGrid.GetTileSize() || workloadChanged)
+		{
+			uint32_t previousTileSize = mTileGrid.GetTileSize();
+			ComputeWorkload previousWorkload = mWorkload;
+			if (workloadChanged)
+			{
+				mWorkload = GetComputeWorkloadPreset((uint32_t)workloadSelection);
+			}
+
+			// Frames in flight may still be reading the buffers that are about to be released, as in Resize(). A failed
+			// rebuild leaves the grid and buffers mismatched, so they are built again with the previous settings. If
+			// that fails too, the grid is emptied so the compute pass dispatches nothing until the next resize.
+			mFramePacer.Flush();
+			if (!CreateTileConstantBuffers((uint32_t)tileSizeButtonValue))
+			{
+				fprintf(stderr, "Failed to rebuild the tile buffers; keeping %ux%u tiles and the previous workload\n", previousTileSize, previousTileSize);
+				mWorkload = previousWorkload;
+				if (!CreateTileConstantBuffers(previousTileSize))
+				{
+					fprintf(stderr, "Failed to restore the tile buffers; the compute pass is disabled\n");
+					ReleaseTileConstantBuffers();
+					mTileGrid.Resize(0, 0, previousTileSize);
+				}
+			}
+		}
 
 		ImGui::End();
 	}
 
+	mPassTimer.BeginFrame();
+
 	/************************************************************************************************
 	 **	Compute Pass                                                                               **
 	 ** By design, each dispatch is guaranteed to write to a unique location within the bound UAV, ** 
 	 **	so it is safe to disable UAV syncs between them.                                           **
 	 ***********************************************************************************************/
 	{
-		// Bind sample compute shader
-		mImmediateContext->CSSetShader(mComputeShader, NULL, 0);
+		// Count every context call made by this pass, and time how long the CPU spends issuing them
+		std::chrono::steady_clock::time_point submitStart = std::chrono::steady_clock::now();
+		uint32_t commandCount = 0;
+
+		// Disable UAV syncs until a call to EndUAVOverlap() is encountered. The hazard tracker issues the brackets:
+		// either one around the whole pass, trusting that every tile writes a unique location, or in automatic mode
+		// one around each run of dispatches whose tiles it has checked are disjoint.
+		UAVOverlapMode overlapMode = UAV_OVERLAP_OFF;
+		if (bUseUAVOverlapExtension && mDevice->IsUAVOverlapSupported())
+		{
+			overlapMode = bAutoUAVOverlap ? UAV_OVERLAP_AUTO : UAV_OVERLAP_ALWAYS;
+		}
 
-		// Bind sample texture as a UAV
-		mImmediateContext->CSSetUnorderedAccessViews(0, 1, &mSampleUAV, 0);
+		// The sample compute shader variant matching the current tile size, reading its tiles from the tile list when
+		// the pass is a single indirect dispatch. A workload swaps in the same variant of the workload shader.
+		uint32_t tileSizeIndex = TileSizeIndex(mTileGrid.GetTileSize());
+		bool useWorkload = IsComputeWorkloadEnabled(mWorkload);
+		GfxShader computeShader = bUseIndirectDispatch ? mTileListShader[tileSizeIndex] : mComputeShader[tileSizeIndex];
+		if (useWorkload)
+		{
+			computeShader = bUseIndirectDispatch ? mWorkloadListShader[tileSizeIndex] : mWorkloadShader[tileSizeIndex];
+		}
 
-		// Disable UAV syncs until a call to D3D11EndUAVOverlap() is encountered
-		if (bUseUAVOverlapExtension && bUAVOverlapSupported)
+		if (mTileGrid.GetTileCount() == 0)
 		{
-			INTC_D3D11_BeginUAVOverlap(mINTCExtensionContext);
+			// The tile buffers could not be rebuilt from the Settings window, so there is nothing to dispatch
+			mComputeCounters.recordTimeMs = 0.0;
 		}
+		else if (!mDeferredContexts.empty() && !bUseBatchedDispatch && !bUseIndirectDispatch)
+		{
+			commandCount = SubmitComputePassDeferred(computeShader, overlapMode);
+		}
+		else
+		{
+			mComputeCounters.recordTimeMs = 0.0;
 
-		// Compute the number of dispatches needed to touch every pixel on screen, 
-		// knowing that the sample compute shader runs a 16x16x1 thread group
-		uint32_t numDispatchesX = mWidth / 16;
-		uint32_t numDispatchesY = mHeight / 16;
+			// Bind the sample compute shader
+			mDevice->CSSetShader(computeShader);
+			commandCount++;
 
-		for (uint32_t x = 0; x < numDispatchesX; x++)
-		{
-			for (uint32_t y = 0; y < numDispatchesY; y++)
-			{
-				// Bind the sample constant buffer
-				mImmediateContext->CSSetConstantBuffers(0, 1, &mConstantBuffer[(x * numDispatchesY) + y]);
+			// Bind sample texture as a UAV
+			mDevice->CSSetUnorderedAccessView(0, mSampleUAV[mFrameSet]);
+			commandCount++;
 
-				mImmediateContext->Dispatch(1, 1, 1);
+			// The workload shaders read the source texture as t1; it is never written after Init
+			if (useWorkload)
+			{
+				mDevice->CSSetShaderResource(1, mWorkloadSourceSRV);
+				commandCount++;
 			}
-		}
 
-		// Re-enable UAV syncs
-		if (bUseUAVOverlapExtension && bUAVOverlapSupported)
-		{
-			INTC_D3D11_EndUAVOverlap(mINTCExtensionContext);
-		}
+			commandCount += mHazardTracker.BeginPass(mDevice, overlapMode, mWidth, mHeight);
+
+			// The tile grid holds the number of dispatches needed to touch every pixel on screen,
+			// rounded up so partially covered edge tiles are still dispatched
+			uint32_t numDispatchesX = mTileGrid.GetTilesX();
+			uint32_t numDispatchesY = mTileGrid.GetTilesY();
+
+			if (bUseIndirectDispatch)
+			{
+				// One command for the whole tile list: the group counts come from the argument buffer, and each group
+				// looks its tile up in the list bound as t0. The tiles cover the frame, so the footprint is all of it.
+				mDevice->CSSetShaderResource(0, mTileListSRV);
+				mDevice->CSSetConstantBuffer(0, mBatchedConstantBuffer);
+				UAVFootprint footprint = { 0, 0, mWidth, mHeight };
+				commandCount += 2 + mHazardTracker.DispatchIndirect(footprint, mIndirectArguments, 0);
+			}
+			else if (bUseBatchedDispatch)
+			{
+				// One dispatch covers the whole frame; each thread group finds its tile through SV_GroupID
+				mDevice->CSSetConstantBuffer(0, mBatchedConstantBuffer);
+				UAVFootprint footprint = { 0, 0, mWidth, mHeight };
+				commandCount += 1 + mHazardTracker.Dispatch(footprint, numDispatchesX, numDispatchesY, 1);
+			}
+			else
+			{
+				for (uint32_t x = 0; x < numDispatchesX; x++)
+				{
+					for (uint32_t y = 0; y < numDispatchesY; y++)
+					{
+						// Bind the sample constant buffer, and declare the pixels of the tile it points the dispatch at
+						uint32_t tileIndex = mTileGrid.GetTileIndex(x, y);
+						mDevice->CSSetConstantBuffer(0, mConstantBuffer[tileIndex]);
+
+						TileGrid::Tile tile = mTileGrid.GetTile(tileIndex);
+						UAVFootprint footprint = { tile.x, tile.y, tile.x + tile.width, tile.y + tile.height };
+						commandCount += 1 + mHazardTracker.Dispatch(footprint, 1, 1, 1);
+					}
+				}
+			}
 
-		// Unbind the sample compute shader
-		mImmediateContext->CSSetShader(NULL, NULL, 0);
+			// Re-enable UAV syncs
+			commandCount += mHazardTracker.EndPass();
+			mLastOverlapStats = mHazardTracker.GetLastPassStats();
 
-		// Unbind the sample texture that was bound as a UAV
-		ID3D11UnorderedAccessView* nullUAV[1] = { NULL };
-		mImmediateContext->CSSetUnorderedAccessViews(0, 1, nullUAV, 0);
+			// Unbind the sample compute shader, the sample texture that was bound as a UAV, and the sample constant buffer
+			mDevice->CSSetShader(GFX_NULL_HANDLE);
+			mDevice->CSSetUnorderedAccessView(0, GFX_NULL_HANDLE);
+			mDevice->CSSetConstantBuffer(0, GFX_NULL_HANDLE);
+			commandCount += 3;
+			if (bUseIndirectDispatch)
+			{
+				mDevice->CSSetShaderResource(0, GFX_NULL_HANDLE);
+				commandCount++;
+			}
+			if (useWorkload)
+			{
+				mDevice->CSSetShaderResource(1, GFX_NULL_HANDLE);
+				commandCount++;
+			}
+		}
 
-		// Unbind the sample constant buffer
-		ID3D11Buffer* nullBuffer[1] = { NULL };
-		mImmediateContext->CSSetConstantBuffers(0, 1, nullBuffer);
+		std::chrono::duration<double, std::milli> submitTime = std::chrono::steady_clock::now() - submitStart;
+		mComputeCounters.commandCount = commandCount;
+		mComputeCounters.submissionTimeMs = submitTime.count();
 	}
 
+	mPassTimer.EndPass(PASS_COMPUTE);
+
 	/***************************************************************************************************
 	 **	Render Fullscreen Triangle                                                                    **
 	 **	The UAV that was written in the previous compute pass is now bound as an SRV and sampled from **
@@ -393,40 +714,128 @@ void UAVOverlapSampleApp::Render(double frameTime)
 	{
 		// Clear the back buffer. No depth buffer is used in this sample.
 		float ClearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-		mImmediateContext->ClearRenderTargetView(mBackBufferRTV, ClearColor);
-		mImmediateContext->OMSetRenderTargets(1, &mBackBufferRTV, NULL);
+		mDevice->ClearRenderTargetView(mBackBufferRTV, ClearColor);
+		mDevice->OMSetRenderTarget(mBackBufferRTV);
 
-		mImmediateContext->RSSetViewports(1, &mViewPort);
+		mDevice->RSSetViewport((float)mWidth, (float)mHeight);
 
-		mImmediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-		// Bind the geometry buffers for the fullscreen triangle
-		UINT stride = sizeof(SimpleVertex);
-		UINT offset = 0;
-		mImmediateContext->IASetVertexBuffers(0, 1, &mVertexBuffer, &stride, &offset);
+		// Bind the input layout and geometry buffers for the fullscreen triangle. Executing a command list unbinds
+		// everything, so the layout is set every frame rather than once at Init.
+		mDevice->IASetInputLayout(mVertexLayout);
+		mDevice->IASetVertexBuffer(0, mVertexBuffer, sizeof(SimpleVertex), 0);
 
 		// Bind simple vertex and pixel shaders
-		mImmediateContext->VSSetShader(mVertexShader, NULL, 0);
-		mImmediateContext->PSSetShader(mPixelShader, NULL, 0);
+		mDevice->VSSetShader(mVertexShader);
+		mDevice->PSSetShader(mPixelShader);
 
 		// Bind the sample texture (written in the previous compute pass) as an SRV
-		mImmediateContext->PSSetShaderResources(0, 1, &mSampleSRV);
+		mDevice->PSSetShaderResource(0, mSampleSRV[mFrameSet]);
 
 		// Draw the fullscreen triangle
-		mImmediateContext->Draw(3, 0);
+		mDevice->Draw(3, 0);
 
 		// Unbind the simple vertex and pixel shaders
-		mImmediateContext->VSSetShader(NULL, NULL, 0);
-		mImmediateContext->PSSetShader(NULL, NULL, 0);
+		mDevice->VSSetShader(GFX_NULL_HANDLE);
+		mDevice->PSSetShader(GFX_NULL_HANDLE);
 
 		// Unbind the sample texture as an SRV (it will get bound as a UAV again next frame)
-		ID3D11ShaderResourceView* nullSRV[1] = { NULL };
-		mImmediateContext->PSSetShaderResources(0, 1, nullSRV);
+		mDevice->PSSetShaderResource(0, GFX_NULL_HANDLE);
 
 		// Render IMGUI
 		ImGui::Render();
-		ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+		mDevice->RenderUI(ImGui::GetDrawData());
 	}
 
-	mSwapChain->Present(0, 0);
+	mPassTimer.EndPass(PASS_COMPOSITE);
+	mPassTimer.EndFrame();
+
+	mFramePacer.Present();
 }
+
+uint32_t UAVOverlapSampleApp::SubmitComputePassDeferred(GfxShader computeShader, UAVOverlapMode overlapMode)
+{
+	std::chrono::steady_clock::time_point recordStart = std::chrono::steady_clock::now();
+
+	// Each context records a contiguous range of the serial loop's dispatch order, so executing the lists in context
+	// order issues the same dispatches in the same order
+	uint32_t contextCount = (uint32_t)mDeferredContexts.size();
+	uint32_t dispatchCount = mTileGrid.GetTilesX() * mTileGrid.GetTilesY();
+	for (uint32_t i = 0; i < contextCount; i++)
+	{
+		uint32_t begin = (uint32_t)((uint64_t)dispatchCount * i / contextCount);
+		uint32_t end = (uint32_t)((uint64_t)dispatchCount * (i + 1) / contextCount);
+		mRecordPool->Submit([this, i, begin, end, computeShader, overlapMode]()
+		{
+			mRecordCommandCounts[i] = RecordTileRange(i, begin, end, computeShader, overlapMode);
+		});
+	}
+	mRecordPool->Wait();
+
+	std::chrono::duration<double, std::milli> recordTime = std::chrono::steady_clock::now() - recordStart;
+	mComputeCounters.recordTimeMs = recordTime.count();
+
+	// Merge: the lists run back to back on the immediate context, which is left with nothing bound
+	uint32_t commandCount = 0;
+	mLastOverlapStats = {};
+	for (uint32_t i = 0; i < contextCount; i++)
+	{
+		mDevice->ExecuteCommandList(mDeferredContexts[i].get());
+		commandCount += mRecordCommandCounts[i] + 1;
+
+		const UAVHazardTracker::PassStats& stats = mRecordTrackers[i].GetLastPassStats();
+		mLastOverlapStats.dispatchCount += stats.dispatchCount;
+		mLastOverlapStats.hazardCount += stats.hazardCount;
+		mLastOverlapStats.bracketCount += stats.bracketCount;
+		mLastOverlapStats.longestRun = stats.longestRun > mLastOverlapStats.longestRun ? stats.longestRun : mLastOverlapStats.longestRun;
+	}
+
+	return commandCount;
+}
+
+uint32_t UAVOverlapSampleApp::RecordTileRange(uint32_t contextIndex, uint32_t begin, uint32_t end, GfxShader computeShader, UAVOverlapMode overlapMode)
+{
+	GfxDeferredContext* context = mDeferredContexts[contextIndex].get();
+	UAVHazardTracker& tracker = mRecordTrackers[contextIndex];
+
+	// A deferred context starts every list with nothing bound
+	context->CSSetShader(computeShader);
+	context->CSSetUnorderedAccessView(0, mSampleUAV[mFrameSet]);
+	uint32_t commandCount = 2;
+	if (IsComputeWorkloadEnabled(mWorkload))
+	{
+		context->CSSetShaderResource(1, mWorkloadSourceSRV);
+		commandCount++;
+	}
+
+	// Each list brackets its own runs, and the bracket closes before the list ends, so lists never overlap each other.
+	// Contexts that cannot record the brackets sync between every dispatch.
+	commandCount += tracker.BeginPass(context, context->IsUAVOverlapSupported() ? overlapMode : UAV_OVERLAP_OFF, mWidth, mHeight);
+
+	// Dispatch k of the serial loop, which walks the grid column by column
+	uint32_t numDispatchesY = mTileGrid.GetTilesY();
+	for (uint32_t k = begin; k < end; k++)
+	{
+		uint32_t tileIndex = mTileGrid.GetTileIndex(k / numDispatchesY, k % numDispatchesY);
+		context->CSSetConstantBuffer(0, mConstantBuffer[tileIndex]);
+
+		TileGrid::Tile tile = mTileGrid.GetTile(tileIndex);
+		UAVFootprint footprint = { tile.x, tile.y, tile.x + tile.width, tile.y + tile.height };
+		commandCount += 1 + tracker.Dispatch(footprint, 1, 1, 1);
+	}
+
+	commandCount += tracker.EndPass();
+
+	context->FinishCommandList();
+	return commandCount + 1;
+}
+
+bool UAVOverlapSampleApp::WriteFrameToPPM(const char* path)
+{
+	std::vector<uint32_t> texels;
+	if (!mDevice->ReadBackBuffer(texels))
+	{
+		return false;
+	}
+
+	return WriteRGBA8ToPPM(path, texels.data(), mWidth, mHeight, mWidth);
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*************************************************************************
+ **	Name:        UIPipeline.cpp                                         **
+ **	Description: ImGui draw data walk with an owned-pipeline bind cache **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com           **
+ **	Published:   <insert date>                                          **
+ ************************************************************************/
+
+#include "UIPipeline.h"
+
+#include "imgui.h"
+
+bool UIBinding::operator==(const UIBinding& other) const
+{
+	return object == other.object && rect[0] == other.rect[0] && rect[1] == other.rect[1] && rect[2] == other.rect[2] && rect[3] == other.rect[3];
+}
+
+UIPipelineRenderer::UIPipelineRenderer() :
+	bOwnedPipeline(false),
+	mKnownSlots(0)
+{
+	for (uint32_t slot = 0; slot < UI_SLOT_COUNT; slot++)
+	{
+		mBound[slot] = UIBinding();
+	}
+	mCounters = UIPipelineCounters();
+}
+
+void UIPipelineRenderer::SetOwnedPipeline(bool owned)
+{
+	bOwnedPipeline = owned;
+	mKnownSlots = 0;
+}
+
+void UIPipelineRenderer::Invalidate(uint32_t slotMask)
+{
+	mKnownSlots &= ~slotMask;
+}
+
+void UIPipelineRenderer::Bind(UIPipelineSlot slot, const UIBinding& binding, UIPipelineContext& context)
+{
+	if (bOwnedPipeline && (mKnownSlots & UI_SLOT_BIT(slot)) != 0 && mBound[slot] == binding)
+	{
+		mCounters.skippedBinds++;
+		return;
+	}
+	context.Bind(slot, binding);
+	mBound[slot] = binding;
+	mKnownSlots |= UI_SLOT_BIT(slot);
+	mCounters.issuedCalls++;
+}
+
+void UIPipelineRenderer::SetupRenderState(const ImDrawData* drawData, const void* const objects[UI_SLOT_COUNT], UIPipelineContext& context)
+{
+	UIBinding viewport = { nullptr, { 0, 0, (int32_t)drawData->DisplaySize.x, (int32_t)drawData->DisplaySize.y } };
+	Bind(UI_SLOT_VIEWPORT, viewport, context);
+
+	for (uint32_t slot = UI_SLOT_INPUT_LAYOUT; slot <= UI_SLOT_RASTERIZER_STATE; slot++)
+	{
+		UIBinding binding = { objects[slot], { 0, 0, 0, 0 } };
+		Bind((UIPipelineSlot)slot, binding, context);
+	}
+}
+
+void UIPipelineRenderer::Render(const ImDrawData* drawData, const void* const objects[UI_SLOT_COUNT], uint32_t vertexOffset, uint32_t indexOffset, UIPipelineContext& context)
+{
+	mCounters = UIPipelineCounters();
+
+	// Without the pipeline nothing is known about what the context holds, before or after the frame
+	if (bOwnedPipeline)
+	{
+		mCounters.skippedRoundTripCalls += context.GetStateRoundTripCallCount();
+	}
+	else
+	{
+		mKnownSlots = 0;
+		context.BackupState();
+		mCounters.issuedCalls += context.GetStateRoundTripCallCount();
+	}
+
+	SetupRenderState(drawData, objects, context);
+
+	// The command lists are packed one after the other from the offsets
+	uint32_t globalIndexOffset = indexOffset;
+	int32_t globalVertexOffset = (int32_t)vertexOffset;
+	ImVec2 clipOffset = drawData->DisplayPos;
+	for (int n = 0; n < drawData->CmdListsCount; n++)
+	{
+		const ImDrawList* commandList = drawData->CmdLists[n];
+		for (int i = 0; i < commandList->CmdBuffer.Size; i++)
+		{
+			const ImDrawCmd* command = &commandList->CmdBuffer[i];
+			if (command->UserCallback == ImDrawCallback_ResetRenderState)
+			{
+				SetupRenderState(drawData, objects, context);
+			}
+			else if (command->UserCallback != nullptr)
+			{
+				command->UserCallback(commandList, command);
+				Invalidate();
+			}
+			else
+			{
+				UIBinding scissor = { nullptr, { (int32_t)(command->ClipRect.x - clipOffset.x), (int32_t)(command->ClipRect.y - clipOffset.y),
+					(int32_t)(command->ClipRect.z - clipOffset.x), (int32_t)(command->ClipRect.w - clipOffset.y) } };
+				UIBinding texture = { command->TextureId, { 0, 0, 0, 0 } };
+				Bind(UI_SLOT_SCISSOR_RECT, scissor, context);
+				Bind(UI_SLOT_PS_TEXTURE, texture, context);
+				context.DrawIndexed(command->ElemCount, command->IdxOffset + globalIndexOffset, (int32_t)command->VtxOffset + globalVertexOffset);
+				mCounters.issuedCalls++;
+			}
+		}
+		globalIndexOffset += (uint32_t)commandList->IdxBuffer.Size;
+		globalVertexOffset += commandList->VtxBuffer.Size;
+	}
+
+	if (!bOwnedPipeline)
+	{
+		context.RestoreState();
+	}
+}
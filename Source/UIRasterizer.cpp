@@ -0,0 +1,393 @@
+/******************************************************************************************
+ **	Name:        UIRasterizer.cpp                                                        **
+ **	Description: Tiled, multithreaded ImGui triangle rasterizer with SSE2 edge functions **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                            **
+ **	Published:   <insert date>                                                           **
+ *****************************************************************************************/
+
+#include "UIRasterizer.h"
+#include "GradientKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "imgui.h"
+
+// SSE2 is part of every x64 target, so unlike the wide gradient kernels this needs no per-function target
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UI_RASTERIZER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Keeps float coordinates that are far off screen representable as int32_t
+static int32_t ClampToInt(float value)
+{
+	const float limit = 1073741824.0f;
+	return (int32_t)(value < -limit ? -limit : (value > limit ? limit : value));
+}
+
+void BuildUIFrame(const ImDrawData* drawData, const UITextureResolver& resolveTexture, UIFrame& frame)
+{
+	frame.vertices.clear();
+	frame.commands.clear();
+	if (drawData == nullptr || !drawData->Valid)
+	{
+		return;
+	}
+	frame.vertices.reserve((size_t)drawData->TotalIdxCount);
+
+	// Vertices and scissor rectangles are in display coordinates, which start at DisplayPos
+	ImVec2 offset = drawData->DisplayPos;
+	for (int n = 0; n < drawData->CmdListsCount; n++)
+	{
+		const ImDrawList* list = drawData->CmdLists[n];
+		for (int i = 0; i < list->CmdBuffer.Size; i++)
+		{
+			const ImDrawCmd& command = list->CmdBuffer[i];
+			const CPUTexture2D* texture = (command.UserCallback == nullptr) ? resolveTexture(command.TextureId) : nullptr;
+			if (texture == nullptr || texture->width == 0 || texture->height == 0)
+			{
+				continue;
+			}
+
+			// Truncated like the D3D11_RECT the DX11 backend builds
+			UIDrawCommand out;
+			out.clipX0 = ClampToInt(command.ClipRect.x - offset.x);
+			out.clipY0 = ClampToInt(command.ClipRect.y - offset.y);
+			out.clipX1 = ClampToInt(command.ClipRect.z - offset.x);
+			out.clipY1 = ClampToInt(command.ClipRect.w - offset.y);
+			out.texture = texture;
+			out.firstTriangle = (uint32_t)(frame.vertices.size() / 3);
+			out.triangleCount = command.ElemCount / 3;
+
+			for (uint32_t k = 0; k < out.triangleCount * 3; k++)
+			{
+				const ImDrawVert& vertex = list->VtxBuffer[command.VtxOffset + list->IdxBuffer[command.IdxOffset + k]];
+				UIVertex copy = { vertex.pos.x - offset.x, vertex.pos.y - offset.y, vertex.uv.x, vertex.uv.y, vertex.col };
+				frame.vertices.push_back(copy);
+			}
+			frame.commands.push_back(out);
+		}
+	}
+}
+
+static inline uint32_t Channel(uint32_t packed, uint32_t channel)
+{
+	return (packed >> (8 * channel)) & 0xFF;
+}
+
+// round(x / 255) for x up to 255 * 255
+static inline uint32_t Div255(uint32_t x)
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+// Point sample with wrap addressing
+static uint32_t SampleWrap(const CPUTexture2D& texture, float u, float v)
+{
+	u -= floorf(u);
+	v -= floorf(v);
+	uint32_t x = std::min((uint32_t)(u * texture.width), texture.width - 1);
+	uint32_t y = std::min((uint32_t)(v * texture.height), texture.height - 1);
+	return texture.texels[(size_t)y * texture.width + x];
+}
+
+// Vertex color times texture color at barycentric weights (w0, w1, w2)
+static uint32_t Shade(const UIVertex* vertices, const CPUTexture2D& texture, float w0, float w1, float w2)
+{
+	float u = vertices[0].u * w0 + vertices[1].u * w1 + vertices[2].u * w2;
+	float v = vertices[0].v * w0 + vertices[1].v * w1 + vertices[2].v * w2;
+	uint32_t texel = SampleWrap(texture, u, v);
+
+	uint32_t result = 0;
+	for (uint32_t c = 0; c < 4; c++)
+	{
+		float color = (float)Channel(vertices[0].color, c) * w0 + (float)Channel(vertices[1].color, c) * w1 + (float)Channel(vertices[2].color, c) * w2;
+		result |= FloatToUNorm8(color * (float)Channel(texel, c) * (1.0f / 65025.0f)) << (8 * c);
+	}
+	return result;
+}
+
+// SRC_ALPHA / INV_SRC_ALPHA on color; INV_SRC_ALPHA / ZERO on alpha, so alpha ends up srcAlpha * (1 - srcAlpha)
+static inline uint32_t Blend(uint32_t src, uint32_t dst)
+{
+	uint32_t alpha = src >> 24;
+	uint32_t inverse = 255 - alpha;
+	uint32_t result = Div255(alpha * inverse) << 24;
+	for (uint32_t c = 0; c < 3; c++)
+	{
+		result |= Div255(Channel(src, c) * alpha + Channel(dst, c) * inverse) << (8 * c);
+	}
+	return result;
+}
+
+static inline bool IsInside(float e, bool bTieInside)
+{
+	return e > 0.0f || (e == 0.0f && bTieInside);
+}
+
+UIRasterizer::UIRasterizer(ThreadPool* pool) : mPool(pool), mTilesX(0)
+{
+#ifdef UI_RASTERIZER_SSE2
+	bUseSIMD = true;
+#else
+	bUseSIMD = false;
+#endif
+	mStats = Stats();
+}
+
+void UIRasterizer::SetSIMDEnabled(bool enabled)
+{
+#ifdef UI_RASTERIZER_SSE2
+	bUseSIMD = enabled;
+#else
+	(void)enabled;
+#endif
+}
+
+void UIRasterizer::SetupTriangles(const UIFrame& frame, const CPUTexture2D& target)
+{
+	mTriangles.clear();
+	for (uint32_t tile : mActiveTiles)
+	{
+		mTileBins[tile].clear();
+	}
+	mActiveTiles.clear();
+
+	mTilesX = (target.width + TILE_SIZE - 1) / TILE_SIZE;
+	uint32_t tilesY = (target.height + TILE_SIZE - 1) / TILE_SIZE;
+	if (mTileBins.size() < (size_t)mTilesX * tilesY)
+	{
+		mTileBins.resize((size_t)mTilesX * tilesY);
+	}
+	mStats.binnedCount = 0;
+
+	for (const UIDrawCommand& command : frame.commands)
+	{
+		int32_t clipX0 = std::max(command.clipX0, 0);
+		int32_t clipY0 = std::max(command.clipY0, 0);
+		int32_t clipX1 = std::min(command.clipX1, (int32_t)target.width);
+		int32_t clipY1 = std::min(command.clipY1, (int32_t)target.height);
+		if (clipX0 >= clipX1 || clipY0 >= clipY1)
+		{
+			continue;
+		}
+
+		for (uint32_t i = 0; i < command.triangleCount; i++)
+		{
+			const UIVertex* v = &frame.vertices[3 * (size_t)(command.firstTriangle + i)];
+
+			// Rejects degenerate triangles and NaN positions
+			float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+			if (!(fabsf(area) > 0.0f))
+			{
+				continue;
+			}
+
+			// Pixel centers at x + 0.5 inside [minX, maxX] are in [floor(minX), ceil(maxX))
+			float minX = std::min(v[0].x, std::min(v[1].x, v[2].x));
+			float maxX = std::max(v[0].x, std::max(v[1].x, v[2].x));
+			float minY = std::min(v[0].y, std::min(v[1].y, v[2].y));
+			float maxY = std::max(v[0].y, std::max(v[1].y, v[2].y));
+
+			Triangle triangle;
+			triangle.x0 = std::max(clipX0, ClampToInt(floorf(minX)));
+			triangle.y0 = std::max(clipY0, ClampToInt(floorf(minY)));
+			triangle.x1 = std::min(clipX1, ClampToInt(ceilf(maxX)));
+			triangle.y1 = std::min(clipY1, ClampToInt(ceilf(maxY)));
+			if (triangle.x0 >= triangle.x1 || triangle.y0 >= triangle.y1)
+			{
+				continue;
+			}
+
+			// Each edge is anchored at its lower endpoint, so the neighbouring triangle's edge function for a shared
+			// edge is the exact negation of this one and the tie rule gives every pixel on it to one of the two
+			float sign = area > 0.0f ? 1.0f : -1.0f;
+			for (uint32_t e = 0; e < 3; e++)
+			{
+				const UIVertex& p = v[(e + 1) % 3];
+				const UIVertex& q = v[(e + 2) % 3];
+				const UIVertex& anchor = (p.y < q.y || (p.y == q.y && p.x < q.x)) ? p : q;
+				triangle.a[e] = (p.y - q.y) * sign;
+				triangle.b[e] = (q.x - p.x) * sign;
+				triangle.c[e] = -(triangle.a[e] * anchor.x + triangle.b[e] * anchor.y);
+				triangle.bTieInside[e] = triangle.a[e] > 0.0f || (triangle.a[e] == 0.0f && triangle.b[e] > 0.0f);
+			}
+			triangle.invArea = 1.0f / fabsf(area);
+			triangle.vertices = v;
+			triangle.texture = command.texture;
+			triangle.bFlat = v[0].color == v[1].color && v[0].color == v[2].color && v[0].u == v[1].u && v[0].u == v[2].u &&
+				v[0].v == v[1].v && v[0].v == v[2].v;
+			triangle.flatColor = triangle.bFlat ? Shade(v, *command.texture, 1.0f, 0.0f, 0.0f) : 0;
+
+			// Transparent flat triangles still write alpha, as the DX11 blend state does, so they are drawn too
+			uint32_t index = (uint32_t)mTriangles.size();
+			mTriangles.push_back(triangle);
+
+			for (uint32_t ty = (uint32_t)triangle.y0 / TILE_SIZE; ty <= (uint32_t)(triangle.y1 - 1) / TILE_SIZE; ty++)
+			{
+				for (uint32_t tx = (uint32_t)triangle.x0 / TILE_SIZE; tx <= (uint32_t)(triangle.x1 - 1) / TILE_SIZE; tx++)
+				{
+					std::vector<uint32_t>& bin = mTileBins[ty * mTilesX + tx];
+					if (bin.empty())
+					{
+						mActiveTiles.push_back(ty * mTilesX + tx);
+					}
+					bin.push_back(index);
+					mStats.binnedCount++;
+				}
+			}
+		}
+	}
+	mStats.triangleCount = (uint32_t)mTriangles.size();
+	mStats.tileCount = (uint32_t)mActiveTiles.size();
+}
+
+void UIRasterizer::RasterizeRowScalar(const Triangle& triangle, const float rowE[3], int32_t x0, int32_t x1, uint32_t* row) const
+{
+	for (int32_t x = x0; x < x1; x++)
+	{
+		float px = (float)x + 0.5f;
+		float e0 = triangle.a[0] * px + rowE[0];
+		float e1 = triangle.a[1] * px + rowE[1];
+		float e2 = triangle.a[2] * px + rowE[2];
+		if (IsInside(e0, triangle.bTieInside[0]) && IsInside(e1, triangle.bTieInside[1]) && IsInside(e2, triangle.bTieInside[2]))
+		{
+			uint32_t src = triangle.bFlat ? triangle.flatColor :
+				Shade(triangle.vertices, *triangle.texture, e0 * triangle.invArea, e1 * triangle.invArea, e2 * triangle.invArea);
+			row[x] = Blend(src, row[x]);
+		}
+	}
+}
+
+void UIRasterizer::RasterizeRowSSE2(const Triangle& triangle, const float rowE[3], int32_t x0, int32_t x1, uint32_t* row) const
+{
+#ifdef UI_RASTERIZER_SSE2
+	// Four pixel centers per step; (float)x + 1.5f is exactly (float)(x + 1) + 0.5f, so the edge values match the
+	// scalar loop's bit for bit
+	const __m128 centers = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+	__m128 a[3];
+	__m128 r[3];
+	__m128 tie[3];
+	for (uint32_t e = 0; e < 3; e++)
+	{
+		a[e] = _mm_set1_ps(triangle.a[e]);
+		r[e] = _mm_set1_ps(rowE[e]);
+		tie[e] = _mm_castsi128_ps(_mm_set1_epi32(triangle.bTieInside[e] ? -1 : 0));
+	}
+
+	for (int32_t x = x0; x < x1; x += 4)
+	{
+		__m128 px = _mm_add_ps(_mm_set1_ps((float)x), centers);
+		__m128 e[3];
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			e[i] = _mm_add_ps(_mm_mul_ps(a[i], px), r[i]);
+			__m128 edgeInside = _mm_or_ps(_mm_cmpgt_ps(e[i], zero), _mm_and_ps(_mm_cmpeq_ps(e[i], zero), tie[i]));
+			inside = _mm_and_ps(inside, edgeInside);
+		}
+
+		int32_t count = std::min(4, x1 - x);
+		uint32_t mask = (uint32_t)_mm_movemask_ps(inside) & ((1u << count) - 1);
+		if (mask == 0)
+		{
+			continue;
+		}
+
+		if (triangle.bFlat)
+		{
+			for (uint32_t lane = 0; lane < 4; lane++)
+			{
+				if (mask & (1u << lane))
+				{
+					row[x + lane] = Blend(triangle.flatColor, row[x + lane]);
+				}
+			}
+			continue;
+		}
+
+		float values[3][4];
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			_mm_storeu_ps(values[i], e[i]);
+		}
+		for (uint32_t lane = 0; lane < 4; lane++)
+		{
+			if (mask & (1u << lane))
+			{
+				uint32_t src = Shade(triangle.vertices, *triangle.texture, values[0][lane] * triangle.invArea, values[1][lane] * triangle.invArea,
+					values[2][lane] * triangle.invArea);
+				row[x + lane] = Blend(src, row[x + lane]);
+			}
+		}
+	}
+#else
+	RasterizeRowScalar(triangle, rowE, x0, x1, row);
+#endif
+}
+
+void UIRasterizer::RasterizeTile(uint32_t tile, CPUTexture2D& target) const
+{
+	int32_t tileX0 = (int32_t)((tile % mTilesX) * TILE_SIZE);
+	int32_t tileY0 = (int32_t)((tile / mTilesX) * TILE_SIZE);
+	int32_t tileX1 = std::min(tileX0 + (int32_t)TILE_SIZE, (int32_t)target.width);
+	int32_t tileY1 = std::min(tileY0 + (int32_t)TILE_SIZE, (int32_t)target.height);
+
+	for (uint32_t index : mTileBins[tile])
+	{
+		const Triangle& triangle = mTriangles[index];
+		int32_t x0 = std::max(tileX0, triangle.x0);
+		int32_t x1 = std::min(tileX1, triangle.x1);
+		int32_t y0 = std::max(tileY0, triangle.y0);
+		int32_t y1 = std::min(tileY1, triangle.y1);
+
+		for (int32_t y = y0; y < y1; y++)
+		{
+			float py = (float)y + 0.5f;
+			float rowE[3] = { triangle.b[0] * py + triangle.c[0], triangle.b[1] * py + triangle.c[1], triangle.b[2] * py + triangle.c[2] };
+			uint32_t* row = &target.texels[(size_t)y * target.width];
+			if (bUseSIMD)
+			{
+				RasterizeRowSSE2(triangle, rowE, x0, x1, row);
+			}
+			else
+			{
+				RasterizeRowScalar(triangle, rowE, x0, x1, row);
+			}
+		}
+	}
+}
+
+void UIRasterizer::Render(const UIFrame& frame, CPUTexture2D& target)
+{
+	std::chrono::steady_clock::time_point setupStart = std::chrono::steady_clock::now();
+	SetupTriangles(frame, target);
+	std::chrono::steady_clock::time_point rasterStart = std::chrono::steady_clock::now();
+
+	// Tiles own disjoint pixels, so they need no ordering between them
+	if (mPool != nullptr && mActiveTiles.size() > 1)
+	{
+		mPool->ParallelFor((uint32_t)mActiveTiles.size(), 1, [this, &target](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				RasterizeTile(mActiveTiles[i], target);
+			}
+		});
+	}
+	else
+	{
+		for (uint32_t tile : mActiveTiles)
+		{
+			RasterizeTile(tile, target);
+		}
+	}
+
+	std::chrono::steady_clock::time_point rasterEnd = std::chrono::steady_clock::now();
+	mStats.setupMs = std::chrono::duration<double, std::milli>(rasterStart - setupStart).count();
+	mStats.rasterMs = std::chrono::duration<double, std::milli>(rasterEnd - rasterStart).count();
+}
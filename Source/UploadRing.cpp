@@ -0,0 +1,60 @@
+/*****************************************************************
+ **	Name:        UploadRing.cpp                                 **
+ **	Description: Ring sub-allocation for dynamic upload buffers **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com   **
+ **	Published:   <insert date>                                  **
+ ****************************************************************/
+
+#include "UploadRing.h"
+
+UploadRing::UploadRing(uint32_t elementSize, uint32_t initialCapacity) :
+	mElementSize(elementSize),
+	mCapacity(initialCapacity > 0 ? initialCapacity : 1),
+	mHead(0),
+	bHasBuffer(false)
+{
+	mStats = UploadRingStats();
+}
+
+UploadRingAllocation UploadRing::Allocate(uint32_t count)
+{
+	UploadRingAllocation allocation = {};
+	mStats.allocationCount++;
+	mStats.bytesUploaded += (uint64_t)count * mElementSize;
+
+	uint64_t capacity = mCapacity;
+	while ((uint64_t)count * 2 > capacity)
+	{
+		capacity *= 2;
+	}
+	if (capacity > UINT32_MAX)
+	{
+		capacity = UINT32_MAX;
+	}
+
+	if (!bHasBuffer || capacity != mCapacity)
+	{
+		mCapacity = (uint32_t)capacity;
+		bHasBuffer = true;
+		allocation.bRecreate = true;
+		allocation.bDiscard = true;
+		mStats.recreationCount++;
+		mHead = 0;
+	}
+	else if ((uint64_t)mHead + count > mCapacity)
+	{
+		allocation.bDiscard = true;
+		mStats.discardCount++;
+		mHead = 0;
+	}
+
+	allocation.offset = mHead;
+	mHead += count;
+	return allocation;
+}
+
+void UploadRing::Invalidate()
+{
+	bHasBuffer = false;
+	mHead = 0;
+}
@@ -6,12 +6,23 @@
  ********************************************************************/
 
 #include "UAVOverlapSampleApp.h"
+#include "BenchmarkRunner.h"
+#include "D3D11GraphicsDevice.h"
+#include "RecordingGraphicsDevice.h"
+#include "StartupBench.h"
+#include "StateFilterGraphicsDevice.h"
+
+#include <shellapi.h>
 
 #define WINDOW_WIDTH 1280
 #define WINDOW_HEIGHT 720
 
 extern LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
+// Client size from the last WM_SIZE, applied by the message loop before the next frame
+static uint32_t gPendingWidth = 0;
+static uint32_t gPendingHeight = 0;
+
 struct SimplePerformanceTimer
 {
 	double invFreq;
@@ -51,6 +62,15 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 		PostQuitMessage(0);
 		break;
 
+	case WM_SIZE:
+		// A minimized window has a zero client area; keep the last size until it is restored
+		if (wParam != SIZE_MINIMIZED)
+		{
+			gPendingWidth = LOWORD(lParam);
+			gPendingHeight = HIWORD(lParam);
+		}
+		break;
+
 	default:
 		return DefWindowProc(hWnd, message, wParam, lParam);
 	}
@@ -78,9 +98,8 @@ HWND InitWindow( HINSTANCE hInstance, int nCmdShow )
 		return NULL;
 	}
 
-	// Disabled resizing, minimizing, and maximizing, as they are not needed to demonstrate the extension
-	// and it makes the sample code less cumbersome.
-	DWORD windowStyle = WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU;
+	// Resizing goes through UAVOverlapSampleApp::Resize, which only recreates what the new size invalidates
+	DWORD windowStyle = WS_OVERLAPPEDWINDOW;
 
 	RECT R = { 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT };
 	AdjustWindowRect(&R, windowStyle, false);
@@ -101,21 +120,236 @@ HWND InitWindow( HINSTANCE hInstance, int nCmdShow )
     return window;
 }
 
+std::vector<std::string> GetCommandLineArgs()
+{
+	std::vector<std::string> args;
+
+	int argc = 0;
+	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	if (argv == NULL)
+	{
+		return args;
+	}
+
+	// Skip the executable path; the options themselves are plain ASCII
+	for (int i = 1; i < argc; i++)
+	{
+		char arg[MAX_PATH] = {};
+		WideCharToMultiByte(CP_UTF8, 0, argv[i], -1, arg, MAX_PATH - 1, NULL, NULL);
+		args.push_back(arg);
+	}
+
+	LocalFree(argv);
+	return args;
+}
+
+// A /SUBSYSTEM:WINDOWS process has no console of its own, so report to the one that launched it, if any
+void AttachParentConsole()
+{
+	if (AttachConsole(ATTACH_PARENT_PROCESS))
+	{
+		FILE* stream;
+		freopen_s(&stream, "CONOUT$", "w", stdout);
+		freopen_s(&stream, "CONOUT$", "w", stderr);
+	}
+}
+
+// Writes the --capture file, if one was asked for
+bool WriteCapture(const HeadlessOptions& options, const RecordingGraphicsDevice& recorder)
+{
+	if (options.capturePath.empty())
+	{
+		return true;
+	}
+	if (!recorder.WriteToFile(options.capturePath.c_str()))
+	{
+		fprintf(stderr, "Failed to write %s\n", options.capturePath.c_str());
+		return false;
+	}
+	printf("captured %u frame(s), %zu bytes, to %s\n", recorder.GetRecordedFrameCount(), recorder.GetCommandStream().size(), options.capturePath.c_str());
+	return true;
+}
+
+// Renders a fixed number of frames without a window or swap chain, then prints timing stats and exits
+int RunHeadless(const HeadlessOptions& options)
+{
+	AttachParentConsole();
+
+	// app -> recorder (--capture) -> state filter -> D3D11 device, so a capture holds every call the app made
+	D3D11GraphicsDevice d3dDevice(NULL);
+	d3dDevice.SetUIOwnedPipeline(options.bUIOwnedPipeline);
+	StateFilterGraphicsDevice stateFilter(&d3dDevice);
+	GraphicsDevice* filtered = options.bUseStateFilter ? static_cast<GraphicsDevice*>(&stateFilter) : &d3dDevice;
+	RecordingGraphicsDevice recorder(filtered, options.captureFrames);
+	GraphicsDevice& device = options.capturePath.empty() ? *filtered : recorder;
+
+	UAVOverlapSampleApp app(&device, options.width, options.height);
+	app.ApplyOptions(options);
+
+	if (!app.Init())
+	{
+		app.Cleanup();
+		return 1;
+	}
+
+	int result = 0;
+	if (!options.startupTracePath.empty() && !WriteStartupTrace(options.startupTracePath.c_str(), std::vector<StartupTimer>(1, app.GetStartupTimer())))
+	{
+		fprintf(stderr, "Failed to write %s\n", options.startupTracePath.c_str());
+		result = 1;
+	}
+
+	unsigned long long freq;
+	QueryPerformanceFrequency((LARGE_INTEGER*)& freq);
+
+	HeadlessFrameStats stats;
+	double frameTime = 0.0;
+	for (uint32_t frame = 0; frame < options.frameCount; frame++)
+	{
+		// Resize latency is reported on its own rather than counted in the frame time
+		uint32_t resizeWidth = 0;
+		uint32_t resizeHeight = 0;
+		if (GetHeadlessResize(options, frame, resizeWidth, resizeHeight) && !app.Resize(resizeWidth, resizeHeight))
+		{
+			app.Cleanup();
+			return 1;
+		}
+
+		unsigned long long frameStart, frameEnd;
+		QueryPerformanceCounter((LARGE_INTEGER*)& frameStart);
+
+		app.Render(frameTime);
+
+		QueryPerformanceCounter((LARGE_INTEGER*)& frameEnd);
+		frameTime = (double)(frameEnd - frameStart) * 1000.0 / freq;
+		stats.AddFrame(frameTime);
+	}
+	app.FinishFrames();
+
+	stats.Print(stdout, options, device.GetName());
+	app.GetStartupTimer().PrintReport(stdout);
+	printf("ui shaders: %s\n", d3dDevice.IsUIShaderPrecompiled() ? "precompiled" : "compiled at runtime");
+	app.GetFrameTimeHistogram().PrintSummary(stdout);
+	app.GetFramePacer().PrintReport(stdout);
+	printf("compute=%.4f ms composite=%.4f ms (device timestamps, mean of the last %u resolved frames)\n",
+		app.GetPassTimer().GetAveragePassMs(PASS_COMPUTE), app.GetPassTimer().GetAveragePassMs(PASS_COMPOSITE), GpuPassTimer::AVERAGE_FRAMES);
+	if (app.GetResizeReport().GetCount() > 0)
+	{
+		app.GetResizeReport().Print(stdout);
+	}
+	if (options.bUseStateFilter)
+	{
+		printf("state changes: forwarded=%llu filtered=%llu\n", (unsigned long long)stateFilter.GetForwardedCount(), (unsigned long long)stateFilter.GetFilteredCount());
+	}
+
+	UploadRingStats vertexUploads;
+	UploadRingStats indexUploads;
+	d3dDevice.GetUIUploadStats(vertexUploads, indexUploads);
+	printf("ui upload: vertex recreations=%llu discards=%llu bytes=%llu, index recreations=%llu discards=%llu bytes=%llu\n",
+		(unsigned long long)vertexUploads.recreationCount, (unsigned long long)vertexUploads.discardCount, (unsigned long long)vertexUploads.bytesUploaded,
+		(unsigned long long)indexUploads.recreationCount, (unsigned long long)indexUploads.discardCount, (unsigned long long)indexUploads.bytesUploaded);
+
+	UIPipelineCounters uiCalls;
+	d3dDevice.GetUIPipelineCounters(uiCalls);
+	printf("ui pipeline: %s, context calls=%u saved=%u (state round-trip %u, redundant binds %u) (last frame)\n", options.bUIOwnedPipeline ? "owned" : "saved and restored",
+		uiCalls.issuedCalls, uiCalls.GetSavedCalls(), uiCalls.skippedRoundTripCalls, uiCalls.skippedBinds);
+
+	if (options.recordThreadCount > 0 && app.GetRecordThreadCount() == 0)
+	{
+		printf("deferred recording was requested but is unavailable (no deferred contexts, or capturing); dispatches were recorded on the immediate context\n");
+	}
+	else if (options.recordThreadCount > 0)
+	{
+		printf("deferred recording: threads=%u last record=%.4f ms last submit=%.4f ms\n", app.GetRecordThreadCount(),
+			app.GetComputeCounters().recordTimeMs, app.GetComputeCounters().submissionTimeMs);
+	}
+
+	if (!options.outputPath.empty() && !app.WriteFrameToPPM(options.outputPath.c_str()))
+	{
+		fprintf(stderr, "Failed to write %s\n", options.outputPath.c_str());
+		result = 1;
+	}
+
+	app.Cleanup();
+
+	if (!WriteCapture(options, recorder))
+	{
+		result = 1;
+	}
+	return result;
+}
+
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, int nCmdShow)
 {
+	std::vector<std::string> args = GetCommandLineArgs();
+
+	HeadlessOptions options;
+	BenchmarkMatrix matrix;
+	if (!ExtractBenchmarkOptions(args, matrix) || !ParseHeadlessOptions(args, options))
+	{
+		MessageBox(0, L"Usage: UAVOverlapSample.exe [--headless] [--frames N] [--width N] [--height N] [--tile 8|16|32] [--overlap] [--auto-overlap] [--batched] [--indirect] [--no-state-filter] [--output frame.ppm] [--frame-stats file.csv|file.json] [--capture file.uavc] [--capture-frames N] [--record-threads N] [--frames-in-flight 1|2|3] [--workload preset|alu=N+reads=N+coverage=N+reduce+irregular] [--resize WxH,WxH,...] [--resize-interval N] [--ui-owned-pipeline] [--startup-trace file.json]\n"
+			L"       UAVOverlapSample.exe --bench [--bench-overlap off,on] [--bench-tiles 8,16,32] [--bench-resolutions 1280x720,...] [--bench-dispatch tiles,batched,indirect] [--bench-frames-in-flight 1,2,3] [--bench-workloads none,alu,...] [--bench-warmup N] [--bench-frames N] [--bench-report file.json|file.csv]\n"
+			L"       UAVOverlapSample.exe --startup-bench N [--startup-trace file.json] [sample options]",
+			L"Invalid Command Line", MB_ICONERROR);
+		return 1;
+	}
+
+	// Benchmark configurations each run on a fresh offscreen device
+	if (matrix.bEnabled)
+	{
+		AttachParentConsole();
+		std::vector<BenchmarkResult> results;
+		bool ok = RunBenchmarkMatrix(matrix, []() { return std::unique_ptr<GraphicsDevice>(new D3D11GraphicsDevice(NULL)); }, stdout, results);
+		return ok ? 0 : 1;
+	}
+
+	// Each startup run creates and destroys its own offscreen device, without the state filter or recorder in front
+	if (options.startupBenchRuns > 0)
+	{
+		AttachParentConsole();
+		bool ownedPipeline = options.bUIOwnedPipeline;
+		std::vector<StartupTimer> runs;
+		bool ok = RunStartupBench(options, [ownedPipeline]()
+		{
+			D3D11GraphicsDevice* device = new D3D11GraphicsDevice(NULL);
+			device->SetUIOwnedPipeline(ownedPipeline);
+			return std::unique_ptr<GraphicsDevice>(device);
+		}, stdout, runs);
+		return ok ? 0 : 1;
+	}
+
+	if (options.bHeadless)
+	{
+		return RunHeadless(options);
+	}
+
 	HWND window = InitWindow(hInstance, nCmdShow);
 	if (window == NULL)
 	{
 		return 0;
 	}
 
-	UAVOverlapSampleApp app(window, WINDOW_WIDTH, WINDOW_HEIGHT);
+	D3D11GraphicsDevice d3dDevice(window);
+	d3dDevice.SetUIOwnedPipeline(options.bUIOwnedPipeline);
+	StateFilterGraphicsDevice stateFilter(&d3dDevice);
+	GraphicsDevice* filtered = options.bUseStateFilter ? static_cast<GraphicsDevice*>(&stateFilter) : &d3dDevice;
+	RecordingGraphicsDevice recorder(filtered, options.captureFrames);
+	GraphicsDevice& device = options.capturePath.empty() ? *filtered : recorder;
+
+	UAVOverlapSampleApp app(&device, WINDOW_WIDTH, WINDOW_HEIGHT);
+	app.ApplyOptions(options);
 
-	if (FAILED(app.Init()))
+	if (!app.Init())
 	{
 		app.Cleanup();
 		return 0;
 	}
+	if (!options.startupTracePath.empty())
+	{
+		WriteStartupTrace(options.startupTracePath.c_str(), std::vector<StartupTimer>(1, app.GetStartupTimer()));
+	}
+	gPendingWidth = app.GetWidth();
+	gPendingHeight = app.GetHeight();
 
 	SimplePerformanceTimer perfTimer = { 0 };
 	{
@@ -140,12 +374,17 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLi
 		}
 		else
 		{
+			if ((gPendingWidth != app.GetWidth() || gPendingHeight != app.GetHeight()) && !app.Resize(gPendingWidth, gPendingHeight))
+			{
+				break;
+			}
 			UpdatePerformanceTimer(perfTimer);
 			app.Render(perfTimer.frameTime);
 		}
 	}
 
 	app.Cleanup();
+	WriteCapture(options, recorder);
 
 	return (int)msg.wParam;
 }
@@ -0,0 +1,189 @@
+/*******************************************************************************************************************
+ **	Name:        CommandStreamTests.cpp                                                                           **
+ **	Description: Checks the capture file format and the replay report of a known frame: the file round-trips byte **
+ **              for byte, damaged files are rejected and the counts and hazards match what the frame does        **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                     **
+ **	Published:   <insert date>                                                                                    **
+ ******************************************************************************************************************/
+
+#include "CPUComputeBackend.h"
+#include "CPUGraphicsDevice.h"
+#include "CommandReplay.h"
+#include "CommandStream.h"
+#include "RecordingGraphicsDevice.h"
+#include "UAVOverlapTest.h"
+
+#include <cstdio>
+#include <vector>
+
+static const char* gCapturePath = "CommandStreamTests.uavc";
+
+// Records one 64x64 frame of 16x16 tile dispatches on a single UAV. The comments give each call's index in the
+// stream; the Cleanup after the Present falls outside the one captured frame.
+static bool CaptureKnownFrame(std::vector<uint8_t>& stream)
+{
+	CPUGraphicsDevice cpuDevice(1);
+	RecordingGraphicsDevice device(&cpuDevice, 1);
+	const uint32_t bindFlags = GFX_BIND_SHADER_RESOURCE | GFX_BIND_UNORDERED_ACCESS;
+	bool ok = device.Init(64, 64);                                                                      // 0
+	GfxTexture texture = device.CreateTexture2D(64, 64, bindFlags);                                     // 1
+	GfxView uav = device.CreateUnorderedAccessView(texture);                                            // 2
+	GfxShader shader = device.CreateComputeShader("ComputeShader");                                     // 3
+	CPUComputeBackend::ConstantBuffer tile00 = { 0, 0, 64, 64 };
+	CPUComputeBackend::ConstantBuffer tile10 = { 1, 0, 64, 64 };
+	GfxBuffer cb00 = device.CreateConstantBuffer(&tile00, sizeof(tile00));                              // 4
+	GfxBuffer cb10 = device.CreateConstantBuffer(&tile10, sizeof(tile10));                              // 5
+	ok = ok && texture != GFX_NULL_HANDLE && uav != GFX_NULL_HANDLE && shader != GFX_NULL_HANDLE &&
+		cb00 != GFX_NULL_HANDLE && cb10 != GFX_NULL_HANDLE;
+
+	device.CSSetShader(shader);                                                                         // 6
+	device.CSSetShader(shader);                                                                         // 7: redundant
+	device.CSSetUnorderedAccessView(0, uav);                                                            // 8
+	device.CSSetConstantBuffer(0, cb00);                                                                // 9
+	device.Dispatch(1, 1, 1);                                                                           // 10: tile (0,0)
+
+	device.BeginUAVOverlap();                                                                           // 11
+	device.CSSetConstantBuffer(0, cb10);                                                                // 12
+	device.Dispatch(1, 1, 1);                                                                           // 13: sync, disjoint
+	device.CSSetConstantBuffer(0, cb00);                                                                // 14
+	device.Dispatch(1, 1, 1);                                                                           // 15: overlap, disjoint
+	device.CSSetConstantBuffer(0, cb00);                                                                // 16: redundant
+	device.Dispatch(1, 1, 1);                                                                           // 17: overlap, hazard with 15
+	device.EndUAVOverlap();                                                                             // 18
+
+	device.CSSetUnorderedAccessView(0, uav);                                                            // 19: redundant
+	device.Dispatch(2, 1, 1);                                                                           // 20: sync, tiles (0,0) and (1,0)
+	device.Present();                                                                                   // 21
+	device.Cleanup();
+
+	stream = device.GetCommandStream();
+	return ok && device.GetRecordedFrameCount() == 1;
+}
+
+static bool WriteRawFile(const char* path, const std::vector<uint8_t>& bytes)
+{
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	bool ok = bytes.empty() || fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+	return fclose(file) == 0 && ok;
+}
+
+static std::vector<uint8_t> MakeHeader(uint32_t magic, uint32_t version)
+{
+	std::vector<uint8_t> header;
+	for (uint32_t value : { magic, version })
+	{
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			header.push_back((uint8_t)(value >> (i * 8)));
+		}
+	}
+	return header;
+}
+
+// A file written with WriteCommandStreamFile reads back as the same bytes, header stripped
+TEST(CommandStream, FileRoundTrip)
+{
+	std::vector<uint8_t> stream;
+	REQUIRE(CaptureKnownFrame(stream));
+	CHECK(!stream.empty());
+
+	CHECK(WriteCommandStreamFile(gCapturePath, stream));
+	std::vector<uint8_t> read;
+	CHECK(ReadCommandStreamFile(gCapturePath, read));
+	CHECK(read == stream);
+
+	// The header is the little-endian magic and version ahead of the commands
+	std::vector<uint8_t> file = MakeHeader(COMMAND_STREAM_MAGIC, COMMAND_STREAM_VERSION);
+	file.insert(file.end(), stream.begin(), stream.end());
+	std::vector<uint8_t> raw;
+	CHECK(WriteRawFile(gCapturePath, file) && ReadCommandStreamFile(gCapturePath, raw) && raw == stream);
+
+	// An empty capture is still a valid file
+	CHECK(WriteCommandStreamFile(gCapturePath, std::vector<uint8_t>()));
+	CHECK(ReadCommandStreamFile(gCapturePath, read) && read.empty());
+	remove(gCapturePath);
+}
+
+// Files with a short header, a bad magic or an unsupported version are rejected, and so is a command stream cut
+// off in the middle of a command
+TEST(CommandStream, RejectsDamagedStreams)
+{
+	std::vector<uint8_t> stream;
+	REQUIRE(CaptureKnownFrame(stream));
+
+	std::vector<uint8_t> read;
+	std::vector<uint8_t> header = MakeHeader(COMMAND_STREAM_MAGIC, COMMAND_STREAM_VERSION);
+	CHECK(WriteRawFile(gCapturePath, std::vector<uint8_t>(header.begin(), header.begin() + 6)));
+	CHECK(!ReadCommandStreamFile(gCapturePath, read));
+
+	std::vector<uint8_t> file = MakeHeader(COMMAND_STREAM_MAGIC ^ 0xFF, COMMAND_STREAM_VERSION);
+	file.insert(file.end(), stream.begin(), stream.end());
+	CHECK(WriteRawFile(gCapturePath, file));
+	CHECK(!ReadCommandStreamFile(gCapturePath, read));
+
+	file = MakeHeader(COMMAND_STREAM_MAGIC, COMMAND_STREAM_VERSION + 1);
+	file.insert(file.end(), stream.begin(), stream.end());
+	CHECK(WriteRawFile(gCapturePath, file));
+	CHECK(!ReadCommandStreamFile(gCapturePath, read));
+
+	CHECK(!ReadCommandStreamFile("CommandStreamTests.missing", read));
+	remove(gCapturePath);
+
+	// Dropping the Present and the last byte before it leaves the final Dispatch one argument short
+	std::vector<uint8_t> truncated(stream.begin(), stream.end() - 2);
+	ReplayReport report;
+	CPUGraphicsDevice replayDevice(1);
+	CHECK(!ReplayCommandStream(truncated, &replayDevice, report));
+	CHECK(report.frameCount == 0);
+
+	// A zero opcode is never valid
+	std::vector<uint8_t> bad = stream;
+	bad.push_back(0);
+	CPUGraphicsDevice badDevice(1);
+	CHECK(!ReplayCommandStream(bad, &badDevice, report));
+}
+
+// The known frame replays with the call counts, redundant binds and dispatch edges its comments describe
+TEST(CommandStream, ReplayReport)
+{
+	std::vector<uint8_t> stream;
+	REQUIRE(CaptureKnownFrame(stream));
+
+	ReplayReport report;
+	CPUGraphicsDevice replayDevice(1);
+	REQUIRE(ReplayCommandStream(stream, &replayDevice, report));
+	CHECK(report.commandCount == 22);
+	CHECK(report.frameCount == 1);
+	CHECK(report.skippedCount == 0);
+	CHECK(report.unmappedHandleCount == 0);
+
+	CHECK(report.opcodes[CMD_INIT].count == 1);
+	CHECK(report.opcodes[CMD_CREATE_CONSTANT_BUFFER].count == 2);
+	CHECK(report.opcodes[CMD_DISPATCH].count == 5);
+	CHECK(report.opcodes[CMD_BEGIN_UAV_OVERLAP].count == 1);
+	CHECK(report.opcodes[CMD_END_UAV_OVERLAP].count == 1);
+	CHECK(report.opcodes[CMD_PRESENT].count == 1);
+	CHECK(report.opcodes[CMD_CLEANUP].count == 0);
+
+	CHECK(report.opcodes[CMD_CS_SET_SHADER].count == 2);
+	CHECK(report.opcodes[CMD_CS_SET_SHADER].redundantCount == 1);
+	CHECK(report.opcodes[CMD_CS_SET_UAV].count == 2);
+	CHECK(report.opcodes[CMD_CS_SET_UAV].redundantCount == 1);
+	CHECK(report.opcodes[CMD_CS_SET_CONSTANT_BUFFER].count == 4);
+	CHECK(report.opcodes[CMD_CS_SET_CONSTANT_BUFFER].redundantCount == 1);
+	CHECK(report.opcodes[CMD_DISPATCH].redundantCount == 0);
+
+	// 10 -> 13 and 17 -> 20 cross a bracket boundary; only the first writes disjoint tiles
+	CHECK(report.syncEdges == 2);
+	CHECK(report.unnecessarySyncEdges == 1);
+	CHECK(report.overlapEdges == 2);
+	CHECK(report.overlapHazards == 1);
+	CHECK(report.uavToSrvEdges == 0);
+	REQUIRE(report.hazards.size() == 1);
+	CHECK(report.hazards[0].firstCommand == 15);
+	CHECK(report.hazards[0].secondCommand == 17);
+}
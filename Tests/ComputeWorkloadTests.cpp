@@ -0,0 +1,288 @@
+/**********************************************************************************************************************
+ **	Name:        ComputeWorkloadTests.cpp                                                                            **
+ **	Description: Checks the ComputeWorkload.hlsl reference kernel against a literal transcription of the shader, and **
+ **              every submission path of the sample against per-tile dispatch at each workload preset               **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                        **
+ **	Published:   <insert date>                                                                                       **
+ *********************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "ComputeWorkload.h"
+#include "HeadlessRun.h"
+#include "SampleFixture.h"
+#include "UAVOverlapSampleApp.h"
+#include "UAVOverlapTest.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// WorkloadHash in ComputeWorkload.hlsl
+static uint32_t ShaderHash(uint32_t value)
+{
+	value ^= value >> 16;
+	value *= 0x7feb352du;
+	value ^= value >> 15;
+	value *= 0x846ca68bu;
+	value ^= value >> 16;
+	return value;
+}
+
+// ComputeWorkload.hlsl thread group (groupX, groupY) phase by phase: every thread runs up to a barrier before any
+// thread goes past it, with the group shared array as a local. The gradient uses the reciprocal, as the CPU device does.
+static void RunShaderTranscription(const UAVOverlapSampleApp::ConstantBuffer& cb, uint32_t tileSize, uint32_t groupX, uint32_t groupY,
+	const CPUTexture2D& source, CPUTexture2D& output)
+{
+	const ComputeWorkload& workload = cb.workload;
+	uint32_t threads = tileSize * tileSize;
+	uint32_t tileX = cb.dispatchX + groupX;
+	uint32_t tileY = cb.dispatchY + groupY;
+
+	uint32_t edge = (workload.coverage == 0 || workload.coverage >= 100) ? tileSize : (tileSize * workload.coverage / 100 > 1 ? tileSize * workload.coverage / 100 : 1);
+	if (workload.flags & COMPUTE_WORKLOAD_IRREGULAR_TILES)
+	{
+		edge = 1 + ShaderHash(tileX | (tileY << 16)) % edge;
+	}
+
+	std::vector<uint32_t> values(threads, 0);
+	std::vector<bool> inWindow(threads, false);
+	std::vector<bool> active(threads, false);
+	for (uint32_t index = 0; index < threads; index++)
+	{
+		uint32_t threadX = index % tileSize;
+		uint32_t threadY = index / tileSize;
+		uint32_t xcoord = tileX * tileSize + threadX;
+		uint32_t ycoord = tileY * tileSize + threadY;
+		inWindow[index] = xcoord < cb.windowWidth && ycoord < cb.windowHeight;
+		active[index] = inWindow[index] && threadX < edge && threadY < edge;
+		if (!active[index])
+		{
+			continue;
+		}
+
+		uint32_t value = xcoord | (ycoord << 16);
+		for (uint32_t i = 0; i < workload.aluIterations; i++)
+		{
+			value = ShaderHash(value + i);
+		}
+		uint32_t sourceWidth = source.width > 0 ? source.width : 1;
+		uint32_t sourceHeight = source.height > 0 ? source.height : 1;
+		for (uint32_t j = 0; j < workload.srvReads; j++)
+		{
+			uint32_t x = (xcoord + j * 37) % sourceWidth;
+			uint32_t y = (ycoord + j * 11) % sourceHeight;
+			uint32_t texel = source.texels.empty() ? 0 : source.texels[(size_t)y * source.width + x];
+			value = (value ^ texel) * 16777619u;
+		}
+		values[index] = value;
+	}
+
+	if (workload.flags & COMPUTE_WORKLOAD_GROUP_REDUCTION)
+	{
+		std::vector<uint32_t> partialSums = values;
+		for (uint32_t stride = threads / 2; stride > 0; stride >>= 1)
+		{
+			for (uint32_t index = 0; index < stride; index++)
+			{
+				partialSums[index] += partialSums[index + stride];
+			}
+		}
+		for (uint32_t& value : values)
+		{
+			value += partialSums[0];
+		}
+	}
+
+	float invWidth = 1.0f / (float)cb.windowWidth;
+	float invHeight = 1.0f / (float)cb.windowHeight;
+	for (uint32_t index = 0; index < threads; index++)
+	{
+		if (inWindow[index])
+		{
+			uint32_t xcoord = tileX * tileSize + index % tileSize;
+			uint32_t ycoord = tileY * tileSize + index / tileSize;
+			float blue = active[index] ? (float)(values[index] & 0xFF) / 255.0f : 0.5f;
+			output.Store(xcoord, ycoord, PackUNorm4x8((float)xcoord * invWidth, (float)ycoord * invHeight, blue, 1.0f));
+		}
+	}
+}
+
+static const char* gWorkloadShaderNames[] = { "ComputeWorkloadTile8", "ComputeWorkload", "ComputeWorkloadTile32" };
+static const char* gWorkloadListShaderNames[] = { "ComputeWorkloadTile8List", "ComputeWorkloadList", "ComputeWorkloadTile32List" };
+
+// Every preset at every tile size on the CPU device, as one batched dispatch and as a tile-list dispatch of every tile
+// in reverse order, against the transcription. The presets between them cover the hash loop, the strided source
+// reads, the group reduction and the partial and irregular active edge. 200x136 is not a multiple of any tile size.
+// The "bandwidth" preset also runs with t1 unbound, which reads zeros.
+TEST(ComputeWorkload, ReferenceMatchesShader)
+{
+	const uint32_t width = 200;
+	const uint32_t height = 136;
+	const uint32_t tileSizes[] = { 8, 16, 32 };
+
+	CPUGraphicsDevice device(2);
+	REQUIRE(device.Init(width, height));
+
+	// Any pattern will do for the source; the sample's gradient shader writes one
+	GfxTexture sourceTexture = device.CreateTexture2D(width, height, GFX_BIND_UNORDERED_ACCESS | GFX_BIND_SHADER_RESOURCE);
+	GfxView sourceUAV = device.CreateUnorderedAccessView(sourceTexture);
+	GfxView sourceSRV = device.CreateShaderResourceView(sourceTexture);
+	GfxShader gradient = device.CreateComputeShader("ComputeShaderTile8");
+	UAVOverlapSampleApp::ConstantBuffer origin = { 0, 0, width, height, ComputeWorkload() };
+	GfxBuffer originBuffer = device.CreateConstantBuffer(&origin, sizeof(origin));
+	device.CSSetShader(gradient);
+	device.CSSetUnorderedAccessView(0, sourceUAV);
+	device.CSSetConstantBuffer(0, originBuffer);
+	device.Dispatch(TileGrid::CeilDiv(width, 8), TileGrid::CeilDiv(height, 8), 1);
+	device.CSSetUnorderedAccessView(0, GFX_NULL_HANDLE);
+
+	CPUTexture2D source(width, height);
+	CPUTexture2D unbound;
+	CHECK(ReadThroughBackBuffer(device, sourceSRV, width, height, source.texels));
+
+	GfxTexture texture = device.CreateTexture2D(width, height, GFX_BIND_UNORDERED_ACCESS | GFX_BIND_SHADER_RESOURCE);
+	GfxView uav = device.CreateUnorderedAccessView(texture);
+	GfxView srv = device.CreateShaderResourceView(texture);
+
+	for (uint32_t preset = 1; preset < GetComputeWorkloadPresetCount(); preset++)
+	{
+		for (uint32_t useSource = 0; useSource < 2; useSource++)
+		{
+			if (!useSource && strcmp(GetComputeWorkloadPresetName(preset), "bandwidth") != 0)
+			{
+				continue;
+			}
+
+			for (uint32_t t = 0; t < 3; t++)
+			{
+				uint32_t tileSize = tileSizes[t];
+				uint32_t tilesX = TileGrid::CeilDiv(width, tileSize);
+				uint32_t tilesY = TileGrid::CeilDiv(height, tileSize);
+
+				UAVOverlapSampleApp::ConstantBuffer cb = { 0, 0, width, height, GetComputeWorkloadPreset(preset) };
+				GfxBuffer constantBuffer = device.CreateConstantBuffer(&cb, sizeof(cb));
+
+				CPUTexture2D expected(width, height);
+				for (uint32_t y = 0; y < tilesY; y++)
+				{
+					for (uint32_t x = 0; x < tilesX; x++)
+					{
+						RunShaderTranscription(cb, tileSize, x, y, useSource ? source : unbound, expected);
+					}
+				}
+
+				std::vector<uint32_t> tiles;
+				for (uint32_t i = tilesX * tilesY; i-- > 0;)
+				{
+					tiles.push_back(PackTileListEntry(i % tilesX, i / tilesX));
+				}
+				GfxBuffer list = device.CreateStructuredBuffer(tiles.data(), sizeof(uint32_t), (uint32_t)tiles.size());
+				GfxView listSRV = device.CreateShaderResourceView(list);
+				GfxShader shaders[2] = { device.CreateComputeShader(gWorkloadShaderNames[t]), device.CreateComputeShader(gWorkloadListShaderNames[t]) };
+				CHECK(shaders[0] != GFX_NULL_HANDLE && shaders[1] != GFX_NULL_HANDLE);
+
+				for (uint32_t variant = 0; variant < 2; variant++)
+				{
+					float black[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+					device.ClearRenderTargetView(device.GetBackBufferRTV(), black);
+
+					device.CSSetShader(shaders[variant]);
+					device.CSSetUnorderedAccessView(0, uav);
+					device.CSSetConstantBuffer(0, constantBuffer);
+					device.CSSetShaderResource(0, variant ? listSRV : GFX_NULL_HANDLE);
+					device.CSSetShaderResource(1, useSource ? sourceSRV : GFX_NULL_HANDLE);
+					if (variant)
+					{
+						device.Dispatch((uint32_t)tiles.size(), 1, 1);
+					}
+					else
+					{
+						device.Dispatch(tilesX, tilesY, 1);
+					}
+					device.CSSetUnorderedAccessView(0, GFX_NULL_HANDLE);
+					device.CSSetShaderResource(1, GFX_NULL_HANDLE);
+
+					std::vector<uint32_t> image;
+					CHECK(ReadThroughBackBuffer(device, srv, width, height, image));
+					CHECK(image == expected.texels);
+				}
+
+				GfxHandle handles[] = { shaders[0], shaders[1], listSRV, list, constantBuffer };
+				for (GfxHandle handle : handles)
+				{
+					device.Release(handle);
+				}
+			}
+		}
+	}
+
+	GfxHandle handles[] = { srv, uav, texture, originBuffer, gradient, sourceSRV, sourceUAV, sourceTexture };
+	for (GfxHandle handle : handles)
+	{
+		device.Release(handle);
+	}
+	device.Cleanup();
+}
+
+// Every preset through the sample: batched, indirect, overlapped, automatic overlap and deferred recording must all
+// match plain per-tile dispatch, and the workload must change the image. With 8x8 tiles at 328x200 the tile list
+// spans two rows of the indirect dispatch.
+TEST(ComputeWorkload, SubmissionPathsMatchPerTile)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 328;
+	options.height = 200;
+
+	struct Path
+	{
+		bool bBatched;
+		bool bIndirect;
+		bool bOverlap;
+		bool bAutoOverlap;
+		uint32_t recordThreads;
+	};
+	const Path paths[] =
+	{
+		{ true,  false, false, false, 0 },   // batched
+		{ false, true,  false, false, 0 },   // indirect
+		{ false, false, true,  false, 0 },   // overlap
+		{ false, false, false, true,  0 },   // auto overlap
+		{ false, false, true,  false, 3 }    // deferred x3
+	};
+	const uint32_t tileSizes[] = { 8, 32 };
+
+	for (uint32_t tileSize : tileSizes)
+	{
+		options.tileSize = tileSize;
+
+		SampleFrame gradient;
+		options.workload = ComputeWorkload();
+		REQUIRE(RenderSample(options, false, 2, gradient));
+
+		for (uint32_t preset = 1; preset < GetComputeWorkloadPresetCount(); preset++)
+		{
+			options.workload = GetComputeWorkloadPreset(preset);
+			options.bUseBatchedDispatch = options.bUseIndirectDispatch = options.bUseUAVOverlap = options.bAutoUAVOverlap = false;
+			options.recordThreadCount = 0;
+
+			SampleFrame reference;
+			REQUIRE(RenderSample(options, false, 2, reference));
+			CHECK(reference.image != gradient.image);
+
+			for (const Path& path : paths)
+			{
+				options.bUseBatchedDispatch = path.bBatched;
+				options.bUseIndirectDispatch = path.bIndirect;
+				options.bUseUAVOverlap = path.bOverlap;
+				options.bAutoUAVOverlap = path.bAutoOverlap;
+				options.recordThreadCount = path.recordThreads;
+
+				SampleFrame frame;
+				CHECK(RenderSample(options, false, 2, frame));
+				CHECK(frame.image == reference.image);
+			}
+		}
+	}
+}
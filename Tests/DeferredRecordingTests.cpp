@@ -0,0 +1,51 @@
+/**********************************************************************************************************************
+ **	Name:        DeferredRecordingTests.cpp                                                                          **
+ **	Description: Checks that recording the compute pass on deferred contexts renders the same image as the immediate **
+ **              context, in every overlap mode, with and without the state filter                                   **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                        **
+ **	Published:   <insert date>                                                                                       **
+ *********************************************************************************************************************/
+
+#include "HeadlessRun.h"
+#include "SampleFixture.h"
+#include "UAVOverlapTest.h"
+
+#include <string>
+#include <vector>
+
+// Each thread count records the same dispatches, without hazards, and renders the immediate context's image
+TEST(DeferredRecording, MatchesImmediateContext)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 320;
+	options.height = 180;
+	options.tileSize = 8;
+
+	const uint32_t threadCounts[] = { 1, 3, 8 };
+	for (uint32_t useStateFilter = 0; useStateFilter < 2; useStateFilter++)
+	{
+		for (uint32_t mode = UAV_OVERLAP_OFF; mode <= UAV_OVERLAP_AUTO; mode++)
+		{
+			options.bUseUAVOverlap = (mode == UAV_OVERLAP_ALWAYS);
+			options.bAutoUAVOverlap = (mode == UAV_OVERLAP_AUTO);
+
+			SampleFrame reference;
+			options.recordThreadCount = 0;
+			REQUIRE(RenderSample(options, useStateFilter != 0, 3, reference));
+			CHECK(reference.recordThreadCount == 0);
+
+			for (uint32_t threads : threadCounts)
+			{
+				SampleFrame frame;
+				options.recordThreadCount = threads;
+				CHECK(RenderSample(options, useStateFilter != 0, 3, frame));
+				CHECK(frame.image == reference.image);
+				CHECK(frame.recordThreadCount == threads);
+				CHECK(frame.overlapStats.dispatchCount == reference.overlapStats.dispatchCount);
+				CHECK(frame.overlapStats.hazardCount == 0);
+			}
+		}
+	}
+}
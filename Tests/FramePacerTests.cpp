@@ -0,0 +1,139 @@
+/************************************************************************************************************************
+ **	Name:        FramePacerTests.cpp                                                                                   **
+ **	Description: Checks that the CPU device's frames-in-flight pipeline renders the same frames as running inline, and **
+ **              that its fences stay in order and bounded and its timestamps never resolve early                      **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                          **
+ **	Published:   <insert date>                                                                                         **
+ ***********************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "SampleFixture.h"
+#include "UAVOverlapSampleApp.h"
+#include "UAVOverlapTest.h"
+
+#include <string>
+#include <vector>
+
+// Drives the device directly: fence values only move forward, Present() never leaves more than framesInFlight - 1
+// earlier frames executing, and a timestamp never resolves before the frame it was taken in has finished
+static void CheckFences(uint32_t framesInFlight, uint32_t frames)
+{
+	const uint32_t width = 256;
+	const uint32_t height = 256;
+
+	CPUGraphicsDevice device(2);
+	device.SetMaxFramesInFlight(framesInFlight);
+	REQUIRE(device.Init(width, height));
+	CHECK(device.GetMaxFramesInFlight() == framesInFlight);
+
+	GfxTexture texture = device.CreateTexture2D(width, height, GFX_BIND_UNORDERED_ACCESS | GFX_BIND_SHADER_RESOURCE);
+	GfxView uav = device.CreateUnorderedAccessView(texture);
+	GfxShader shader = device.CreateComputeShader("ComputeShaderTile8");
+	UAVOverlapSampleApp::ConstantBuffer origin = { 0, 0, width, height, ComputeWorkload() };
+	GfxBuffer constantBuffer = device.CreateConstantBuffer(&origin, sizeof(origin));
+	GfxQuery timestamp = device.CreateQuery(GFX_QUERY_TIMESTAMP);
+
+	bool ordered = true;
+	bool bounded = true;
+	bool resolvedEarly = false;
+	uint64_t lastCompleted = 0;
+	uint64_t timestampFrame = 0;
+	for (uint32_t frame = 1; frame <= frames; frame++)
+	{
+		// A frame of per-tile dispatches, long enough for the timeline to still be busy when the next one starts
+		device.CSSetShader(shader);
+		device.CSSetUnorderedAccessView(0, uav);
+		device.CSSetConstantBuffer(0, constantBuffer);
+		for (uint32_t i = 0; i < 64; i++)
+		{
+			device.Dispatch(width / 8, height / 8, 1);
+		}
+
+		uint64_t ticks = 0;
+		if (timestampFrame != 0 && device.GetTimestamp(timestamp, ticks))
+		{
+			resolvedEarly |= device.GetCompletedFrame() < timestampFrame;
+			timestampFrame = 0;
+		}
+		if (timestampFrame == 0)
+		{
+			device.End(timestamp);
+			timestampFrame = frame;
+		}
+
+		device.Present();
+
+		uint64_t completed = device.GetCompletedFrame();
+		ordered &= device.GetSubmittedFrame() == frame && completed >= lastCompleted && completed <= frame;
+		bounded &= frame - completed < framesInFlight;
+		lastCompleted = completed;
+	}
+	CHECK(ordered);
+	CHECK(bounded);
+	CHECK(!resolvedEarly);
+
+	device.WaitForFrame(frames);
+	CHECK(device.GetCompletedFrame() == frames);
+
+	GfxHandle handles[] = { timestamp, constantBuffer, shader, uav, texture };
+	for (GfxHandle handle : handles)
+	{
+		device.Release(handle);
+	}
+	device.Cleanup();
+}
+
+TEST(FramePacer, Fences)
+{
+	for (uint32_t framesInFlight = 1; framesInFlight <= GFX_MAX_FRAMES_IN_FLIGHT; framesInFlight++)
+	{
+		CheckFences(framesInFlight, 40);
+	}
+}
+
+// Every submission path renders the same frames with two and three frames in flight as with one
+TEST(FramePacer, SameFramesAtEveryDepth)
+{
+	struct Configuration
+	{
+		uint32_t tileSize;
+		bool bAutoUAVOverlap;
+		uint32_t recordThreadCount;
+		bool bUseIndirectDispatch;
+	};
+	const Configuration configurations[] =
+	{
+		{ 16, false, 0, false },   // per-tile 16x16
+		{ 8, true, 0, false },     // per-tile 8x8, auto overlap
+		{ 16, false, 3, false },   // deferred, 3 record threads
+		{ 32, false, 0, true }     // indirect 32x32
+	};
+
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 1000;
+	options.height = 700;
+
+	for (const Configuration& configuration : configurations)
+	{
+		options.tileSize = configuration.tileSize;
+		options.bAutoUAVOverlap = configuration.bAutoUAVOverlap;
+		options.recordThreadCount = configuration.recordThreadCount;
+		options.bUseIndirectDispatch = configuration.bUseIndirectDispatch;
+
+		// With the state filter in front, as the sample runs
+		SampleFrame reference;
+		options.framesInFlight = 1;
+		REQUIRE(RenderSample(options, true, 3, reference));
+
+		for (uint32_t framesInFlight = 2; framesInFlight <= GFX_MAX_FRAMES_IN_FLIGHT; framesInFlight++)
+		{
+			SampleFrame frame;
+			options.framesInFlight = framesInFlight;
+			CHECK(RenderSample(options, true, 3, frame));
+			CHECK(frame.image == reference.image);
+		}
+	}
+}
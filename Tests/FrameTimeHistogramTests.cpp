@@ -0,0 +1,147 @@
+/*****************************************************************************************************************
+ **	Name:        FrameTimeHistogramTests.cpp                                                                    **
+ **	Description: Percentiles of the frame time histogram against an exact sort, the rolling window and history, **
+ **              and no lost updates from concurrent Record() calls                                             **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                   **
+ **	Published:   <insert date>                                                                                  **
+ ****************************************************************************************************************/
+
+#include "FakeClock.h"
+#include "FrameTimeHistogram.h"
+#include "UAVOverlapTest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Exact nearest-rank percentile of a sorted sample
+static double ExactPercentileMs(const std::vector<uint64_t>& sorted, double percentile)
+{
+	size_t rank = (size_t)std::ceil(percentile / 100.0 * (double)sorted.size());
+	rank = rank < 1 ? 1 : rank;
+	return (double)sorted[rank - 1] / 1.0e6;
+}
+
+// Count and range exact, percentiles within half a bucket either side of the true value
+static void CheckPercentiles(const FrameTimeHistogram::Summary& summary, std::vector<uint64_t> values)
+{
+	std::sort(values.begin(), values.end());
+	REQUIRE(summary.count == values.size());
+	CHECK(summary.minMs == (double)values.front() / 1.0e6);
+	CHECK(summary.maxMs == (double)values.back() / 1.0e6);
+
+	const double tolerance = 0.5 / FrameTimeHistogram::SUB_BUCKET_COUNT + 1.0e-9;
+	const double percentiles[] = { 50.0, 95.0, 99.0 };
+	const double reported[] = { summary.p50Ms, summary.p95Ms, summary.p99Ms };
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		double exact = ExactPercentileMs(values, percentiles[i]);
+		CHECK(std::fabs(reported[i] - exact) <= exact * tolerance + 1.0e-6);
+	}
+}
+
+// A 60 Hz-ish log-normal distribution with occasional 3-6x stutters, driven through a FrameTimer on the fake clock
+static void RecordStutteringFrames(uint32_t frames, FrameTimeHistogram& histogram, std::vector<uint64_t>& values)
+{
+	std::mt19937_64 rng(1234);
+	std::lognormal_distribution<double> frameTime(std::log(16.6e6), 0.1);
+	std::uniform_real_distribution<double> stutter(0.0, 1.0);
+
+	gFakeClockNs = 0;
+	FrameTimer timer(FakeClock);
+	timer.Tick();
+	for (uint32_t i = 0; i < frames; i++)
+	{
+		uint64_t ns = (uint64_t)frameTime(rng);
+		if (stutter(rng) < 0.02)
+		{
+			ns *= 3 + (uint64_t)(stutter(rng) * 4.0);
+		}
+		gFakeClockNs += ns;
+		histogram.Record(timer.Tick());
+		values.push_back(ns);
+	}
+}
+
+TEST(FrameTimeHistogram, FrameTimerOnFakeClock)
+{
+	gFakeClockNs = 5000;
+	FrameTimer timer(FakeClock);
+	CHECK(timer.Tick() == 0);
+	gFakeClockNs += 16600000;
+	CHECK(timer.Tick() == 16600000);
+	CHECK(timer.Tick() == 0);
+}
+
+TEST(FrameTimeHistogram, PercentilesWithinBucket)
+{
+	FrameTimeHistogram histogram;
+	std::vector<uint64_t> values;
+	RecordStutteringFrames(100000, histogram, values);
+
+	CheckPercentiles(histogram.GetSummary(), values);
+	CheckPercentiles(histogram.GetRollingSummary(), std::vector<uint64_t>(values.end() - FrameTimeHistogram::HISTORY_SIZE, values.end()));
+}
+
+TEST(FrameTimeHistogram, HistoryOldestFirst)
+{
+	FrameTimeHistogram histogram;
+	std::vector<uint64_t> values;
+	RecordStutteringFrames(FrameTimeHistogram::HISTORY_SIZE * 3 + 17, histogram, values);
+
+	float history[FrameTimeHistogram::HISTORY_SIZE];
+	REQUIRE(histogram.GetHistoryMs(history, FrameTimeHistogram::HISTORY_SIZE) == FrameTimeHistogram::HISTORY_SIZE);
+	std::vector<uint64_t> recent(values.end() - FrameTimeHistogram::HISTORY_SIZE, values.end());
+	for (uint32_t i = 0; i < FrameTimeHistogram::HISTORY_SIZE; i++)
+	{
+		CHECK(history[i] == (float)((double)recent[i] / 1.0e6));
+	}
+}
+
+TEST(FrameTimeHistogram, PartialHistory)
+{
+	FrameTimeHistogram histogram;
+	std::vector<uint64_t> values;
+	RecordStutteringFrames(10, histogram, values);
+
+	float history[FrameTimeHistogram::HISTORY_SIZE];
+	CHECK(histogram.GetHistoryMs(history, FrameTimeHistogram::HISTORY_SIZE) == 10);
+	CheckPercentiles(histogram.GetRollingSummary(), values);
+
+	histogram.Reset();
+	CHECK(histogram.GetSummary().count == 0 && histogram.GetRollingSummary().count == 0);
+	CHECK(histogram.GetHistoryMs(history, FrameTimeHistogram::HISTORY_SIZE) == 0);
+}
+
+// Every Record() from several threads at once is counted, in the lifetime buckets and the rolling window
+TEST(FrameTimeHistogram, ConcurrentRecordsCounted)
+{
+	const uint32_t threadCounts[] = { 2, 4, 8 };
+	const uint32_t perThread = 50000;
+	for (uint32_t threads : threadCounts)
+	{
+		FrameTimeHistogram histogram;
+		std::vector<std::thread> workers;
+		for (uint32_t t = 0; t < threads; t++)
+		{
+			workers.push_back(std::thread([&histogram, perThread, t]()
+			{
+				uint64_t value = 1000000 + t * 7919;
+				for (uint32_t i = 0; i < perThread; i++)
+				{
+					histogram.Record(value);
+					value = (value * 6364136223846793005ull + 1442695040888963407ull) % 100000000ull;
+				}
+			}));
+		}
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+
+		CHECK(histogram.GetSummary().count == (uint64_t)perThread * threads);
+		CHECK(histogram.GetRollingSummary().count == FrameTimeHistogram::HISTORY_SIZE);
+	}
+}
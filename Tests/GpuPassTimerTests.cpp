@@ -0,0 +1,80 @@
+/**************************************************************************************************************
+ **	Name:        GpuPassTimerTests.cpp                                                                       **
+ **	Description: Checks the GpuPassTimer query ring on the CPU device with a fake clock and simulated result **
+ **              latency: every resolved time belongs to the frame it is reported for                        **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                **
+ **	Published:   <insert date>                                                                               **
+ *************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "FakeClock.h"
+#include "GpuPassTimer.h"
+#include "UAVOverlapTest.h"
+
+// Pass lengths that differ from frame to frame, so a result can be traced back to the frame it came from
+static uint64_t PassNs(uint64_t frame, uint32_t pass)
+{
+	return pass == 0 ? 2000000 + (frame % 7) * 100000 : 500000 + (frame % 5) * 10000;
+}
+
+// Runs frames through a timer whose results arrive latency frames late. Every resolved value must be exactly the
+// pass length of the frame the timer says it came from. While the ring is deep enough every frame is timed, each
+// exactly latency frames late; beyond that frames are skipped rather than waited for.
+static void CheckRing(uint32_t ringSize, uint32_t latency, uint32_t frames)
+{
+	gFakeClockNs = 0;
+	CPUGraphicsDevice device(1, FakeClock);
+	device.SetQueryLatency(latency);
+	REQUIRE(device.Init(64, 64));
+
+	GpuPassTimer timer;
+	bool ok = timer.Init(&device, 2, ringSize);
+	CHECK(ok);
+	uint64_t lastResolved = 0;
+	uint32_t maxLatency = 0;
+	bool traced = true;
+	for (uint64_t frame = 0; ok && frame < frames; frame++)
+	{
+		timer.BeginFrame();
+		gFakeClockNs += PassNs(frame, 0);
+		timer.EndPass(0);
+		gFakeClockNs += PassNs(frame, 1);
+		timer.EndPass(1);
+		timer.EndFrame();
+		device.Present();
+
+		if (timer.GetResolvedFrameCount() != lastResolved)
+		{
+			lastResolved = timer.GetResolvedFrameCount();
+			uint64_t source = frame - timer.GetResultLatencyFrames();
+			traced &= timer.GetLastPassMs(0) == (double)PassNs(source, 0) / 1.0e6;
+			traced &= timer.GetLastPassMs(1) == (double)PassNs(source, 1) / 1.0e6;
+			maxLatency = timer.GetResultLatencyFrames() > maxLatency ? timer.GetResultLatencyFrames() : maxLatency;
+		}
+	}
+	CHECK(traced);
+	CHECK(timer.GetResolvedFrameCount() > 0);
+
+	bool expectSkips = latency > ringSize;
+	CHECK((timer.GetSkippedFrameCount() > 0) == expectSkips);
+	if (!expectSkips)
+	{
+		CHECK(maxLatency == latency);
+		CHECK(timer.GetResolvedFrameCount() + latency == frames);
+	}
+
+	timer.Release();
+	device.Cleanup();
+}
+
+TEST(GpuPassTimer, QueryRing)
+{
+	const uint32_t ringSizes[] = { 1, 2, 4, 8 };
+	for (uint32_t ringSize : ringSizes)
+	{
+		for (uint32_t latency = 0; latency <= ringSize + 1; latency++)
+		{
+			CheckRing(ringSize, latency, 1000);
+		}
+	}
+}
@@ -0,0 +1,138 @@
+/*************************************************************************************************************
+ **	Name:        GradientKernelTests.cpp                                                                    **
+ **	Description: Checks every SIMD gradient row kernel the CPU supports bit-for-bit against the scalar one, **
+ **              per row with guard texels and through full frames of thread groups                         **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                               **
+ **	Published:   <insert date>                                                                              **
+ ************************************************************************************************************/
+
+#include "CPUComputeBackend.h"
+#include "UAVOverlapTest.h"
+
+#include <cstdio>
+#include <vector>
+
+// Compares one ISA against the scalar kernel over every start column and count up to 64 for a spread of widths,
+// plus full rows, including widths whose reciprocal rounds badly. Guard texels past the end catch tails and masked
+// stores that write too far. Returns the number of mismatching rows.
+static uint32_t CountRowMismatches(KernelISA isa)
+{
+	static const uint32_t widths[] = { 1, 3, 7, 8, 15, 16, 17, 33, 100, 255, 256, 257, 641, 1280, 1366, 1920, 2560, 3840, 7680 };
+
+	GradientRowKernel scalar = GetGradientRowKernel(KERNEL_ISA_SCALAR);
+	GradientRowKernel kernel = GetGradientRowKernel(isa);
+
+	const uint32_t guard = 0xDEADBEEF;
+	std::vector<uint32_t> expected;
+	std::vector<uint32_t> actual;
+
+	uint32_t mismatches = 0;
+	for (uint32_t width : widths)
+	{
+		float invWidth = 1.0f / (float)width;
+		uint32_t rowBits = PackUNorm4x8(0.0f, 0.25f, 0.5f, 1.0f);
+
+		for (uint32_t x = 0; x < width && x < 80; x++)
+		{
+			for (uint32_t count = 1; count <= 64 && x + count <= width; count++)
+			{
+				expected.assign(count + 16, guard);
+				actual.assign(count + 16, guard);
+				scalar(expected.data(), x, count, invWidth, rowBits);
+				kernel(actual.data(), x, count, invWidth, rowBits);
+				if (expected != actual)
+				{
+					if (mismatches == 0)
+					{
+						printf("  %s mismatch: width %u, x %u, count %u\n", GetKernelISAName(isa), width, x, count);
+					}
+					mismatches++;
+				}
+			}
+		}
+
+		expected.assign(width + 16, guard);
+		actual.assign(width + 16, guard);
+		scalar(expected.data(), 0, width, invWidth, rowBits);
+		kernel(actual.data(), 0, width, invWidth, rowBits);
+		if (expected != actual)
+		{
+			if (mismatches == 0)
+			{
+				printf("  %s mismatch: full row of width %u\n", GetKernelISAName(isa), width);
+			}
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+// Every thread group of a width x height frame with the given ISA selected, on the calling thread
+static void RenderFrame(KernelISA isa, uint32_t width, uint32_t height, uint32_t tileSize, CPUTexture2D& uav)
+{
+	TileGrid grid(width, height, tileSize);
+	std::vector<CPUComputeBackend::ConstantBuffer> tiles;
+	CPUComputeBackend::BuildTileConstants(grid, tiles);
+
+	CPUComputeBackend::SetKernelISA(isa);
+	uav = CPUTexture2D(width, height);
+	for (const CPUComputeBackend::ConstantBuffer& cb : tiles)
+	{
+		CPUComputeBackend::RunThreadGroup(cb, grid.GetTileSize(), 0, 0, uav);
+	}
+}
+
+TEST(GradientKernels, RowsMatchScalar)
+{
+	for (int isa = KERNEL_ISA_SCALAR + 1; isa < KERNEL_ISA_COUNT; isa++)
+	{
+		if (IsKernelISASupported((KernelISA)isa))
+		{
+			CHECK(CountRowMismatches((KernelISA)isa) == 0);
+		}
+	}
+}
+
+// The kernel is selected process-wide, so the default is put back afterwards
+TEST(GradientKernels, FramesMatchScalar)
+{
+	struct FrameSize
+	{
+		uint32_t width;
+		uint32_t height;
+		uint32_t tileSize;
+	};
+	const FrameSize sizes[] = { { 1280, 720, 16 }, { 1001, 777, 8 }, { 1366, 768, 32 } };
+
+	KernelISA defaultISA = CPUComputeBackend::GetKernelISA();
+	for (const FrameSize& size : sizes)
+	{
+		CPUTexture2D reference;
+		RenderFrame(KERNEL_ISA_SCALAR, size.width, size.height, size.tileSize, reference);
+		for (int isa = KERNEL_ISA_SCALAR + 1; isa < KERNEL_ISA_COUNT; isa++)
+		{
+			if (IsKernelISASupported((KernelISA)isa))
+			{
+				CPUTexture2D frame;
+				RenderFrame((KernelISA)isa, size.width, size.height, size.tileSize, frame);
+				CHECK(frame.texels == reference.texels);
+			}
+		}
+	}
+	CPUComputeBackend::SetKernelISA(defaultISA);
+}
+
+TEST(GradientKernels, UnsupportedISARejected)
+{
+	KernelISA defaultISA = CPUComputeBackend::GetKernelISA();
+	CHECK(IsKernelISASupported(KERNEL_ISA_SCALAR));
+	CHECK(IsKernelISASupported(defaultISA));
+	for (int isa = KERNEL_ISA_SCALAR; isa < KERNEL_ISA_COUNT; isa++)
+	{
+		if (!IsKernelISASupported((KernelISA)isa))
+		{
+			CHECK(!CPUComputeBackend::SetKernelISA((KernelISA)isa));
+			CHECK(CPUComputeBackend::GetKernelISA() == defaultISA);
+		}
+	}
+}
@@ -0,0 +1,79 @@
+/*******************************************************************************************************
+ **	Name:        HeadlessOptionsTests.cpp                                                             **
+ **	Description: Command line parsing of headless runs: defaults, rejected arguments and resize lists **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                         **
+ **	Published:   <insert date>                                                                        **
+ ******************************************************************************************************/
+
+#include "HeadlessRun.h"
+#include "UAVOverlapTest.h"
+
+#include <string>
+#include <vector>
+
+TEST(HeadlessOptions, Defaults)
+{
+	HeadlessOptions options;
+	REQUIRE(ParseHeadlessOptions(std::vector<std::string>(), options));
+	CHECK(!options.bHeadless);
+	CHECK(options.frameCount == 100);
+	CHECK(options.width == 1280 && options.height == 720);
+	CHECK(options.tileSize == 16);
+	CHECK(!options.bUseUAVOverlap && !options.bAutoUAVOverlap);
+	CHECK(!options.bUseBatchedDispatch && !options.bUseIndirectDispatch);
+	CHECK(options.bUseStateFilter);
+	CHECK(options.recordThreadCount == 0);
+	CHECK(options.framesInFlight == 1);
+	CHECK(options.captureFrames == 1);
+	CHECK(options.resizeWidths.empty() && options.resizeInterval == 10);
+	CHECK(options.startupBenchRuns == 0 && options.startupTracePath.empty());
+}
+
+TEST(HeadlessOptions, Flags)
+{
+	HeadlessOptions options;
+	REQUIRE(ParseHeadlessOptions({ "--headless", "--overlap", "--batched", "--no-state-filter", "--frames", "7", "--width", "320", "--height", "200",
+		"--tile", "32", "--record-threads", "3", "--frames-in-flight", "2" }, options));
+	CHECK(options.bHeadless && options.bUseUAVOverlap && options.bUseBatchedDispatch && !options.bUseStateFilter);
+	CHECK(options.frameCount == 7);
+	CHECK(options.width == 320 && options.height == 200);
+	CHECK(options.tileSize == 32);
+	CHECK(options.recordThreadCount == 3);
+	CHECK(options.framesInFlight == 2);
+}
+
+TEST(HeadlessOptions, RejectsMalformedArguments)
+{
+	HeadlessOptions options;
+	CHECK(!ParseHeadlessOptions({ "--unknown" }, options));
+	CHECK(!ParseHeadlessOptions({ "--frames", "ten" }, options));
+	CHECK(!ParseHeadlessOptions({ "--frames", "" }, options));
+	CHECK(!ParseHeadlessOptions({ "--width", "0" }, options));
+	CHECK(!ParseHeadlessOptions({ "--frames-in-flight", "0" }, options));
+	CHECK(!ParseHeadlessOptions({ "--frames-in-flight", "9" }, options));
+	CHECK(!ParseHeadlessOptions({ "--workload", "alu=x" }, options));
+
+	// A value-taking option without its value is unknown
+	CHECK(!ParseHeadlessOptions({ "--frames" }, options));
+}
+
+TEST(HeadlessOptions, ResizeList)
+{
+	HeadlessOptions options;
+	REQUIRE(ParseHeadlessOptions({ "--resize", "640x360,1280x720,96x64", "--resize-interval", "5" }, options));
+	REQUIRE(options.resizeWidths.size() == 3 && options.resizeHeights.size() == 3);
+	CHECK(options.resizeWidths[0] == 640 && options.resizeHeights[0] == 360);
+	CHECK(options.resizeWidths[2] == 96 && options.resizeHeights[2] == 64);
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	CHECK(!GetHeadlessResize(options, 0, width, height));
+	CHECK(!GetHeadlessResize(options, 4, width, height));
+	CHECK(GetHeadlessResize(options, 5, width, height) && width == 640 && height == 360);
+	CHECK(GetHeadlessResize(options, 15, width, height) && width == 96 && height == 64);
+	CHECK(GetHeadlessResize(options, 20, width, height) && width == 640 && height == 360);
+
+	CHECK(!ParseHeadlessOptions({ "--resize", "640x360," }, options));
+	CHECK(!ParseHeadlessOptions({ "--resize", "640x0" }, options));
+	CHECK(!ParseHeadlessOptions({ "--resize", "640" }, options));
+}
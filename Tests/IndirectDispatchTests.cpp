@@ -0,0 +1,133 @@
+/***********************************************************************************************************************
+ **	Name:        IndirectDispatchTests.cpp                                                                            **
+ **	Description: Checks that one DispatchIndirect over the tile list renders the same image as a dispatch per tile,   **
+ **              that deferred indirect dispatches read their arguments on execution and that bad offsets are dropped **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                         **
+ **	Published:   <insert date>                                                                                        **
+ **********************************************************************************************************************/
+
+#include "CPUComputeBackend.h"
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "SampleFixture.h"
+#include "UAVOverlapSampleApp.h"
+#include "UAVOverlapTest.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Every tile size and overlap mode, with and without the state filter. 1000x700 is not a multiple of any tile size,
+// and with 8x8 tiles the list spans several rows of the indirect dispatch.
+TEST(IndirectDispatch, MatchesPerTile)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 1000;
+	options.height = 700;
+
+	const uint32_t tileSizes[] = { 8, 16, 32 };
+	for (uint32_t tileSize : tileSizes)
+	{
+		options.tileSize = tileSize;
+		for (uint32_t useStateFilter = 0; useStateFilter < 2; useStateFilter++)
+		{
+			for (uint32_t mode = UAV_OVERLAP_OFF; mode <= UAV_OVERLAP_AUTO; mode++)
+			{
+				options.bUseUAVOverlap = (mode == UAV_OVERLAP_ALWAYS);
+				options.bAutoUAVOverlap = (mode == UAV_OVERLAP_AUTO);
+
+				SampleFrame reference;
+				SampleFrame indirect;
+				options.bUseIndirectDispatch = false;
+				REQUIRE(RenderSample(options, useStateFilter != 0, 3, reference));
+				options.bUseIndirectDispatch = true;
+				REQUIRE(RenderSample(options, useStateFilter != 0, 3, indirect));
+				CHECK(indirect.image == reference.image);
+				CHECK(indirect.computeCounters.commandCount < reference.computeCounters.commandCount);
+			}
+		}
+	}
+}
+
+// Indirect dispatches recorded on a deferred context read their arguments when the list executes, like on the GPU, and
+// an argument offset that is misaligned or runs past the buffer drops the dispatch
+TEST(IndirectDispatch, DeferredArguments)
+{
+	const uint32_t width = 96;
+	const uint32_t height = 64;
+	const uint32_t tileSize = 16;
+
+	CPUGraphicsDevice device(2);
+	REQUIRE(device.Init(width, height));
+
+	GfxTexture texture = device.CreateTexture2D(width, height, GFX_BIND_UNORDERED_ACCESS | GFX_BIND_SHADER_RESOURCE);
+	GfxView uav = device.CreateUnorderedAccessView(texture);
+	GfxView srv = device.CreateShaderResourceView(texture);
+	GfxShader perTile = device.CreateComputeShader("ComputeShader");
+	GfxShader tileList = device.CreateComputeShader("ComputeShaderList");
+
+	UAVOverlapSampleApp::ConstantBuffer origin = { 0, 0, width, height, ComputeWorkload() };
+	GfxBuffer constantBuffer = device.CreateConstantBuffer(&origin, sizeof(origin));
+
+	// Every tile in reverse order, so the list order is not the group order
+	std::vector<uint32_t> tiles;
+	for (uint32_t y = height / tileSize; y-- > 0;)
+	{
+		for (uint32_t x = width / tileSize; x-- > 0;)
+		{
+			tiles.push_back(PackTileListEntry(x, y));
+		}
+	}
+	GfxBuffer list = device.CreateStructuredBuffer(tiles.data(), sizeof(uint32_t), (uint32_t)tiles.size());
+	GfxView listSRV = device.CreateShaderResourceView(list);
+
+	// Zeroed arguments at offset 0 and the real ones at 12; the last word only makes offset 16 overrun by one
+	uint32_t arguments[7] = { 0, 0, 0, (uint32_t)tiles.size(), 1, 1, 0 };
+	GfxBuffer argumentBuffer = device.CreateIndirectArgumentBuffer(arguments, sizeof(arguments));
+
+	std::vector<uint32_t> blank;
+	CHECK(ReadThroughBackBuffer(device, srv, width, height, blank));
+
+	// Offset 14 is misaligned and offset 16 runs past the buffer: neither writes anything
+	std::unique_ptr<GfxDeferredContext> context = device.CreateDeferredContext();
+	context->CSSetShader(tileList);
+	context->CSSetUnorderedAccessView(0, uav);
+	context->CSSetConstantBuffer(0, constantBuffer);
+	context->CSSetShaderResource(0, listSRV);
+	context->DispatchIndirect(argumentBuffer, 14);
+	context->DispatchIndirect(argumentBuffer, 16);
+	context->FinishCommandList();
+	device.ExecuteCommandList(context.get());
+
+	std::vector<uint32_t> image;
+	CHECK(ReadThroughBackBuffer(device, srv, width, height, image));
+	CHECK(image == blank);
+
+	context->CSSetShader(tileList);
+	context->CSSetUnorderedAccessView(0, uav);
+	context->CSSetConstantBuffer(0, constantBuffer);
+	context->CSSetShaderResource(0, listSRV);
+	context->DispatchIndirect(argumentBuffer, 12);
+	context->FinishCommandList();
+	device.ExecuteCommandList(context.get());
+
+	std::vector<uint32_t> indirect;
+	CHECK(ReadThroughBackBuffer(device, srv, width, height, indirect));
+	CHECK(indirect != blank);
+
+	// The same tiles from the per-tile shader, as one batched dispatch
+	device.CSSetShader(perTile);
+	device.CSSetUnorderedAccessView(0, uav);
+	device.CSSetConstantBuffer(0, constantBuffer);
+	device.Dispatch(width / tileSize, height / tileSize, 1);
+	device.CSSetUnorderedAccessView(0, GFX_NULL_HANDLE);
+
+	std::vector<uint32_t> reference;
+	CHECK(ReadThroughBackBuffer(device, srv, width, height, reference));
+	CHECK(indirect == reference);
+
+	context.reset();
+	device.Cleanup();
+}
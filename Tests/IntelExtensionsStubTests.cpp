@@ -0,0 +1,224 @@
+/******************************************************************************************************************
+ **	Name:        IntelExtensionsStubTests.cpp                                                                    **
+ **	Description: Checks extension negotiation against the stub runtime: version selection, injected failures,    **
+ **              load/unload balance, bracket nesting and the serialized fallback when no context can be created **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                    **
+ **	Published:   <insert date>                                                                                   **
+ *****************************************************************************************************************/
+
+#include "HeadlessRun.h"
+#include "IntelExtensionsStub.h"
+#include "SampleFixture.h"
+#include "UAVOverlapTest.h"
+
+#include <string>
+#include <vector>
+
+// Starts and leaves the stub in its default configuration, so injected failures never reach other tests
+struct StubScope
+{
+	StubScope() { INTCStub_Reset(); }
+	~StubScope() { INTCStub_Reset(); }
+};
+
+static uint64_t Calls(INTCStubEntrypoint entrypoint)
+{
+	return INTCStub_GetCallStats(entrypoint).callCount;
+}
+
+static uint64_t Failures(INTCStubEntrypoint entrypoint)
+{
+	return INTCStub_GetCallStats(entrypoint).failureCount;
+}
+
+// Every successful load has been matched by an unload: one more unload is rejected. Costs one unload failure.
+static bool IsLibraryUnloaded()
+{
+	uint64_t failures = Failures(INTC_STUB_UNLOAD_LIBRARY);
+	INTC_UnloadExtensionsLibrary();
+	return Failures(INTC_STUB_UNLOAD_LIBRARY) == failures + 1;
+}
+
+static INTCExtensionVersion Version(uint32_t hwFeatureLevel, uint32_t apiVersion, uint32_t revision)
+{
+	INTCExtensionVersion version = { hwFeatureLevel, apiVersion, revision };
+	return version;
+}
+
+// Counts the overlap brackets the stub hands on
+static void CountBracket(void* userData, bool begin)
+{
+	uint32_t* counts = static_cast<uint32_t*>(userData);
+	counts[begin ? 0 : 1]++;
+}
+
+// A context is only created for a version at or above 1.2.0, and the library is unloaded again when there is none
+TEST(IntelExtensionsStub, VersionNegotiation)
+{
+	StubScope stub;
+	INTCExtensionContext* context = nullptr;
+
+	INTCStub_SetSupportedVersions(std::vector<INTCExtensionVersion>(1, Version(1, 1, 0)));
+	CHECK(!CreateIntelExtensionContext(nullptr, &context));
+	CHECK(context == nullptr);
+	CHECK(Calls(INTC_STUB_GET_SUPPORTED_VERSIONS) == 2);
+	CHECK(Calls(INTC_STUB_CREATE_CONTEXT) == 0);
+	CHECK(Calls(INTC_STUB_LOAD_LIBRARY) == 1 && Calls(INTC_STUB_UNLOAD_LIBRARY) == 1);
+
+	// No versions at all stops after the count query
+	INTCStub_ResetCallStats();
+	INTCStub_SetSupportedVersions(std::vector<INTCExtensionVersion>());
+	CHECK(!CreateIntelExtensionContext(nullptr, &context));
+	CHECK(context == nullptr);
+	CHECK(Calls(INTC_STUB_GET_SUPPORTED_VERSIONS) == 1);
+	CHECK(Calls(INTC_STUB_UNLOAD_LIBRARY) == 1);
+
+	// The first acceptable version in the list is requested, and the stub accepts it
+	INTCStub_ResetCallStats();
+	std::vector<INTCExtensionVersion> versions;
+	versions.push_back(Version(1, 1, 0));
+	versions.push_back(Version(1, 3, 0));
+	versions.push_back(Version(1, 2, 0));
+	INTCStub_SetSupportedVersions(versions);
+	CHECK(CreateIntelExtensionContext(nullptr, &context));
+	CHECK(context != nullptr);
+	CHECK(Calls(INTC_STUB_CREATE_CONTEXT) == 1 && Failures(INTC_STUB_CREATE_CONTEXT) == 0);
+	CHECK(DestroyIntelExtensionContext(&context));
+	CHECK(context == nullptr);
+	CHECK(Calls(INTC_STUB_LOAD_LIBRARY) == 1 && Calls(INTC_STUB_UNLOAD_LIBRARY) == 1);
+	CHECK(IsLibraryUnloaded());
+}
+
+// An injected failure in any step fails the negotiation, after skipCalls successful calls, and leaves nothing loaded
+TEST(IntelExtensionsStub, FailureInjection)
+{
+	StubScope stub;
+	INTCExtensionContext* context = nullptr;
+
+	INTCStub_SetFailure(INTC_STUB_LOAD_LIBRARY, E_FAIL);
+	CHECK(!CreateIntelExtensionContext(nullptr, &context));
+	CHECK(context == nullptr);
+	CHECK(Failures(INTC_STUB_LOAD_LIBRARY) == 1);
+	CHECK(Calls(INTC_STUB_GET_SUPPORTED_VERSIONS) == 0 && Calls(INTC_STUB_UNLOAD_LIBRARY) == 0);
+
+	// The second version query, which fills in the table, fails
+	INTCStub_Reset();
+	INTCStub_SetFailure(INTC_STUB_GET_SUPPORTED_VERSIONS, E_OUTOFMEMORY, 1);
+	CHECK(!CreateIntelExtensionContext(nullptr, &context));
+	CHECK(context == nullptr);
+	CHECK(Calls(INTC_STUB_GET_SUPPORTED_VERSIONS) == 2 && Failures(INTC_STUB_GET_SUPPORTED_VERSIONS) == 1);
+	CHECK(Calls(INTC_STUB_CREATE_CONTEXT) == 0);
+	CHECK(Calls(INTC_STUB_UNLOAD_LIBRARY) == 1 && Failures(INTC_STUB_UNLOAD_LIBRARY) == 0);
+
+	// Context creation succeeds once, then fails until the failures are cleared
+	INTCStub_Reset();
+	INTCStub_SetFailure(INTC_STUB_CREATE_CONTEXT, E_OUTOFMEMORY, 1);
+	INTCExtensionContext* first = nullptr;
+	CHECK(CreateIntelExtensionContext(nullptr, &first));
+	CHECK(first != nullptr);
+	CHECK(!CreateIntelExtensionContext(nullptr, &context));
+	CHECK(!CreateIntelExtensionContext(nullptr, &context));
+	CHECK(context == nullptr);
+	CHECK(Calls(INTC_STUB_CREATE_CONTEXT) == 3 && Failures(INTC_STUB_CREATE_CONTEXT) == 2);
+	INTCStub_ClearFailures();
+	CHECK(CreateIntelExtensionContext(nullptr, &context));
+	CHECK(DestroyIntelExtensionContext(&context));
+	CHECK(DestroyIntelExtensionContext(&first));
+	CHECK(Calls(INTC_STUB_LOAD_LIBRARY) == 4 && Calls(INTC_STUB_UNLOAD_LIBRARY) == 4);
+
+	// A failed destroy is reported, and the library is still unloaded
+	INTCStub_ResetCallStats();
+	CHECK(CreateIntelExtensionContext(nullptr, &context));
+	INTCStub_SetFailure(INTC_STUB_DESTROY_CONTEXT, E_FAIL);
+	INTCExtensionContext* leaked = context;
+	CHECK(!DestroyIntelExtensionContext(&context));
+	CHECK(context == nullptr);
+	CHECK(Failures(INTC_STUB_DESTROY_CONTEXT) == 1 && Calls(INTC_STUB_UNLOAD_LIBRARY) == 1);
+	INTCStub_ClearFailures();
+	CHECK(SUCCEEDED(INTC_DestroyDeviceExtensionContext(&leaked)));
+	CHECK(IsLibraryUnloaded());
+}
+
+// Repeated create and destroy cycles, and a null context, leave the load count where it started
+TEST(IntelExtensionsStub, LoadUnloadBalance)
+{
+	StubScope stub;
+	CHECK(IsLibraryUnloaded());
+	INTCStub_ResetCallStats();
+
+	INTCExtensionContext* contexts[3] = {};
+	for (INTCExtensionContext*& context : contexts)
+	{
+		CHECK(CreateIntelExtensionContext(nullptr, &context));
+	}
+	for (INTCExtensionContext*& context : contexts)
+	{
+		CHECK(DestroyIntelExtensionContext(&context));
+	}
+
+	INTCExtensionContext* none = nullptr;
+	CHECK(DestroyIntelExtensionContext(&none));
+	CHECK(Calls(INTC_STUB_LOAD_LIBRARY) == 3);
+	CHECK(Calls(INTC_STUB_UNLOAD_LIBRARY) == 3 && Failures(INTC_STUB_UNLOAD_LIBRARY) == 0);
+	CHECK(Calls(INTC_STUB_DESTROY_CONTEXT) == 3);
+	CHECK(IsLibraryUnloaded());
+}
+
+// Brackets do not nest: a second Begin or an unmatched End is rejected and never reaches the handler
+TEST(IntelExtensionsStub, NestedBracketsRejected)
+{
+	StubScope stub;
+	INTCExtensionContext* context = nullptr;
+	REQUIRE(CreateIntelExtensionContext(nullptr, &context));
+
+	uint32_t brackets[2] = {};
+	INTCStub_SetOverlapHandler(context, CountBracket, brackets);
+
+	CHECK(INTC_D3D11_EndUAVOverlap(context) == E_FAIL);
+	CHECK(INTC_D3D11_BeginUAVOverlap(context) == S_OK);
+	CHECK(INTC_D3D11_BeginUAVOverlap(context) == E_FAIL);
+	CHECK(INTCStub_GetOverlapDepth(context) == 1);
+	CHECK(INTC_D3D11_EndUAVOverlap(context) == S_OK);
+	CHECK(INTC_D3D11_EndUAVOverlap(context) == E_FAIL);
+	CHECK(INTCStub_GetOverlapDepth(context) == 0);
+	CHECK(INTC_D3D11_BeginUAVOverlap(nullptr) == E_INVALIDARG);
+
+	CHECK(brackets[0] == 1 && brackets[1] == 1);
+	CHECK(Calls(INTC_STUB_BEGIN_UAV_OVERLAP) == 3 && Failures(INTC_STUB_BEGIN_UAV_OVERLAP) == 2);
+	CHECK(Calls(INTC_STUB_END_UAV_OVERLAP) == 3 && Failures(INTC_STUB_END_UAV_OVERLAP) == 2);
+
+	CHECK(DestroyIntelExtensionContext(&context));
+	CHECK(IsLibraryUnloaded());
+}
+
+// Without a context, --overlap falls back to serialized dispatch: no brackets, and the same image as overlap off
+TEST(IntelExtensionsStub, SerializedFallback)
+{
+	StubScope stub;
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 160;
+	options.height = 96;
+
+	SampleFrame serialized;
+	REQUIRE(RenderSample(options, false, 2, serialized));
+
+	options.bUseUAVOverlap = true;
+	SampleFrame overlapped;
+	REQUIRE(RenderSample(options, false, 2, overlapped));
+	CHECK(overlapped.overlapStats.bracketCount > 0);
+	CHECK(Calls(INTC_STUB_BEGIN_UAV_OVERLAP) > 0 && Failures(INTC_STUB_BEGIN_UAV_OVERLAP) == 0);
+
+	INTCStub_ResetCallStats();
+	INTCStub_SetFailure(INTC_STUB_CREATE_CONTEXT, E_OUTOFMEMORY);
+	SampleFrame fallback;
+	REQUIRE(RenderSample(options, false, 2, fallback));
+	CHECK(Failures(INTC_STUB_CREATE_CONTEXT) == 1);
+	CHECK(fallback.overlapStats.bracketCount == 0);
+	CHECK(Calls(INTC_STUB_BEGIN_UAV_OVERLAP) == 0 && Calls(INTC_STUB_END_UAV_OVERLAP) == 0);
+	CHECK(Calls(INTC_STUB_LOAD_LIBRARY) == Calls(INTC_STUB_UNLOAD_LIBRARY));
+	CHECK(fallback.image == serialized.image);
+	CHECK(overlapped.image == serialized.image);
+	CHECK(IsLibraryUnloaded());
+}
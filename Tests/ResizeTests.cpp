@@ -0,0 +1,272 @@
+/*******************************************************************************************************************
+ **	Name:        ResizeTests.cpp                                                                                  **
+ **	Description: Checks that resizing the sample at runtime follows its resize plan, rebuilds only what the new   **
+ **              size invalidates, renders the same image as a fresh Init at that size and replays from a capture **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                     **
+ **	Published:   <insert date>                                                                                    **
+ ******************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "CommandReplay.h"
+#include "GraphicsDeviceDecorator.h"
+#include "HeadlessRun.h"
+#include "RecordingGraphicsDevice.h"
+#include "ResizePlan.h"
+#include "SampleFixture.h"
+#include "StateFilterGraphicsDevice.h"
+#include "UAVOverlapSampleApp.h"
+#include "UAVOverlapTest.h"
+
+#include <vector>
+
+// Counts the objects the app creates and releases, so a resize can be compared with a fresh Init
+class ResourceCountingDevice : public GraphicsDeviceDecorator
+{
+public:
+	explicit ResourceCountingDevice(GraphicsDevice* inner) : GraphicsDeviceDecorator(inner), mTextureCount(0), mCreateCount(0), mReleaseCount(0) {}
+
+	uint32_t GetTextureCount() const { return mTextureCount; }
+	uint32_t GetCreateCount() const { return mCreateCount; }
+	uint32_t GetLiveCount() const { return mCreateCount - mReleaseCount; }
+
+	virtual GfxTexture CreateTexture2D(uint32_t width, uint32_t height, uint32_t bindFlags) { mTextureCount++; return Count(mInner->CreateTexture2D(width, height, bindFlags)); }
+	virtual GfxView CreateShaderResourceView(GfxTexture texture) { return Count(mInner->CreateShaderResourceView(texture)); }
+	virtual GfxView CreateUnorderedAccessView(GfxTexture texture) { return Count(mInner->CreateUnorderedAccessView(texture)); }
+	virtual GfxView CreateRenderTargetView(GfxTexture texture) { return Count(mInner->CreateRenderTargetView(texture)); }
+	virtual GfxBuffer CreateConstantBuffer(const void* data, uint32_t byteWidth) { return Count(mInner->CreateConstantBuffer(data, byteWidth)); }
+	virtual GfxBuffer CreateVertexBuffer(const void* data, uint32_t byteWidth) { return Count(mInner->CreateVertexBuffer(data, byteWidth)); }
+	virtual GfxBuffer CreateStructuredBuffer(const void* data, uint32_t stride, uint32_t count) { return Count(mInner->CreateStructuredBuffer(data, stride, count)); }
+	virtual GfxBuffer CreateIndirectArgumentBuffer(const void* data, uint32_t byteWidth) { return Count(mInner->CreateIndirectArgumentBuffer(data, byteWidth)); }
+	virtual GfxShader CreateComputeShader(const char* name) { return Count(mInner->CreateComputeShader(name)); }
+	virtual GfxShader CreateVertexShader(const char* name) { return Count(mInner->CreateVertexShader(name)); }
+	virtual GfxShader CreatePixelShader(const char* name) { return Count(mInner->CreatePixelShader(name)); }
+	virtual GfxInputLayout CreateInputLayout(GfxShader vertexShader) { return Count(mInner->CreateInputLayout(vertexShader)); }
+	virtual GfxQuery CreateQuery(GfxQueryType type) { return Count(mInner->CreateQuery(type)); }
+	virtual void Release(GfxHandle handle) { mReleaseCount += (handle != GFX_NULL_HANDLE) ? 1 : 0; mInner->Release(handle); }
+
+private:
+	GfxHandle Count(GfxHandle handle)
+	{
+		mCreateCount += (handle != GFX_NULL_HANDLE) ? 1 : 0;
+		return handle;
+	}
+
+	uint32_t mTextureCount;
+	uint32_t mCreateCount;
+	uint32_t mReleaseCount;
+};
+
+struct PlanCase
+{
+	uint32_t width, height, allocatedWidth, allocatedHeight, newWidth, newHeight;
+	uint32_t expectedWidth, expectedHeight;
+	bool bResizeBuffers, bReallocateTextures, bUpdateTexCoords;
+};
+
+TEST(Resize, Plan)
+{
+	const PlanCase cases[] =
+	{
+		{ 320, 200, 320, 200, 320, 200, 320, 200, false, false, false },   // Same size
+		{ 320, 200, 320, 200, 200, 136, 320, 200, true, false, true },     // Shrink into the pool
+		{ 640, 360, 640, 360, 320, 180, 640, 360, true, false, true },     // Exactly a quarter of the pool still in use
+		{ 640, 360, 640, 360, 319, 180, 319, 180, true, true, false },     // Under a quarter, trimmed
+		{ 96, 64, 96, 64, 328, 200, 328, 200, true, true, false },         // Grow
+		{ 256, 160, 328, 200, 328, 200, 328, 200, true, false, true },     // Grow back within the pool
+		{ 320, 200, 320, 200, 200, 300, 320, 300, true, true, true },      // Taller but narrower, grows one dimension
+		{ 200, 100, 400, 200, 100, 50, 100, 50, true, true, true }         // Trimmed to the new size, all of it in use
+	};
+
+	for (const PlanCase& c : cases)
+	{
+		ResizePlan plan = PlanResize(c.width, c.height, c.allocatedWidth, c.allocatedHeight, c.newWidth, c.newHeight);
+		CHECK(plan.width == c.newWidth && plan.height == c.newHeight);
+		CHECK(plan.allocatedWidth == c.expectedWidth && plan.allocatedHeight == c.expectedHeight);
+		CHECK(plan.bResizeBuffers == c.bResizeBuffers);
+		CHECK(plan.bReallocateTextures == c.bReallocateTextures);
+		CHECK(plan.bUpdateTexCoords == c.bUpdateTexCoords);
+		CHECK(plan.bRebuildTiles == c.bResizeBuffers && plan.bRebuildSource == c.bResizeBuffers);
+	}
+}
+
+// Objects alive after a fresh Init at width x height, with the options a resized app uses
+static bool CountFreshInit(const HeadlessOptions& options, uint32_t width, uint32_t height, uint32_t& liveCount)
+{
+	CPUGraphicsDevice cpuDevice(1);
+	ResourceCountingDevice counter(&cpuDevice);
+	UAVOverlapSampleApp app(&counter, width, height);
+	app.ApplyOptions(options);
+	bool ok = app.Init();
+	liveCount = counter.GetLiveCount();
+	app.Cleanup();
+	return ok;
+}
+
+// Textures created by each resize, and no objects leaked or missing compared with a fresh Init at the new size. ImGui
+// has one current context, so the fresh apps are counted before the resized one exists.
+TEST(Resize, Resources)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.framesInFlight = 2;
+
+	struct ResourceStep
+	{
+		uint32_t width, height;
+		uint32_t expectedTextures;   // Workload source, plus one sample texture per frame in flight when the pool is reallocated
+	};
+	const ResourceStep steps[] =
+	{
+		{ 200, 136, 1 },
+		{ 96, 64, 3 },
+		{ 328, 200, 3 },
+		{ 256, 160, 1 },
+		{ 328, 200, 1 }
+	};
+	const uint32_t stepCount = sizeof(steps) / sizeof(steps[0]);
+
+	uint32_t freshCounts[stepCount] = {};
+	for (uint32_t i = 0; i < stepCount; i++)
+	{
+		CHECK(CountFreshInit(options, steps[i].width, steps[i].height, freshCounts[i]));
+	}
+
+	CPUGraphicsDevice cpuDevice(1);
+	ResourceCountingDevice counter(&cpuDevice);
+	UAVOverlapSampleApp app(&counter, 320, 200);
+	app.ApplyOptions(options);
+	if (!app.Init())
+	{
+		app.Cleanup();
+		REQUIRE(!"Init failed");
+	}
+	app.Render(1.0);
+
+	for (uint32_t i = 0; i < stepCount; i++)
+	{
+		const ResourceStep& step = steps[i];
+		uint32_t textures = counter.GetTextureCount();
+		uint32_t reallocations = app.GetResizeReport().GetReallocationCount();
+		CHECK(app.Resize(step.width, step.height));
+		textures = counter.GetTextureCount() - textures;
+		app.Render(1.0);
+
+		std::vector<uint32_t> image;
+		CHECK(counter.GetLiveCount() == freshCounts[i]);
+		CHECK(textures == step.expectedTextures);
+		CHECK(app.GetResizeReport().GetReallocationCount() - reallocations == (step.expectedTextures > 1 ? 1u : 0u));
+		CHECK(counter.ReadBackBuffer(image) && image.size() == (size_t)step.width * step.height);
+	}
+
+	// Zero sizes, like a minimized window, are ignored
+	uint32_t createCount = counter.GetCreateCount();
+	CHECK(app.Resize(0, 0));
+	CHECK(app.Resize(app.GetWidth(), app.GetHeight()));
+	CHECK(counter.GetCreateCount() == createCount);
+	CHECK(app.GetWidth() == 328 && app.GetHeight() == 200);
+
+	app.Cleanup();
+}
+
+// Renders frames at each size of a resize sequence and reads back the last frame at each
+static bool RenderResized(const HeadlessOptions& options, const uint32_t (*sizes)[2], uint32_t sizeCount, uint32_t frames, std::vector<std::vector<uint32_t>>& images)
+{
+	CPUGraphicsDevice cpuDevice(2);
+	StateFilterGraphicsDevice stateFilter(&cpuDevice);
+
+	UAVOverlapSampleApp app(&stateFilter, options.width, options.height);
+	app.ApplyOptions(options);
+	if (!app.Init())
+	{
+		app.Cleanup();
+		return false;
+	}
+	app.Render(1.0);
+
+	bool ok = true;
+	images.resize(sizeCount);
+	for (uint32_t i = 0; i < sizeCount && ok; i++)
+	{
+		ok = app.Resize(sizes[i][0], sizes[i][1]);
+		for (uint32_t frame = 0; frame < frames && ok; frame++)
+		{
+			app.Render(1.0);
+		}
+		app.FinishFrames();
+		ok = ok && stateFilter.ReadBackBuffer(images[i]);
+	}
+	app.Cleanup();
+	return ok;
+}
+
+// Every submission path renders the same image after a resize as an app initialized at that size. The sequence shrinks
+// into the pool, trims it, grows past it, then shrinks into the new one; none of the sizes are tile multiples.
+TEST(Resize, SameImageAsFreshInit)
+{
+	const uint32_t sizes[][2] = { { 200, 136 }, { 96, 64 }, { 328, 200 }, { 256, 160 } };
+	const uint32_t sizeCount = sizeof(sizes) / sizeof(sizes[0]);
+	const uint32_t frames = 2;
+
+	for (uint32_t config = 0; config < 7; config++)
+	{
+		HeadlessOptions options;
+		ParseHeadlessOptions(std::vector<std::string>(), options);
+		options.bHeadless = true;
+		options.width = 320;
+		options.height = 200;
+		options.tileSize = 16;
+		options.bUseBatchedDispatch = (config == 1);
+		options.bUseIndirectDispatch = (config == 2);
+		options.bAutoUAVOverlap = (config == 3);
+		options.recordThreadCount = (config == 4) ? 2 : 0;
+		options.framesInFlight = (config == 5) ? 2 : 1;
+		if (config == 6)
+		{
+			ParseComputeWorkload("mixed", options.workload);
+		}
+
+		std::vector<std::vector<uint32_t>> images;
+		REQUIRE(RenderResized(options, sizes, sizeCount, frames, images));
+		for (uint32_t i = 0; i < sizeCount; i++)
+		{
+			SampleFrame fresh;
+			options.width = sizes[i][0];
+			options.height = sizes[i][1];
+			CHECK(RenderSample(options, true, frames, fresh));
+			CHECK(fresh.image.size() == (size_t)sizes[i][0] * sizes[i][1]);
+			CHECK(images[i] == fresh.image);
+		}
+	}
+}
+
+// A capture of a run with resizes replays, ResizeBuffers included
+TEST(Resize, CaptureReplays)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+
+	CPUGraphicsDevice cpuDevice(1);
+	StateFilterGraphicsDevice stateFilter(&cpuDevice);
+	RecordingGraphicsDevice recorder(&stateFilter, 0);
+
+	UAVOverlapSampleApp app(&recorder, 160, 96);
+	app.ApplyOptions(options);
+	bool ok = app.Init();
+	const uint32_t sizes[][2] = { { 96, 64 }, { 160, 96 }, { 200, 136 } };
+	for (const uint32_t* size : sizes)
+	{
+		app.Render(1.0);
+		ok = ok && app.Resize(size[0], size[1]);
+	}
+	app.Render(1.0);
+	app.Cleanup();
+	REQUIRE(ok);
+
+	ReplayReport report;
+	CPUGraphicsDevice replayDevice(1);
+	CHECK(ReplayCommandStream(recorder.GetCommandStream(), &replayDevice, report));
+	CHECK(report.opcodes[CMD_RESIZE_BUFFERS].count == 3);
+	CHECK(report.unmappedHandleCount == 0);
+}
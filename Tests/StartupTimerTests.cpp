@@ -0,0 +1,256 @@
+/********************************************************************************************************************
+ **	Name:        StartupTimerTests.cpp                                                                             **
+ **	Description: Checks the nesting, totals and appending of StartupTimer on a fake clock, the phases the sample's **
+ **              Init() reports, and --startup-bench with its Chrome trace on the CPU device                       **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                      **
+ **	Published:   <insert date>                                                                                     **
+ *******************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "FakeClock.h"
+#include "GraphicsDeviceDecorator.h"
+#include "HeadlessRun.h"
+#include "SampleUtils.h"
+#include "StartupBench.h"
+#include "StartupTimer.h"
+#include "UAVOverlapSampleApp.h"
+#include "UAVOverlapTest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+static bool IsPhase(const StartupTimer::Phase& phase, const char* name, uint32_t depth, uint64_t startNs, uint64_t durationNs, bool open)
+{
+	return phase.name == name && phase.depth == depth && phase.startNs == startNs && phase.durationNs == durationNs && phase.bOpen == open;
+}
+
+// Nested phases start from the first phase, count towards the total only at the top level, and an unmatched
+// EndPhase() or a phase still open changes nothing
+TEST(StartupTimer, FakeClock)
+{
+	gFakeClockNs = 5000;
+	StartupTimer timer(FakeClock);
+	timer.EndPhase();
+
+	timer.BeginPhase("device");
+	gFakeClockNs += 2000000;
+	timer.BeginPhase("adapter");
+	gFakeClockNs += 500000;
+	timer.EndPhase();
+	gFakeClockNs += 250000;
+	{
+		StartupPhaseScope scope(&timer, "swap chain");
+		gFakeClockNs += 1000000;
+	}
+	timer.EndPhase();
+	gFakeClockNs += 100000;
+	timer.BeginPhase("shaders");
+	gFakeClockNs += 3000000;
+	timer.EndPhase();
+	timer.BeginPhase("ui");
+	gFakeClockNs += 700000;
+
+	const std::vector<StartupTimer::Phase>& phases = timer.GetPhases();
+	REQUIRE(phases.size() == 5);
+	CHECK(IsPhase(phases[0], "device", 0, 0, 3750000, false));
+	CHECK(IsPhase(phases[1], "adapter", 1, 2000000, 500000, false));
+	CHECK(IsPhase(phases[2], "swap chain", 1, 2750000, 1000000, false));
+	CHECK(IsPhase(phases[3], "shaders", 0, 3850000, 3000000, false));
+	CHECK(IsPhase(phases[4], "ui", 0, 6850000, 0, true));
+	CHECK(timer.GetTotalNs() == 6750000);
+
+	// Ending "ui" and a stray EndPhase() after it
+	timer.EndPhase();
+	timer.EndPhase();
+	REQUIRE(phases.size() == 5);
+	CHECK(IsPhase(phases[4], "ui", 0, 6850000, 700000, false));
+	CHECK(timer.GetTotalNs() == 7450000);
+
+	// Reset() starts the clock again from the next phase
+	timer.Reset();
+	gFakeClockNs += 1000;
+	timer.BeginPhase("device");
+	gFakeClockNs += 42;
+	timer.EndPhase();
+	REQUIRE(phases.size() == 1);
+	CHECK(IsPhase(phases[0], "device", 0, 0, 42, false));
+	CHECK(timer.GetTotalNs() == 42);
+}
+
+// Appended phases keep their times on the outer timeline and nest in the phase open there; one still open in the
+// appended timer stays open
+TEST(StartupTimer, AppendedPhases)
+{
+	gFakeClockNs = 1000;
+	StartupTimer outer(FakeClock);
+	outer.BeginPhase("device constructor");
+	gFakeClockNs += 300;
+	outer.EndPhase();
+	outer.BeginPhase("Init()");
+	gFakeClockNs += 200;
+
+	StartupTimer inner(FakeClock);
+	inner.BeginPhase("device");
+	gFakeClockNs += 1000;
+	inner.BeginPhase("back buffer");
+	gFakeClockNs += 400;
+	inner.EndPhase();
+	inner.EndPhase();
+	inner.BeginPhase("shaders");
+	gFakeClockNs += 50;
+
+	outer.Append(inner);
+	outer.EndPhase();
+
+	const std::vector<StartupTimer::Phase>& phases = outer.GetPhases();
+	REQUIRE(phases.size() == 5);
+	CHECK(IsPhase(phases[0], "device constructor", 0, 0, 300, false));
+	CHECK(IsPhase(phases[1], "Init()", 0, 300, 1650, false));
+	CHECK(IsPhase(phases[2], "device", 1, 500, 1400, false));
+	CHECK(IsPhase(phases[3], "back buffer", 2, 1500, 400, false));
+	CHECK(IsPhase(phases[4], "shaders", 1, 1900, 0, true));
+	CHECK(outer.GetTotalNs() == 1950);
+}
+
+// Fails every compute shader, so Init() stops in its shader stage
+class NoComputeShaderDevice : public GraphicsDeviceDecorator
+{
+public:
+	explicit NoComputeShaderDevice(GraphicsDevice* inner) : GraphicsDeviceDecorator(inner) {}
+
+	virtual GfxShader CreateComputeShader(const char*) { return GFX_NULL_HANDLE; }
+};
+
+// The top-level phases are the first count stages, all ended unless lastOpen says the last one is still open
+static bool HasPhases(const StartupTimer& timer, const char* const* names, uint32_t count, bool lastOpen)
+{
+	std::vector<StartupTimer::Phase> topLevel;
+	for (const StartupTimer::Phase& phase : timer.GetPhases())
+	{
+		if (phase.depth == 0)
+		{
+			topLevel.push_back(phase);
+		}
+	}
+
+	bool ok = topLevel.size() == count;
+	for (uint32_t i = 0; ok && i < count; i++)
+	{
+		ok = topLevel[i].name == names[i] && topLevel[i].bOpen == (lastOpen && i + 1 == count);
+	}
+	return ok;
+}
+
+// Whether timer has an ended phase called name, depth levels down, inside one called parent
+static bool HasNestedPhase(const StartupTimer& timer, const char* parent, const char* name, uint32_t depth)
+{
+	const std::vector<StartupTimer::Phase>& phases = timer.GetPhases();
+	std::vector<std::string> enclosing;
+	for (const StartupTimer::Phase& phase : phases)
+	{
+		enclosing.resize(phase.depth);
+		if (phase.name == name && phase.depth == depth && !phase.bOpen && depth > 0 && enclosing[depth - 1] == parent)
+		{
+			return true;
+		}
+		enclosing.push_back(phase.name);
+	}
+	return false;
+}
+
+// Occurrences of pattern in the file at path, or 0 if it cannot be read
+static size_t CountTraceEvents(const char* path, const char* pattern)
+{
+	FILE* file = OpenFile(path, "rb");
+	if (file == nullptr)
+	{
+		return 0;
+	}
+	std::string text;
+	char buffer[4096];
+	size_t read = 0;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		text.append(buffer, read);
+	}
+	fclose(file);
+
+	size_t count = 0;
+	for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1))
+	{
+		count++;
+	}
+	return count;
+}
+
+// Every stage of a successful Init() is timed, and a failed stage is left open, out of the total
+TEST(StartupTimer, SampleInitStages)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+
+	const char* stages[] = { "device", "shaders", "resources", "deferred contexts", "ui", "pass timer" };
+	{
+		CPUGraphicsDevice device(2);
+		UAVOverlapSampleApp app(&device, options.width, options.height);
+		app.ApplyOptions(options);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		CHECK(app.Init());
+		uint64_t wallNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		const StartupTimer& timer = app.GetStartupTimer();
+		CHECK(HasPhases(timer, stages, 6, false));
+		CHECK(timer.GetTotalNs() <= wallNs);
+
+		// The CPU device's own steps, and the app's inside its stages
+		CHECK(HasNestedPhase(timer, "device", "back buffer", 1));
+		CHECK(HasNestedPhase(timer, "resources", "tile constant buffers", 1));
+		CHECK(HasNestedPhase(timer, "ui backend", "font atlas", 2));
+		app.Cleanup();
+	}
+	{
+		CPUGraphicsDevice device(2);
+		NoComputeShaderDevice failing(&device);
+		UAVOverlapSampleApp app(&failing, options.width, options.height);
+		app.ApplyOptions(options);
+		CHECK(!app.Init());
+		const StartupTimer& timer = app.GetStartupTimer();
+		CHECK(HasPhases(timer, stages, 2, true));
+		CHECK(!timer.GetPhases().empty() && timer.GetTotalNs() == timer.GetPhases()[0].durationNs);
+		app.Cleanup();
+	}
+}
+
+// Every --startup-bench run has the four top-level steps, and its trace an event per ended phase and a thread per run
+TEST(StartupTimer, StartupBenchTrace)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.startupBenchRuns = 2;
+	options.startupTracePath = "StartupTimerTests.json";
+
+	FILE* log = tmpfile();
+	REQUIRE(log != nullptr);
+	std::vector<StartupTimer> timers;
+	CHECK(RunStartupBench(options, []() { return std::unique_ptr<GraphicsDevice>(new CPUGraphicsDevice()); }, log, timers));
+	fclose(log);
+
+	const char* steps[] = { "device constructor", "Init()", "Cleanup()", "device destructor" };
+	size_t endedCount = 0;
+	for (const StartupTimer& timer : timers)
+	{
+		CHECK(HasPhases(timer, steps, 4, false));
+		for (const StartupTimer::Phase& phase : timer.GetPhases())
+		{
+			endedCount += phase.bOpen ? 0 : 1;
+		}
+	}
+	CHECK(timers.size() == options.startupBenchRuns);
+	CHECK(CountTraceEvents(options.startupTracePath.c_str(), "\"ph\": \"X\"") == endedCount);
+	CHECK(CountTraceEvents(options.startupTracePath.c_str(), "\"ph\": \"M\"") == options.startupBenchRuns);
+	remove(options.startupTracePath.c_str());
+}
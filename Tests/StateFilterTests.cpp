@@ -0,0 +1,248 @@
+/*********************************************************************************************************
+ **	Name:        StateFilterTests.cpp                                                                   **
+ **	Description: Checks the redundant state filter against a call-counting device, including the handle **
+ **              reuse and SRV/UAV hazard cases, and that the sample renders the same image through it  **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                           **
+ **	Published:   <insert date>                                                                          **
+ ********************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "GraphicsDeviceDecorator.h"
+#include "HeadlessRun.h"
+#include "StateFilterGraphicsDevice.h"
+#include "UAVOverlapSampleApp.h"
+#include "UAVOverlapTest.h"
+
+#include <vector>
+
+// Counts the state changes that reach the device underneath the filter
+class CountingGraphicsDevice : public GraphicsDeviceDecorator
+{
+public:
+	explicit CountingGraphicsDevice(GraphicsDevice* inner) : GraphicsDeviceDecorator(inner), mSetCount(0) {}
+
+	uint64_t GetSetCount() const { return mSetCount; }
+
+	virtual void CSSetShader(GfxShader shader) { mSetCount++; mInner->CSSetShader(shader); }
+	virtual void CSSetUnorderedAccessView(uint32_t slot, GfxView view) { mSetCount++; mInner->CSSetUnorderedAccessView(slot, view); }
+	virtual void CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer) { mSetCount++; mInner->CSSetConstantBuffer(slot, buffer); }
+	virtual void OMSetRenderTarget(GfxView view) { mSetCount++; mInner->OMSetRenderTarget(view); }
+	virtual void RSSetViewport(float width, float height) { mSetCount++; mInner->RSSetViewport(width, height); }
+	virtual void IASetInputLayout(GfxInputLayout layout) { mSetCount++; mInner->IASetInputLayout(layout); }
+	virtual void IASetVertexBuffer(uint32_t slot, GfxBuffer buffer, uint32_t stride, uint32_t offset) { mSetCount++; mInner->IASetVertexBuffer(slot, buffer, stride, offset); }
+	virtual void VSSetShader(GfxShader shader) { mSetCount++; mInner->VSSetShader(shader); }
+	virtual void PSSetShader(GfxShader shader) { mSetCount++; mInner->PSSetShader(shader); }
+	virtual void PSSetShaderResource(uint32_t slot, GfxView view) { mSetCount++; mInner->PSSetShaderResource(slot, view); }
+
+private:
+	uint64_t mSetCount;
+};
+
+// A filter over a counting CPU device, with a texture viewed both ways, a compute shader and two constant buffers
+struct FilterFixture
+{
+	CPUGraphicsDevice cpuDevice;
+	CountingGraphicsDevice counter;
+	StateFilterGraphicsDevice filter;
+	bool bInitialized;
+	GfxView srv;
+	GfxView uav;
+	GfxShader shader;
+	GfxBuffer bufferA;
+	GfxBuffer bufferB;
+	uint64_t start;
+
+	FilterFixture() : cpuDevice(1), counter(&cpuDevice), filter(&counter), srv(GFX_NULL_HANDLE), uav(GFX_NULL_HANDLE), shader(GFX_NULL_HANDLE),
+		bufferA(GFX_NULL_HANDLE), bufferB(GFX_NULL_HANDLE), start(0)
+	{
+		bInitialized = filter.Init(64, 64);
+		if (bInitialized)
+		{
+			const uint32_t zero[4] = { 0, 0, 0, 0 };
+			GfxTexture texture = filter.CreateTexture2D(64, 64, GFX_BIND_SHADER_RESOURCE | GFX_BIND_UNORDERED_ACCESS);
+			srv = filter.CreateShaderResourceView(texture);
+			uav = filter.CreateUnorderedAccessView(texture);
+			shader = filter.CreateComputeShader("ComputeShader");
+			bufferA = filter.CreateConstantBuffer(zero, sizeof(zero));
+			bufferB = filter.CreateConstantBuffer(zero, sizeof(zero));
+		}
+	}
+
+	~FilterFixture()
+	{
+		filter.Cleanup();
+	}
+
+	// Calls forwarded to the device since the last call
+	uint64_t Forwarded()
+	{
+		uint64_t forwarded = counter.GetSetCount() - start;
+		start = counter.GetSetCount();
+		return forwarded;
+	}
+};
+
+TEST(StateFilter, UnbindOnFreshDevice)
+{
+	FilterFixture fixture;
+	REQUIRE(fixture.bInitialized);
+	fixture.Forwarded();
+	fixture.filter.CSSetShader(GFX_NULL_HANDLE);
+	fixture.filter.PSSetShaderResource(0, GFX_NULL_HANDLE);
+	CHECK(fixture.Forwarded() == 0);
+}
+
+TEST(StateFilter, RebindShaderAndConstantBuffers)
+{
+	FilterFixture fixture;
+	REQUIRE(fixture.bInitialized);
+	StateFilterGraphicsDevice& filter = fixture.filter;
+	fixture.Forwarded();
+	filter.CSSetShader(fixture.shader);
+	filter.CSSetShader(fixture.shader);
+	filter.CSSetConstantBuffer(0, fixture.bufferA);
+	filter.CSSetConstantBuffer(0, fixture.bufferA);
+	filter.CSSetConstantBuffer(0, fixture.bufferB);
+	filter.CSSetConstantBuffer(1, fixture.bufferB);
+	CHECK(fixture.Forwarded() == 4);
+}
+
+TEST(StateFilter, ViewportAndVertexBufferCompareEveryArgument)
+{
+	FilterFixture fixture;
+	REQUIRE(fixture.bInitialized);
+	StateFilterGraphicsDevice& filter = fixture.filter;
+	fixture.Forwarded();
+	filter.RSSetViewport(64.0f, 64.0f);
+	filter.RSSetViewport(64.0f, 64.0f);
+	filter.RSSetViewport(32.0f, 64.0f);
+	filter.IASetVertexBuffer(0, fixture.bufferA, 20, 0);
+	filter.IASetVertexBuffer(0, fixture.bufferA, 20, 0);
+	filter.IASetVertexBuffer(0, fixture.bufferA, 20, 4);
+	CHECK(fixture.Forwarded() == 4);
+}
+
+// A released handle is reused by the next object of any kind, which must not look bound
+TEST(StateFilter, ReusedHandleAfterRelease)
+{
+	FilterFixture fixture;
+	REQUIRE(fixture.bInitialized);
+	StateFilterGraphicsDevice& filter = fixture.filter;
+	const uint32_t zero[4] = { 0, 0, 0, 0 };
+	filter.CSSetConstantBuffer(1, fixture.bufferB);
+	filter.Release(fixture.bufferB);
+	GfxBuffer reused = filter.CreateConstantBuffer(zero, sizeof(zero));
+	fixture.Forwarded();
+	filter.CSSetConstantBuffer(1, reused);
+	CHECK(fixture.Forwarded() == 1);
+}
+
+// Binding the texture as a UAV unbinds its SRV on D3D11, so binding the SRV again must reach the device
+TEST(StateFilter, SRVAfterItsTextureWasBoundAsUAV)
+{
+	FilterFixture fixture;
+	REQUIRE(fixture.bInitialized);
+	StateFilterGraphicsDevice& filter = fixture.filter;
+	filter.PSSetShaderResource(0, fixture.srv);
+	filter.CSSetUnorderedAccessView(0, fixture.uav);
+	filter.CSSetUnorderedAccessView(0, GFX_NULL_HANDLE);
+	fixture.Forwarded();
+	filter.PSSetShaderResource(0, fixture.srv);
+	CHECK(fixture.Forwarded() == 1);
+}
+
+// An SRV bound while its texture is a UAV is bound as null on D3D11, so it is not assumed bound afterwards
+TEST(StateFilter, SRVBoundWhileItsTextureWasUAV)
+{
+	FilterFixture fixture;
+	REQUIRE(fixture.bInitialized);
+	StateFilterGraphicsDevice& filter = fixture.filter;
+	filter.CSSetUnorderedAccessView(0, fixture.uav);
+	filter.PSSetShaderResource(0, fixture.srv);
+	filter.CSSetUnorderedAccessView(0, GFX_NULL_HANDLE);
+	fixture.Forwarded();
+	filter.PSSetShaderResource(0, fixture.srv);
+	CHECK(fixture.Forwarded() == 1);
+}
+
+TEST(StateFilter, RenderTargetAcrossPresent)
+{
+	FilterFixture fixture;
+	REQUIRE(fixture.bInitialized);
+	StateFilterGraphicsDevice& filter = fixture.filter;
+	GfxView backBuffer = filter.GetBackBufferRTV();
+	filter.OMSetRenderTarget(backBuffer);
+	fixture.Forwarded();
+	filter.OMSetRenderTarget(backBuffer);
+	filter.Present();
+	filter.OMSetRenderTarget(backBuffer);
+	CHECK(fixture.Forwarded() == 1);
+}
+
+TEST(StateFilter, EveryBindingAfterInvalidate)
+{
+	FilterFixture fixture;
+	REQUIRE(fixture.bInitialized);
+	StateFilterGraphicsDevice& filter = fixture.filter;
+	filter.CSSetShader(fixture.shader);
+	filter.PSSetShaderResource(0, fixture.srv);
+	filter.Invalidate();
+	fixture.Forwarded();
+	filter.CSSetShader(fixture.shader);
+	filter.PSSetShaderResource(0, fixture.srv);
+	CHECK(fixture.Forwarded() == 2);
+}
+
+// Renders frames of the sample through the filter and without it. The images must match, the device must see exactly
+// the calls the filter reports as forwarded, and those plus the filtered ones are every call the app made.
+static void CheckSample(bool batched, bool overlap)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 320;
+	options.height = 180;
+	options.bUseBatchedDispatch = batched;
+	options.bUseUAVOverlap = overlap;
+
+	std::vector<uint32_t> images[2];
+	uint64_t calls[2] = { 0, 0 };
+	uint64_t forwarded = 0;
+	uint64_t filtered = 0;
+	for (uint32_t useFilter = 0; useFilter < 2; useFilter++)
+	{
+		CPUGraphicsDevice cpuDevice(1);
+		CountingGraphicsDevice counter(&cpuDevice);
+		StateFilterGraphicsDevice filter(&counter);
+		GraphicsDevice* device = useFilter ? static_cast<GraphicsDevice*>(&filter) : &counter;
+
+		UAVOverlapSampleApp app(device, options.width, options.height);
+		app.ApplyOptions(options);
+		bool initialized = app.Init();
+		CHECK(initialized);
+		for (uint32_t frame = 0; frame < 4 && initialized; frame++)
+		{
+			app.Render(1.0);
+		}
+		CHECK(device->ReadBackBuffer(images[useFilter]));
+		calls[useFilter] = counter.GetSetCount();
+		if (useFilter)
+		{
+			forwarded = filter.GetForwardedCount();
+			filtered = filter.GetFilteredCount();
+		}
+		app.Cleanup();
+	}
+
+	CHECK(!images[0].empty() && images[0] == images[1]);
+	CHECK(forwarded == calls[1]);
+	CHECK(forwarded + filtered == calls[0]);
+	CHECK(filtered > 0);
+}
+
+TEST(StateFilter, SampleRendersTheSameImage)
+{
+	CheckSample(false, false);
+	CheckSample(false, true);
+	CheckSample(true, false);
+}
@@ -0,0 +1,138 @@
+/************************************************************************************************************
+ **	Name:        SubmissionCounterTests.cpp                                                                **
+ **	Description: Checks the compute pass command counter against a device that records every compute call, **
+ **              and that batched and indirect submission issue a fixed number of calls per frame          **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                              **
+ **	Published:   <insert date>                                                                             **
+ ***********************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "GraphicsDeviceDecorator.h"
+#include "HeadlessRun.h"
+#include "TileGrid.h"
+#include "UAVOverlapSampleApp.h"
+#include "UAVOverlapTest.h"
+
+#include <vector>
+
+// Counts the compute calls of each frame, up to its Present()
+class ComputeCallRecorder : public GraphicsDeviceDecorator
+{
+public:
+	explicit ComputeCallRecorder(GraphicsDevice* inner) : GraphicsDeviceDecorator(inner), mCalls(), mLastFrame() {}
+
+	struct Calls
+	{
+		uint32_t total;
+		uint32_t dispatches;
+		uint32_t indirectDispatches;
+		uint32_t constantBuffers;
+	};
+
+	const Calls& GetLastFrame() const { return mLastFrame; }
+
+	virtual void CSSetShader(GfxShader shader) { mCalls.total++; mInner->CSSetShader(shader); }
+	virtual void CSSetUnorderedAccessView(uint32_t slot, GfxView view) { mCalls.total++; mInner->CSSetUnorderedAccessView(slot, view); }
+	virtual void CSSetConstantBuffer(uint32_t slot, GfxBuffer buffer) { mCalls.total++; mCalls.constantBuffers++; mInner->CSSetConstantBuffer(slot, buffer); }
+	virtual void CSSetShaderResource(uint32_t slot, GfxView view) { mCalls.total++; mInner->CSSetShaderResource(slot, view); }
+	virtual void Dispatch(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ) { mCalls.total++; mCalls.dispatches++; mInner->Dispatch(groupsX, groupsY, groupsZ); }
+	virtual void DispatchIndirect(GfxBuffer arguments, uint32_t byteOffset) { mCalls.total++; mCalls.indirectDispatches++; mInner->DispatchIndirect(arguments, byteOffset); }
+	virtual void BeginUAVOverlap() { mCalls.total++; mInner->BeginUAVOverlap(); }
+	virtual void EndUAVOverlap() { mCalls.total++; mInner->EndUAVOverlap(); }
+
+	virtual void Present()
+	{
+		mLastFrame = mCalls;
+		mCalls = Calls();
+		mInner->Present();
+	}
+
+private:
+	Calls mCalls;
+	Calls mLastFrame;
+};
+
+enum SubmissionMode
+{
+	SUBMIT_PER_TILE,
+	SUBMIT_BATCHED,
+	SUBMIT_INDIRECT
+};
+
+// Renders two frames with the recorder between the app and the device, and returns the app's counters of the last
+static bool RenderCounted(SubmissionMode mode, bool overlap, uint32_t tileSize, ComputeCallRecorder::Calls& calls,
+	UAVOverlapSampleApp::SubmissionCounters& counters)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 200;
+	options.height = 136;
+	options.tileSize = tileSize;
+	options.bUseUAVOverlap = overlap;
+	options.bUseBatchedDispatch = (mode == SUBMIT_BATCHED);
+	options.bUseIndirectDispatch = (mode == SUBMIT_INDIRECT);
+
+	CPUGraphicsDevice cpuDevice(1);
+	ComputeCallRecorder recorder(&cpuDevice);
+	UAVOverlapSampleApp app(&recorder, options.width, options.height);
+	app.ApplyOptions(options);
+	bool ok = app.Init();
+	for (uint32_t frame = 0; frame < 2 && ok; frame++)
+	{
+		app.Render(1.0);
+	}
+	calls = recorder.GetLastFrame();
+	counters = app.GetComputeCounters();
+	app.Cleanup();
+	return ok;
+}
+
+// The counter the Performance window shows is every compute call the device received in the frame
+TEST(SubmissionCounters, CountMatchesDeviceCalls)
+{
+	const SubmissionMode modes[] = { SUBMIT_PER_TILE, SUBMIT_BATCHED, SUBMIT_INDIRECT };
+	for (SubmissionMode mode : modes)
+	{
+		for (uint32_t overlap = 0; overlap < 2; overlap++)
+		{
+			ComputeCallRecorder::Calls calls;
+			UAVOverlapSampleApp::SubmissionCounters counters;
+			REQUIRE(RenderCounted(mode, overlap != 0, 16, calls, counters));
+			CHECK(counters.commandCount == calls.total);
+			CHECK(counters.submissionTimeMs >= 0.0);
+		}
+	}
+}
+
+// Per-tile submission binds a constant buffer and dispatches once per tile; batched and indirect submission issue the
+// same few calls whatever the tile count
+TEST(SubmissionCounters, BatchedSubmissionIsConstant)
+{
+	const uint32_t tileSizes[] = { 8, 16, 32 };
+	uint32_t batchedCalls[3] = {};
+	uint32_t indirectCalls[3] = {};
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		TileGrid grid(200, 136, tileSizes[i]);
+
+		ComputeCallRecorder::Calls calls;
+		UAVOverlapSampleApp::SubmissionCounters counters;
+		REQUIRE(RenderCounted(SUBMIT_PER_TILE, true, tileSizes[i], calls, counters));
+		CHECK(calls.dispatches == grid.GetTileCount() && calls.indirectDispatches == 0);
+		CHECK(calls.constantBuffers == grid.GetTileCount() + 1);
+		uint32_t perTileCalls = calls.total;
+
+		REQUIRE(RenderCounted(SUBMIT_BATCHED, true, tileSizes[i], calls, counters));
+		CHECK(calls.dispatches == 1 && calls.indirectDispatches == 0);
+		CHECK(calls.total < perTileCalls);
+		batchedCalls[i] = calls.total;
+
+		REQUIRE(RenderCounted(SUBMIT_INDIRECT, true, tileSizes[i], calls, counters));
+		CHECK(calls.dispatches == 0 && calls.indirectDispatches == 1);
+		CHECK(calls.total < perTileCalls);
+		indirectCalls[i] = calls.total;
+	}
+	CHECK(batchedCalls[0] == batchedCalls[1] && batchedCalls[1] == batchedCalls[2]);
+	CHECK(indirectCalls[0] == indirectCalls[1] && indirectCalls[1] == indirectCalls[2]);
+}
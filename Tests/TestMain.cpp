@@ -0,0 +1,75 @@
+/***********************************************************************************************************
+ **	Name:        TestMain.cpp                                                                             **
+ **	Description: Runs every registered test case, or those whose suite.name contains the filter argument, **
+ **              and exits non-zero if any of them failed                                                 **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                             **
+ **	Published:   <insert date>                                                                            **
+ **********************************************************************************************************/
+
+#include "UAVOverlapTest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct TestCase
+{
+	std::string name;   // suite.name
+	TestFn fn;
+};
+
+// Function-local so registrations in other translation units never run before it exists
+static std::vector<TestCase>& GetTestCases()
+{
+	static std::vector<TestCase> testCases;
+	return testCases;
+}
+
+static uint32_t gFailureCount = 0;
+
+TestRegistration::TestRegistration(const char* suite, const char* name, TestFn fn)
+{
+	TestCase testCase = { std::string(suite) + "." + name, fn };
+	GetTestCases().push_back(testCase);
+}
+
+void ReportTestFailure(const char* file, int line, const char* expression)
+{
+	printf("%s:%d: failed: %s\n", file, line, expression);
+	gFailureCount++;
+}
+
+int main(int argc, char** argv)
+{
+	const char* filter = (argc > 1) ? argv[1] : "";
+
+	std::vector<std::string> failed;
+	uint32_t runCount = 0;
+	for (const TestCase& testCase : GetTestCases())
+	{
+		if (testCase.name.find(filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		printf("[ RUN    ] %s\n", testCase.name.c_str());
+		fflush(stdout);
+		uint32_t failuresBefore = gFailureCount;
+		testCase.fn();
+		bool passed = (gFailureCount == failuresBefore);
+		printf("[ %s ] %s\n", passed ? "    OK" : "FAILED", testCase.name.c_str());
+		if (!passed)
+		{
+			failed.push_back(testCase.name);
+		}
+		runCount++;
+	}
+
+	printf("\n%u of %u test cases passed\n", runCount - (uint32_t)failed.size(), runCount);
+	for (const std::string& name : failed)
+	{
+		printf("  FAILED %s\n", name.c_str());
+	}
+	return (failed.empty() && runCount > 0) ? 0 : 1;
+}
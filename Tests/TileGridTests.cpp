@@ -0,0 +1,129 @@
+/**************************************************************************************************************
+ **	Name:        TileGridTests.cpp                                                                           **
+ **	Description: Checks that the tile grid and the CPU thread groups it dispatches write every pixel exactly **
+ **              once, right and bottom edge tiles included, at odd and large sizes and every tile size      **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                **
+ **	Published:   <insert date>                                                                               **
+ *************************************************************************************************************/
+
+#include "CPUComputeBackend.h"
+#include "TileGrid.h"
+#include "UAVOverlapTest.h"
+
+#include <vector>
+
+struct GridSize
+{
+	uint32_t width;
+	uint32_t height;
+};
+
+// 1x1, sizes that leave partial tiles on one or both edges, and sizes that are tile multiples
+static const GridSize gGridSizes[] = { { 1, 1 }, { 1, 777 }, { 1001, 1 }, { 1001, 777 }, { 33, 17 }, { 256, 128 }, { 3840, 2160 } };
+static const uint32_t gTileSizes[] = { 8, 16, 32 };
+
+TEST(TileGrid, EveryPixelWrittenOnce)
+{
+	for (const GridSize& size : gGridSizes)
+	{
+		for (uint32_t tileSize : gTileSizes)
+		{
+			TileGrid grid(size.width, size.height, tileSize);
+			REQUIRE(grid.GetTileSize() == tileSize);
+			CHECK(grid.GetTilesX() == TileGrid::CeilDiv(size.width, tileSize));
+			CHECK(grid.GetTilesY() == TileGrid::CeilDiv(size.height, tileSize));
+
+			std::vector<uint8_t> writes((size_t)size.width * size.height, 0);
+			bool inside = true;
+			for (uint32_t i = 0; i < grid.GetTileCount(); i++)
+			{
+				TileGrid::Tile tile = grid.GetTile(i);
+				inside &= tile.width > 0 && tile.height > 0 && tile.x + tile.width <= size.width && tile.y + tile.height <= size.height;
+				for (uint32_t y = tile.y; y < tile.y + tile.height && inside; y++)
+				{
+					for (uint32_t x = tile.x; x < tile.x + tile.width; x++)
+					{
+						writes[(size_t)y * size.width + x]++;
+					}
+				}
+			}
+			CHECK(inside);
+
+			bool once = true;
+			for (uint8_t count : writes)
+			{
+				once &= (count == 1);
+			}
+			CHECK(once);
+		}
+	}
+}
+
+TEST(TileGrid, EdgeTilesClipped)
+{
+	for (const GridSize& size : gGridSizes)
+	{
+		for (uint32_t tileSize : gTileSizes)
+		{
+			TileGrid grid(size.width, size.height, tileSize);
+			uint32_t lastWidth = size.width - (grid.GetTilesX() - 1) * tileSize;
+			uint32_t lastHeight = size.height - (grid.GetTilesY() - 1) * tileSize;
+
+			bool clipped = true;
+			for (uint32_t tileX = 0; tileX < grid.GetTilesX(); tileX++)
+			{
+				for (uint32_t tileY = 0; tileY < grid.GetTilesY(); tileY++)
+				{
+					TileGrid::Tile tile = grid.GetTile(grid.GetTileIndex(tileX, tileY));
+					bool rightEdge = (tileX + 1 == grid.GetTilesX());
+					bool bottomEdge = (tileY + 1 == grid.GetTilesY());
+					clipped &= tile.tileX == tileX && tile.tileY == tileY && tile.x == tileX * tileSize && tile.y == tileY * tileSize;
+					clipped &= tile.width == (rightEdge ? lastWidth : tileSize) && tile.height == (bottomEdge ? lastHeight : tileSize);
+					clipped &= grid.IsEdgeTile(tileX, tileY) == (tile.width < tileSize || tile.height < tileSize);
+				}
+			}
+			CHECK(clipped);
+		}
+	}
+}
+
+TEST(TileGrid, UnsupportedTileSizeFallsBackTo16)
+{
+	TileGrid grid(100, 50, 12);
+	CHECK(grid.GetTileSize() == 16);
+	CHECK(grid.GetTilesX() == 7 && grid.GetTilesY() == 4);
+}
+
+// The thread groups of every tile cover the window and stop at its right and bottom edges. The texture is a tile larger
+// than the window in each direction, so a group running past the edge would write into the margin. Every texel the
+// shader writes has alpha 1, so zero marks one it never reached.
+TEST(TileGrid, ThreadGroupsCoverWindow)
+{
+	for (const GridSize& size : gGridSizes)
+	{
+		for (uint32_t tileSize : gTileSizes)
+		{
+			TileGrid grid(size.width, size.height, tileSize);
+			std::vector<CPUComputeBackend::ConstantBuffer> tiles;
+			CPUComputeBackend::BuildTileConstants(grid, tiles);
+			REQUIRE(tiles.size() == grid.GetTileCount());
+
+			CPUTexture2D uav(size.width + tileSize, size.height + tileSize);
+			for (const CPUComputeBackend::ConstantBuffer& cb : tiles)
+			{
+				CPUComputeBackend::RunThreadGroup(cb, tileSize, 0, 0, uav);
+			}
+
+			bool covered = true;
+			for (uint32_t y = 0; y < uav.height; y++)
+			{
+				for (uint32_t x = 0; x < uav.width; x++)
+				{
+					bool written = uav.texels[(size_t)y * uav.width + x] != 0;
+					covered &= written == (x < size.width && y < size.height);
+				}
+			}
+			CHECK(covered);
+		}
+	}
+}
@@ -0,0 +1,176 @@
+/********************************************************************************************************************
+ **	Name:        UAVHazardTests.cpp                                                                                **
+ **	Description: Checks the UAV footprint index against brute force, the automatic overlap brackets against a call **
+ **              log, and that the sample renders the same image through automatic overlap                         **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                      **
+ **	Published:   <insert date>                                                                                     **
+ *******************************************************************************************************************/
+
+#include "HeadlessRun.h"
+#include "SampleFixture.h"
+#include "UAVHazardFixture.h"
+#include "UAVHazardTracker.h"
+#include "UAVOverlapTest.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+static void CheckIndex(uint32_t operations, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<uint32_t> position(0, 2000);
+	std::uniform_int_distribution<uint32_t> size(0, 200);
+	std::uniform_int_distribution<uint32_t> clearChance(0, 99);
+
+	UAVFootprintIndex index;
+	index.Reset(1920, 1080, 64);
+	std::vector<UAVFootprint> inserted;
+
+	uint32_t mismatches = 0;
+	uint32_t hits = 0;
+	for (uint32_t i = 0; i < operations; i++)
+	{
+		if (clearChance(rng) == 0)
+		{
+			index.Clear();
+			inserted.clear();
+		}
+
+		// Positions reach past the 1920x1080 texture, and sizes include empty footprints
+		UAVFootprint footprint;
+		footprint.x0 = position(rng);
+		footprint.y0 = position(rng);
+		footprint.x1 = footprint.x0 + size(rng);
+		footprint.y1 = footprint.y0 + size(rng);
+
+		bool expected = false;
+		for (const UAVFootprint& other : inserted)
+		{
+			expected |= !footprint.IsEmpty() && footprint.Intersects(other);
+		}
+		bool actual = index.Intersects(footprint);
+		mismatches += (actual != expected) ? 1 : 0;
+		hits += actual ? 1 : 0;
+
+		index.Insert(footprint);
+		if (!footprint.IsEmpty())
+		{
+			inserted.push_back(footprint);
+		}
+	}
+
+	CHECK(mismatches == 0);
+	CHECK(hits > 0 && hits < operations);
+}
+
+// Runs footprints through the tracker, then replays the call log: no two dispatches inside one bracket may
+// intersect, and a bracket may only close early where the next dispatch would have raced
+static void CheckTracker(UAVOverlapMode mode, const std::vector<UAVFootprint>& footprints, uint32_t expectedHazards, uint32_t expectedBrackets)
+{
+	CallLogDevice device;
+	UAVHazardTracker tracker;
+	tracker.BeginPass(&device, mode, 1920, 1080);
+	for (const UAVFootprint& footprint : footprints)
+	{
+		tracker.Dispatch(footprint, 1, 1, 1);
+	}
+	tracker.EndPass();
+	const UAVHazardTracker::PassStats& stats = tracker.GetLastPassStats();
+	CHECK(stats.dispatchCount == footprints.size());
+	CHECK(stats.hazardCount == expectedHazards);
+	CHECK(stats.bracketCount == expectedBrackets);
+
+	bool ok = true;
+	bool bInBracket = false;
+	size_t dispatch = 0;
+	std::vector<UAVFootprint> bracket;
+	for (size_t i = 0; i < device.calls.size(); i++)
+	{
+		char call = device.calls[i];
+		ok &= (call == 'B') != bInBracket || call == 'D';
+		if (call == 'B')
+		{
+			bInBracket = true;
+			bracket.clear();
+		}
+		else if (call == 'E')
+		{
+			bInBracket = false;
+			bool bRaceAvoided = dispatch < footprints.size();
+			for (const UAVFootprint& other : bracket)
+			{
+				bRaceAvoided = bRaceAvoided && !footprints[dispatch].Intersects(other);
+			}
+			ok &= mode != UAV_OVERLAP_AUTO || dispatch == footprints.size() || !bRaceAvoided;
+		}
+		else
+		{
+			for (const UAVFootprint& other : bracket)
+			{
+				ok &= mode != UAV_OVERLAP_AUTO || !footprints[dispatch].Intersects(other);
+			}
+			ok &= mode == UAV_OVERLAP_OFF || bInBracket;
+			bracket.push_back(footprints[dispatch++]);
+		}
+	}
+	CHECK(ok);
+	CHECK(!bInBracket && dispatch == footprints.size());
+}
+
+TEST(UAVHazard, IndexMatchesBruteForce)
+{
+	CheckIndex(20000, 1);
+	CheckIndex(20000, 2);
+}
+
+TEST(UAVHazard, TrackerBrackets)
+{
+	std::vector<UAVFootprint> grid;
+	TileFootprints(1920, 1080, 8, grid);
+
+	// The same grid swept twice: the second sweep starts with a hazard and is disjoint from then on
+	std::vector<UAVFootprint> twice = grid;
+	twice.insert(twice.end(), grid.begin(), grid.end());
+
+	// 16x16 footprints on an 8 texel stride, so each overlaps its neighbours
+	std::vector<UAVFootprint> overlapping;
+	for (uint32_t x = 0; x < 64; x += 8)
+	{
+		for (uint32_t y = 0; y < 64; y += 8)
+		{
+			UAVFootprint footprint = { x, y, x + 16, y + 16 };
+			overlapping.push_back(footprint);
+		}
+	}
+
+	CheckTracker(UAV_OVERLAP_AUTO, grid, 0, 1);
+	CheckTracker(UAV_OVERLAP_AUTO, twice, 1, 2);
+	CheckTracker(UAV_OVERLAP_ALWAYS, twice, (uint32_t)grid.size(), 1);
+	CheckTracker(UAV_OVERLAP_OFF, twice, 0, 0);
+	CheckTracker(UAV_OVERLAP_AUTO, overlapping, 56, 57);
+}
+
+// The sample through automatic overlap renders the same image as without overlap, in one bracket
+TEST(UAVHazard, AutoOverlapSameImage)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 320;
+	options.height = 180;
+	options.tileSize = 8;
+
+	SampleFrame frames[2];
+	for (uint32_t useAuto = 0; useAuto < 2; useAuto++)
+	{
+		options.bAutoUAVOverlap = (useAuto != 0);
+		REQUIRE(RenderSample(options, false, 3, frames[useAuto]));
+	}
+
+	CHECK(!frames[0].image.empty());
+	CHECK(frames[0].image == frames[1].image);
+	CHECK(frames[0].overlapStats.bracketCount == 0);
+	CHECK(frames[1].overlapStats.bracketCount == 1);
+	CHECK(frames[1].overlapStats.hazardCount == 0);
+}
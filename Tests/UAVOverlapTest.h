@@ -0,0 +1,35 @@
+/********************************************************************************************************
+ **	Name:        UAVOverlapTest.h                                                                      **
+ **	Description: Minimal test registry for UAVOverlapTests: TEST() registers a case, CHECK() records a **
+ **              failure and carries on, REQUIRE() records a failure and leaves the case               **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                          **
+ **	Published:   <insert date>                                                                         **
+ *******************************************************************************************************/
+
+#ifndef UAVOVERLAPTEST_H
+#define UAVOVERLAPTEST_H
+
+typedef void (*TestFn)();
+
+// Adds a test case to the list TestMain.cpp runs; done by TEST() during static initialization
+class TestRegistration
+{
+public:
+	TestRegistration(const char* suite, const char* name, TestFn fn);
+};
+
+// Records a failed CHECK or REQUIRE against the running test case
+void ReportTestFailure(const char* file, int line, const char* expression);
+
+#define TEST(suite, name) \
+	static void suite##_##name(); \
+	static TestRegistration suite##_##name##_registration(#suite, #name, suite##_##name); \
+	static void suite##_##name()
+
+#define CHECK(expression) \
+	do { if (!(expression)) ReportTestFailure(__FILE__, __LINE__, #expression); } while (0)
+
+#define REQUIRE(expression) \
+	do { if (!(expression)) { ReportTestFailure(__FILE__, __LINE__, #expression); return; } } while (0)
+
+#endif // UAVOVERLAPTEST_H
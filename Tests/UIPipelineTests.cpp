@@ -0,0 +1,160 @@
+/******************************************************************************************************************
+ **	Name:        UIPipelineTests.cpp                                                                             **
+ **	Description: Checks that the owned ImGui pipeline draws with the same state as the save-and-restore path on  **
+ **              synthetic draw data and the sample's overlay, and that the state filter forgets what it changed **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                    **
+ **	Published:   <insert date>                                                                                   **
+ *****************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "GraphicsDeviceDecorator.h"
+#include "HeadlessRun.h"
+#include "StateFilterGraphicsDevice.h"
+#include "UAVOverlapSampleApp.h"
+#include "UAVOverlapTest.h"
+#include "UIPipelineFixture.h"
+
+#include <string>
+#include <vector>
+
+#include "imgui.h"
+
+// What the draw callback binds
+static const char gCallbackObject = 0;
+
+static void BindFromCallback(const ImDrawList*, const ImDrawCmd*)
+{
+	gCallbackContext->BindForApp(UI_SLOT_VERTEX_SHADER, &gCallbackObject);
+	gCallbackContext->BindForApp(UI_SLOT_SCISSOR_RECT, &gCallbackObject);
+}
+
+static ImDrawCmd MakeCommand(uint32_t elemCount, uint32_t idxOffset, uint32_t vtxOffset, void* texture, float x0, float y0, float x1, float y1)
+{
+	ImDrawCmd command;
+	command.ElemCount = elemCount;
+	command.IdxOffset = idxOffset;
+	command.VtxOffset = vtxOffset;
+	command.TextureId = texture;
+	command.ClipRect = ImVec4(x0, y0, x1, y1);
+	return command;
+}
+
+// Redundant draws, both kinds of callback, a display origin and vertex offsets, over several frames
+TEST(UIPipeline, SyntheticDrawData)
+{
+	static char textures[2];
+	ImDrawList first(nullptr);
+	ImDrawList second(nullptr);
+	first.VtxBuffer.resize(40);
+	first.IdxBuffer.resize(60);
+	second.VtxBuffer.resize(70000);
+	second.IdxBuffer.resize(12);
+
+	first.CmdBuffer.push_back(MakeCommand(12, 0, 0, &textures[0], 10.5f, 20.0f, 200.0f, 120.7f));
+	first.CmdBuffer.push_back(MakeCommand(6, 12, 0, &textures[0], 10.5f, 20.0f, 200.0f, 120.7f));
+	ImDrawCmd reset;
+	reset.UserCallback = ImDrawCallback_ResetRenderState;
+	first.CmdBuffer.push_back(reset);
+	first.CmdBuffer.push_back(MakeCommand(18, 18, 0, &textures[1], 10.0f, 20.0f, 60.0f, 80.0f));
+	ImDrawCmd callback;
+	callback.UserCallback = BindFromCallback;
+	first.CmdBuffer.push_back(callback);
+	first.CmdBuffer.push_back(MakeCommand(24, 36, 0, &textures[1], 10.0f, 20.0f, 60.0f, 80.0f));
+	second.CmdBuffer.push_back(MakeCommand(6, 0, 0, &textures[0], 10.5f, 20.0f, 200.0f, 120.7f));
+	second.CmdBuffer.push_back(MakeCommand(6, 6, 65536, &textures[0], 10.5f, 20.0f, 200.0f, 120.7f));
+
+	ImDrawList* lists[] = { &first, &second };
+	ImDrawData drawData;
+	drawData.Valid = true;
+	drawData.CmdLists = lists;
+	drawData.CmdListsCount = 2;
+	drawData.TotalVtxCount = first.VtxBuffer.Size + second.VtxBuffer.Size;
+	drawData.TotalIdxCount = first.IdxBuffer.Size + second.IdxBuffer.Size;
+	drawData.DisplayPos = ImVec2(10.0f, 20.0f);
+	drawData.DisplaySize = ImVec2(640.0f, 480.0f);
+
+	FrameComparison comparison;
+	for (uint32_t frame = 0; frame < 4; frame++)
+	{
+		comparison.Render(&drawData, 500, 900);
+
+		// The last draw is second's with the vertex offset, after first's data and the ring offsets
+		const std::vector<MockContext::DrawRecord>& draws = comparison.owned.GetDraws();
+		REQUIRE(draws.size() == 6);
+		CHECK(draws[5].startIndex == 900 + 60 + 6 && draws[5].baseVertex == 500 + 40 + 65536);
+		CHECK(draws[0].state[UI_SLOT_SCISSOR_RECT].rect[0] == 0 && draws[0].state[UI_SLOT_SCISSOR_RECT].rect[3] == 100);
+		CHECK(draws[4].state[UI_SLOT_VERTEX_SHADER].object == &gCallbackObject);
+
+		// The owned path skips the binds of the second draw, the whole reset and the last draw, but rebinds the draw
+		// after the callback and, in the next frame, everything the callback left unknown. Only the scissor rectangle
+		// the last frame ended with carries over to the first draw.
+		const UIPipelineCounters& counters = comparison.ownedRenderer.GetLastCounters();
+		CHECK(counters.skippedBinds == 2 + 16 + 2 + (frame > 0 ? 1u : 0u));
+	}
+	CHECK(comparison.bOk);
+}
+
+// Counts what reaches the device below the state filter, and reports the UI state as preserved or not
+class UIStateDevice : public GraphicsDeviceDecorator
+{
+public:
+	UIStateDevice(GraphicsDevice* inner, bool preserved) : GraphicsDeviceDecorator(inner), bPreserved(preserved), mVertexShaderCount(0) {}
+
+	virtual bool IsUIStatePreserved() const { return bPreserved; }
+	virtual void RenderUI(ImDrawData*) {}
+	virtual void VSSetShader(GfxShader shader) { mVertexShaderCount++; mInner->VSSetShader(shader); }
+
+	uint32_t GetVertexShaderCount() const { return mVertexShaderCount; }
+
+private:
+	bool bPreserved;
+	uint32_t mVertexShaderCount;
+};
+
+
+// The state filter forgets the bindings an owning UI renderer may have changed, and only then
+TEST(UIPipeline, StateFilterForgetsUIBindings)
+{
+	for (uint32_t preserved = 0; preserved < 2; preserved++)
+	{
+		CPUGraphicsDevice device(1);
+		UIStateDevice uiDevice(&device, preserved != 0);
+		StateFilterGraphicsDevice filter(&uiDevice);
+		CHECK(filter.Init(64, 64));
+		GfxShader shader = filter.CreateVertexShader("VertexShader");
+		filter.VSSetShader(shader);
+		filter.RenderUI(nullptr);
+		filter.VSSetShader(shader);
+		CHECK(uiDevice.GetVertexShaderCount() == (preserved ? 1u : 2u));
+		filter.Release(shader);
+		filter.Cleanup();
+	}
+}
+
+// The sample's own overlay, frame after frame, makes the same draws with the same state and fewer context calls
+TEST(UIPipeline, SampleOverlay)
+{
+	const uint32_t frames = 20;
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 1280;
+	options.height = 720;
+
+	CPUGraphicsDevice cpuDevice(2);
+	DrawDataComparisonDevice comparisonDevice(&cpuDevice);
+	UAVOverlapSampleApp app(&comparisonDevice, options.width, options.height);
+	app.ApplyOptions(options);
+	bool rendered = app.Init();
+	for (uint32_t frame = 0; frame < frames && rendered; frame++)
+	{
+		app.Render(1.0);
+	}
+	app.Cleanup();
+
+	FrameComparison& comparison = comparisonDevice.GetComparison();
+	CHECK(rendered);
+	CHECK(comparison.bOk);
+	CHECK(comparison.frameCount == frames);
+	CHECK(comparison.ownedCalls < comparison.savedCalls);
+}
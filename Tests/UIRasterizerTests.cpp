@@ -0,0 +1,179 @@
+/**************************************************************************************************************************
+ **	Name:        UIRasterizerTests.cpp                                                                                   **
+ **	Description: Checks the tiled ImGui rasterizer bit-for-bit against a per-triangle reference on the sample's overlay, **
+ **              its tie-break and scissor rules, and that the CPU device only draws the windows' area                   **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                            **
+ **	Published:   <insert date>                                                                                           **
+ *************************************************************************************************************************/
+
+#include "CPUGraphicsDevice.h"
+#include "HeadlessRun.h"
+#include "UAVOverlapSampleApp.h"
+#include "UAVOverlapTest.h"
+#include "UIRasterizerFixture.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+static UIVertex MakeVertex(float x, float y, uint32_t color)
+{
+	UIVertex vertex = { x, y, 0.0f, 0.0f, color };
+	return vertex;
+}
+
+// The captured overlay, scalar and SSE2, on the calling thread and on 4 threads, matches the reference
+TEST(UIRasterizer, CapturedFrameMatchesReference)
+{
+	CPUGraphicsDevice cpuDevice(2);
+	DrawDataCaptureDevice capture(&cpuDevice);
+	CPUTexture2D background;
+	REQUIRE(CaptureSampleUI(1280, 720, 3, capture, background));
+	const UIFrame& frame = capture.GetFrame();
+
+	CPUTexture2D reference = background;
+	ReferenceRender(frame, reference);
+	CHECK(reference.texels != background.texels);
+
+	ThreadPool pool(4);
+	for (uint32_t config = 0; config < 4; config++)
+	{
+		UIRasterizer rasterizer(config >= 2 ? &pool : nullptr);
+		rasterizer.SetSIMDEnabled(config & 1);
+
+		// Twice, so the second frame runs on the bins the first one left behind
+		CPUTexture2D image = background;
+		rasterizer.Render(frame, image);
+		image = background;
+		rasterizer.Render(frame, image);
+		CHECK(image.texels == reference.texels);
+	}
+}
+
+// Triangles sharing edges at every angle blend each covered pixel exactly once
+TEST(UIRasterizer, SharedEdgesBlendedOnce)
+{
+	CPUTexture2D white(1, 1);
+	white.Clear(0xFFFFFFFF);
+
+	const uint32_t width = 200;
+	const uint32_t height = 160;
+	const uint32_t color = 0x80FF8040;
+	const uint32_t once = ReferenceBlend(color, 0xFF000000);
+
+	// A fan of 37 triangles around an off-grid center; the last one closes it with slivers
+	UIFrame fan;
+	const float centerX = 100.3f;
+	const float centerY = 80.7f;
+	const uint32_t spokes = 37;
+	for (uint32_t i = 0; i < spokes; i++)
+	{
+		float angle0 = 6.2831853f * i / spokes;
+		float angle1 = 6.2831853f * ((i + 1) % spokes) / spokes;
+		fan.vertices.push_back(MakeVertex(centerX, centerY, color));
+		fan.vertices.push_back(MakeVertex(centerX + 70.1f * cosf(angle0), centerY + 70.1f * sinf(angle0), color));
+		fan.vertices.push_back(MakeVertex(centerX + 70.1f * cosf(angle1), centerY + 70.1f * sinf(angle1), color));
+	}
+	UIDrawCommand fanCommand = { 0, 0, (int32_t)width, (int32_t)height, &white, 0, spokes };
+	fan.commands.push_back(fanCommand);
+
+	ThreadPool pool(3);
+	UIRasterizer rasterizer(&pool);
+	CPUTexture2D image(width, height);
+	image.Clear(0xFF000000);
+	rasterizer.Render(fan, image);
+
+	uint32_t covered = 0;
+	bool blendedOnce = true;
+	for (uint32_t texel : image.texels)
+	{
+		covered += (texel != 0xFF000000) ? 1 : 0;
+		blendedOnce &= (texel == 0xFF000000 || texel == once);
+	}
+	CHECK(blendedOnce);
+	// The polygon's area is about 15,400 pixels
+	CHECK(covered > 15000 && covered < 15600);
+}
+
+// A triangle over the whole target, scissored to a rectangle, draws exactly that rectangle
+TEST(UIRasterizer, ScissorRectangle)
+{
+	CPUTexture2D white(1, 1);
+	white.Clear(0xFFFFFFFF);
+
+	const uint32_t width = 200;
+	const uint32_t height = 160;
+
+	UIFrame clipped;
+	clipped.vertices.push_back(MakeVertex(-10.0f, -10.0f, 0xFFFFFFFF));
+	clipped.vertices.push_back(MakeVertex(500.0f, -10.0f, 0xFFFFFFFF));
+	clipped.vertices.push_back(MakeVertex(-10.0f, 500.0f, 0xFFFFFFFF));
+	UIDrawCommand clippedCommand = { 10, 20, 50, 61, &white, 0, 1 };
+	clipped.commands.push_back(clippedCommand);
+
+	ThreadPool pool(3);
+	UIRasterizer rasterizer(&pool);
+	CPUTexture2D image(width, height);
+	image.Clear(0xFF000000);
+	rasterizer.Render(clipped, image);
+
+	bool scissored = true;
+	for (uint32_t y = 0; y < height; y++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			bool inside = x >= 10 && x < 50 && y >= 20 && y < 61;
+			scissored &= image.texels[(size_t)y * width + x] == (inside ? 0x00FFFFFFu : 0xFF000000u);
+		}
+	}
+	CHECK(scissored);
+}
+
+// The device draws the overlay only when asked to, into the windows' area only, with any number of frames in flight
+TEST(UIRasterizer, DeviceDrawsWindowsOnly)
+{
+	HeadlessOptions options;
+	ParseHeadlessOptions(std::vector<std::string>(), options);
+	options.bHeadless = true;
+	options.width = 640;
+	options.height = 600;
+
+	for (uint32_t framesInFlight = 1; framesInFlight <= 2; framesInFlight++)
+	{
+		options.framesInFlight = framesInFlight;
+
+		std::vector<uint32_t> images[2];
+		UIRasterizer::Stats stats = {};
+		for (uint32_t rasterize = 0; rasterize < 2; rasterize++)
+		{
+			CPUGraphicsDevice device(2);
+			device.SetUIRasterizationEnabled(rasterize != 0);
+			UAVOverlapSampleApp app(&device, options.width, options.height);
+			app.ApplyOptions(options);
+			bool rendered = app.Init();
+			for (uint32_t frame = 0; frame < 3 && rendered; frame++)
+			{
+				app.Render(1.0);
+			}
+			CHECK(rendered && device.ReadBackBuffer(images[rasterize]));
+			stats = device.GetLastUIStats();
+			app.Cleanup();
+		}
+		REQUIRE(images[0].size() == images[1].size());
+
+		// The Performance and Settings windows are 250 wide and end at y = 538
+		uint32_t changed = 0;
+		bool outside = true;
+		for (size_t i = 0; i < images[0].size(); i++)
+		{
+			uint32_t x = (uint32_t)(i % options.width);
+			uint32_t y = (uint32_t)(i / options.width);
+			bool differs = images[0][i] != images[1][i];
+			changed += differs ? 1 : 0;
+			outside &= !differs || (x < 251 && y < 539);
+		}
+		CHECK(outside);
+		CHECK(changed > 10000);
+		CHECK(stats.triangleCount > 0);
+	}
+}
@@ -0,0 +1,150 @@
+/*****************************************************************************************************************
+ **	Name:        UploadRingTests.cpp                                                                            **
+ **	Description: Checks the upload ring against a model of a dynamic buffer with one to three frames in flight, **
+ **              on synthetic and captured ImGui traces, and its doubling growth and wrap                       **
+ **	Author:      Geoffrey Douglas, geoffrey.douglas@intel.com                                                   **
+ **	Published:   <insert date>                                                                                  **
+ ****************************************************************************************************************/
+
+#include "UAVOverlapTest.h"
+#include "UploadRing.h"
+#include "UploadTraceFixture.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+// A dynamic buffer as the driver sees it: WRITE_DISCARD hands out fresh memory and leaves the old contents to the
+// frames still reading them, WRITE_NO_OVERWRITE writes into the current memory. Each frame writes a pattern into its
+// range and, once it is framesInFlight frames old, checks that the pattern is still there when the GPU would read it.
+class DynamicBufferModel
+{
+public:
+	explicit DynamicBufferModel(uint32_t framesInFlight) : mFramesInFlight(framesInFlight), mFrame(0), bOk(true) {}
+
+	bool IsOk() const { return bOk; }
+
+	void Upload(const UploadRing& ring, const UploadRingAllocation& allocation, uint32_t count)
+	{
+		if (allocation.bRecreate || allocation.bDiscard || !mMemory)
+		{
+			// Recreation is only asked for with a discard, so a buffer is never written before its first discard
+			bOk &= allocation.bDiscard;
+			mMemory = std::make_shared<std::vector<uint32_t>>(ring.GetCapacity(), 0xCDCDCDCD);
+		}
+		bOk &= (uint64_t)allocation.offset + count <= mMemory->size();
+
+		PendingRead read = { mMemory, allocation.offset, count, mFrame };
+		for (uint32_t i = 0; i < count && bOk; i++)
+		{
+			(*mMemory)[allocation.offset + i] = Pattern(mFrame, i);
+		}
+		mPending.push_back(read);
+
+		while (!mPending.empty() && mPending.front().frame + mFramesInFlight <= mFrame)
+		{
+			Retire(mPending.front());
+			mPending.pop_front();
+		}
+		mFrame++;
+	}
+
+	void Finish()
+	{
+		for (const PendingRead& read : mPending)
+		{
+			Retire(read);
+		}
+		mPending.clear();
+	}
+
+private:
+	struct PendingRead
+	{
+		std::shared_ptr<std::vector<uint32_t>> memory;
+		uint32_t offset;
+		uint32_t count;
+		uint32_t frame;
+	};
+
+	static uint32_t Pattern(uint32_t frame, uint32_t i) { return frame * 0x9E3779B1u + i; }
+
+	void Retire(const PendingRead& read)
+	{
+		for (uint32_t i = 0; i < read.count && bOk; i++)
+		{
+			bOk &= (*read.memory)[read.offset + i] == Pattern(read.frame, i);
+		}
+	}
+
+	uint32_t mFramesInFlight;
+	uint32_t mFrame;
+	bool bOk;
+	std::shared_ptr<std::vector<uint32_t>> mMemory;
+	std::deque<PendingRead> mPending;
+};
+
+// Every upload lands inside the buffer, is intact when the frames in flight read it, and is counted
+static bool MatchesModel(const Trace& trace, uint32_t framesInFlight)
+{
+	UploadRing ring(sizeof(uint32_t), 5000);
+	DynamicBufferModel model(framesInFlight);
+	uint64_t bytes = 0;
+	uint64_t recreations = 0;
+	uint64_t discards = 0;
+	for (uint32_t frame = 0; frame < trace.counts.size(); frame++)
+	{
+		if (frame == trace.counts.size() / 3)
+		{
+			ring.Invalidate();
+		}
+		UploadRingAllocation allocation = ring.Allocate(trace.counts[frame]);
+		model.Upload(ring, allocation, trace.counts[frame]);
+		bytes += (uint64_t)trace.counts[frame] * sizeof(uint32_t);
+		recreations += allocation.bRecreate ? 1 : 0;
+		discards += (allocation.bDiscard && !allocation.bRecreate) ? 1 : 0;
+	}
+	model.Finish();
+
+	const UploadRingStats& stats = ring.GetStats();
+	return model.IsOk() && stats.bytesUploaded == bytes && stats.recreationCount == recreations && stats.discardCount == discards &&
+		stats.allocationCount == trace.counts.size();
+}
+
+TEST(UploadRing, MatchesBufferModel)
+{
+	std::vector<uint32_t> vertexCounts;
+	std::vector<uint32_t> indexCounts;
+	REQUIRE(CaptureSampleCounts(8, vertexCounts, indexCounts));
+
+	for (const Trace& trace : MakeTraces(indexCounts, 2000))
+	{
+		CHECK(trace.counts.size() == 2000);
+		for (uint32_t framesInFlight = 1; framesInFlight <= 3; framesInFlight++)
+		{
+			CHECK(MatchesModel(trace, framesInFlight));
+		}
+	}
+}
+
+// An upload of more than half the buffer doubles it until it fits twice; smaller ones follow on until the wrap
+TEST(UploadRing, DoublingGrowthAndWrap)
+{
+	UploadRing ring(sizeof(uint32_t), 4);
+	UploadRingAllocation first = ring.Allocate(3);
+	UploadRingAllocation second = ring.Allocate(100);
+	UploadRingAllocation third = ring.Allocate(50);
+	UploadRingAllocation fourth = ring.Allocate(60);
+	UploadRingAllocation empty = ring.Allocate(0);
+	UploadRingAllocation wrap = ring.Allocate(50);
+
+	CHECK(first.bRecreate);
+	CHECK(second.bRecreate && second.offset == 0);
+	CHECK(ring.GetCapacity() == 256);
+	CHECK(!third.bDiscard && third.offset == 100);
+	CHECK(!fourth.bDiscard && fourth.offset == 150);
+	CHECK(!empty.bDiscard && empty.offset == 210);
+	CHECK(wrap.bDiscard && !wrap.bRecreate && wrap.offset == 0);
+	CHECK(ring.GetStats().recreationCount == 2);
+	CHECK(ring.GetStats().discardCount == 1);
+}